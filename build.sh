@@ -7,10 +7,12 @@ set -e
 # Defaults
 CC=gcc
 CXX=g++
+HOST_CC=gcc
 SDL2_CONFIG="sdl2-config"
 IMGUI_VERSION="imgui-1.89.9"
 CLEAN_BUILD="false"
 DEVELOPER_BUILD="false"
+HEADLESS_BUILD="false"
 
 EXTRA_FLAGS=""
 EXTRA_LINKS=""
@@ -43,12 +45,22 @@ build_prepare ()
 }
 
 
+# Generate tables that are compiled into the emulator core.
+build_tables ()
+{
+    echo "Generating tables..."
+    $HOST_CC -std=c17 -O2 -Wall -Werror source/cpu/m68k_gen.c -o work/m68k_gen
+    ./work/m68k_gen work/m68k_tables.h
+}
+
+
 # Compile Snepulator emulator core.
 build_snepulator ()
 {
     echo "Compiling emulator..."
-    eval $CC $CFLAGS -c source/cpu/m68k.c           -o work/m68k.o
+    eval $CC $CFLAGS -I work/ -c source/cpu/m68k.c  -o work/m68k.o
     eval $CC $CFLAGS -c source/cpu/z80.c            -o work/z80.o
+    eval $CC $CFLAGS -c source/cpu/z80_jit.c        -o work/z80_jit.o
     eval $CC $CFLAGS -c source/database/sg_db.c     -o work/sg_db.o
     eval $CC $CFLAGS -c source/database/sms_db.c    -o work/sms_db.o
     eval $CC $CFLAGS -c source/sound/band_limit.c   -o work/band_limit.o
@@ -60,7 +72,6 @@ build_snepulator ()
     eval $CC $CFLAGS -c source/colecovision.c       -o work/colecovision.o
     eval $CC $CFLAGS -c source/config.c             -o work/config.o
     eval $CC $CFLAGS -c source/gamepad.c            -o work/gamepad.o
-    eval $CC $CFLAGS -c source/gamepad_sdl.c        -o work/gamepad_sdl.o
     eval $CC $CFLAGS -c source/logo.c               -o work/logo.o
     eval $CC $CFLAGS -c source/midi_player.c        -o work/midi_player.o
     eval $CC $CFLAGS -c source/path.c               -o work/path.o
@@ -84,6 +95,7 @@ build_snepulator ()
 build_snepulator_gui ()
 {
     echo "Compiling GUI..."
+    eval $CC  $CFLAGS   -c source/gamepad_sdl.c   -o work/gamepad_sdl.o
     eval $CXX $CXXFLAGS -c source/main.cpp        -o work/main.o
     eval $CXX $CXXFLAGS -c source/shader.cpp      -o work/shader.o
     eval $CXX $CXXFLAGS -c source/gui/input.cpp   -o work/input.o
@@ -92,6 +104,15 @@ build_snepulator_gui ()
 }
 
 
+# Compile the headless runner.
+build_snepulator_headless ()
+{
+    echo "Compiling headless runner..."
+    eval $CC $CFLAGS -c source/headless.c           -o work/headless.o
+    eval $CC $CFLAGS -c source/headless_run.c       -o work/headless_run.o
+}
+
+
 # Compile ImGui if we haven't already.
 build_imgui ()
 {
@@ -122,8 +143,12 @@ build_libraries ()
     eval $CC $CFLAGS -c libraries/BLAKE3/blake3_portable.c -o work/blake3_portable.o
     eval $CC $CFLAGS -DBLAKE3_NO_SSE2 -DBLAKE3_NO_SSE41 -DBLAKE3_NO_AVX2 -DBLAKE3_NO_AVX512 \
                      -c libraries/BLAKE3/blake3_dispatch.c -o work/blake3_dispatch.o
-    eval $CC $CFLAGS -c libraries/gl3w/GL/gl3w.c           -o work/gl3w.o
     eval $CC $CFLAGS -c libraries/libspng-0.7.4/spng.c     -o work/spng.o
+
+    if [ ${HEADLESS_BUILD} = "false" ]
+    then
+        eval $CC $CFLAGS -c libraries/gl3w/GL/gl3w.c       -o work/gl3w.o
+    fi
 }
 
 # Version from Git tag.
@@ -160,6 +185,7 @@ do
             echo "Using Clang"
             CC="clang"
             CXX="clang++"
+            HOST_CC="clang"
             ;;
         windows)
             echo "Windows build (x86_64)"
@@ -174,6 +200,31 @@ do
             DEVELOPER_BUILD="true"
             EXTRA_FLAGS="${EXTRA_FLAGS} -DDEVELOPER_BUILD"
             ;;
+        native)
+            echo "Optimising for the host CPU"
+            EXTRA_FLAGS="${EXTRA_FLAGS} -march=native"
+            ;;
+        threaded)
+            echo "Threaded Z80 dispatch"
+            EXTRA_FLAGS="${EXTRA_FLAGS} -DZ80_COMPUTED_GOTO"
+            ;;
+        m68k-compact)
+            echo "Compact 68000 decoder"
+            EXTRA_FLAGS="${EXTRA_FLAGS} -DM68K_COMPACT"
+            ;;
+        vdp-deferred)
+            echo "Deferred SMS VDP rendering"
+            EXTRA_FLAGS="${EXTRA_FLAGS} -DSMS_VDP_DEFERRED"
+            ;;
+        rgbx)
+            echo "32-bit RGBX pixels"
+            EXTRA_FLAGS="${EXTRA_FLAGS} -DVIDEO_PIXEL_RGBX"
+            ;;
+        headless)
+            echo "Headless build"
+            HEADLESS_BUILD="true"
+            EXTRA_FLAGS="${EXTRA_FLAGS} -DTARGET_HEADLESS"
+            ;;
         *)
             echo "Unknown option ${1}, aborting."
             exit
@@ -191,8 +242,16 @@ then
     CXX="ccache $CXX"
 fi
 
+# The headless runner does not use SDL
+if [ ${HEADLESS_BUILD} = "true" ]
+then
+    SDL2_CFLAGS=""
+else
+    SDL2_CFLAGS="$(${SDL2_CONFIG} --cflags)"
+fi
+
 CFLAGS="-std=c17 -O2 -Wall -Werror -D_POSIX_C_SOURCE=200809L \
-        $(${SDL2_CONFIG} --cflags) \
+        ${SDL2_CFLAGS} \
         -I libraries/BLAKE3/ \
         -I libraries/gl3w/ \
         -I libraries/libspng-0.7.4/ \
@@ -202,7 +261,7 @@ CFLAGS="-std=c17 -O2 -Wall -Werror -D_POSIX_C_SOURCE=200809L \
         ${EXTRA_FLAGS}"
 
 CXXFLAGS="-std=c++17 -O2 -Wall -Werror \
-          $(${SDL2_CONFIG} --cflags) \
+          ${SDL2_CFLAGS} \
           -I libraries/gl3w/ \
           -I ${IMGUI_PATH}/ \
           -I ${IMGUI_PATH}/backends/ \
@@ -210,13 +269,32 @@ CXXFLAGS="-std=c++17 -O2 -Wall -Werror \
           -DBUILD_TAG=\\\"${TAG:1}\\\" \
           ${EXTRA_FLAGS}"
 
-# Keep track of the compiler name and imgui version.
+# Keep track of the compiler name, imgui version, and build options.
 # If they change, we can force a clean build.
-BUILD_ID="${CC},${IMGUI_VERSION}"
+BUILD_ID="${CC},${IMGUI_VERSION},${EXTRA_FLAGS}"
 build_prepare
 echo ${BUILD_ID} > build_id.txt
 
+# The headless runner only needs the emulator core.
+if [ ${HEADLESS_BUILD} = "true" ]
+then
+    build_tables
+    build_snepulator
+    build_snepulator_headless
+    build_libraries
+
+    echo "Linking..."
+    eval $CC $CFLAGS \
+        work/*.o \
+        -lz -lm -lpthread \
+        -o Snepulator-headless
+
+    echo "Done."
+    exit
+fi
+
 # Compile the various components.
+build_tables
 build_snepulator
 build_snepulator_gui
 build_imgui
@@ -7,7 +7,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef TARGET_HEADLESS
 #include <SDL2/SDL.h>
+#endif
 
 #include "snepulator.h"
 #include "util.h"
@@ -32,6 +34,7 @@ static uint8_t  colecovision_io_read (void *context_ptr, uint8_t addr);
 static void     colecovision_io_write (void *context_ptr, uint8_t addr, uint8_t data);
 static uint8_t  colecovision_memory_read (void *context_ptr, uint16_t addr);
 static void     colecovision_memory_write (void *context_ptr, uint16_t addr, uint8_t data);
+static void     colecovision_memory_map_update (ColecoVision_Context *context);
 static void     colecovision_run (void *context_ptr, uint32_t ms);
 #ifdef HAVE_SAVE_STATES
 static void     colecovision_state_load (void *context_ptr, const char *filename);
@@ -107,7 +110,7 @@ static void colecovision_frame_done (void *context_ptr)
     ColecoVision_Context *context = (ColecoVision_Context *) context_ptr;
     TMS9928A_Context *vdp_context = context->vdp_context;
 
-    snepulator_frame_done (&vdp_context->frame_buffer);
+    snepulator_frame_done (vdp_context->frame_buffer);
 }
 
 
@@ -166,6 +169,12 @@ ColecoVision_Context *colecovision_init (void)
                             colecovision_get_int, colecovision_get_nmi);
     context->z80_context = z80_context;
 
+    /* Idle loops may poll the VDP status */
+    for (uint32_t port = 0xa1; port <= 0xbf; port += 0x02)
+    {
+        z80_idle_port_set (z80_context, port);
+    }
+
     /* Initialise VDP */
     vdp_context = tms9928a_init (context, colecovision_frame_done);
     context->vdp_context = vdp_context;
@@ -219,6 +228,8 @@ ColecoVision_Context *colecovision_init (void)
 #endif
     state.update_settings = colecovision_update_settings;
 
+    colecovision_memory_map_update (context);
+
     /* Set controller mapping */
     gamepad [1].group = GAMEPAD_MAPPING_GROUP_SMS;
     gamepad [2].group = GAMEPAD_MAPPING_GROUP_SMS;
@@ -269,6 +280,10 @@ static uint8_t colecovision_io_read (void *context_ptr, uint8_t addr)
             }
             else
             {
+#ifdef TARGET_HEADLESS
+                /* No keyboard available, report that no key is pressed. */
+                return 0x0f | BIT_4 | BIT_5 | (gamepad [1].state [GAMEPAD_BUTTON_2] ? 0 : BIT_6);
+#else
                 /* For now, just use the computer keyboard. */
                 uint8_t const *keyboard_state = SDL_GetKeyboardState (NULL);
                 uint8_t key;
@@ -329,6 +344,7 @@ static uint8_t colecovision_io_read (void *context_ptr, uint8_t addr)
                 }
 
                 return key | BIT_4 | BIT_5 | (gamepad [1].state [GAMEPAD_BUTTON_2] ? 0 : BIT_6);
+#endif
             }
         }
         else
@@ -343,25 +359,25 @@ static uint8_t colecovision_io_read (void *context_ptr, uint8_t addr)
 
 
 /*
- * Handle ColecoVision memory reads.
+ * Find the host memory that backs an address.
+ *
+ * Returns NULL for addresses that are not mapped to memory.
  */
-static uint8_t colecovision_memory_read (void *context_ptr, uint16_t addr)
+static uint8_t *colecovision_memory_pointer (ColecoVision_Context *context, uint16_t addr)
 {
-    ColecoVision_Context *context = (ColecoVision_Context *) context_ptr;
-
     /* BIOS */
     if (addr >= 0x0000 && addr <= 0x1fff)
     {
         if (context->bios != NULL)
         {
-            return context->bios [(addr) & context->bios_mask];
+            return &context->bios [(addr) & context->bios_mask];
         }
     }
 
     /* 1 KiB RAM (mirrored) */
     if (addr >= 0x6000 && addr <= 0x7fff)
     {
-        return context->ram [addr & (COLECOVISION_RAM_SIZE - 1)];
+        return &context->ram [addr & (COLECOVISION_RAM_SIZE - 1)];
     }
 
     /* Cartridge slot */
@@ -369,11 +385,53 @@ static uint8_t colecovision_memory_read (void *context_ptr, uint16_t addr)
     {
         if (context->rom != NULL)
         {
-            return context->rom [addr & context->rom_mask];
+            return &context->rom [addr & context->rom_mask];
         }
     }
 
-    return 0xff;
+    return NULL;
+}
+
+
+/*
+ * Handle ColecoVision memory reads.
+ */
+static uint8_t colecovision_memory_read (void *context_ptr, uint16_t addr)
+{
+    ColecoVision_Context *context = (ColecoVision_Context *) context_ptr;
+    uint8_t *pointer = colecovision_memory_pointer (context, addr);
+
+    if (pointer == NULL)
+    {
+        return 0xff;
+    }
+
+    return *pointer;
+}
+
+
+/*
+ * Build the Z80 memory map. There is no mapper, so this is only done once.
+ *
+ * Pages are only mapped if they are backed by contiguous host memory.
+ */
+static void colecovision_memory_map_update (ColecoVision_Context *context)
+{
+    for (uint32_t page = 0; page < Z80_PAGE_COUNT; page++)
+    {
+        uint16_t addr = page * Z80_PAGE_SIZE;
+        uint8_t *first = colecovision_memory_pointer (context, addr);
+        uint8_t *last = colecovision_memory_pointer (context, addr + Z80_PAGE_SIZE - 1);
+
+        if (first != NULL && last == first + Z80_PAGE_SIZE - 1)
+        {
+            context->z80_context->memory_map [page] = first;
+        }
+        else
+        {
+            context->z80_context->memory_map [page] = NULL;
+        }
+    }
 }
 
 
@@ -454,6 +512,12 @@ static void colecovision_run (void *context_ptr, uint32_t cycles)
         z80_run_cycles (context->z80_context, 228 + context->overclock);
         sn76489_run_cycles (context->psg_context, state.clock_rate, 228);
         tms9928a_run_one_scanline (context->vdp_context);
+
+        /* If the VDP is raising an interrupt, have the Z80 check before its next instruction */
+        if (tms9928a_get_interrupt (context->vdp_context))
+        {
+            z80_interrupt_deadline_set (context->z80_context, context->z80_context->cycle_count);
+        }
     }
 }
 
@@ -527,6 +591,7 @@ static void colecovision_state_load (void *context_ptr, const char *filename)
             if (size == TMS9928A_VRAM_SIZE)
             {
                 memcpy (context->vdp_context->vram, data, TMS9928A_VRAM_SIZE);
+                tms9928a_sprite_lines_invalidate (context->vdp_context);
             }
             else
             {
@@ -582,6 +647,8 @@ static void colecovision_update_settings (void *context_ptr)
 
     /* Update console */
     context->overclock           = state.overclock;
+    context->z80_context->idle_skip = state.z80_idle_skip;
+    z80_jit_set (context->z80_context, state.z80_jit);
 
     if (state.format_auto)
     {
@@ -3,6 +3,10 @@
  * Motorola 68000 header
  */
 
+/* Memory map used for fast-path accesses, covering the 24-bit address bus */
+#define M68K_PAGE_SIZE      SIZE_64K
+#define M68K_PAGE_COUNT     256
+
 /* Structs */
 typedef struct M68000_State_s {
 
@@ -51,6 +55,7 @@ typedef struct M68000_Context_s {
     void *parent;
     M68000_State state;
     int32_t clock_cycles; /* Outstanding clock cycles to run. */
+    uint64_t instruction_count; /* Instructions executed since power-on. */
 
     /* Connections to the rest of the system */
     /* TODO: 8-bit read / write support with UDS/LDS */
@@ -60,6 +65,13 @@ typedef struct M68000_Context_s {
     void     (* memory_write_8)  (void *, uint32_t, uint8_t);
     uint8_t  (* get_int)         (void *);
 
+    /* Host memory backing each page of the address space, maintained by the
+     * console. Accesses to pages left as NULL, such as I/O and the VDP, go
+     * through the memory_read / memory_write callbacks. Data is stored as
+     * host-endian 16-bit words, with byte accesses made to address ^ 1. */
+    uint8_t *memory_map [M68K_PAGE_COUNT];
+    uint8_t *memory_map_write [M68K_PAGE_COUNT];
+
 } M68000_Context;
 
 /* Run the 68000 for the specified number of clock cycles. */
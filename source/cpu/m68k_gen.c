@@ -0,0 +1,2178 @@
+/*
+ * Snepulator
+ * Motorola 68000 table generator
+ *
+ * Runs on the build host to create the opcode tables for m68k.c:
+ *  - m68k_instruction: The handler for each of the 64K opcodes.
+ *  - m68k_cycles: The base number of clock cycles used by each opcode,
+ *                 including the time taken to calculate its effective
+ *                 addresses. Where the time also depends on the operands,
+ *                 the handler returns the additional cycles.
+ *
+ * And for the compact core, built with M68K_COMPACT:
+ *  - m68k_class: The class of each of the 64K opcodes.
+ *  - m68k_class_info: The handler and base number of clock cycles for each
+ *                     class. Opcodes that share both are in the same class.
+ *
+ * Usage: m68k_gen <output.h>
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIZE_64K (64 << 10)
+
+/* Handler names, indexed by opcode */
+static const char *m68k_instruction [SIZE_64K] = { };
+
+/* Base clock cycles, indexed by opcode */
+static uint8_t m68k_cycles [SIZE_64K] = { };
+
+/* Compact core classes. Class 0 is used for opcodes without a handler. */
+#define MAX_CLASSES 1024
+static uint16_t m68k_class [SIZE_64K] = { };
+static char class_handler [MAX_CLASSES] [32] = { "NULL" };
+static uint8_t class_cycles [MAX_CLASSES] = { };
+static uint32_t class_count = 1;
+
+/* Effective address modes */
+typedef enum M68000_EA_Mode_e {
+    EA_DN = 0,      /* Dn */
+    EA_AN,          /* An */
+    EA_AN_IND,      /* (An) */
+    EA_AN_POST,     /* (An)+ */
+    EA_AN_PRE,      /* -(An) */
+    EA_AN_DISP,     /* d(An) */
+    EA_AN_INDEX,    /* d(An,Xi) */
+    EA_ABS_W,       /* (xxx).w */
+    EA_ABS_L,       /* (xxx).l */
+    EA_PC_DISP,     /* d(PC) */
+    EA_PC_INDEX,    /* d(PC,Xi) */
+    EA_IMM,         /* #xxx */
+    EA_INVALID
+} M68000_EA_Mode;
+
+/* Clock cycles to calculate an effective address and read the operand,
+ * for byte / word and long operands. */
+static const uint8_t ea_cycles [EA_INVALID + 1] [2] = {
+    { 0,  0  },     /* Dn */
+    { 0,  0  },     /* An */
+    { 4,  8  },     /* (An) */
+    { 4,  8  },     /* (An)+ */
+    { 6,  10 },     /* -(An) */
+    { 8,  12 },     /* d(An) */
+    { 10, 14 },     /* d(An,Xi) */
+    { 8,  12 },     /* (xxx).w */
+    { 12, 16 },     /* (xxx).l */
+    { 8,  12 },     /* d(PC) */
+    { 10, 14 },     /* d(PC,Xi) */
+    { 4,  8  }      /* #xxx */
+};
+
+/* Clock cycles for the control instructions, by effective address mode */
+static const uint8_t jmp_cycles [EA_INVALID + 1] = { [EA_AN_IND] = 8,  [EA_AN_DISP] = 10, [EA_AN_INDEX] = 14, [EA_ABS_W] = 10,
+                                                     [EA_ABS_L] = 12,  [EA_PC_DISP] = 10, [EA_PC_INDEX] = 14 };
+static const uint8_t jsr_cycles [EA_INVALID + 1] = { [EA_AN_IND] = 16, [EA_AN_DISP] = 18, [EA_AN_INDEX] = 22, [EA_ABS_W] = 18,
+                                                     [EA_ABS_L] = 20,  [EA_PC_DISP] = 18, [EA_PC_INDEX] = 22 };
+static const uint8_t lea_cycles [EA_INVALID + 1] = { [EA_AN_IND] = 4,  [EA_AN_DISP] = 8,  [EA_AN_INDEX] = 12, [EA_ABS_W] = 8,
+                                                     [EA_ABS_L] = 12,  [EA_PC_DISP] = 8,  [EA_PC_INDEX] = 12 };
+static const uint8_t pea_cycles [EA_INVALID + 1] = { [EA_AN_IND] = 12, [EA_AN_DISP] = 16, [EA_AN_INDEX] = 20, [EA_ABS_W] = 16,
+                                                     [EA_ABS_L] = 20,  [EA_PC_DISP] = 16, [EA_PC_INDEX] = 20 };
+
+/* Clock cycles for movem, not including the time per register */
+static const uint8_t movem_read_cycles [EA_INVALID + 1] =  { [EA_AN_IND] = 12, [EA_AN_POST] = 12, [EA_AN_DISP] = 16, [EA_AN_INDEX] = 18,
+                                                             [EA_ABS_W] = 16,  [EA_ABS_L] = 20,   [EA_PC_DISP] = 16, [EA_PC_INDEX] = 18 };
+static const uint8_t movem_write_cycles [EA_INVALID + 1] = { [EA_AN_IND] = 8,  [EA_AN_PRE] = 8,   [EA_AN_DISP] = 12, [EA_AN_INDEX] = 14,
+                                                             [EA_ABS_W] = 12,  [EA_ABS_L] = 16 };
+
+
+/*
+ * Populate the handler names.
+ */
+static void m68k_init_instructions (void)
+{
+    /* TODO: Consider something that reads closer to the datasheet.
+     *       Eg, add_instruction ("0001 xxx 000 011 xxx", m68k_1018_move_b_dn_anp); */
+
+    /* Bit Instructions */
+    for (uint16_t data_reg = 0; data_reg < 8; data_reg++)
+    {
+        for (uint16_t bit_reg = 0; bit_reg < 8; bit_reg++)
+        {
+            m68k_instruction [0x0100 | (bit_reg << 9) | data_reg] = "m68k_0100_btst_l_dn_dn";
+            m68k_instruction [0x0110 | (bit_reg << 9) | data_reg] = "m68k_0110_btst_b_an_dn";
+            m68k_instruction [0x0118 | (bit_reg << 9) | data_reg] = "m68k_0118_btst_b_anp_dn";
+            m68k_instruction [0x0120 | (bit_reg << 9) | data_reg] = "m68k_0120_btst_b_pan_dn";
+            m68k_instruction [0x0128 | (bit_reg << 9) | data_reg] = "m68k_0128_btst_b_dan_dn";
+            m68k_instruction [0x0130 | (bit_reg << 9) | data_reg] = "m68k_0130_btst_b_danxi_dn";
+            m68k_instruction [0x0140 | (bit_reg << 9) | data_reg] = "m68k_0140_bchg_l_dn_dn";
+            m68k_instruction [0x0150 | (bit_reg << 9) | data_reg] = "m68k_0150_bchg_b_an_dn";
+            m68k_instruction [0x0158 | (bit_reg << 9) | data_reg] = "m68k_0158_bchg_b_anp_dn";
+            m68k_instruction [0x0160 | (bit_reg << 9) | data_reg] = "m68k_0160_bchg_b_pan_dn";
+            m68k_instruction [0x0168 | (bit_reg << 9) | data_reg] = "m68k_0168_bchg_b_dan_dn";
+            m68k_instruction [0x0170 | (bit_reg << 9) | data_reg] = "m68k_0170_bchg_b_danxi_dn";
+            m68k_instruction [0x0180 | (bit_reg << 9) | data_reg] = "m68k_0180_bclr_l_dn_dn";
+            m68k_instruction [0x0190 | (bit_reg << 9) | data_reg] = "m68k_0190_bclr_b_an_dn";
+            m68k_instruction [0x0198 | (bit_reg << 9) | data_reg] = "m68k_0198_bclr_b_anp_dn";
+            m68k_instruction [0x01a0 | (bit_reg << 9) | data_reg] = "m68k_01a0_bclr_b_pan_dn";
+            m68k_instruction [0x01a8 | (bit_reg << 9) | data_reg] = "m68k_01a8_bclr_b_dan_dn";
+            m68k_instruction [0x01b0 | (bit_reg << 9) | data_reg] = "m68k_01b0_bclr_b_danxi_dn";
+            m68k_instruction [0x01c0 | (bit_reg << 9) | data_reg] = "m68k_01c0_bset_l_dn_dn";
+            m68k_instruction [0x01d0 | (bit_reg << 9) | data_reg] = "m68k_01d0_bset_b_an_dn";
+            m68k_instruction [0x01d8 | (bit_reg << 9) | data_reg] = "m68k_01d8_bset_b_anp_dn";
+            m68k_instruction [0x01e0 | (bit_reg << 9) | data_reg] = "m68k_01e0_bset_b_pan_dn";
+            m68k_instruction [0x01e8 | (bit_reg << 9) | data_reg] = "m68k_01e8_bset_b_dan_dn";
+            m68k_instruction [0x01f0 | (bit_reg << 9) | data_reg] = "m68k_01f0_bset_b_danxi_dn";
+        }
+        m68k_instruction [0x0138 | (data_reg << 9)] = "m68k_0138_btst_b_aw_dn";
+        m68k_instruction [0x0139 | (data_reg << 9)] = "m68k_0139_btst_b_al_dn";
+        m68k_instruction [0x013a | (data_reg << 9)] = "m68k_013a_btst_b_dpc_dn";
+        m68k_instruction [0x013b | (data_reg << 9)] = "m68k_013b_btst_b_dpcxi_dn";
+        m68k_instruction [0x013c | (data_reg << 9)] = "m68k_013c_btst_b_imm_dn";
+        m68k_instruction [0x0178 | (data_reg << 9)] = "m68k_0178_bchg_b_aw_dn";
+        m68k_instruction [0x0179 | (data_reg << 9)] = "m68k_0179_bchg_b_al_dn";
+        m68k_instruction [0x01b8 | (data_reg << 9)] = "m68k_01b8_bclr_b_aw_dn"; /* actually the bit-register. */
+        m68k_instruction [0x01b9 | (data_reg << 9)] = "m68k_01b9_bclr_b_al_dn"; /* actually the bit-register. */
+        m68k_instruction [0x01f8 | (data_reg << 9)] = "m68k_01f8_bset_b_aw_dn"; /* actually the bit-register. */
+        m68k_instruction [0x01f9 | (data_reg << 9)] = "m68k_01f9_bset_b_al_dn"; /* actually the bit-register. */
+        m68k_instruction [0x0800 | data_reg] = "m68k_0800_btst_l_dn_imm";
+        m68k_instruction [0x0810 | data_reg] = "m68k_0810_btst_b_an_imm";
+        m68k_instruction [0x0818 | data_reg] = "m68k_0818_btst_b_anp_imm";
+        m68k_instruction [0x0820 | data_reg] = "m68k_0820_btst_b_pan_imm";
+        m68k_instruction [0x0828 | data_reg] = "m68k_0828_btst_b_dan_imm";
+        m68k_instruction [0x0830 | data_reg] = "m68k_0830_btst_b_danxi_imm";
+        m68k_instruction [0x0840 | data_reg] = "m68k_0840_bchg_l_dn_imm";
+        m68k_instruction [0x0850 | data_reg] = "m68k_0850_bchg_b_an_imm";
+        m68k_instruction [0x0858 | data_reg] = "m68k_0858_bchg_b_anp_imm";
+        m68k_instruction [0x0860 | data_reg] = "m68k_0860_bchg_b_pan_imm";
+        m68k_instruction [0x0868 | data_reg] = "m68k_0868_bchg_b_dan_imm";
+        m68k_instruction [0x0870 | data_reg] = "m68k_0870_bchg_b_danxi_imm";
+        m68k_instruction [0x0880 | data_reg] = "m68k_0880_bclr_l_dn_imm";
+        m68k_instruction [0x0890 | data_reg] = "m68k_0890_bclr_b_an_imm";
+        m68k_instruction [0x0898 | data_reg] = "m68k_0898_bclr_b_anp_imm";
+        m68k_instruction [0x08a0 | data_reg] = "m68k_08a0_bclr_b_pan_imm";
+        m68k_instruction [0x08a8 | data_reg] = "m68k_08a8_bclr_b_dan_imm";
+        m68k_instruction [0x08b0 | data_reg] = "m68k_08b0_bclr_b_danxi_imm";
+        m68k_instruction [0x08c0 | data_reg] = "m68k_08c0_bset_l_dn_imm";
+        m68k_instruction [0x08d0 | data_reg] = "m68k_08d0_bset_b_an_imm";
+        m68k_instruction [0x08d8 | data_reg] = "m68k_08d8_bset_b_anp_imm";
+        m68k_instruction [0x08e0 | data_reg] = "m68k_08e0_bset_b_pan_imm";
+        m68k_instruction [0x08e8 | data_reg] = "m68k_08e8_bset_b_dan_imm";
+        m68k_instruction [0x08f0 | data_reg] = "m68k_08f0_bset_b_danxi_imm";
+    }
+    m68k_instruction [0x0838] = "m68k_0838_btst_b_aw_imm";
+    m68k_instruction [0x0839] = "m68k_0839_btst_b_al_imm";
+    m68k_instruction [0x083a] = "m68k_083a_btst_b_dpc_imm";
+    m68k_instruction [0x083b] = "m68k_083b_btst_b_dpcxi_imm";
+    m68k_instruction [0x0878] = "m68k_0878_bchg_b_aw_imm";
+    m68k_instruction [0x0879] = "m68k_0879_bchg_b_al_imm";
+    m68k_instruction [0x08b8] = "m68k_08b8_bclr_b_aw_imm";
+    m68k_instruction [0x08b9] = "m68k_08b9_bclr_b_al_imm";
+    m68k_instruction [0x08f8] = "m68k_08f8_bset_b_aw_imm";
+    m68k_instruction [0x08f9] = "m68k_08f9_bset_b_al_imm";
+
+    /* movep */
+    for (uint16_t data_reg = 0; data_reg < 8; data_reg++)
+    {
+        for (uint16_t address_reg = 0; address_reg < 8; address_reg++)
+        {
+            m68k_instruction [0x0108 | (data_reg << 9) | address_reg ] = "m68k_0108_movep_w_dn_dan";
+            m68k_instruction [0x0148 | (data_reg << 9) | address_reg ] = "m68k_0148_movep_l_dn_dan";
+            m68k_instruction [0x0188 | (data_reg << 9) | address_reg ] = "m68k_0188_movep_w_dan_dn";
+            m68k_instruction [0x01c8 | (data_reg << 9) | address_reg ] = "m68k_01c8_movep_l_dan_dn";
+        }
+    }
+
+    /* immediate */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x0000 | reg] = "m68k_0000_ori_b_dn";
+        m68k_instruction [0x0010 | reg] = "m68k_0010_ori_b_an";
+        m68k_instruction [0x0018 | reg] = "m68k_0018_ori_b_anp";
+        m68k_instruction [0x0020 | reg] = "m68k_0020_ori_b_pan";
+        m68k_instruction [0x0028 | reg] = "m68k_0028_ori_b_dan";
+        m68k_instruction [0x0030 | reg] = "m68k_0030_ori_b_danxi";
+        m68k_instruction [0x0040 | reg] = "m68k_0040_ori_w_dn";
+        m68k_instruction [0x0050 | reg] = "m68k_0050_ori_w_an";
+        m68k_instruction [0x0058 | reg] = "m68k_0058_ori_w_anp";
+        m68k_instruction [0x0060 | reg] = "m68k_0060_ori_w_pan";
+        m68k_instruction [0x0068 | reg] = "m68k_0068_ori_w_dan";
+        m68k_instruction [0x0070 | reg] = "m68k_0070_ori_w_danxi";
+        m68k_instruction [0x0080 | reg] = "m68k_0080_ori_l_dn";
+        m68k_instruction [0x0090 | reg] = "m68k_0090_ori_l_an";
+        m68k_instruction [0x0098 | reg] = "m68k_0098_ori_l_anp";
+        m68k_instruction [0x00a0 | reg] = "m68k_00a0_ori_l_pan";
+        m68k_instruction [0x00a8 | reg] = "m68k_00a8_ori_l_dan";
+        m68k_instruction [0x00b0 | reg] = "m68k_00b0_ori_l_danxi";
+        m68k_instruction [0x0200 | reg] = "m68k_0200_andi_b_dn";
+        m68k_instruction [0x0210 | reg] = "m68k_0210_andi_b_an";
+        m68k_instruction [0x0218 | reg] = "m68k_0218_andi_b_anp";
+        m68k_instruction [0x0220 | reg] = "m68k_0220_andi_b_pan";
+        m68k_instruction [0x0228 | reg] = "m68k_0228_andi_b_dan";
+        m68k_instruction [0x0230 | reg] = "m68k_0230_andi_b_danxi";
+        m68k_instruction [0x0240 | reg] = "m68k_0240_andi_w_dn";
+        m68k_instruction [0x0250 | reg] = "m68k_0250_andi_w_an";
+        m68k_instruction [0x0258 | reg] = "m68k_0258_andi_w_anp";
+        m68k_instruction [0x0260 | reg] = "m68k_0260_andi_w_pan";
+        m68k_instruction [0x0268 | reg] = "m68k_0268_andi_w_dan";
+        m68k_instruction [0x0270 | reg] = "m68k_0270_andi_w_danxi";
+        m68k_instruction [0x0280 | reg] = "m68k_0280_andi_l_dn";
+        m68k_instruction [0x0290 | reg] = "m68k_0290_andi_l_an";
+        m68k_instruction [0x0298 | reg] = "m68k_0298_andi_l_anp";
+        m68k_instruction [0x02a0 | reg] = "m68k_02a0_andi_l_pan";
+        m68k_instruction [0x02a8 | reg] = "m68k_02a8_andi_l_dan";
+        m68k_instruction [0x02b0 | reg] = "m68k_02b0_andi_l_danxi";
+        m68k_instruction [0x0400 | reg] = "m68k_0400_subi_b_dn";
+        m68k_instruction [0x0410 | reg] = "m68k_0410_subi_b_an";
+        m68k_instruction [0x0418 | reg] = "m68k_0418_subi_b_anp";
+        m68k_instruction [0x0420 | reg] = "m68k_0420_subi_b_pan";
+        m68k_instruction [0x0428 | reg] = "m68k_0428_subi_b_dan";
+        m68k_instruction [0x0430 | reg] = "m68k_0430_subi_b_danxi";
+        m68k_instruction [0x0440 | reg] = "m68k_0440_subi_w_dn";
+        m68k_instruction [0x0450 | reg] = "m68k_0450_subi_w_an";
+        m68k_instruction [0x0458 | reg] = "m68k_0458_subi_w_anp";
+        m68k_instruction [0x0460 | reg] = "m68k_0460_subi_w_pan";
+        m68k_instruction [0x0468 | reg] = "m68k_0468_subi_w_dan";
+        m68k_instruction [0x0470 | reg] = "m68k_0470_subi_w_danxi";
+        m68k_instruction [0x0480 | reg] = "m68k_0480_subi_l_dn";
+        m68k_instruction [0x0490 | reg] = "m68k_0490_subi_l_an";
+        m68k_instruction [0x0498 | reg] = "m68k_0498_subi_l_anp";
+        m68k_instruction [0x04a0 | reg] = "m68k_04a0_subi_l_pan";
+        m68k_instruction [0x04a8 | reg] = "m68k_04a8_subi_l_dan";
+        m68k_instruction [0x04b0 | reg] = "m68k_04b0_subi_l_danxi";
+        m68k_instruction [0x0600 | reg] = "m68k_0600_addi_b_dn";
+        m68k_instruction [0x0610 | reg] = "m68k_0610_addi_b_an";
+        m68k_instruction [0x0618 | reg] = "m68k_0618_addi_b_anp";
+        m68k_instruction [0x0620 | reg] = "m68k_0620_addi_b_pan";
+        m68k_instruction [0x0628 | reg] = "m68k_0628_addi_b_dan";
+        m68k_instruction [0x0630 | reg] = "m68k_0630_addi_b_danxi";
+        m68k_instruction [0x0640 | reg] = "m68k_0640_addi_w_dn";
+        m68k_instruction [0x0650 | reg] = "m68k_0650_addi_w_an";
+        m68k_instruction [0x0658 | reg] = "m68k_0658_addi_w_anp";
+        m68k_instruction [0x0660 | reg] = "m68k_0660_addi_w_pan";
+        m68k_instruction [0x0668 | reg] = "m68k_0668_addi_w_dan";
+        m68k_instruction [0x0670 | reg] = "m68k_0670_addi_w_danxi";
+        m68k_instruction [0x0680 | reg] = "m68k_0680_addi_l_dn";
+        m68k_instruction [0x0690 | reg] = "m68k_0690_addi_l_an";
+        m68k_instruction [0x0698 | reg] = "m68k_0698_addi_l_anp";
+        m68k_instruction [0x06a0 | reg] = "m68k_06a0_addi_l_pan";
+        m68k_instruction [0x06a8 | reg] = "m68k_06a8_addi_l_dan";
+        m68k_instruction [0x06b0 | reg] = "m68k_06b0_addi_l_danxi";
+        m68k_instruction [0x0a00 | reg] = "m68k_0a00_eori_b_dn";
+        m68k_instruction [0x0a10 | reg] = "m68k_0a10_eori_b_an";
+        m68k_instruction [0x0a18 | reg] = "m68k_0a18_eori_b_anp";
+        m68k_instruction [0x0a20 | reg] = "m68k_0a20_eori_b_pan";
+        m68k_instruction [0x0a28 | reg] = "m68k_0a28_eori_b_dan";
+        m68k_instruction [0x0a30 | reg] = "m68k_0a30_eori_b_danxi";
+        m68k_instruction [0x0a40 | reg] = "m68k_0a40_eori_w_dn";
+        m68k_instruction [0x0a80 | reg] = "m68k_0a80_eori_l_dn";
+        m68k_instruction [0x0c00 | reg] = "m68k_0c00_cmpi_b_dn";
+        m68k_instruction [0x0c10 | reg] = "m68k_0c10_cmpi_b_an";
+        m68k_instruction [0x0c18 | reg] = "m68k_0c18_cmpi_b_anp";
+        m68k_instruction [0x0c20 | reg] = "m68k_0c20_cmpi_b_pan";
+        m68k_instruction [0x0c28 | reg] = "m68k_0c28_cmpi_b_dan";
+        m68k_instruction [0x0c30 | reg] = "m68k_0c30_cmpi_b_danxi";
+        m68k_instruction [0x0c40 | reg] = "m68k_0c40_cmpi_w_dn";
+        m68k_instruction [0x0c50 | reg] = "m68k_0c50_cmpi_w_an";
+        m68k_instruction [0x0c58 | reg] = "m68k_0c58_cmpi_w_anp";
+        m68k_instruction [0x0c60 | reg] = "m68k_0c60_cmpi_w_pan";
+        m68k_instruction [0x0c68 | reg] = "m68k_0c68_cmpi_w_dan";
+        m68k_instruction [0x0c70 | reg] = "m68k_0c70_cmpi_w_danxi";
+        m68k_instruction [0x0c80 | reg] = "m68k_0c80_cmpi_l_dn";
+        m68k_instruction [0x0c90 | reg] = "m68k_0c90_cmpi_l_an";
+        m68k_instruction [0x0c98 | reg] = "m68k_0c98_cmpi_l_anp";
+        m68k_instruction [0x0ca0 | reg] = "m68k_0ca0_cmpi_l_pan";
+        m68k_instruction [0x0ca8 | reg] = "m68k_0ca8_cmpi_l_dan";
+        m68k_instruction [0x0cb0 | reg] = "m68k_0cb0_cmpi_l_danxi";
+    }
+    m68k_instruction [0x0038] = "m68k_0038_ori_b_aw";
+    m68k_instruction [0x0039] = "m68k_0039_ori_b_al";
+    m68k_instruction [0x003c] = "m68k_003c_ori_b_ccr";
+    m68k_instruction [0x0078] = "m68k_0078_ori_w_aw";
+    m68k_instruction [0x0079] = "m68k_0079_ori_w_al";
+    m68k_instruction [0x007c] = "m68k_007c_ori_w_sr";
+    m68k_instruction [0x00b8] = "m68k_00b8_ori_l_aw";
+    m68k_instruction [0x00b9] = "m68k_00b9_ori_l_al";
+    m68k_instruction [0x0238] = "m68k_0238_andi_b_aw";
+    m68k_instruction [0x0239] = "m68k_0239_andi_b_al";
+    m68k_instruction [0x023c] = "m68k_023c_andi_b_ccr";
+    m68k_instruction [0x0278] = "m68k_0278_andi_w_aw";
+    m68k_instruction [0x0279] = "m68k_0279_andi_w_al";
+    m68k_instruction [0x027c] = "m68k_027c_andi_w_sr";
+    m68k_instruction [0x02b8] = "m68k_02b8_andi_l_aw";
+    m68k_instruction [0x02b9] = "m68k_02b9_andi_l_al";
+    m68k_instruction [0x0438] = "m68k_0438_subi_b_aw";
+    m68k_instruction [0x0439] = "m68k_0439_subi_b_al";
+    m68k_instruction [0x0478] = "m68k_0478_subi_w_aw";
+    m68k_instruction [0x0479] = "m68k_0479_subi_w_al";
+    m68k_instruction [0x04b8] = "m68k_04b8_subi_l_aw";
+    m68k_instruction [0x04b9] = "m68k_04b9_subi_l_al";
+    m68k_instruction [0x0638] = "m68k_0638_addi_b_aw";
+    m68k_instruction [0x0639] = "m68k_0639_addi_b_al";
+    m68k_instruction [0x0678] = "m68k_0678_addi_w_aw";
+    m68k_instruction [0x0679] = "m68k_0679_addi_w_al";
+    m68k_instruction [0x06b8] = "m68k_06b8_addi_l_aw";
+    m68k_instruction [0x06b9] = "m68k_06b9_addi_l_al";
+    m68k_instruction [0x0a38] = "m68k_0a38_eori_b_aw";
+    m68k_instruction [0x0a39] = "m68k_0a39_eori_b_al";
+    m68k_instruction [0x0a3c] = "m68k_0a3c_eori_b_ccr";
+    m68k_instruction [0x0a7c] = "m68k_0a7c_eori_w_sr";
+    m68k_instruction [0x0c38] = "m68k_0c38_cmpi_b_aw";
+    m68k_instruction [0x0c39] = "m68k_0c39_cmpi_b_al";
+    m68k_instruction [0x0c78] = "m68k_0c78_cmpi_w_aw";
+    m68k_instruction [0x0c79] = "m68k_0c79_cmpi_w_al";
+    m68k_instruction [0x0cb8] = "m68k_0cb8_cmpi_l_aw";
+    m68k_instruction [0x0cb9] = "m68k_0cb9_cmpi_l_al";
+
+    /* move */
+    for (uint16_t reg_a = 0; reg_a < 8; reg_a++)
+    {
+        for (uint16_t reg_b = 0; reg_b < 8; reg_b++)
+        {
+            m68k_instruction [0x1000 | (reg_a << 9) | reg_b] = "m68k_1000_move_b_dn_dn";
+            m68k_instruction [0x1010 | (reg_a << 9) | reg_b] = "m68k_1010_move_b_dn_an";
+            m68k_instruction [0x1018 | (reg_a << 9) | reg_b] = "m68k_1018_move_b_dn_anp";
+            m68k_instruction [0x1020 | (reg_a << 9) | reg_b] = "m68k_1020_move_b_dn_pan";
+            m68k_instruction [0x1028 | (reg_a << 9) | reg_b] = "m68k_1028_move_b_dn_dan";
+            m68k_instruction [0x1030 | (reg_a << 9) | reg_b] = "m68k_1030_move_b_dn_danxi";
+            m68k_instruction [0x1080 | (reg_a << 9) | reg_b] = "m68k_1080_move_b_an_dn";
+            m68k_instruction [0x1090 | (reg_a << 9) | reg_b] = "m68k_1090_move_b_an_an";
+            m68k_instruction [0x1098 | (reg_a << 9) | reg_b] = "m68k_1098_move_b_an_anp";
+            m68k_instruction [0x10a0 | (reg_a << 9) | reg_b] = "m68k_10a0_move_b_an_pan";
+            m68k_instruction [0x10a8 | (reg_a << 9) | reg_b] = "m68k_10a8_move_b_an_dan";
+            m68k_instruction [0x10b0 | (reg_a << 9) | reg_b] = "m68k_10b0_move_b_an_danxi";
+            m68k_instruction [0x10c0 | (reg_a << 9) | reg_b] = "m68k_10c0_move_b_anp_dn";
+            m68k_instruction [0x10d0 | (reg_a << 9) | reg_b] = "m68k_10d0_move_b_anp_an";
+            m68k_instruction [0x10d8 | (reg_a << 9) | reg_b] = "m68k_10d8_move_b_anp_anp";
+            m68k_instruction [0x10e0 | (reg_a << 9) | reg_b] = "m68k_10e0_move_b_anp_pan";
+            m68k_instruction [0x10e8 | (reg_a << 9) | reg_b] = "m68k_10e8_move_b_anp_dan";
+            m68k_instruction [0x10f0 | (reg_a << 9) | reg_b] = "m68k_10f0_move_b_anp_danxi";
+            m68k_instruction [0x1100 | (reg_a << 9) | reg_b] = "m68k_1100_move_b_pan_dn";
+            m68k_instruction [0x1110 | (reg_a << 9) | reg_b] = "m68k_1110_move_b_pan_an";
+            m68k_instruction [0x1118 | (reg_a << 9) | reg_b] = "m68k_1118_move_b_pan_anp";
+            m68k_instruction [0x1120 | (reg_a << 9) | reg_b] = "m68k_1120_move_b_pan_pan";
+            m68k_instruction [0x1128 | (reg_a << 9) | reg_b] = "m68k_1128_move_b_pan_dan";
+            m68k_instruction [0x1130 | (reg_a << 9) | reg_b] = "m68k_1130_move_b_pan_danxi";
+            m68k_instruction [0x1140 | (reg_a << 9) | reg_b] = "m68k_1140_move_b_dan_dn";
+            m68k_instruction [0x1150 | (reg_a << 9) | reg_b] = "m68k_1150_move_b_dan_an";
+            m68k_instruction [0x1158 | (reg_a << 9) | reg_b] = "m68k_1158_move_b_dan_anp";
+            m68k_instruction [0x1160 | (reg_a << 9) | reg_b] = "m68k_1160_move_b_dan_pan";
+            m68k_instruction [0x1168 | (reg_a << 9) | reg_b] = "m68k_1168_move_b_dan_dan";
+            m68k_instruction [0x1170 | (reg_a << 9) | reg_b] = "m68k_1170_move_b_dan_danxi";
+            m68k_instruction [0x1180 | (reg_a << 9) | reg_b] = "m68k_1180_move_b_danxi_dn";
+            m68k_instruction [0x1190 | (reg_a << 9) | reg_b] = "m68k_1190_move_b_danxi_an";
+            m68k_instruction [0x1198 | (reg_a << 9) | reg_b] = "m68k_1198_move_b_danxi_anp";
+            m68k_instruction [0x11a0 | (reg_a << 9) | reg_b] = "m68k_11a0_move_b_danxi_pan";
+            m68k_instruction [0x11a8 | (reg_a << 9) | reg_b] = "m68k_11a8_move_b_danxi_dan";
+            m68k_instruction [0x11b0 | (reg_a << 9) | reg_b] = "m68k_11b0_move_b_danxi_danxi";
+            m68k_instruction [0x2000 | (reg_a << 9) | reg_b] = "m68k_2000_move_l_dn_dn";
+            m68k_instruction [0x2008 | (reg_a << 9) | reg_b] = "m68k_2008_move_l_dn_an";
+            m68k_instruction [0x2010 | (reg_a << 9) | reg_b] = "m68k_2010_move_l_dn_an";
+            m68k_instruction [0x2018 | (reg_a << 9) | reg_b] = "m68k_2018_move_l_dn_anp";
+            m68k_instruction [0x2020 | (reg_a << 9) | reg_b] = "m68k_2020_move_l_dn_pan";
+            m68k_instruction [0x2028 | (reg_a << 9) | reg_b] = "m68k_2028_move_l_dn_dan";
+            m68k_instruction [0x2030 | (reg_a << 9) | reg_b] = "m68k_2030_move_l_dn_danxi";
+            m68k_instruction [0x2040 | (reg_a << 9) | reg_b] = "m68k_2040_movea_l_an_dn";
+            m68k_instruction [0x2048 | (reg_a << 9) | reg_b] = "m68k_2048_movea_l_an_an";
+            m68k_instruction [0x2050 | (reg_a << 9) | reg_b] = "m68k_2050_movea_l_an_an";
+            m68k_instruction [0x2058 | (reg_a << 9) | reg_b] = "m68k_2058_movea_l_an_anp";
+            m68k_instruction [0x2060 | (reg_a << 9) | reg_b] = "m68k_2060_movea_l_an_pan";
+            m68k_instruction [0x2068 | (reg_a << 9) | reg_b] = "m68k_2068_movea_l_an_dan";
+            m68k_instruction [0x2070 | (reg_a << 9) | reg_b] = "m68k_2070_movea_l_an_danxi";
+            m68k_instruction [0x2080 | (reg_a << 9) | reg_b] = "m68k_2080_move_l_an_dn";
+            m68k_instruction [0x2088 | (reg_a << 9) | reg_b] = "m68k_2088_move_l_an_an";
+            m68k_instruction [0x2090 | (reg_a << 9) | reg_b] = "m68k_2090_move_l_an_an";
+            m68k_instruction [0x2098 | (reg_a << 9) | reg_b] = "m68k_2098_move_l_an_anp";
+            m68k_instruction [0x20a0 | (reg_a << 9) | reg_b] = "m68k_20a0_move_l_an_pan";
+            m68k_instruction [0x20a8 | (reg_a << 9) | reg_b] = "m68k_20a8_move_l_an_dan";
+            m68k_instruction [0x20b0 | (reg_a << 9) | reg_b] = "m68k_20b0_move_l_an_danxi";
+            m68k_instruction [0x20c0 | (reg_a << 9) | reg_b] = "m68k_20c0_move_l_anp_dn";
+            m68k_instruction [0x20c8 | (reg_a << 9) | reg_b] = "m68k_20c8_move_l_anp_an";
+            m68k_instruction [0x20d0 | (reg_a << 9) | reg_b] = "m68k_20d0_move_l_anp_an";
+            m68k_instruction [0x20d8 | (reg_a << 9) | reg_b] = "m68k_20d8_move_l_anp_anp";
+            m68k_instruction [0x20e0 | (reg_a << 9) | reg_b] = "m68k_20e0_move_l_anp_pan";
+            m68k_instruction [0x20e8 | (reg_a << 9) | reg_b] = "m68k_20e8_move_l_anp_dan";
+            m68k_instruction [0x20f0 | (reg_a << 9) | reg_b] = "m68k_20f0_move_l_anp_danxi";
+            m68k_instruction [0x2100 | (reg_a << 9) | reg_b] = "m68k_2100_move_l_pan_dn";
+            m68k_instruction [0x2108 | (reg_a << 9) | reg_b] = "m68k_2108_move_l_pan_an";
+            m68k_instruction [0x2110 | (reg_a << 9) | reg_b] = "m68k_2110_move_l_pan_an";
+            m68k_instruction [0x2118 | (reg_a << 9) | reg_b] = "m68k_2118_move_l_pan_anp";
+            m68k_instruction [0x2120 | (reg_a << 9) | reg_b] = "m68k_2120_move_l_pan_pan";
+            m68k_instruction [0x2128 | (reg_a << 9) | reg_b] = "m68k_2128_move_l_pan_dan";
+            m68k_instruction [0x2130 | (reg_a << 9) | reg_b] = "m68k_2130_move_l_pan_danxi";
+            m68k_instruction [0x2140 | (reg_a << 9) | reg_b] = "m68k_2140_move_l_dan_dn";
+            m68k_instruction [0x2148 | (reg_a << 9) | reg_b] = "m68k_2148_move_l_dan_an";
+            m68k_instruction [0x2150 | (reg_a << 9) | reg_b] = "m68k_2150_move_l_dan_an";
+            m68k_instruction [0x2158 | (reg_a << 9) | reg_b] = "m68k_2158_move_l_dan_anp";
+            m68k_instruction [0x2160 | (reg_a << 9) | reg_b] = "m68k_2160_move_l_dan_pan";
+            m68k_instruction [0x2168 | (reg_a << 9) | reg_b] = "m68k_2168_move_l_dan_dan";
+            m68k_instruction [0x2170 | (reg_a << 9) | reg_b] = "m68k_2170_move_l_dan_danxi";
+            m68k_instruction [0x2180 | (reg_a << 9) | reg_b] = "m68k_2180_move_l_danxi_dn";
+            m68k_instruction [0x2188 | (reg_a << 9) | reg_b] = "m68k_2188_move_l_danxi_an";
+            m68k_instruction [0x2190 | (reg_a << 9) | reg_b] = "m68k_2190_move_l_danxi_an";
+            m68k_instruction [0x2198 | (reg_a << 9) | reg_b] = "m68k_2198_move_l_danxi_anp";
+            m68k_instruction [0x21a0 | (reg_a << 9) | reg_b] = "m68k_21a0_move_l_danxi_pan";
+            m68k_instruction [0x21a8 | (reg_a << 9) | reg_b] = "m68k_21a8_move_l_danxi_dan";
+            m68k_instruction [0x21b0 | (reg_a << 9) | reg_b] = "m68k_21b0_move_l_danxi_danxi";
+            m68k_instruction [0x3000 | (reg_a << 9) | reg_b] = "m68k_3000_move_w_dn_dn";
+            m68k_instruction [0x3008 | (reg_a << 9) | reg_b] = "m68k_3008_move_w_dn_an";
+            m68k_instruction [0x3010 | (reg_a << 9) | reg_b] = "m68k_3010_move_w_dn_an";
+            m68k_instruction [0x3018 | (reg_a << 9) | reg_b] = "m68k_3018_move_w_dn_anp";
+            m68k_instruction [0x3020 | (reg_a << 9) | reg_b] = "m68k_3020_move_w_dn_pan";
+            m68k_instruction [0x3028 | (reg_a << 9) | reg_b] = "m68k_3028_move_w_dn_dan";
+            m68k_instruction [0x3030 | (reg_a << 9) | reg_b] = "m68k_3030_move_w_dn_danxi";
+            m68k_instruction [0x3040 | (reg_a << 9) | reg_b] = "m68k_3040_movea_w_an_dn";
+            m68k_instruction [0x3048 | (reg_a << 9) | reg_b] = "m68k_3048_movea_w_an_an";
+            m68k_instruction [0x3050 | (reg_a << 9) | reg_b] = "m68k_3050_movea_w_an_an";
+            m68k_instruction [0x3058 | (reg_a << 9) | reg_b] = "m68k_3058_movea_w_an_anp";
+            m68k_instruction [0x3060 | (reg_a << 9) | reg_b] = "m68k_3060_movea_w_an_pan";
+            m68k_instruction [0x3068 | (reg_a << 9) | reg_b] = "m68k_3068_movea_w_an_dan";
+            m68k_instruction [0x3070 | (reg_a << 9) | reg_b] = "m68k_3070_movea_w_an_danxi";
+            m68k_instruction [0x3080 | (reg_a << 9) | reg_b] = "m68k_3080_move_w_an_dn";
+            m68k_instruction [0x3088 | (reg_a << 9) | reg_b] = "m68k_3088_move_w_an_an";
+            m68k_instruction [0x3090 | (reg_a << 9) | reg_b] = "m68k_3090_move_w_an_an";
+            m68k_instruction [0x3098 | (reg_a << 9) | reg_b] = "m68k_3098_move_w_an_anp";
+            m68k_instruction [0x30a0 | (reg_a << 9) | reg_b] = "m68k_30a0_move_w_an_pan";
+            m68k_instruction [0x30a8 | (reg_a << 9) | reg_b] = "m68k_30a8_move_w_an_dan";
+            m68k_instruction [0x30b0 | (reg_a << 9) | reg_b] = "m68k_30b0_move_w_an_danxi";
+            m68k_instruction [0x30c0 | (reg_a << 9) | reg_b] = "m68k_30c0_move_w_anp_dn";
+            m68k_instruction [0x30c8 | (reg_a << 9) | reg_b] = "m68k_30c8_move_w_anp_an";
+            m68k_instruction [0x30d0 | (reg_a << 9) | reg_b] = "m68k_30d0_move_w_anp_an";
+            m68k_instruction [0x30d8 | (reg_a << 9) | reg_b] = "m68k_30d8_move_w_anp_anp";
+            m68k_instruction [0x30e0 | (reg_a << 9) | reg_b] = "m68k_30e0_move_w_anp_pan";
+            m68k_instruction [0x30e8 | (reg_a << 9) | reg_b] = "m68k_30e8_move_w_anp_dan";
+            m68k_instruction [0x30f0 | (reg_a << 9) | reg_b] = "m68k_30f0_move_w_anp_danxi";
+            m68k_instruction [0x3100 | (reg_a << 9) | reg_b] = "m68k_3100_move_w_pan_dn";
+            m68k_instruction [0x3108 | (reg_a << 9) | reg_b] = "m68k_3108_move_w_pan_an";
+            m68k_instruction [0x3110 | (reg_a << 9) | reg_b] = "m68k_3110_move_w_pan_an";
+            m68k_instruction [0x3118 | (reg_a << 9) | reg_b] = "m68k_3118_move_w_pan_anp";
+            m68k_instruction [0x3120 | (reg_a << 9) | reg_b] = "m68k_3120_move_w_pan_pan";
+            m68k_instruction [0x3128 | (reg_a << 9) | reg_b] = "m68k_3128_move_w_pan_dan";
+            m68k_instruction [0x3130 | (reg_a << 9) | reg_b] = "m68k_3130_move_w_pan_danxi";
+            m68k_instruction [0x3140 | (reg_a << 9) | reg_b] = "m68k_3140_move_w_dan_dn";
+            m68k_instruction [0x3148 | (reg_a << 9) | reg_b] = "m68k_3148_move_w_dan_an";
+            m68k_instruction [0x3150 | (reg_a << 9) | reg_b] = "m68k_3150_move_w_dan_an";
+            m68k_instruction [0x3158 | (reg_a << 9) | reg_b] = "m68k_3158_move_w_dan_anp";
+            m68k_instruction [0x3160 | (reg_a << 9) | reg_b] = "m68k_3160_move_w_dan_pan";
+            m68k_instruction [0x3168 | (reg_a << 9) | reg_b] = "m68k_3168_move_w_dan_dan";
+            m68k_instruction [0x3170 | (reg_a << 9) | reg_b] = "m68k_3170_move_w_dan_danxi";
+            m68k_instruction [0x3180 | (reg_a << 9) | reg_b] = "m68k_3180_move_w_danxi_dn";
+            m68k_instruction [0x3188 | (reg_a << 9) | reg_b] = "m68k_3188_move_w_danxi_an";
+            m68k_instruction [0x3190 | (reg_a << 9) | reg_b] = "m68k_3190_move_w_danxi_an";
+            m68k_instruction [0x3198 | (reg_a << 9) | reg_b] = "m68k_3198_move_w_danxi_anp";
+            m68k_instruction [0x31a0 | (reg_a << 9) | reg_b] = "m68k_31a0_move_w_danxi_pan";
+            m68k_instruction [0x31a8 | (reg_a << 9) | reg_b] = "m68k_31a8_move_w_danxi_dan";
+            m68k_instruction [0x31b0 | (reg_a << 9) | reg_b] = "m68k_31b0_move_w_danxi_danxi";
+        }
+        m68k_instruction [0x1038 | (reg_a << 9)] = "m68k_1038_move_b_dn_aw";
+        m68k_instruction [0x1039 | (reg_a << 9)] = "m68k_1039_move_b_dn_al";
+        m68k_instruction [0x103a | (reg_a << 9)] = "m68k_103a_move_b_dn_dpc";
+        m68k_instruction [0x103b | (reg_a << 9)] = "m68k_103b_move_b_dn_dpcxi";
+        m68k_instruction [0x103c | (reg_a << 9)] = "m68k_103c_move_b_dn_imm";
+        m68k_instruction [0x10b8 | (reg_a << 9)] = "m68k_10b8_move_b_an_aw";
+        m68k_instruction [0x10b9 | (reg_a << 9)] = "m68k_10b9_move_b_an_al";
+        m68k_instruction [0x10ba | (reg_a << 9)] = "m68k_10ba_move_b_an_dpc";
+        m68k_instruction [0x10bb | (reg_a << 9)] = "m68k_10bb_move_b_an_dpcxi";
+        m68k_instruction [0x10bc | (reg_a << 9)] = "m68k_10bc_move_b_an_imm";
+        m68k_instruction [0x10f8 | (reg_a << 9)] = "m68k_10f8_move_b_anp_aw";
+        m68k_instruction [0x10f9 | (reg_a << 9)] = "m68k_10f9_move_b_anp_al";
+        m68k_instruction [0x10fa | (reg_a << 9)] = "m68k_10fa_move_b_anp_dpc";
+        m68k_instruction [0x10fb | (reg_a << 9)] = "m68k_10fb_move_b_anp_dpcxi";
+        m68k_instruction [0x10fc | (reg_a << 9)] = "m68k_10fc_move_b_anp_imm";
+        m68k_instruction [0x1138 | (reg_a << 9)] = "m68k_1138_move_b_pan_aw";
+        m68k_instruction [0x1139 | (reg_a << 9)] = "m68k_1139_move_b_pan_al";
+        m68k_instruction [0x113a | (reg_a << 9)] = "m68k_113a_move_b_pan_dpc";
+        m68k_instruction [0x113b | (reg_a << 9)] = "m68k_113b_move_b_pan_dpcxi";
+        m68k_instruction [0x113c | (reg_a << 9)] = "m68k_113c_move_b_pan_imm";
+        m68k_instruction [0x1178 | (reg_a << 9)] = "m68k_1178_move_b_dan_aw";
+        m68k_instruction [0x1179 | (reg_a << 9)] = "m68k_1179_move_b_dan_al";
+        m68k_instruction [0x117a | (reg_a << 9)] = "m68k_117a_move_b_dan_dpc";
+        m68k_instruction [0x117b | (reg_a << 9)] = "m68k_117b_move_b_dan_dpcxi";
+        m68k_instruction [0x117c | (reg_a << 9)] = "m68k_117c_move_b_dan_imm";
+        m68k_instruction [0x11b8 | (reg_a << 9)] = "m68k_11b8_move_b_danxi_aw";
+        m68k_instruction [0x11b9 | (reg_a << 9)] = "m68k_11b9_move_b_danxi_al";
+        m68k_instruction [0x11ba | (reg_a << 9)] = "m68k_11ba_move_b_danxi_dpc";
+        m68k_instruction [0x11bb | (reg_a << 9)] = "m68k_11bb_move_b_danxi_dpcxi";
+        m68k_instruction [0x11bc | (reg_a << 9)] = "m68k_11bc_move_b_danxi_imm";
+        m68k_instruction [0x11c0 | reg_a       ] = "m68k_11c0_move_b_aw_dn";
+        m68k_instruction [0x11d0 | reg_a       ] = "m68k_11d0_move_b_aw_an";
+        m68k_instruction [0x11d8 | reg_a       ] = "m68k_11d8_move_b_aw_anp";
+        m68k_instruction [0x11e0 | reg_a       ] = "m68k_11e0_move_b_aw_pan";
+        m68k_instruction [0x11e8 | reg_a       ] = "m68k_11e8_move_b_aw_dan";
+        m68k_instruction [0x11f0 | reg_a       ] = "m68k_11f0_move_b_aw_danxi";
+        m68k_instruction [0x13c0 | reg_a       ] = "m68k_13c0_move_b_al_dn";
+        m68k_instruction [0x13d0 | reg_a       ] = "m68k_13d0_move_b_al_an";
+        m68k_instruction [0x13d8 | reg_a       ] = "m68k_13d8_move_b_al_anp";
+        m68k_instruction [0x13e0 | reg_a       ] = "m68k_13e0_move_b_al_pan";
+        m68k_instruction [0x13e8 | reg_a       ] = "m68k_13e8_move_b_al_dan";
+        m68k_instruction [0x13f0 | reg_a       ] = "m68k_13f0_move_b_al_danxi";
+        m68k_instruction [0x2038 | (reg_a << 9)] = "m68k_2038_move_l_dn_aw";
+        m68k_instruction [0x2039 | (reg_a << 9)] = "m68k_2039_move_l_dn_al";
+        m68k_instruction [0x203a | (reg_a << 9)] = "m68k_203a_move_l_dn_dpc";
+        m68k_instruction [0x203b | (reg_a << 9)] = "m68k_203b_move_l_dn_dpcxi";
+        m68k_instruction [0x203c | (reg_a << 9)] = "m68k_203c_move_l_dn_imm";
+        m68k_instruction [0x2078 | (reg_a << 9)] = "m68k_2078_movea_l_an_aw";
+        m68k_instruction [0x2079 | (reg_a << 9)] = "m68k_2079_movea_l_an_al";
+        m68k_instruction [0x207a | (reg_a << 9)] = "m68k_207a_movea_l_an_dpc";
+        m68k_instruction [0x207b | (reg_a << 9)] = "m68k_207b_movea_l_an_dpcxi";
+        m68k_instruction [0x207c | (reg_a << 9)] = "m68k_207c_movea_l_an_imm";
+        m68k_instruction [0x20b8 | (reg_a << 9)] = "m68k_20b8_move_l_an_aw";
+        m68k_instruction [0x20b9 | (reg_a << 9)] = "m68k_20b9_move_l_an_al";
+        m68k_instruction [0x20ba | (reg_a << 9)] = "m68k_20ba_move_l_an_dpc";
+        m68k_instruction [0x20bb | (reg_a << 9)] = "m68k_20bb_move_l_an_dpcxi";
+        m68k_instruction [0x20bc | (reg_a << 9)] = "m68k_20bc_move_l_an_imm";
+        m68k_instruction [0x20f8 | (reg_a << 9)] = "m68k_20f8_move_l_anp_aw";
+        m68k_instruction [0x20f9 | (reg_a << 9)] = "m68k_20f9_move_l_anp_al";
+        m68k_instruction [0x20fa | (reg_a << 9)] = "m68k_20fa_move_l_anp_dpc";
+        m68k_instruction [0x20fb | (reg_a << 9)] = "m68k_20fb_move_l_anp_dpcxi";
+        m68k_instruction [0x20fc | (reg_a << 9)] = "m68k_20fc_move_l_anp_imm";
+        m68k_instruction [0x2138 | (reg_a << 9)] = "m68k_2138_move_l_pan_aw";
+        m68k_instruction [0x2139 | (reg_a << 9)] = "m68k_2139_move_l_pan_al";
+        m68k_instruction [0x213a | (reg_a << 9)] = "m68k_213a_move_l_pan_dpc";
+        m68k_instruction [0x213b | (reg_a << 9)] = "m68k_213b_move_l_pan_dpcxi";
+        m68k_instruction [0x213c | (reg_a << 9)] = "m68k_213c_move_l_pan_imm";
+        m68k_instruction [0x2178 | (reg_a << 9)] = "m68k_2178_move_l_dan_aw";
+        m68k_instruction [0x2179 | (reg_a << 9)] = "m68k_2179_move_l_dan_al";
+        m68k_instruction [0x217a | (reg_a << 9)] = "m68k_217a_move_l_dan_dpc";
+        m68k_instruction [0x217b | (reg_a << 9)] = "m68k_217b_move_l_dan_dpcxi";
+        m68k_instruction [0x217c | (reg_a << 9)] = "m68k_217c_move_l_dan_imm";
+        m68k_instruction [0x21b8 | (reg_a << 9)] = "m68k_21b8_move_l_danxi_aw";
+        m68k_instruction [0x21b9 | (reg_a << 9)] = "m68k_21b9_move_l_danxi_al";
+        m68k_instruction [0x21ba | (reg_a << 9)] = "m68k_21ba_move_l_danxi_dpc";
+        m68k_instruction [0x21bb | (reg_a << 9)] = "m68k_21bb_move_l_danxi_dpcxi";
+        m68k_instruction [0x21bc | (reg_a << 9)] = "m68k_21bc_move_l_danxi_imm";
+        m68k_instruction [0x21c0 | reg_a       ] = "m68k_21c0_move_l_aw_dn";
+        m68k_instruction [0x21c8 | reg_a       ] = "m68k_21c8_move_l_aw_an";
+        m68k_instruction [0x21d0 | reg_a       ] = "m68k_21d0_move_l_aw_an";
+        m68k_instruction [0x21d8 | reg_a       ] = "m68k_21d8_move_l_aw_anp";
+        m68k_instruction [0x21e0 | reg_a       ] = "m68k_21e0_move_l_aw_pan";
+        m68k_instruction [0x21e8 | reg_a       ] = "m68k_21e8_move_l_aw_dan";
+        m68k_instruction [0x21f0 | reg_a       ] = "m68k_21f0_move_l_aw_danxi";
+        m68k_instruction [0x23c0 | reg_a       ] = "m68k_23c0_move_l_al_dn";
+        m68k_instruction [0x23c8 | reg_a       ] = "m68k_23c8_move_l_al_an";
+        m68k_instruction [0x23d0 | reg_a       ] = "m68k_23d0_move_l_al_an";
+        m68k_instruction [0x23d8 | reg_a       ] = "m68k_23d8_move_l_al_anp";
+        m68k_instruction [0x23e0 | reg_a       ] = "m68k_23e0_move_l_al_pan";
+        m68k_instruction [0x23e8 | reg_a       ] = "m68k_23e8_move_l_al_dan";
+        m68k_instruction [0x23f0 | reg_a       ] = "m68k_23f0_move_l_al_danxi";
+        m68k_instruction [0x3038 | (reg_a << 9)] = "m68k_3038_move_w_dn_aw";
+        m68k_instruction [0x3039 | (reg_a << 9)] = "m68k_3039_move_w_dn_al";
+        m68k_instruction [0x303a | (reg_a << 9)] = "m68k_303a_move_w_dn_dpc";
+        m68k_instruction [0x303b | (reg_a << 9)] = "m68k_303b_move_w_dn_dpcxi";
+        m68k_instruction [0x303c | (reg_a << 9)] = "m68k_303c_move_w_dn_imm";
+        m68k_instruction [0x3078 | (reg_a << 9)] = "m68k_3078_movea_w_an_aw";
+        m68k_instruction [0x3079 | (reg_a << 9)] = "m68k_3079_movea_w_an_al";
+        m68k_instruction [0x307a | (reg_a << 9)] = "m68k_307a_movea_w_an_dpc";
+        m68k_instruction [0x307b | (reg_a << 9)] = "m68k_307b_movea_w_an_dpcxi";
+        m68k_instruction [0x307c | (reg_a << 9)] = "m68k_307c_movea_w_an_imm";
+        m68k_instruction [0x30b8 | (reg_a << 9)] = "m68k_30b8_move_w_an_aw";
+        m68k_instruction [0x30b9 | (reg_a << 9)] = "m68k_30b9_move_w_an_al";
+        m68k_instruction [0x30ba | (reg_a << 9)] = "m68k_30ba_move_w_an_dpc";
+        m68k_instruction [0x30bb | (reg_a << 9)] = "m68k_30bb_move_w_an_dpcxi";
+        m68k_instruction [0x30bc | (reg_a << 9)] = "m68k_30bc_move_w_an_imm";
+        m68k_instruction [0x30f8 | (reg_a << 9)] = "m68k_30f8_move_w_anp_aw";
+        m68k_instruction [0x30f9 | (reg_a << 9)] = "m68k_30f9_move_w_anp_al";
+        m68k_instruction [0x30fa | (reg_a << 9)] = "m68k_30fa_move_w_anp_dpc";
+        m68k_instruction [0x30fb | (reg_a << 9)] = "m68k_30fb_move_w_anp_dpcxi";
+        m68k_instruction [0x30fc | (reg_a << 9)] = "m68k_30fc_move_w_anp_imm";
+        m68k_instruction [0x3138 | (reg_a << 9)] = "m68k_3138_move_w_pan_aw";
+        m68k_instruction [0x3139 | (reg_a << 9)] = "m68k_3139_move_w_pan_al";
+        m68k_instruction [0x313a | (reg_a << 9)] = "m68k_313a_move_w_pan_dpc";
+        m68k_instruction [0x313b | (reg_a << 9)] = "m68k_313b_move_w_pan_dpcxi";
+        m68k_instruction [0x313c | (reg_a << 9)] = "m68k_313c_move_w_pan_imm";
+        m68k_instruction [0x3178 | (reg_a << 9)] = "m68k_3178_move_w_dan_aw";
+        m68k_instruction [0x3179 | (reg_a << 9)] = "m68k_3179_move_w_dan_al";
+        m68k_instruction [0x317a | (reg_a << 9)] = "m68k_317a_move_w_dan_dpc";
+        m68k_instruction [0x317b | (reg_a << 9)] = "m68k_317b_move_w_dan_dpcxi";
+        m68k_instruction [0x317c | (reg_a << 9)] = "m68k_317c_move_w_dan_imm";
+        m68k_instruction [0x31b8 | (reg_a << 9)] = "m68k_31b8_move_w_danxi_aw";
+        m68k_instruction [0x31b9 | (reg_a << 9)] = "m68k_31b9_move_w_danxi_al";
+        m68k_instruction [0x31ba | (reg_a << 9)] = "m68k_31ba_move_w_danxi_dpc";
+        m68k_instruction [0x31bb | (reg_a << 9)] = "m68k_31bb_move_w_danxi_dpcxi";
+        m68k_instruction [0x31bc | (reg_a << 9)] = "m68k_31bc_move_w_danxi_imm";
+        m68k_instruction [0x31c0 | reg_a       ] = "m68k_31c0_move_w_aw_dn";
+        m68k_instruction [0x31c8 | reg_a       ] = "m68k_31c8_move_w_aw_an";
+        m68k_instruction [0x31d0 | reg_a       ] = "m68k_31d0_move_w_aw_an";
+        m68k_instruction [0x31d8 | reg_a       ] = "m68k_31d8_move_w_aw_anp";
+        m68k_instruction [0x31e0 | reg_a       ] = "m68k_31e0_move_w_aw_pan";
+        m68k_instruction [0x31e8 | reg_a       ] = "m68k_31e8_move_w_aw_dan";
+        m68k_instruction [0x31f0 | reg_a       ] = "m68k_31f0_move_w_aw_danxi";
+        m68k_instruction [0x33c0 | reg_a       ] = "m68k_33c0_move_w_al_dn";
+        m68k_instruction [0x33c8 | reg_a       ] = "m68k_33c8_move_w_al_an";
+        m68k_instruction [0x33d0 | reg_a       ] = "m68k_33d0_move_w_al_an";
+        m68k_instruction [0x33d8 | reg_a       ] = "m68k_33d8_move_w_al_anp";
+        m68k_instruction [0x33e0 | reg_a       ] = "m68k_33e0_move_w_al_pan";
+        m68k_instruction [0x33e8 | reg_a       ] = "m68k_33e8_move_w_al_dan";
+        m68k_instruction [0x33f0 | reg_a       ] = "m68k_33f0_move_w_al_danxi";
+        m68k_instruction [0x40c0 | reg_a       ] = "m68k_40c0_move_dn_sr";
+        m68k_instruction [0x40d0 | reg_a       ] = "m68k_40d0_move_an_sr";
+        m68k_instruction [0x40d8 | reg_a       ] = "m68k_40d8_move_anp_sr";
+        m68k_instruction [0x40e0 | reg_a       ] = "m68k_40e0_move_pan_sr";
+        m68k_instruction [0x40e8 | reg_a       ] = "m68k_40e8_move_dan_sr";
+        m68k_instruction [0x40f0 | reg_a       ] = "m68k_40f0_move_danxi_sr";
+        m68k_instruction [0x44c0 | reg_a       ] = "m68k_44c0_move_ccr_dn";
+        m68k_instruction [0x44d0 | reg_a       ] = "m68k_44d0_move_ccr_an";
+        m68k_instruction [0x44d8 | reg_a       ] = "m68k_44d8_move_ccr_anp";
+        m68k_instruction [0x44e0 | reg_a       ] = "m68k_44e0_move_ccr_pan";
+        m68k_instruction [0x44e8 | reg_a       ] = "m68k_44e8_move_ccr_dan";
+        m68k_instruction [0x44f0 | reg_a       ] = "m68k_44f0_move_ccr_danxi";
+        m68k_instruction [0x46c0 | reg_a       ] = "m68k_46c0_move_sr_dn";
+        m68k_instruction [0x46d0 | reg_a       ] = "m68k_46d0_move_sr_an";
+        m68k_instruction [0x46d8 | reg_a       ] = "m68k_46d8_move_sr_anp";
+        m68k_instruction [0x46e0 | reg_a       ] = "m68k_46e0_move_sr_pan";
+        m68k_instruction [0x46e8 | reg_a       ] = "m68k_46e8_move_sr_dan";
+        m68k_instruction [0x46f0 | reg_a       ] = "m68k_46f0_move_sr_danxi";
+        m68k_instruction [0x4e60 | reg_a       ] = "m68k_4e60_move_an_usp";
+        m68k_instruction [0x4e68 | reg_a       ] = "m68k_4e68_move_usp_an";
+    }
+    m68k_instruction [0x11f8] = "m68k_11f8_move_b_aw_aw";
+    m68k_instruction [0x11f9] = "m68k_11f9_move_b_aw_al";
+    m68k_instruction [0x11fa] = "m68k_11fa_move_b_aw_dpc";
+    m68k_instruction [0x11fb] = "m68k_11fb_move_b_aw_dpcxi";
+    m68k_instruction [0x11fc] = "m68k_11fc_move_b_aw_imm";
+    m68k_instruction [0x13f8] = "m68k_13f8_move_b_al_aw";
+    m68k_instruction [0x13f9] = "m68k_13f9_move_b_al_al";
+    m68k_instruction [0x13fa] = "m68k_13fa_move_b_al_dpc";
+    m68k_instruction [0x13fb] = "m68k_13fb_move_b_al_dpcxi";
+    m68k_instruction [0x13fc] = "m68k_13fc_move_b_al_imm";
+    m68k_instruction [0x21f8] = "m68k_21f8_move_l_aw_aw";
+    m68k_instruction [0x21f9] = "m68k_21f9_move_l_aw_al";
+    m68k_instruction [0x21fa] = "m68k_21fa_move_l_aw_dpc";
+    m68k_instruction [0x21fb] = "m68k_21fb_move_l_aw_dpcxi";
+    m68k_instruction [0x21fc] = "m68k_21fc_move_l_aw_imm";
+    m68k_instruction [0x23f8] = "m68k_23f8_move_l_al_aw";
+    m68k_instruction [0x23f9] = "m68k_23f9_move_l_al_al";
+    m68k_instruction [0x23fa] = "m68k_23fa_move_l_al_dpc";
+    m68k_instruction [0x23fb] = "m68k_23fb_move_l_al_dpcxi";
+    m68k_instruction [0x23fc] = "m68k_23fc_move_l_al_imm";
+    m68k_instruction [0x31f8] = "m68k_31f8_move_w_aw_aw";
+    m68k_instruction [0x31f9] = "m68k_31f9_move_w_aw_al";
+    m68k_instruction [0x31fa] = "m68k_31fa_move_w_aw_dpc";
+    m68k_instruction [0x31fb] = "m68k_31fb_move_w_aw_dpcxi";
+    m68k_instruction [0x31fc] = "m68k_31fc_move_w_aw_imm";
+    m68k_instruction [0x33f8] = "m68k_33f8_move_w_al_aw";
+    m68k_instruction [0x33f9] = "m68k_33f9_move_w_al_al";
+    m68k_instruction [0x33fa] = "m68k_33fa_move_w_al_dpc";
+    m68k_instruction [0x33fb] = "m68k_33fb_move_w_al_dpcxi";
+    m68k_instruction [0x33fc] = "m68k_33fc_move_w_al_imm";
+    m68k_instruction [0x40f8] = "m68k_40f8_move_aw_sr";
+    m68k_instruction [0x40f9] = "m68k_40f9_move_al_sr";
+    m68k_instruction [0x44f8] = "m68k_44f8_move_ccr_aw";
+    m68k_instruction [0x44f9] = "m68k_44f9_move_ccr_al";
+    m68k_instruction [0x44fa] = "m68k_44fa_move_ccr_dpc";
+    m68k_instruction [0x44fb] = "m68k_44fb_move_ccr_dpcxi";
+    m68k_instruction [0x44fc] = "m68k_44fc_move_ccr_imm";
+    m68k_instruction [0x46f8] = "m68k_46f8_move_sr_aw";
+    m68k_instruction [0x46f9] = "m68k_46f9_move_sr_al";
+    m68k_instruction [0x46fa] = "m68k_46fa_move_sr_dpc";
+    m68k_instruction [0x46fb] = "m68k_46fb_move_sr_dpcxi";
+    m68k_instruction [0x46fc] = "m68k_46fc_move_sr_imm";
+
+    /* not */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x4600 | reg] = "m68k_4600_not_b_dn";
+        m68k_instruction [0x4610 | reg] = "m68k_4610_not_b_an";
+        m68k_instruction [0x4618 | reg] = "m68k_4618_not_b_anp";
+        m68k_instruction [0x4620 | reg] = "m68k_4620_not_b_pan";
+        m68k_instruction [0x4628 | reg] = "m68k_4628_not_b_dan";
+        m68k_instruction [0x4630 | reg] = "m68k_4630_not_b_danxi";
+        m68k_instruction [0x4640 | reg] = "m68k_4640_not_w_dn";
+        m68k_instruction [0x4650 | reg] = "m68k_4650_not_w_an";
+        m68k_instruction [0x4658 | reg] = "m68k_4658_not_w_anp";
+        m68k_instruction [0x4660 | reg] = "m68k_4660_not_w_pan";
+        m68k_instruction [0x4668 | reg] = "m68k_4668_not_w_dan";
+        m68k_instruction [0x4670 | reg] = "m68k_4670_not_w_danxi";
+        m68k_instruction [0x4680 | reg] = "m68k_4680_not_l_dn";
+        m68k_instruction [0x4690 | reg] = "m68k_4690_not_l_an";
+        m68k_instruction [0x4698 | reg] = "m68k_4698_not_l_anp";
+        m68k_instruction [0x46a0 | reg] = "m68k_46a0_not_l_pan";
+        m68k_instruction [0x46a8 | reg] = "m68k_46a8_not_l_dan";
+        m68k_instruction [0x46b0 | reg] = "m68k_46b0_not_l_danxi";
+    }
+    m68k_instruction [0x4638] = "m68k_4638_not_b_aw";
+    m68k_instruction [0x4639] = "m68k_4639_not_b_al";
+    m68k_instruction [0x4678] = "m68k_4678_not_w_aw";
+    m68k_instruction [0x4679] = "m68k_4679_not_w_al";
+    m68k_instruction [0x46b8] = "m68k_46b8_not_l_aw";
+    m68k_instruction [0x46b9] = "m68k_46b9_not_l_al";
+
+    /* tst */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x4a00 | reg] = "m68k_4a00_tst_b_dn";
+        m68k_instruction [0x4a10 | reg] = "m68k_4a10_tst_b_an";
+        m68k_instruction [0x4a18 | reg] = "m68k_4a18_tst_b_anp";
+        m68k_instruction [0x4a20 | reg] = "m68k_4a20_tst_b_pan";
+        m68k_instruction [0x4a28 | reg] = "m68k_4a28_tst_b_dan";
+        m68k_instruction [0x4a30 | reg] = "m68k_4a30_tst_b_danxi";
+        m68k_instruction [0x4a40 | reg] = "m68k_4a40_tst_w_dn";
+        m68k_instruction [0x4a50 | reg] = "m68k_4a50_tst_w_an";
+        m68k_instruction [0x4a58 | reg] = "m68k_4a58_tst_w_anp";
+        m68k_instruction [0x4a60 | reg] = "m68k_4a60_tst_w_pan";
+        m68k_instruction [0x4a68 | reg] = "m68k_4a68_tst_w_dan";
+        m68k_instruction [0x4a70 | reg] = "m68k_4a70_tst_w_danxi";
+        m68k_instruction [0x4a80 | reg] = "m68k_4a80_tst_l_dn";
+        m68k_instruction [0x4a90 | reg] = "m68k_4a90_tst_l_an";
+        m68k_instruction [0x4a98 | reg] = "m68k_4a98_tst_l_anp";
+        m68k_instruction [0x4aa0 | reg] = "m68k_4aa0_tst_l_pan";
+        m68k_instruction [0x4aa8 | reg] = "m68k_4aa8_tst_l_dan";
+        m68k_instruction [0x4ab0 | reg] = "m68k_4ab0_tst_l_danxi";
+    }
+    m68k_instruction [0x4a38] = "m68k_4a38_tst_b_aw";
+    m68k_instruction [0x4a39] = "m68k_4a39_tst_b_al";
+    m68k_instruction [0x4a78] = "m68k_4a78_tst_w_aw";
+    m68k_instruction [0x4a79] = "m68k_4a79_tst_w_al";
+    m68k_instruction [0x4ab8] = "m68k_4ab8_tst_l_aw";
+    m68k_instruction [0x4ab9] = "m68k_4ab9_tst_l_al";
+
+
+    m68k_instruction [0x4e71] = "m68k_4e71_nop";
+    m68k_instruction [0x4e73] = "m68k_4e73_rte";
+    m68k_instruction [0x4e75] = "m68k_4e75_rts";
+    m68k_instruction [0x4e76] = "m68k_4e76_trapv";
+
+    /* jsr / jmp */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x4e90 | reg] = "m68k_4e90_jsr_an";
+        m68k_instruction [0x4ea8 | reg] = "m68k_4ea8_jsr_dan";
+        m68k_instruction [0x4eb0 | reg] = "m68k_4eb0_jsr_danxi";
+        m68k_instruction [0x4ed0 | reg] = "m68k_4ed0_jmp_an";
+        m68k_instruction [0x4ee8 | reg] = "m68k_4ee8_jmp_dan";
+        m68k_instruction [0x4ef0 | reg] = "m68k_4ef0_jmp_danxi";
+    }
+    m68k_instruction [0x4eb8] = "m68k_4eb8_jsr_aw";
+    m68k_instruction [0x4eb9] = "m68k_4eb9_jsr_al";
+    m68k_instruction [0x4eba] = "m68k_4eba_jsr_dpc";
+    m68k_instruction [0x4ebb] = "m68k_4ebb_jsr_dpcxi";
+    m68k_instruction [0x4ef8] = "m68k_4ef8_jmp_aw";
+    m68k_instruction [0x4ef9] = "m68k_4ef9_jmp_al";
+    m68k_instruction [0x4efa] = "m68k_4efa_jmp_dpc";
+    m68k_instruction [0x4efb] = "m68k_4efb_jmp_dpcxi";
+
+    /* movem */
+    for (uint16_t an = 0; an < 8; an++)
+    {
+        m68k_instruction [0x4890 | an] = "m68k_4890_movem_w_an_regs";
+        m68k_instruction [0x48a0 | an] = "m68k_48a0_movem_w_pan_regs";
+        m68k_instruction [0x48a8 | an] = "m68k_48a8_movem_w_dan_regs";
+        m68k_instruction [0x48b0 | an] = "m68k_48b0_movem_w_danxi_regs";
+        m68k_instruction [0x48d0 | an] = "m68k_48d0_movem_l_an_regs";
+        m68k_instruction [0x48e0 | an] = "m68k_48e0_movem_l_pan_regs";
+        m68k_instruction [0x48e8 | an] = "m68k_48e8_movem_l_dan_regs";
+        m68k_instruction [0x48f0 | an] = "m68k_48f0_movem_l_danxi_regs";
+        m68k_instruction [0x4c90 | an] = "m68k_4c90_movem_w_regs_an";
+        m68k_instruction [0x4c98 | an] = "m68k_4c98_movem_w_regs_anp";
+        m68k_instruction [0x4ca8 | an] = "m68k_4ca8_movem_w_regs_dan";
+        m68k_instruction [0x4cb0 | an] = "m68k_4cb0_movem_w_regs_danxi";
+        m68k_instruction [0x4cd0 | an] = "m68k_4cd0_movem_l_regs_an";
+        m68k_instruction [0x4cd8 | an] = "m68k_4cd8_movem_l_regs_anp";
+        m68k_instruction [0x4ce8 | an] = "m68k_4ce8_movem_l_regs_dan";
+        m68k_instruction [0x4cf0 | an] = "m68k_4cf0_movem_l_regs_danxi";
+    }
+    m68k_instruction [0x48b8] = "m68k_48b8_movem_w_aw_regs";
+    m68k_instruction [0x48b9] = "m68k_48b9_movem_w_al_regs";
+    m68k_instruction [0x48f8] = "m68k_48f8_movem_l_aw_regs";
+    m68k_instruction [0x48f9] = "m68k_48f9_movem_l_al_regs";
+    m68k_instruction [0x4cb8] = "m68k_4cb8_movem_w_regs_aw";
+    m68k_instruction [0x4cb9] = "m68k_4cb9_movem_w_regs_al";
+    m68k_instruction [0x4cba] = "m68k_4cba_movem_w_regs_dpc";
+    m68k_instruction [0x4cbb] = "m68k_4cbb_movem_w_regs_dpcxi";
+    m68k_instruction [0x4cf8] = "m68k_4cf8_movem_l_regs_aw";
+    m68k_instruction [0x4cf9] = "m68k_4cf9_movem_l_regs_al";
+    m68k_instruction [0x4cfa] = "m68k_4cfa_movem_l_regs_dpc";
+    m68k_instruction [0x4cfb] = "m68k_4cfb_movem_l_regs_dpcxi";
+
+    /* lea */
+    for (uint16_t an = 0; an < 8; an++)
+    {
+        for (uint16_t reg = 0; reg < 8; reg++)
+        {
+            m68k_instruction [0x41d0 | (an << 9) | reg] = "m68k_41d0_lea_an";
+            m68k_instruction [0x41e8 | (an << 9) | reg] = "m68k_41e8_lea_dan";
+            m68k_instruction [0x41f0 | (an << 9) | reg] = "m68k_41f0_lea_danxi";
+        }
+        m68k_instruction [0x41f8 | (an << 9)] = "m68k_41f8_lea_aw";
+        m68k_instruction [0x41f9 | (an << 9)] = "m68k_41f9_lea_al";
+        m68k_instruction [0x41fa | (an << 9)] = "m68k_41fa_lea_dpc";
+        m68k_instruction [0x41fb | (an << 9)] = "m68k_41fb_lea_dpcxi";
+    }
+
+    /* clr */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x4200 | reg] = "m68k_4200_clr_b_dn";
+        m68k_instruction [0x4210 | reg] = "m68k_4210_clr_b_an";
+        m68k_instruction [0x4218 | reg] = "m68k_4218_clr_b_anp";
+        m68k_instruction [0x4220 | reg] = "m68k_4220_clr_b_pan";
+        m68k_instruction [0x4228 | reg] = "m68k_4228_clr_b_dan";
+        m68k_instruction [0x4230 | reg] = "m68k_4230_clr_b_danxi";
+        m68k_instruction [0x4240 | reg] = "m68k_4240_clr_w_dn";
+        m68k_instruction [0x4250 | reg] = "m68k_4250_clr_w_an";
+        m68k_instruction [0x4258 | reg] = "m68k_4258_clr_w_anp";
+        m68k_instruction [0x4260 | reg] = "m68k_4260_clr_w_pan";
+        m68k_instruction [0x4268 | reg] = "m68k_4268_clr_w_dan";
+        m68k_instruction [0x4270 | reg] = "m68k_4270_clr_w_danxi";
+        m68k_instruction [0x4280 | reg] = "m68k_4280_clr_l_dn";
+        m68k_instruction [0x4290 | reg] = "m68k_4290_clr_l_an";
+        m68k_instruction [0x4298 | reg] = "m68k_4298_clr_l_anp";
+        m68k_instruction [0x42a0 | reg] = "m68k_42a0_clr_l_pan";
+        m68k_instruction [0x42a8 | reg] = "m68k_42a8_clr_l_dan";
+        m68k_instruction [0x42b0 | reg] = "m68k_42b0_clr_l_danxi";
+    }
+    m68k_instruction [0x4238] = "m68k_4238_clr_b_aw";
+    m68k_instruction [0x4239] = "m68k_4239_clr_b_al";
+    m68k_instruction [0x4278] = "m68k_4278_clr_w_aw";
+    m68k_instruction [0x4279] = "m68k_4279_clr_w_al";
+    m68k_instruction [0x42b8] = "m68k_42b8_clr_l_aw";
+    m68k_instruction [0x42b9] = "m68k_42b9_clr_l_al";
+
+    /* neg / swap / ext */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x4400 | reg] = "m68k_4400_neg_b_dn";
+        m68k_instruction [0x4410 | reg] = "m68k_4410_neg_b_an";
+        m68k_instruction [0x4418 | reg] = "m68k_4418_neg_b_anp";
+        m68k_instruction [0x4420 | reg] = "m68k_4420_neg_b_pan";
+        m68k_instruction [0x4428 | reg] = "m68k_4428_neg_b_dan";
+        m68k_instruction [0x4430 | reg] = "m68k_4430_neg_b_danxi";
+        m68k_instruction [0x4440 | reg] = "m68k_4440_neg_w_dn";
+        m68k_instruction [0x4450 | reg] = "m68k_4450_neg_w_an";
+        m68k_instruction [0x4458 | reg] = "m68k_4458_neg_w_anp";
+        m68k_instruction [0x4460 | reg] = "m68k_4460_neg_w_pan";
+        m68k_instruction [0x4468 | reg] = "m68k_4468_neg_w_dan";
+        m68k_instruction [0x4470 | reg] = "m68k_4470_neg_w_danxi";
+        m68k_instruction [0x4480 | reg] = "m68k_4480_neg_l_dn";
+        m68k_instruction [0x4490 | reg] = "m68k_4490_neg_l_an";
+        m68k_instruction [0x4498 | reg] = "m68k_4498_neg_l_anp";
+        m68k_instruction [0x44a0 | reg] = "m68k_44a0_neg_l_pan";
+        m68k_instruction [0x44a8 | reg] = "m68k_44a8_neg_l_dan";
+        m68k_instruction [0x44b0 | reg] = "m68k_44b0_neg_l_danxi";
+        m68k_instruction [0x4840 | reg] = "m68k_4840_swap_dn";
+        m68k_instruction [0x4880 | reg] = "m68k_4880_ext_w_dn";
+        m68k_instruction [0x48c0 | reg] = "m68k_48c0_ext_l_dn";
+    }
+    m68k_instruction [0x4438] = "m68k_4438_neg_b_aw";
+    m68k_instruction [0x4439] = "m68k_4439_neg_b_al";
+    m68k_instruction [0x4478] = "m68k_4478_neg_w_aw";
+    m68k_instruction [0x4479] = "m68k_4479_neg_w_al";
+    m68k_instruction [0x44b8] = "m68k_44b8_neg_l_aw";
+    m68k_instruction [0x44b9] = "m68k_44b9_neg_l_al";
+
+    /* pea */
+    for (uint16_t an = 0; an < 8; an++)
+    {
+        m68k_instruction [0x4850 | an] = "m68k_4850_pea_an";
+        m68k_instruction [0x4868 | an] = "m68k_4868_pea_dan";
+        m68k_instruction [0x4870 | an] = "m68k_4870_pea_danxi";
+    }
+    m68k_instruction [0x4878] = "m68k_4878_pea_aw";
+    m68k_instruction [0x4879] = "m68k_4879_pea_al";
+    m68k_instruction [0x487a] = "m68k_487a_pea_dpc";
+    m68k_instruction [0x487b] = "m68k_487b_pea_dpcxi";
+
+    /* trap */
+    for (uint32_t vector = 0; vector < 16; vector++)
+    {
+        m68k_instruction [0x4e40 | vector] = "m68k_4e40_trap";
+    }
+
+    /* link / unlink */
+    for (uint32_t reg = 0; reg < 8; reg++)
+    {
+        m68k_instruction [0x4e50 | reg] = "m68k_4e50_link";
+        m68k_instruction [0x4e58 | reg] = "m68k_4e58_unlink";
+    }
+
+    /* addq / subq */
+    for (uint16_t data = 0; data < 8; data++)
+    {
+        for (uint16_t reg = 0; reg < 8; reg++)
+        {
+            m68k_instruction [0x5000 | (data << 9) | reg] = "m68k_5000_addq_b_dn";
+            m68k_instruction [0x5010 | (data << 9) | reg] = "m68k_5010_addq_b_an";
+            m68k_instruction [0x5018 | (data << 9) | reg] = "m68k_5018_addq_b_anp";
+            m68k_instruction [0x5020 | (data << 9) | reg] = "m68k_5020_addq_b_pan";
+            m68k_instruction [0x5028 | (data << 9) | reg] = "m68k_5028_addq_b_dan";
+            m68k_instruction [0x5030 | (data << 9) | reg] = "m68k_5030_addq_b_danxi";
+            m68k_instruction [0x5040 | (data << 9) | reg] = "m68k_5040_addq_w_dn";
+            m68k_instruction [0x5048 | (data << 9) | reg] = "m68k_5048_addq_w_an";
+            m68k_instruction [0x5050 | (data << 9) | reg] = "m68k_5050_addq_w_an";
+            m68k_instruction [0x5058 | (data << 9) | reg] = "m68k_5058_addq_w_anp";
+            m68k_instruction [0x5060 | (data << 9) | reg] = "m68k_5060_addq_w_pan";
+            m68k_instruction [0x5068 | (data << 9) | reg] = "m68k_5068_addq_w_dan";
+            m68k_instruction [0x5070 | (data << 9) | reg] = "m68k_5070_addq_w_danxi";
+            m68k_instruction [0x5080 | (data << 9) | reg] = "m68k_5080_addq_l_dn";
+            m68k_instruction [0x5088 | (data << 9) | reg] = "m68k_5088_addq_l_an";
+            m68k_instruction [0x5090 | (data << 9) | reg] = "m68k_5090_addq_l_an";
+            m68k_instruction [0x5098 | (data << 9) | reg] = "m68k_5098_addq_l_anp";
+            m68k_instruction [0x50a0 | (data << 9) | reg] = "m68k_50a0_addq_l_pan";
+            m68k_instruction [0x50a8 | (data << 9) | reg] = "m68k_50a8_addq_l_dan";
+            m68k_instruction [0x50b0 | (data << 9) | reg] = "m68k_50b0_addq_l_danxi";
+            m68k_instruction [0x5100 | (data << 9) | reg] = "m68k_5100_subq_b_dn";
+            m68k_instruction [0x5110 | (data << 9) | reg] = "m68k_5110_subq_b_an";
+            m68k_instruction [0x5118 | (data << 9) | reg] = "m68k_5118_subq_b_anp";
+            m68k_instruction [0x5120 | (data << 9) | reg] = "m68k_5120_subq_b_pan";
+            m68k_instruction [0x5128 | (data << 9) | reg] = "m68k_5128_subq_b_dan";
+            m68k_instruction [0x5130 | (data << 9) | reg] = "m68k_5130_subq_b_danxi";
+            m68k_instruction [0x5140 | (data << 9) | reg] = "m68k_5140_subq_w_dn";
+            m68k_instruction [0x5148 | (data << 9) | reg] = "m68k_5148_subq_w_an";
+            m68k_instruction [0x5150 | (data << 9) | reg] = "m68k_5150_subq_w_an";
+            m68k_instruction [0x5158 | (data << 9) | reg] = "m68k_5158_subq_w_anp";
+            m68k_instruction [0x5160 | (data << 9) | reg] = "m68k_5160_subq_w_pan";
+            m68k_instruction [0x5168 | (data << 9) | reg] = "m68k_5168_subq_w_dan";
+            m68k_instruction [0x5170 | (data << 9) | reg] = "m68k_5170_subq_w_danxi";
+            m68k_instruction [0x5180 | (data << 9) | reg] = "m68k_5180_subq_l_dn";
+            m68k_instruction [0x5188 | (data << 9) | reg] = "m68k_5188_subq_l_an";
+            m68k_instruction [0x5190 | (data << 9) | reg] = "m68k_5190_subq_l_an";
+            m68k_instruction [0x5198 | (data << 9) | reg] = "m68k_5198_subq_l_anp";
+            m68k_instruction [0x51a0 | (data << 9) | reg] = "m68k_51a0_subq_l_pan";
+            m68k_instruction [0x51a8 | (data << 9) | reg] = "m68k_51a8_subq_l_dan";
+            m68k_instruction [0x51b0 | (data << 9) | reg] = "m68k_51b0_subq_l_danxi";
+        }
+        m68k_instruction [0x5038 | (data << 9)] = "m68k_5038_addq_b_aw";
+        m68k_instruction [0x5039 | (data << 9)] = "m68k_5039_addq_b_al";
+        m68k_instruction [0x5078 | (data << 9)] = "m68k_5078_addq_w_aw";
+        m68k_instruction [0x5079 | (data << 9)] = "m68k_5079_addq_w_al";
+        m68k_instruction [0x50b8 | (data << 9)] = "m68k_50b8_addq_l_aw";
+        m68k_instruction [0x50b9 | (data << 9)] = "m68k_50b9_addq_l_al";
+        m68k_instruction [0x5138 | (data << 9)] = "m68k_5138_subq_b_aw";
+        m68k_instruction [0x5139 | (data << 9)] = "m68k_5139_subq_b_al";
+        m68k_instruction [0x5178 | (data << 9)] = "m68k_5178_subq_w_aw";
+        m68k_instruction [0x5179 | (data << 9)] = "m68k_5179_subq_w_al";
+        m68k_instruction [0x51b8 | (data << 9)] = "m68k_51b8_subq_l_aw";
+        m68k_instruction [0x51b9 | (data << 9)] = "m68k_51b9_subq_l_al";
+    }
+
+    /* Scc */
+    for (uint16_t dn = 0; dn < 8; dn++)
+    {
+        m68k_instruction [0x50c0 | dn] = "m68k_50c0_st_b_dn";
+        m68k_instruction [0x50d0 | dn] = "m68k_50d0_st_b_an";
+        m68k_instruction [0x50d8 | dn] = "m68k_50d8_st_b_anp";
+        m68k_instruction [0x50e0 | dn] = "m68k_50e0_st_b_pan";
+        m68k_instruction [0x50e8 | dn] = "m68k_50e8_st_b_dan";
+        m68k_instruction [0x50f0 | dn] = "m68k_50f0_st_b_danxi";
+        m68k_instruction [0x51c0 | dn] = "m68k_51c0_sf_b_dn";
+        m68k_instruction [0x51d0 | dn] = "m68k_51d0_sf_b_an";
+        m68k_instruction [0x51d8 | dn] = "m68k_51d8_sf_b_anp";
+        m68k_instruction [0x51e0 | dn] = "m68k_51e0_sf_b_pan";
+        m68k_instruction [0x51e8 | dn] = "m68k_51e8_sf_b_dan";
+        m68k_instruction [0x51f0 | dn] = "m68k_51f0_sf_b_danxi";
+        m68k_instruction [0x54c0 | dn] = "m68k_54c0_scc_b_dn";
+        m68k_instruction [0x54d0 | dn] = "m68k_54d0_scc_b_an";
+        m68k_instruction [0x54d8 | dn] = "m68k_54d8_scc_b_anp";
+        m68k_instruction [0x54e0 | dn] = "m68k_54e0_scc_b_pan";
+        m68k_instruction [0x54e8 | dn] = "m68k_54e8_scc_b_dan";
+        m68k_instruction [0x54f0 | dn] = "m68k_54f0_scc_b_danxi";
+        m68k_instruction [0x56c0 | dn] = "m68k_56c0_sne_b_dn";
+        m68k_instruction [0x56d0 | dn] = "m68k_56d0_sne_b_an";
+        m68k_instruction [0x56d8 | dn] = "m68k_56d8_sne_b_anp";
+        m68k_instruction [0x56e0 | dn] = "m68k_56e0_sne_b_pan";
+        m68k_instruction [0x56e8 | dn] = "m68k_56e8_sne_b_dan";
+        m68k_instruction [0x56f0 | dn] = "m68k_56f0_sne_b_danxi";
+        m68k_instruction [0x57c0 | dn] = "m68k_57c0_seq_b_dn";
+        m68k_instruction [0x57d0 | dn] = "m68k_57d0_seq_b_an";
+        m68k_instruction [0x57d8 | dn] = "m68k_57d8_seq_b_anp";
+        m68k_instruction [0x57e0 | dn] = "m68k_57e0_seq_b_pan";
+        m68k_instruction [0x57e8 | dn] = "m68k_57e8_seq_b_dan";
+        m68k_instruction [0x57f0 | dn] = "m68k_57f0_seq_b_danxi";
+        m68k_instruction [0x5ac0 | dn] = "m68k_5ac0_spl_b_dn";
+        m68k_instruction [0x5ad0 | dn] = "m68k_5ad0_spl_b_an";
+        m68k_instruction [0x5ad8 | dn] = "m68k_5ad8_spl_b_anp";
+        m68k_instruction [0x5ae0 | dn] = "m68k_5ae0_spl_b_pan";
+        m68k_instruction [0x5ae8 | dn] = "m68k_5ae8_spl_b_dan";
+        m68k_instruction [0x5af0 | dn] = "m68k_5af0_spl_b_danxi";
+        m68k_instruction [0x5dc0 | dn] = "m68k_5dc0_slt_b_dn";
+        m68k_instruction [0x5dd0 | dn] = "m68k_5dd0_slt_b_an";
+        m68k_instruction [0x5dd8 | dn] = "m68k_5dd8_slt_b_anp";
+        m68k_instruction [0x5de0 | dn] = "m68k_5de0_slt_b_pan";
+        m68k_instruction [0x5de8 | dn] = "m68k_5de8_slt_b_dan";
+        m68k_instruction [0x5df0 | dn] = "m68k_5df0_slt_b_danxi";
+    }
+    m68k_instruction [0x50f8] = "m68k_50f8_st_b_aw";
+    m68k_instruction [0x50f9] = "m68k_50f9_st_b_al";
+    m68k_instruction [0x51f8] = "m68k_51f8_sf_b_aw";
+    m68k_instruction [0x51f9] = "m68k_51f9_sf_b_al";
+    m68k_instruction [0x54f8] = "m68k_54f8_scc_b_aw";
+    m68k_instruction [0x54f9] = "m68k_54f9_scc_b_al";
+    m68k_instruction [0x56f8] = "m68k_56f8_sne_b_aw";
+    m68k_instruction [0x56f9] = "m68k_56f9_sne_b_al";
+    m68k_instruction [0x57f8] = "m68k_57f8_seq_b_aw";
+    m68k_instruction [0x57f9] = "m68k_57f9_seq_b_al";
+    m68k_instruction [0x5af8] = "m68k_5af8_spl_b_aw";
+    m68k_instruction [0x5af9] = "m68k_5af9_spl_b_al";
+    m68k_instruction [0x5df8] = "m68k_5df8_slt_b_aw";
+    m68k_instruction [0x5df9] = "m68k_5df9_slt_b_al";
+
+    /* dbcc */
+    for (uint16_t dn = 0; dn < 8; dn++)
+    {
+        m68k_instruction [0x50c8 | dn] = "m68k_50c8_dbt";
+        m68k_instruction [0x51c8 | dn] = "m68k_51c8_dbf";
+        m68k_instruction [0x52c8 | dn] = "m68k_52c8_dbhi";
+        m68k_instruction [0x53c8 | dn] = "m68k_53c8_dbls";
+        m68k_instruction [0x54c8 | dn] = "m68k_54c8_dbcc";
+        m68k_instruction [0x55c8 | dn] = "m68k_55c8_dbcs";
+        m68k_instruction [0x56c8 | dn] = "m68k_56c8_dbne";
+        m68k_instruction [0x57c8 | dn] = "m68k_57c8_dbeq";
+        m68k_instruction [0x58c8 | dn] = "m68k_58c8_dbvc";
+        m68k_instruction [0x59c8 | dn] = "m68k_59c8_dbvs";
+        m68k_instruction [0x5ac8 | dn] = "m68k_5ac8_dbpl";
+        m68k_instruction [0x5bc8 | dn] = "m68k_5bc8_dbmi";
+        m68k_instruction [0x5cc8 | dn] = "m68k_5cc8_dbge";
+        m68k_instruction [0x5dc8 | dn] = "m68k_5dc8_dblt";
+        m68k_instruction [0x5ec8 | dn] = "m68k_5ec8_dbgt";
+        m68k_instruction [0x5fc8 | dn] = "m68k_5fc8_dble";
+    }
+
+    /* Bcc/BSR/BRA with 16-bit displacement */
+    m68k_instruction [0x6000] = "m68k_6000_bra_w";
+    m68k_instruction [0x6100] = "m68k_6100_bsr_w";
+    m68k_instruction [0x6200] = "m68k_6200_bhi_w";
+    m68k_instruction [0x6300] = "m68k_6300_bls_w";
+    m68k_instruction [0x6400] = "m68k_6400_bcc_w";
+    m68k_instruction [0x6500] = "m68k_6500_bcs_w";
+    m68k_instruction [0x6600] = "m68k_6600_bne_w";
+    m68k_instruction [0x6700] = "m68k_6700_beq_w";
+    m68k_instruction [0x6a00] = "m68k_6a00_bpl_w";
+    m68k_instruction [0x6b00] = "m68k_6b00_bmi_w";
+    m68k_instruction [0x6c00] = "m68k_6c00_bge_w";
+    m68k_instruction [0x6d00] = "m68k_6d00_blt_w";
+    m68k_instruction [0x6e00] = "m68k_6e00_bgt_w";
+    m68k_instruction [0x6f00] = "m68k_6f00_ble_w";
+
+    /* Bcc/BSR/BRA with 8-bit displacement */
+    for (uint16_t d = 0x01; d <= 0xff; d++)
+    {
+        m68k_instruction [0x6000 | d] = "m68k_6001_bra_s";
+        m68k_instruction [0x6100 | d] = "m68k_6101_bsr_s";
+        m68k_instruction [0x6200 | d] = "m68k_6201_bhi_s";
+        m68k_instruction [0x6300 | d] = "m68k_6301_bls_s";
+        m68k_instruction [0x6400 | d] = "m68k_6401_bcc_s";
+        m68k_instruction [0x6500 | d] = "m68k_6501_bcs_s";
+        m68k_instruction [0x6600 | d] = "m68k_6601_bne_s";
+        m68k_instruction [0x6700 | d] = "m68k_6701_beq_s";
+        m68k_instruction [0x6a00 | d] = "m68k_6a01_bpl_s";
+        m68k_instruction [0x6b00 | d] = "m68k_6b01_bmi_s";
+        m68k_instruction [0x6c00 | d] = "m68k_6c01_bge_s";
+        m68k_instruction [0x6d00 | d] = "m68k_6d01_blt_s";
+        m68k_instruction [0x6e00 | d] = "m68k_6e01_bgt_s";
+        m68k_instruction [0x6f00 | d] = "m68k_6f01_ble_s";
+    }
+
+    /* moveq */
+    for (uint16_t dn = 0; dn < 8; dn++)
+    {
+        for (uint16_t data = 0x00; data <= 0xff; data++)
+        {
+            m68k_instruction [0x7000 | (dn << 9) | data] = "m68k_7000_moveq";
+        }
+    }
+
+    /* or */
+    for (uint16_t reg_a = 0; reg_a < 8; reg_a++)
+    {
+        for (uint16_t reg_b = 0; reg_b < 8; reg_b++)
+        {
+            m68k_instruction [0x8000 | (reg_a << 9) | reg_b] = "m68k_8000_or_b_dn_dn";
+            m68k_instruction [0x8010 | (reg_a << 9) | reg_b] = "m68k_8010_or_b_dn_an";
+            m68k_instruction [0x8018 | (reg_a << 9) | reg_b] = "m68k_8018_or_b_dn_anp";
+            m68k_instruction [0x8020 | (reg_a << 9) | reg_b] = "m68k_8020_or_b_dn_pan";
+            m68k_instruction [0x8028 | (reg_a << 9) | reg_b] = "m68k_8028_or_b_dn_dan";
+            m68k_instruction [0x8030 | (reg_a << 9) | reg_b] = "m68k_8030_or_b_dn_danxi";
+            m68k_instruction [0x8040 | (reg_a << 9) | reg_b] = "m68k_8040_or_w_dn_dn";
+            m68k_instruction [0x8050 | (reg_a << 9) | reg_b] = "m68k_8050_or_w_dn_an";
+            m68k_instruction [0x8058 | (reg_a << 9) | reg_b] = "m68k_8058_or_w_dn_anp";
+            m68k_instruction [0x8060 | (reg_a << 9) | reg_b] = "m68k_8060_or_w_dn_pan";
+            m68k_instruction [0x8068 | (reg_a << 9) | reg_b] = "m68k_8068_or_w_dn_dan";
+            m68k_instruction [0x8070 | (reg_a << 9) | reg_b] = "m68k_8070_or_w_dn_danxi";
+            m68k_instruction [0x8080 | (reg_a << 9) | reg_b] = "m68k_8080_or_l_dn_dn";
+            m68k_instruction [0x8090 | (reg_a << 9) | reg_b] = "m68k_8090_or_l_dn_an";
+            m68k_instruction [0x8098 | (reg_a << 9) | reg_b] = "m68k_8098_or_l_dn_anp";
+            m68k_instruction [0x80a0 | (reg_a << 9) | reg_b] = "m68k_80a0_or_l_dn_pan";
+            m68k_instruction [0x80a8 | (reg_a << 9) | reg_b] = "m68k_80a8_or_l_dn_dan";
+            m68k_instruction [0x80b0 | (reg_a << 9) | reg_b] = "m68k_80b0_or_l_dn_danxi";
+            m68k_instruction [0x8110 | (reg_a << 9) | reg_b] = "m68k_8110_or_b_an_dn";
+            m68k_instruction [0x8118 | (reg_a << 9) | reg_b] = "m68k_8118_or_b_anp_dn";
+            m68k_instruction [0x8120 | (reg_a << 9) | reg_b] = "m68k_8120_or_b_pan_dn";
+            m68k_instruction [0x8128 | (reg_a << 9) | reg_b] = "m68k_8128_or_b_dan_dn";
+            m68k_instruction [0x8130 | (reg_a << 9) | reg_b] = "m68k_8130_or_b_danxi_dn";
+            m68k_instruction [0x8150 | (reg_a << 9) | reg_b] = "m68k_8150_or_w_an_dn";
+            m68k_instruction [0x8158 | (reg_a << 9) | reg_b] = "m68k_8158_or_w_anp_dn";
+            m68k_instruction [0x8160 | (reg_a << 9) | reg_b] = "m68k_8160_or_w_pan_dn";
+            m68k_instruction [0x8168 | (reg_a << 9) | reg_b] = "m68k_8168_or_w_dan_dn";
+            m68k_instruction [0x8170 | (reg_a << 9) | reg_b] = "m68k_8170_or_w_danxi_dn";
+            m68k_instruction [0x8190 | (reg_a << 9) | reg_b] = "m68k_8190_or_l_an_dn";
+            m68k_instruction [0x8198 | (reg_a << 9) | reg_b] = "m68k_8198_or_l_anp_dn";
+            m68k_instruction [0x81a0 | (reg_a << 9) | reg_b] = "m68k_81a0_or_l_pan_dn";
+            m68k_instruction [0x81a8 | (reg_a << 9) | reg_b] = "m68k_81a8_or_l_dan_dn";
+            m68k_instruction [0x81b0 | (reg_a << 9) | reg_b] = "m68k_81b0_or_l_danxi_dn";
+        }
+        m68k_instruction [0x8038 | (reg_a << 9)] = "m68k_8038_or_b_dn_aw";
+        m68k_instruction [0x8039 | (reg_a << 9)] = "m68k_8039_or_b_dn_al";
+        m68k_instruction [0x803a | (reg_a << 9)] = "m68k_803a_or_b_dn_dpc";
+        m68k_instruction [0x803b | (reg_a << 9)] = "m68k_803b_or_b_dn_dpcxi";
+        m68k_instruction [0x803c | (reg_a << 9)] = "m68k_803c_or_b_dn_imm";
+        m68k_instruction [0x8078 | (reg_a << 9)] = "m68k_8078_or_w_dn_aw";
+        m68k_instruction [0x8079 | (reg_a << 9)] = "m68k_8079_or_w_dn_al";
+        m68k_instruction [0x807a | (reg_a << 9)] = "m68k_807a_or_w_dn_dpc";
+        m68k_instruction [0x807b | (reg_a << 9)] = "m68k_807b_or_w_dn_dpcxi";
+        m68k_instruction [0x807c | (reg_a << 9)] = "m68k_807c_or_w_dn_imm";
+        m68k_instruction [0x80b8 | (reg_a << 9)] = "m68k_80b8_or_l_dn_aw";
+        m68k_instruction [0x80b9 | (reg_a << 9)] = "m68k_80b9_or_l_dn_al";
+        m68k_instruction [0x80ba | (reg_a << 9)] = "m68k_80ba_or_l_dn_dpc";
+        m68k_instruction [0x80bb | (reg_a << 9)] = "m68k_80bb_or_l_dn_dpcxi";
+        m68k_instruction [0x80bc | (reg_a << 9)] = "m68k_80bc_or_l_dn_imm";
+        m68k_instruction [0x8138 | (reg_a << 9)] = "m68k_8138_or_b_aw_dn";
+        m68k_instruction [0x8139 | (reg_a << 9)] = "m68k_8139_or_b_al_dn";
+        m68k_instruction [0x8178 | (reg_a << 9)] = "m68k_8178_or_w_aw_dn";
+        m68k_instruction [0x8179 | (reg_a << 9)] = "m68k_8179_or_w_al_dn";
+        m68k_instruction [0x81b8 | (reg_a << 9)] = "m68k_81b8_or_l_aw_dn";
+        m68k_instruction [0x81b9 | (reg_a << 9)] = "m68k_81b9_or_l_al_dn";
+    }
+
+    /* divs / divu */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        for (uint16_t ea = 0; ea < 8; ea++)
+        {
+            m68k_instruction [0x80c0 | (reg << 9) | ea] = "m68k_80c0_divu_w_dn_dn";
+            m68k_instruction [0x80d0 | (reg << 9) | ea] = "m68k_80d0_divu_w_dn_an";
+            m68k_instruction [0x80d8 | (reg << 9) | ea] = "m68k_80d8_divu_w_dn_anp";
+            m68k_instruction [0x80e0 | (reg << 9) | ea] = "m68k_80e0_divu_w_dn_pan";
+            m68k_instruction [0x80e8 | (reg << 9) | ea] = "m68k_80e8_divu_w_dn_dan";
+            m68k_instruction [0x80f0 | (reg << 9) | ea] = "m68k_80f0_divu_w_dn_danxi";
+            m68k_instruction [0x81c0 | (reg << 9) | ea] = "m68k_81c0_divs_w_dn_dn";
+            m68k_instruction [0x81d0 | (reg << 9) | ea] = "m68k_81d0_divs_w_dn_an";
+            m68k_instruction [0x81d8 | (reg << 9) | ea] = "m68k_81d8_divs_w_dn_anp";
+            m68k_instruction [0x81e0 | (reg << 9) | ea] = "m68k_81e0_divs_w_dn_pan";
+            m68k_instruction [0x81e8 | (reg << 9) | ea] = "m68k_81e8_divs_w_dn_dan";
+            m68k_instruction [0x81f0 | (reg << 9) | ea] = "m68k_81f0_divs_w_dn_danxi";
+        }
+        m68k_instruction [0x80f8 | (reg << 9)] = "m68k_80f8_divu_w_dn_aw";
+        m68k_instruction [0x80f9 | (reg << 9)] = "m68k_80f9_divu_w_dn_al";
+        m68k_instruction [0x80fa | (reg << 9)] = "m68k_80fa_divu_w_dn_dpc";
+        m68k_instruction [0x80fb | (reg << 9)] = "m68k_80fb_divu_w_dn_dpcxi";
+        m68k_instruction [0x80fc | (reg << 9)] = "m68k_80fc_divu_w_dn_imm";
+        m68k_instruction [0x81f8 | (reg << 9)] = "m68k_81f8_divs_w_dn_aw";
+        m68k_instruction [0x81f9 | (reg << 9)] = "m68k_81f9_divs_w_dn_al";
+        m68k_instruction [0x81fa | (reg << 9)] = "m68k_81fa_divs_w_dn_dpc";
+        m68k_instruction [0x81fb | (reg << 9)] = "m68k_81fb_divs_w_dn_dpcxi";
+        m68k_instruction [0x81fc | (reg << 9)] = "m68k_81fc_divs_w_dn_imm";
+    }
+
+    /* sub */
+    for (uint16_t reg_a = 0; reg_a < 8; reg_a++)
+    {
+        for (uint16_t reg_b = 0; reg_b < 8; reg_b++)
+        {
+            m68k_instruction [0x9000 | (reg_a << 9) | reg_b] = "m68k_9000_sub_b_dn_dn";
+            m68k_instruction [0x9010 | (reg_a << 9) | reg_b] = "m68k_9010_sub_b_dn_an";
+            m68k_instruction [0x9018 | (reg_a << 9) | reg_b] = "m68k_9018_sub_b_dn_anp";
+            m68k_instruction [0x9020 | (reg_a << 9) | reg_b] = "m68k_9020_sub_b_dn_pan";
+            m68k_instruction [0x9028 | (reg_a << 9) | reg_b] = "m68k_9028_sub_b_dn_dan";
+            m68k_instruction [0x9030 | (reg_a << 9) | reg_b] = "m68k_9030_sub_b_dn_danxi";
+            m68k_instruction [0x9040 | (reg_a << 9) | reg_b] = "m68k_9040_sub_w_dn_dn";
+            m68k_instruction [0x9048 | (reg_a << 9) | reg_b] = "m68k_9048_sub_w_dn_an";
+            m68k_instruction [0x9050 | (reg_a << 9) | reg_b] = "m68k_9050_sub_w_dn_an";
+            m68k_instruction [0x9058 | (reg_a << 9) | reg_b] = "m68k_9058_sub_w_dn_anp";
+            m68k_instruction [0x9060 | (reg_a << 9) | reg_b] = "m68k_9060_sub_w_dn_pan";
+            m68k_instruction [0x9068 | (reg_a << 9) | reg_b] = "m68k_9068_sub_w_dn_dan";
+            m68k_instruction [0x9070 | (reg_a << 9) | reg_b] = "m68k_9070_sub_w_dn_danxi";
+            m68k_instruction [0x9080 | (reg_a << 9) | reg_b] = "m68k_9080_sub_l_dn_dn";
+            m68k_instruction [0x9088 | (reg_a << 9) | reg_b] = "m68k_9088_sub_l_dn_an";
+            m68k_instruction [0x9090 | (reg_a << 9) | reg_b] = "m68k_9090_sub_l_dn_an";
+            m68k_instruction [0x9098 | (reg_a << 9) | reg_b] = "m68k_9098_sub_l_dn_anp";
+            m68k_instruction [0x90a0 | (reg_a << 9) | reg_b] = "m68k_90a0_sub_l_dn_pan";
+            m68k_instruction [0x90a8 | (reg_a << 9) | reg_b] = "m68k_90a8_sub_l_dn_dan";
+            m68k_instruction [0x90b0 | (reg_a << 9) | reg_b] = "m68k_90b0_sub_l_dn_danxi";
+            m68k_instruction [0x90c0 | (reg_a << 9) | reg_b] = "m68k_90c0_suba_w_an_dn";
+            m68k_instruction [0x90c8 | (reg_a << 9) | reg_b] = "m68k_90c8_suba_w_an_an";
+            m68k_instruction [0x90d0 | (reg_a << 9) | reg_b] = "m68k_90d0_suba_w_an_an";
+            m68k_instruction [0x90d8 | (reg_a << 9) | reg_b] = "m68k_90d8_suba_w_an_anp";
+            m68k_instruction [0x90e0 | (reg_a << 9) | reg_b] = "m68k_90e0_suba_w_an_pan";
+            m68k_instruction [0x90e8 | (reg_a << 9) | reg_b] = "m68k_90e8_suba_w_an_dan";
+            m68k_instruction [0x90f0 | (reg_a << 9) | reg_b] = "m68k_90f0_suba_w_an_danxi";
+            m68k_instruction [0x9110 | (reg_a << 9) | reg_b] = "m68k_9110_sub_b_an_dn";
+            m68k_instruction [0x9118 | (reg_a << 9) | reg_b] = "m68k_9118_sub_b_anp_dn";
+            m68k_instruction [0x9120 | (reg_a << 9) | reg_b] = "m68k_9120_sub_b_pan_dn";
+            m68k_instruction [0x9128 | (reg_a << 9) | reg_b] = "m68k_9128_sub_b_dan_dn";
+            m68k_instruction [0x9130 | (reg_a << 9) | reg_b] = "m68k_9130_sub_b_danxi_dn";
+            m68k_instruction [0x9150 | (reg_a << 9) | reg_b] = "m68k_9150_sub_w_an_dn";
+            m68k_instruction [0x9158 | (reg_a << 9) | reg_b] = "m68k_9158_sub_w_anp_dn";
+            m68k_instruction [0x9160 | (reg_a << 9) | reg_b] = "m68k_9160_sub_w_pan_dn";
+            m68k_instruction [0x9168 | (reg_a << 9) | reg_b] = "m68k_9168_sub_w_dan_dn";
+            m68k_instruction [0x9170 | (reg_a << 9) | reg_b] = "m68k_9170_sub_w_danxi_dn";
+            m68k_instruction [0x9190 | (reg_a << 9) | reg_b] = "m68k_9190_sub_l_an_dn";
+            m68k_instruction [0x9198 | (reg_a << 9) | reg_b] = "m68k_9198_sub_l_anp_dn";
+            m68k_instruction [0x91a0 | (reg_a << 9) | reg_b] = "m68k_91a0_sub_l_pan_dn";
+            m68k_instruction [0x91a8 | (reg_a << 9) | reg_b] = "m68k_91a8_sub_l_dan_dn";
+            m68k_instruction [0x91b0 | (reg_a << 9) | reg_b] = "m68k_91b0_sub_l_danxi_dn";
+            m68k_instruction [0x91c0 | (reg_a << 9) | reg_b] = "m68k_91c0_suba_l_an_dn";
+            m68k_instruction [0x91c8 | (reg_a << 9) | reg_b] = "m68k_91c8_suba_l_an_an";
+            m68k_instruction [0x91d0 | (reg_a << 9) | reg_b] = "m68k_91d0_suba_l_an_an";
+            m68k_instruction [0x91d8 | (reg_a << 9) | reg_b] = "m68k_91d8_suba_l_an_anp";
+            m68k_instruction [0x91e0 | (reg_a << 9) | reg_b] = "m68k_91e0_suba_l_an_pan";
+            m68k_instruction [0x91e8 | (reg_a << 9) | reg_b] = "m68k_91e8_suba_l_an_dan";
+            m68k_instruction [0x91f0 | (reg_a << 9) | reg_b] = "m68k_91f0_suba_l_an_danxi";
+        }
+        m68k_instruction [0x9038 | (reg_a << 9)] = "m68k_9038_sub_b_dn_aw";
+        m68k_instruction [0x9039 | (reg_a << 9)] = "m68k_9039_sub_b_dn_al";
+        m68k_instruction [0x903a | (reg_a << 9)] = "m68k_903a_sub_b_dn_dpc";
+        m68k_instruction [0x903b | (reg_a << 9)] = "m68k_903b_sub_b_dn_dpcxi";
+        m68k_instruction [0x903c | (reg_a << 9)] = "m68k_903c_sub_b_dn_imm";
+        m68k_instruction [0x9078 | (reg_a << 9)] = "m68k_9078_sub_w_dn_aw";
+        m68k_instruction [0x9079 | (reg_a << 9)] = "m68k_9079_sub_w_dn_al";
+        m68k_instruction [0x907a | (reg_a << 9)] = "m68k_907a_sub_w_dn_dpc";
+        m68k_instruction [0x907b | (reg_a << 9)] = "m68k_907b_sub_w_dn_dpcxi";
+        m68k_instruction [0x907c | (reg_a << 9)] = "m68k_907c_sub_w_dn_imm";
+        m68k_instruction [0x90b8 | (reg_a << 9)] = "m68k_90b8_sub_l_dn_aw";
+        m68k_instruction [0x90b9 | (reg_a << 9)] = "m68k_90b9_sub_l_dn_al";
+        m68k_instruction [0x90ba | (reg_a << 9)] = "m68k_90ba_sub_l_dn_dpc";
+        m68k_instruction [0x90bb | (reg_a << 9)] = "m68k_90bb_sub_l_dn_dpcxi";
+        m68k_instruction [0x90bc | (reg_a << 9)] = "m68k_90bc_sub_l_dn_imm";
+        m68k_instruction [0x90f8 | (reg_a << 9)] = "m68k_90f8_suba_w_an_aw";
+        m68k_instruction [0x90f9 | (reg_a << 9)] = "m68k_90f9_suba_w_an_al";
+        m68k_instruction [0x90fa | (reg_a << 9)] = "m68k_90fa_suba_w_an_dpc";
+        m68k_instruction [0x90fb | (reg_a << 9)] = "m68k_90fb_suba_w_an_dpcxi";
+        m68k_instruction [0x90fc | (reg_a << 9)] = "m68k_90fc_suba_w_an_imm";
+        m68k_instruction [0x9138 | (reg_a << 9)] = "m68k_9138_sub_b_aw_dn";
+        m68k_instruction [0x9139 | (reg_a << 9)] = "m68k_9139_sub_b_al_dn";
+        m68k_instruction [0x9178 | (reg_a << 9)] = "m68k_9178_sub_w_aw_dn";
+        m68k_instruction [0x9179 | (reg_a << 9)] = "m68k_9179_sub_w_al_dn";
+        m68k_instruction [0x91b8 | (reg_a << 9)] = "m68k_91b8_sub_l_aw_dn";
+        m68k_instruction [0x91b9 | (reg_a << 9)] = "m68k_91b9_sub_l_al_dn";
+        m68k_instruction [0x91f8 | (reg_a << 9)] = "m68k_91f8_suba_l_an_aw";
+        m68k_instruction [0x91f9 | (reg_a << 9)] = "m68k_91f9_suba_l_an_al";
+        m68k_instruction [0x91fa | (reg_a << 9)] = "m68k_91fa_suba_l_an_dpc";
+        m68k_instruction [0x91fb | (reg_a << 9)] = "m68k_91fb_suba_l_an_dpcxi";
+        m68k_instruction [0x91fc | (reg_a << 9)] = "m68k_91fc_suba_l_an_imm";
+    }
+
+    /* Line-A exception */
+    for (uint32_t i = 0x0000; i <= 0x0fff; i++)
+    {
+        m68k_instruction [0xa000 | i] = "m68k_a000_line_a";
+    }
+
+    /* cmp / cmpa */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        for (uint16_t ea = 0; ea < 8; ea++)
+        {
+            m68k_instruction [0xb000 | (reg << 9) | ea] = "m68k_b000_cmp_b_dn_dn";
+            m68k_instruction [0xb010 | (reg << 9) | ea] = "m68k_b010_cmp_b_dn_an";
+            m68k_instruction [0xb018 | (reg << 9) | ea] = "m68k_b018_cmp_b_dn_anp";
+            m68k_instruction [0xb020 | (reg << 9) | ea] = "m68k_b020_cmp_b_dn_pan";
+            m68k_instruction [0xb028 | (reg << 9) | ea] = "m68k_b028_cmp_b_dn_dan";
+            m68k_instruction [0xb030 | (reg << 9) | ea] = "m68k_b030_cmp_b_dn_danxi";
+            m68k_instruction [0xb040 | (reg << 9) | ea] = "m68k_b040_cmp_w_dn_dn";
+            m68k_instruction [0xb048 | (reg << 9) | ea] = "m68k_b048_cmp_w_dn_an";
+            m68k_instruction [0xb050 | (reg << 9) | ea] = "m68k_b050_cmp_w_dn_an";
+            m68k_instruction [0xb058 | (reg << 9) | ea] = "m68k_b058_cmp_w_dn_anp";
+            m68k_instruction [0xb060 | (reg << 9) | ea] = "m68k_b060_cmp_w_dn_pan";
+            m68k_instruction [0xb068 | (reg << 9) | ea] = "m68k_b068_cmp_w_dn_dan";
+            m68k_instruction [0xb070 | (reg << 9) | ea] = "m68k_b070_cmp_w_dn_danxi";
+            m68k_instruction [0xb080 | (reg << 9) | ea] = "m68k_b080_cmp_l_dn_dn";
+            m68k_instruction [0xb088 | (reg << 9) | ea] = "m68k_b088_cmp_l_dn_an";
+            m68k_instruction [0xb090 | (reg << 9) | ea] = "m68k_b090_cmp_l_dn_an";
+            m68k_instruction [0xb098 | (reg << 9) | ea] = "m68k_b098_cmp_l_dn_anp";
+            m68k_instruction [0xb0a0 | (reg << 9) | ea] = "m68k_b0a0_cmp_l_dn_pan";
+            m68k_instruction [0xb0a8 | (reg << 9) | ea] = "m68k_b0a8_cmp_l_dn_dan";
+            m68k_instruction [0xb0b0 | (reg << 9) | ea] = "m68k_b0b0_cmp_l_dn_danxi";
+            m68k_instruction [0xb0c0 | (reg << 9) | ea] = "m68k_b0c0_cmpa_w_an_dn";
+            m68k_instruction [0xb0c8 | (reg << 9) | ea] = "m68k_b0c8_cmpa_w_an_an";
+            m68k_instruction [0xb0d0 | (reg << 9) | ea] = "m68k_b0d0_cmpa_w_an_an";
+            m68k_instruction [0xb0d8 | (reg << 9) | ea] = "m68k_b0d8_cmpa_w_an_anp";
+            m68k_instruction [0xb0e0 | (reg << 9) | ea] = "m68k_b0e0_cmpa_w_an_pan";
+            m68k_instruction [0xb0e8 | (reg << 9) | ea] = "m68k_b0e8_cmpa_w_an_dan";
+            m68k_instruction [0xb0f0 | (reg << 9) | ea] = "m68k_b0f0_cmpa_w_an_danxi";
+            m68k_instruction [0xb1c0 | (reg << 9) | ea] = "m68k_b1c0_cmpa_l_an_dn";
+            m68k_instruction [0xb1c8 | (reg << 9) | ea] = "m68k_b1c8_cmpa_l_an_an";
+            m68k_instruction [0xb1d0 | (reg << 9) | ea] = "m68k_b1d0_cmpa_l_an_an";
+            m68k_instruction [0xb1d8 | (reg << 9) | ea] = "m68k_b1d8_cmpa_l_an_anp";
+            m68k_instruction [0xb1e0 | (reg << 9) | ea] = "m68k_b1e0_cmpa_l_an_pan";
+            m68k_instruction [0xb1e8 | (reg << 9) | ea] = "m68k_b1e8_cmpa_l_an_dan";
+            m68k_instruction [0xb1f0 | (reg << 9) | ea] = "m68k_b1f0_cmpa_l_an_danxi";
+        }
+        m68k_instruction [0xb038 | (reg << 9)] = "m68k_b038_cmp_b_dn_aw";
+        m68k_instruction [0xb039 | (reg << 9)] = "m68k_b039_cmp_b_dn_al";
+        m68k_instruction [0xb03a | (reg << 9)] = "m68k_b03a_cmp_b_dn_dpc";
+        m68k_instruction [0xb03b | (reg << 9)] = "m68k_b03b_cmp_b_dn_dpcxi";
+        m68k_instruction [0xb03c | (reg << 9)] = "m68k_b03c_cmp_b_dn_imm";
+        m68k_instruction [0xb078 | (reg << 9)] = "m68k_b078_cmp_w_dn_aw";
+        m68k_instruction [0xb079 | (reg << 9)] = "m68k_b079_cmp_w_dn_al";
+        m68k_instruction [0xb07a | (reg << 9)] = "m68k_b07a_cmp_w_dn_dpc";
+        m68k_instruction [0xb07b | (reg << 9)] = "m68k_b07b_cmp_w_dn_dpcxi";
+        m68k_instruction [0xb07c | (reg << 9)] = "m68k_b07c_cmp_w_dn_imm";
+        m68k_instruction [0xb0b8 | (reg << 9)] = "m68k_b0b8_cmp_l_dn_aw";
+        m68k_instruction [0xb0b9 | (reg << 9)] = "m68k_b0b9_cmp_l_dn_al";
+        m68k_instruction [0xb0ba | (reg << 9)] = "m68k_b0ba_cmp_l_dn_dpc";
+        m68k_instruction [0xb0bb | (reg << 9)] = "m68k_b0bb_cmp_l_dn_dpcxi";
+        m68k_instruction [0xb0bc | (reg << 9)] = "m68k_b0bc_cmp_l_dn_imm";
+        m68k_instruction [0xb0f8 | (reg << 9)] = "m68k_b0f8_cmpa_w_an_aw";
+        m68k_instruction [0xb0f9 | (reg << 9)] = "m68k_b0f9_cmpa_w_an_al";
+        m68k_instruction [0xb0fa | (reg << 9)] = "m68k_b0fa_cmpa_w_an_dpc";
+        m68k_instruction [0xb0fb | (reg << 9)] = "m68k_b0fb_cmpa_w_an_dpcxi";
+        m68k_instruction [0xb0fc | (reg << 9)] = "m68k_b0fc_cmpa_w_an_imm";
+        m68k_instruction [0xb1f8 | (reg << 9)] = "m68k_b1f8_cmpa_l_an_aw";
+        m68k_instruction [0xb1f9 | (reg << 9)] = "m68k_b1f9_cmpa_l_an_al";
+        m68k_instruction [0xb1fa | (reg << 9)] = "m68k_b1fa_cmpa_l_an_dpc";
+        m68k_instruction [0xb1fb | (reg << 9)] = "m68k_b1fb_cmpa_l_an_dpcxi";
+        m68k_instruction [0xb1fc | (reg << 9)] = "m68k_b1fc_cmpa_l_an_imm";
+    }
+
+    /* eor */
+    for (uint16_t reg_a = 0; reg_a < 8; reg_a++)
+    {
+        for (uint16_t reg_b = 0; reg_b < 8; reg_b++)
+        {
+            m68k_instruction [0xb100 | (reg_a << 9) | reg_b] = "m68k_b100_eor_b_dn_dn";
+            m68k_instruction [0xb140 | (reg_a << 9) | reg_b] = "m68k_b140_eor_w_dn_dn";
+            m68k_instruction [0xb180 | (reg_a << 9) | reg_b] = "m68k_b180_eor_l_dn_dn";
+        }
+    }
+
+    /* and */
+    for (uint16_t reg_a = 0; reg_a < 8; reg_a++)
+    {
+        for (uint16_t reg_b = 0; reg_b < 8; reg_b++)
+        {
+            m68k_instruction [0xc000 | (reg_a << 9) | reg_b] = "m68k_c000_and_b_dn_dn";
+            m68k_instruction [0xc010 | (reg_a << 9) | reg_b] = "m68k_c010_and_b_dn_an";
+            m68k_instruction [0xc018 | (reg_a << 9) | reg_b] = "m68k_c018_and_b_dn_anp";
+            m68k_instruction [0xc020 | (reg_a << 9) | reg_b] = "m68k_c020_and_b_dn_pan";
+            m68k_instruction [0xc028 | (reg_a << 9) | reg_b] = "m68k_c028_and_b_dn_dan";
+            m68k_instruction [0xc030 | (reg_a << 9) | reg_b] = "m68k_c030_and_b_dn_danxi";
+            m68k_instruction [0xc040 | (reg_a << 9) | reg_b] = "m68k_c040_and_w_dn_dn";
+            m68k_instruction [0xc050 | (reg_a << 9) | reg_b] = "m68k_c050_and_w_dn_an";
+            m68k_instruction [0xc058 | (reg_a << 9) | reg_b] = "m68k_c058_and_w_dn_anp";
+            m68k_instruction [0xc060 | (reg_a << 9) | reg_b] = "m68k_c060_and_w_dn_pan";
+            m68k_instruction [0xc068 | (reg_a << 9) | reg_b] = "m68k_c068_and_w_dn_dan";
+            m68k_instruction [0xc070 | (reg_a << 9) | reg_b] = "m68k_c070_and_w_dn_danxi";
+            m68k_instruction [0xc080 | (reg_a << 9) | reg_b] = "m68k_c080_and_l_dn_dn";
+            m68k_instruction [0xc090 | (reg_a << 9) | reg_b] = "m68k_c090_and_l_dn_an";
+            m68k_instruction [0xc098 | (reg_a << 9) | reg_b] = "m68k_c098_and_l_dn_anp";
+            m68k_instruction [0xc0a0 | (reg_a << 9) | reg_b] = "m68k_c0a0_and_l_dn_pan";
+            m68k_instruction [0xc0a8 | (reg_a << 9) | reg_b] = "m68k_c0a8_and_l_dn_dan";
+            m68k_instruction [0xc0b0 | (reg_a << 9) | reg_b] = "m68k_c0b0_and_l_dn_danxi";
+            m68k_instruction [0xc110 | (reg_a << 9) | reg_b] = "m68k_c110_and_b_an_dn";
+            m68k_instruction [0xc118 | (reg_a << 9) | reg_b] = "m68k_c118_and_b_anp_dn";
+            m68k_instruction [0xc120 | (reg_a << 9) | reg_b] = "m68k_c120_and_b_pan_dn";
+            m68k_instruction [0xc128 | (reg_a << 9) | reg_b] = "m68k_c128_and_b_dan_dn";
+            m68k_instruction [0xc130 | (reg_a << 9) | reg_b] = "m68k_c130_and_b_danxi_dn";
+            m68k_instruction [0xc150 | (reg_a << 9) | reg_b] = "m68k_c150_and_w_an_dn";
+            m68k_instruction [0xc158 | (reg_a << 9) | reg_b] = "m68k_c158_and_w_anp_dn";
+            m68k_instruction [0xc160 | (reg_a << 9) | reg_b] = "m68k_c160_and_w_pan_dn";
+            m68k_instruction [0xc168 | (reg_a << 9) | reg_b] = "m68k_c168_and_w_dan_dn";
+            m68k_instruction [0xc170 | (reg_a << 9) | reg_b] = "m68k_c170_and_w_danxi_dn";
+            m68k_instruction [0xc190 | (reg_a << 9) | reg_b] = "m68k_c190_and_l_an_dn";
+            m68k_instruction [0xc198 | (reg_a << 9) | reg_b] = "m68k_c198_and_l_anp_dn";
+            m68k_instruction [0xc1a0 | (reg_a << 9) | reg_b] = "m68k_c1a0_and_l_pan_dn";
+            m68k_instruction [0xc1a8 | (reg_a << 9) | reg_b] = "m68k_c1a8_and_l_dan_dn";
+            m68k_instruction [0xc1b0 | (reg_a << 9) | reg_b] = "m68k_c1b0_and_l_danxi_dn";
+        }
+        m68k_instruction [0xc038 | (reg_a << 9)] = "m68k_c038_and_b_dn_aw";
+        m68k_instruction [0xc039 | (reg_a << 9)] = "m68k_c039_and_b_dn_al";
+        m68k_instruction [0xc03a | (reg_a << 9)] = "m68k_c03a_and_b_dn_dpc";
+        m68k_instruction [0xc03b | (reg_a << 9)] = "m68k_c03b_and_b_dn_dpcxi";
+        m68k_instruction [0xc03c | (reg_a << 9)] = "m68k_c03c_and_b_dn_imm";
+        m68k_instruction [0xc078 | (reg_a << 9)] = "m68k_c078_and_w_dn_aw";
+        m68k_instruction [0xc079 | (reg_a << 9)] = "m68k_c079_and_w_dn_al";
+        m68k_instruction [0xc07a | (reg_a << 9)] = "m68k_c07a_and_w_dn_dpc";
+        m68k_instruction [0xc07b | (reg_a << 9)] = "m68k_c07b_and_w_dn_dpcxi";
+        m68k_instruction [0xc07c | (reg_a << 9)] = "m68k_c07c_and_w_dn_imm";
+        m68k_instruction [0xc0b8 | (reg_a << 9)] = "m68k_c0b8_and_l_dn_aw";
+        m68k_instruction [0xc0b9 | (reg_a << 9)] = "m68k_c0b9_and_l_dn_al";
+        m68k_instruction [0xc0ba | (reg_a << 9)] = "m68k_c0ba_and_l_dn_dpc";
+        m68k_instruction [0xc0bb | (reg_a << 9)] = "m68k_c0bb_and_l_dn_dpcxi";
+        m68k_instruction [0xc0bc | (reg_a << 9)] = "m68k_c0bc_and_l_dn_imm";
+        m68k_instruction [0xc138 | (reg_a << 9)] = "m68k_c138_and_b_aw_dn";
+        m68k_instruction [0xc139 | (reg_a << 9)] = "m68k_c139_and_b_al_dn";
+        m68k_instruction [0xc178 | (reg_a << 9)] = "m68k_c178_and_w_aw_dn";
+        m68k_instruction [0xc179 | (reg_a << 9)] = "m68k_c179_and_w_al_dn";
+        m68k_instruction [0xc1b8 | (reg_a << 9)] = "m68k_c1b8_and_l_aw_dn";
+        m68k_instruction [0xc1b9 | (reg_a << 9)] = "m68k_c1b9_and_l_al_dn";
+    }
+
+    /* exg */
+    for (uint16_t reg_x = 0; reg_x < 8; reg_x++)
+    {
+        for (uint16_t reg_y = 0; reg_y < 8; reg_y++)
+        {
+            m68k_instruction [0xc140 | (reg_x << 9) | reg_y] = "m68k_c140_exg_l_dn_dn";
+        }
+    }
+
+    /* muls / mulu */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        for (uint16_t ea = 0; ea < 8; ea++)
+        {
+            m68k_instruction [0xc0c0 | (reg << 9) | ea] = "m68k_c0c0_mulu_w_dn_dn";
+            m68k_instruction [0xc0d0 | (reg << 9) | ea] = "m68k_c0d0_mulu_w_dn_an";
+            m68k_instruction [0xc0d8 | (reg << 9) | ea] = "m68k_c0d8_mulu_w_dn_anp";
+            m68k_instruction [0xc0e0 | (reg << 9) | ea] = "m68k_c0e0_mulu_w_dn_pan";
+            m68k_instruction [0xc0e8 | (reg << 9) | ea] = "m68k_c0e8_mulu_w_dn_dan";
+            m68k_instruction [0xc0f0 | (reg << 9) | ea] = "m68k_c0f0_mulu_w_dn_danxi";
+            m68k_instruction [0xc1c0 | (reg << 9) | ea] = "m68k_c1c0_muls_w_dn_dn";
+            m68k_instruction [0xc1d0 | (reg << 9) | ea] = "m68k_c1d0_muls_w_dn_an";
+            m68k_instruction [0xc1d8 | (reg << 9) | ea] = "m68k_c1d8_muls_w_dn_anp";
+            m68k_instruction [0xc1e0 | (reg << 9) | ea] = "m68k_c1e0_muls_w_dn_pan";
+            m68k_instruction [0xc1e8 | (reg << 9) | ea] = "m68k_c1e8_muls_w_dn_dan";
+            m68k_instruction [0xc1f0 | (reg << 9) | ea] = "m68k_c1f0_muls_w_dn_danxi";
+        }
+        m68k_instruction [0xc0f8 | (reg << 9)] = "m68k_c0f8_mulu_w_dn_aw";
+        m68k_instruction [0xc0f9 | (reg << 9)] = "m68k_c0f9_mulu_w_dn_al";
+        m68k_instruction [0xc0fa | (reg << 9)] = "m68k_c0fa_mulu_w_dn_dpc";
+        m68k_instruction [0xc0fb | (reg << 9)] = "m68k_c0fb_mulu_w_dn_dpcxi";
+        m68k_instruction [0xc0fc | (reg << 9)] = "m68k_c0fc_mulu_w_dn_imm";
+        m68k_instruction [0xc1f8 | (reg << 9)] = "m68k_c1f8_muls_w_dn_aw";
+        m68k_instruction [0xc1f9 | (reg << 9)] = "m68k_c1f9_muls_w_dn_al";
+        m68k_instruction [0xc1fa | (reg << 9)] = "m68k_c1fa_muls_w_dn_dpc";
+        m68k_instruction [0xc1fb | (reg << 9)] = "m68k_c1fb_muls_w_dn_dpcxi";
+        m68k_instruction [0xc1fc | (reg << 9)] = "m68k_c1fc_muls_w_dn_imm";
+    }
+
+    /* add */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        for (uint16_t ea = 0; ea < 8; ea++)
+        {
+            m68k_instruction [0xd000 | (reg << 9) | ea] = "m68k_d000_add_b_dn_dn";
+            m68k_instruction [0xd010 | (reg << 9) | ea] = "m68k_d010_add_b_dn_an";
+            m68k_instruction [0xd018 | (reg << 9) | ea] = "m68k_d018_add_b_dn_anp";
+            m68k_instruction [0xd020 | (reg << 9) | ea] = "m68k_d020_add_b_dn_pan";
+            m68k_instruction [0xd028 | (reg << 9) | ea] = "m68k_d028_add_b_dn_dan";
+            m68k_instruction [0xd030 | (reg << 9) | ea] = "m68k_d030_add_b_dn_danxi";
+            m68k_instruction [0xd040 | (reg << 9) | ea] = "m68k_d040_add_w_dn_dn";
+            m68k_instruction [0xd048 | (reg << 9) | ea] = "m68k_d048_add_w_dn_an";
+            m68k_instruction [0xd050 | (reg << 9) | ea] = "m68k_d050_add_w_dn_an";
+            m68k_instruction [0xd058 | (reg << 9) | ea] = "m68k_d058_add_w_dn_anp";
+            m68k_instruction [0xd060 | (reg << 9) | ea] = "m68k_d060_add_w_dn_pan";
+            m68k_instruction [0xd068 | (reg << 9) | ea] = "m68k_d068_add_w_dn_dan";
+            m68k_instruction [0xd070 | (reg << 9) | ea] = "m68k_d070_add_w_dn_danxi";
+            m68k_instruction [0xd080 | (reg << 9) | ea] = "m68k_d080_add_l_dn_dn";
+            m68k_instruction [0xd088 | (reg << 9) | ea] = "m68k_d088_add_l_dn_an";
+            m68k_instruction [0xd090 | (reg << 9) | ea] = "m68k_d090_add_l_dn_an";
+            m68k_instruction [0xd098 | (reg << 9) | ea] = "m68k_d098_add_l_dn_anp";
+            m68k_instruction [0xd0a0 | (reg << 9) | ea] = "m68k_d0a0_add_l_dn_pan";
+            m68k_instruction [0xd0a8 | (reg << 9) | ea] = "m68k_d0a8_add_l_dn_dan";
+            m68k_instruction [0xd0b0 | (reg << 9) | ea] = "m68k_d0b0_add_l_dn_danxi";
+            m68k_instruction [0xd0c0 | (reg << 9) | ea] = "m68k_d0c0_adda_w_an_dn";
+            m68k_instruction [0xd0c8 | (reg << 9) | ea] = "m68k_d0c8_adda_w_an_an";
+            m68k_instruction [0xd0d0 | (reg << 9) | ea] = "m68k_d0d0_adda_w_an_an";
+            m68k_instruction [0xd0d8 | (reg << 9) | ea] = "m68k_d0d8_adda_w_an_anp";
+            m68k_instruction [0xd0e0 | (reg << 9) | ea] = "m68k_d0e0_adda_w_an_pan";
+            m68k_instruction [0xd0e8 | (reg << 9) | ea] = "m68k_d0e8_adda_w_an_dan";
+            m68k_instruction [0xd0f0 | (reg << 9) | ea] = "m68k_d0f0_adda_w_an_danxi";
+            m68k_instruction [0xd110 | (reg << 9) | ea] = "m68k_d110_add_b_an_dn";
+            m68k_instruction [0xd118 | (reg << 9) | ea] = "m68k_d118_add_b_anp_dn";
+            m68k_instruction [0xd120 | (reg << 9) | ea] = "m68k_d120_add_b_pan_dn";
+            m68k_instruction [0xd128 | (reg << 9) | ea] = "m68k_d128_add_b_dan_dn";
+            m68k_instruction [0xd130 | (reg << 9) | ea] = "m68k_d130_add_b_danxi_dn";
+            m68k_instruction [0xd150 | (reg << 9) | ea] = "m68k_d150_add_w_an_dn";
+            m68k_instruction [0xd158 | (reg << 9) | ea] = "m68k_d158_add_w_anp_dn";
+            m68k_instruction [0xd160 | (reg << 9) | ea] = "m68k_d160_add_w_pan_dn";
+            m68k_instruction [0xd168 | (reg << 9) | ea] = "m68k_d168_add_w_dan_dn";
+            m68k_instruction [0xd170 | (reg << 9) | ea] = "m68k_d170_add_w_danxi_dn";
+            m68k_instruction [0xd190 | (reg << 9) | ea] = "m68k_d190_add_l_an_dn";
+            m68k_instruction [0xd198 | (reg << 9) | ea] = "m68k_d198_add_l_anp_dn";
+            m68k_instruction [0xd1a0 | (reg << 9) | ea] = "m68k_d1a0_add_l_pan_dn";
+            m68k_instruction [0xd1a8 | (reg << 9) | ea] = "m68k_d1a8_add_l_dan_dn";
+            m68k_instruction [0xd1b0 | (reg << 9) | ea] = "m68k_d1b0_add_l_danxi_dn";
+            m68k_instruction [0xd1c0 | (reg << 9) | ea] = "m68k_d1c0_adda_l_an_dn";
+            m68k_instruction [0xd1c8 | (reg << 9) | ea] = "m68k_d1c8_adda_l_an_an";
+            m68k_instruction [0xd1d0 | (reg << 9) | ea] = "m68k_d1d0_adda_l_an_an";
+            m68k_instruction [0xd1d8 | (reg << 9) | ea] = "m68k_d1d8_adda_l_an_anp";
+            m68k_instruction [0xd1e0 | (reg << 9) | ea] = "m68k_d1e0_adda_l_an_pan";
+            m68k_instruction [0xd1e8 | (reg << 9) | ea] = "m68k_d1e8_adda_l_an_dan";
+            m68k_instruction [0xd1f0 | (reg << 9) | ea] = "m68k_d1f0_adda_l_an_danxi";
+        }
+        m68k_instruction [0xd038 | (reg << 9)] = "m68k_d038_add_b_dn_aw";
+        m68k_instruction [0xd039 | (reg << 9)] = "m68k_d039_add_b_dn_al";
+        m68k_instruction [0xd03a | (reg << 9)] = "m68k_d03a_add_b_dn_dpc";
+        m68k_instruction [0xd03b | (reg << 9)] = "m68k_d03b_add_b_dn_dpcxi";
+        m68k_instruction [0xd03c | (reg << 9)] = "m68k_d03c_add_b_dn_imm";
+        m68k_instruction [0xd078 | (reg << 9)] = "m68k_d078_add_w_dn_aw";
+        m68k_instruction [0xd079 | (reg << 9)] = "m68k_d079_add_w_dn_al";
+        m68k_instruction [0xd07a | (reg << 9)] = "m68k_d07a_add_w_dn_dpc";
+        m68k_instruction [0xd07b | (reg << 9)] = "m68k_d07b_add_w_dn_dpcxi";
+        m68k_instruction [0xd07c | (reg << 9)] = "m68k_d07c_add_w_dn_imm";
+        m68k_instruction [0xd0b8 | (reg << 9)] = "m68k_d0b8_add_l_dn_aw";
+        m68k_instruction [0xd0b9 | (reg << 9)] = "m68k_d0b9_add_l_dn_al";
+        m68k_instruction [0xd0ba | (reg << 9)] = "m68k_d0ba_add_l_dn_dpc";
+        m68k_instruction [0xd0bb | (reg << 9)] = "m68k_d0bb_add_l_dn_dpcxi";
+        m68k_instruction [0xd0bc | (reg << 9)] = "m68k_d0bc_add_l_dn_imm";
+        m68k_instruction [0xd0f8 | (reg << 9)] = "m68k_d0f8_adda_w_an_aw";
+        m68k_instruction [0xd0f9 | (reg << 9)] = "m68k_d0f9_adda_w_an_al";
+        m68k_instruction [0xd0fa | (reg << 9)] = "m68k_d0fa_adda_w_an_dpc";
+        m68k_instruction [0xd0fb | (reg << 9)] = "m68k_d0fb_adda_w_an_dpcxi";
+        m68k_instruction [0xd0fc | (reg << 9)] = "m68k_d0fc_adda_w_an_imm";
+        m68k_instruction [0xd138 | (reg << 9)] = "m68k_d138_add_b_aw_dn";
+        m68k_instruction [0xd139 | (reg << 9)] = "m68k_d139_add_b_al_dn";
+        m68k_instruction [0xd178 | (reg << 9)] = "m68k_d178_add_w_aw_dn";
+        m68k_instruction [0xd179 | (reg << 9)] = "m68k_d179_add_w_al_dn";
+        m68k_instruction [0xd1b8 | (reg << 9)] = "m68k_d1b8_add_l_aw_dn";
+        m68k_instruction [0xd1b9 | (reg << 9)] = "m68k_d1b9_add_l_al_dn";
+        m68k_instruction [0xd1f8 | (reg << 9)] = "m68k_d1f8_adda_l_an_aw";
+        m68k_instruction [0xd1f9 | (reg << 9)] = "m68k_d1f9_adda_l_an_al";
+        m68k_instruction [0xd1fa | (reg << 9)] = "m68k_d1fa_adda_l_an_dpc";
+        m68k_instruction [0xd1fb | (reg << 9)] = "m68k_d1fb_adda_l_an_dpcxi";
+        m68k_instruction [0xd1fc | (reg << 9)] = "m68k_d1fc_adda_l_an_imm";
+    }
+
+    /* shift / rotate */
+    for (uint16_t reg = 0; reg < 8; reg++)
+    {
+        for (uint16_t count = 0; count < 8; count++)
+        {
+            m68k_instruction [0xe000 | (count << 9) | reg] = "m68k_e000_asr_b_dn_imm";
+            m68k_instruction [0xe008 | (count << 9) | reg] = "m68k_e008_lsr_b_dn_imm";
+            m68k_instruction [0xe018 | (count << 9) | reg] = "m68k_e018_ror_b_dn_imm";
+            m68k_instruction [0xe020 | (count << 9) | reg] = "m68k_e020_asr_b_dn_dn";
+            m68k_instruction [0xe028 | (count << 9) | reg] = "m68k_e028_lsr_b_dn_dn";
+            m68k_instruction [0xe038 | (count << 9) | reg] = "m68k_e038_ror_b_dn_dn";
+            m68k_instruction [0xe040 | (count << 9) | reg] = "m68k_e040_asr_w_dn_imm";
+            m68k_instruction [0xe048 | (count << 9) | reg] = "m68k_e048_lsr_w_dn_imm";
+            m68k_instruction [0xe058 | (count << 9) | reg] = "m68k_e058_ror_w_dn_imm";
+            m68k_instruction [0xe060 | (count << 9) | reg] = "m68k_e060_asr_w_dn_dn";
+            m68k_instruction [0xe068 | (count << 9) | reg] = "m68k_e068_lsr_w_dn_dn";
+            m68k_instruction [0xe078 | (count << 9) | reg] = "m68k_e078_ror_w_dn_dn";
+            m68k_instruction [0xe080 | (count << 9) | reg] = "m68k_e080_asr_l_dn_imm";
+            m68k_instruction [0xe088 | (count << 9) | reg] = "m68k_e088_lsr_l_dn_imm";
+            m68k_instruction [0xe098 | (count << 9) | reg] = "m68k_e098_ror_l_dn_imm";
+            m68k_instruction [0xe0a0 | (count << 9) | reg] = "m68k_e0a0_asr_l_dn_dn";
+            m68k_instruction [0xe0a8 | (count << 9) | reg] = "m68k_e0a8_lsr_l_dn_dn";
+            m68k_instruction [0xe0b8 | (count << 9) | reg] = "m68k_e0b8_ror_l_dn_dn";
+            m68k_instruction [0xe100 | (count << 9) | reg] = "m68k_e100_asl_b_dn_imm";
+            m68k_instruction [0xe108 | (count << 9) | reg] = "m68k_e108_lsl_b_dn_imm";
+            m68k_instruction [0xe118 | (count << 9) | reg] = "m68k_e118_rol_b_dn_imm";
+            m68k_instruction [0xe120 | (count << 9) | reg] = "m68k_e120_asl_b_dn_dn";
+            m68k_instruction [0xe128 | (count << 9) | reg] = "m68k_e128_lsl_b_dn_dn";
+            m68k_instruction [0xe138 | (count << 9) | reg] = "m68k_e138_rol_b_dn_dn";
+            m68k_instruction [0xe140 | (count << 9) | reg] = "m68k_e140_asl_w_dn_imm";
+            m68k_instruction [0xe148 | (count << 9) | reg] = "m68k_e148_lsl_w_dn_imm";
+            m68k_instruction [0xe150 | (count << 9) | reg] = "m68k_e150_roxl_w_dn_imm";
+            m68k_instruction [0xe158 | (count << 9) | reg] = "m68k_e158_rol_w_dn_imm";
+            m68k_instruction [0xe160 | (count << 9) | reg] = "m68k_e160_asl_w_dn_dn";
+            m68k_instruction [0xe168 | (count << 9) | reg] = "m68k_e168_lsl_w_dn_dn";
+            m68k_instruction [0xe178 | (count << 9) | reg] = "m68k_e178_rol_w_dn_dn";
+            m68k_instruction [0xe180 | (count << 9) | reg] = "m68k_e180_asl_l_dn_imm";
+            m68k_instruction [0xe188 | (count << 9) | reg] = "m68k_e188_lsl_l_dn_imm";
+            m68k_instruction [0xe198 | (count << 9) | reg] = "m68k_e198_rol_l_dn_imm";
+            m68k_instruction [0xe1a0 | (count << 9) | reg] = "m68k_e1a0_asl_l_dn_dn";
+            m68k_instruction [0xe1a8 | (count << 9) | reg] = "m68k_e1a8_lsl_l_dn_dn";
+            m68k_instruction [0xe1b8 | (count << 9) | reg] = "m68k_e1b8_rol_l_dn_dn";
+        }
+        m68k_instruction [0xe0d0 | reg] = "m68k_e0d0_asr_w_an";
+        m68k_instruction [0xe0d8 | reg] = "m68k_e0d8_asr_w_anp";
+        m68k_instruction [0xe0e0 | reg] = "m68k_e0e0_asr_w_pan";
+        m68k_instruction [0xe0e8 | reg] = "m68k_e0e8_asr_w_dan";
+        m68k_instruction [0xe0f0 | reg] = "m68k_e0f0_asr_w_danxi";
+        m68k_instruction [0xe1d0 | reg] = "m68k_e1d0_asl_w_an";
+        m68k_instruction [0xe1d8 | reg] = "m68k_e1d8_asl_w_anp";
+        m68k_instruction [0xe1e0 | reg] = "m68k_e1e0_asl_w_pan";
+        m68k_instruction [0xe1e8 | reg] = "m68k_e1e8_asl_w_dan";
+        m68k_instruction [0xe1f0 | reg] = "m68k_e1f0_asl_w_danxi";
+        m68k_instruction [0xe2d0 | reg] = "m68k_e2d0_lsr_w_an";
+        m68k_instruction [0xe2d8 | reg] = "m68k_e2d8_lsr_w_anp";
+        m68k_instruction [0xe2e0 | reg] = "m68k_e2e0_lsr_w_pan";
+        m68k_instruction [0xe2e8 | reg] = "m68k_e2e8_lsr_w_dan";
+        m68k_instruction [0xe2f0 | reg] = "m68k_e2f0_lsr_w_danxi";
+        m68k_instruction [0xe3d0 | reg] = "m68k_e3d0_lsl_w_an";
+        m68k_instruction [0xe3d8 | reg] = "m68k_e3d8_lsl_w_anp";
+        m68k_instruction [0xe3e0 | reg] = "m68k_e3e0_lsl_w_pan";
+        m68k_instruction [0xe3e8 | reg] = "m68k_e3e8_lsl_w_dan";
+        m68k_instruction [0xe3f0 | reg] = "m68k_e3f0_lsl_w_danxi";
+        m68k_instruction [0xe6d0 | reg] = "m68k_e6d0_ror_w_an";
+        m68k_instruction [0xe6d8 | reg] = "m68k_e6d8_ror_w_anp";
+        m68k_instruction [0xe6e0 | reg] = "m68k_e6e0_ror_w_pan";
+        m68k_instruction [0xe6e8 | reg] = "m68k_e6e8_ror_w_dan";
+        m68k_instruction [0xe6f0 | reg] = "m68k_e6f0_ror_w_danxi";
+        m68k_instruction [0xe7d0 | reg] = "m68k_e7d0_rol_w_an";
+        m68k_instruction [0xe7d8 | reg] = "m68k_e7d8_rol_w_anp";
+        m68k_instruction [0xe7e0 | reg] = "m68k_e7e0_rol_w_pan";
+        m68k_instruction [0xe7e8 | reg] = "m68k_e7e8_rol_w_dan";
+        m68k_instruction [0xe7f0 | reg] = "m68k_e7f0_rol_w_danxi";
+    }
+    m68k_instruction [0xe0f8] = "m68k_e0f8_asr_w_aw";
+    m68k_instruction [0xe0f9] = "m68k_e0f9_asr_w_al";
+    m68k_instruction [0xe1f8] = "m68k_e1f8_asl_w_aw";
+    m68k_instruction [0xe1f9] = "m68k_e1f9_asl_w_al";
+    m68k_instruction [0xe2f8] = "m68k_e2f8_lsr_w_aw";
+    m68k_instruction [0xe2f9] = "m68k_e2f9_lsr_w_al";
+    m68k_instruction [0xe3f8] = "m68k_e3f8_lsl_w_aw";
+    m68k_instruction [0xe3f9] = "m68k_e3f9_lsl_w_al";
+    m68k_instruction [0xe6f8] = "m68k_e6f8_ror_w_aw";
+    m68k_instruction [0xe6f9] = "m68k_e6f9_ror_w_al";
+    m68k_instruction [0xe7f8] = "m68k_e7f8_rol_w_aw";
+    m68k_instruction [0xe7f9] = "m68k_e7f9_rol_w_al";
+
+    /* Line-F exception */
+    for (uint32_t i = 0x0000; i <= 0x0fff; i++)
+    {
+        m68k_instruction [0xf000 | i] = "m68k_f000_line_f";
+    }
+}
+
+
+/*
+ * Decode the six-bit mode and register field of an effective address.
+ */
+static M68000_EA_Mode ea_mode (uint16_t ea)
+{
+    uint16_t mode = (ea >> 3) & 0x07;
+    uint16_t reg = ea & 0x07;
+
+    if (mode < 7)
+    {
+        return (M68000_EA_Mode) mode;
+    }
+
+    return (reg <= 4) ? (M68000_EA_Mode) (EA_ABS_W + reg) : EA_INVALID;
+}
+
+
+#define MNEMONIC_IS(M) (strcmp (mnemonic, M) == 0)
+
+/*
+ * Calculate the base number of clock cycles used by an opcode.
+ * Returns 0 if the instruction's timing is not known.
+ *
+ * Timing is taken from the M68000 User's Manual, section 8.
+ */
+static uint32_t m68k_opcode_cycles (uint16_t opcode, const char *name)
+{
+    char mnemonic [16] = { '\0' };
+    M68000_EA_Mode ea = ea_mode (opcode & 0x3f);
+
+    /* Handler names take the form m68k_<opcode>_<mnemonic>_<size>_<operands> */
+    sscanf (name, "m68k_%*4x_%15[a-z]", mnemonic);
+    const char *size = name + strlen ("m68k_0000_") + strlen (mnemonic);
+    bool is_long = (strncmp (size, "_l", 2) == 0) && (size [2] == '_' || size [2] == '\0');
+    uint32_t ea_time = ea_cycles [ea] [is_long];
+
+    /* Conditional instructions share an opcode pattern, but have many mnemonics */
+    if ((opcode & 0xf0f8) == 0x50c8)
+    {
+        /* DBcc: The handler adds 2 if the condition is true, or 4 if the counter expires */
+        return 10;
+    }
+    else if ((opcode & 0xf0c0) == 0x50c0)
+    {
+        /* Scc: The handler adds 2 when setting a data register */
+        return (ea == EA_DN) ? 4 : 8 + ea_time;
+    }
+    else if ((opcode & 0xf000) == 0x6000)
+    {
+        if (MNEMONIC_IS ("bsr"))
+        {
+            return 18;
+        }
+        else if (MNEMONIC_IS ("bra"))
+        {
+            return 10;
+        }
+
+        /* Bcc: For byte displacements, the handler adds 2 if the branch is
+         *      taken. For word displacements, it adds 2 if not taken. */
+        return (opcode & 0x00ff) ? 8 : 10;
+    }
+
+    /* Data movement */
+    if (MNEMONIC_IS ("move") || MNEMONIC_IS ("movea"))
+    {
+        if ((opcode & 0xf000) != 0x4000)
+        {
+            /* Writing to -(An) does not take the extra cycles of reading from it */
+            M68000_EA_Mode dest = ea_mode (((opcode >> 3) & 0x38) | ((opcode >> 9) & 0x07));
+            if (dest == EA_AN_PRE)
+            {
+                dest = EA_AN_IND;
+            }
+            return 4 + ea_time + ea_cycles [dest] [is_long];
+        }
+        else if ((opcode & 0xffc0) == 0x40c0)
+        {
+            /* move from SR */
+            return (ea == EA_DN) ? 6 : 8 + ea_time;
+        }
+        else if ((opcode & 0xfff0) == 0x4e60)
+        {
+            /* move to / from USP */
+            return 4;
+        }
+
+        /* move to CCR / SR */
+        return 12 + ea_time;
+    }
+    else if (MNEMONIC_IS ("moveq") || MNEMONIC_IS ("ext") || MNEMONIC_IS ("swap") || MNEMONIC_IS ("nop"))
+    {
+        return 4;
+    }
+    else if (MNEMONIC_IS ("exg"))
+    {
+        return 6;
+    }
+    else if (MNEMONIC_IS ("movem"))
+    {
+        /* The handler adds 4 per register for words, and 8 for longs */
+        return (opcode & 0x0400) ? movem_read_cycles [ea] : movem_write_cycles [ea];
+    }
+    else if (MNEMONIC_IS ("movep"))
+    {
+        return is_long ? 24 : 16;
+    }
+
+    /* Arithmetic and logic */
+    if (MNEMONIC_IS ("add") || MNEMONIC_IS ("sub") || MNEMONIC_IS ("and") ||
+        MNEMONIC_IS ("or")  || MNEMONIC_IS ("eor") || MNEMONIC_IS ("cmp"))
+    {
+        if (opcode & 0x0100)
+        {
+            /* Dn is the source */
+            if (ea == EA_DN)
+            {
+                return is_long ? 8 : 4;
+            }
+            return (is_long ? 12 : 8) + ea_time;
+        }
+        else if (is_long && !MNEMONIC_IS ("cmp") && (ea == EA_DN || ea == EA_AN || ea == EA_IMM))
+        {
+            return 8 + ea_time;
+        }
+        return (is_long ? 6 : 4) + ea_time;
+    }
+    else if (MNEMONIC_IS ("adda") || MNEMONIC_IS ("suba"))
+    {
+        if (is_long)
+        {
+            return ((ea == EA_DN || ea == EA_AN || ea == EA_IMM) ? 8 : 6) + ea_time;
+        }
+        return 8 + ea_time;
+    }
+    else if (MNEMONIC_IS ("cmpa"))
+    {
+        return 6 + ea_time;
+    }
+    else if (MNEMONIC_IS ("addi") || MNEMONIC_IS ("subi") || MNEMONIC_IS ("andi") ||
+             MNEMONIC_IS ("ori")  || MNEMONIC_IS ("eori") || MNEMONIC_IS ("cmpi"))
+    {
+        if ((opcode & 0x3f) == 0x3c)
+        {
+            /* To CCR / SR */
+            return 20;
+        }
+        else if (ea == EA_DN)
+        {
+            if (is_long)
+            {
+                return (MNEMONIC_IS ("andi") || MNEMONIC_IS ("cmpi")) ? 14 : 16;
+            }
+            return 8;
+        }
+        else if (MNEMONIC_IS ("cmpi"))
+        {
+            return (is_long ? 12 : 8) + ea_time;
+        }
+        return (is_long ? 20 : 12) + ea_time;
+    }
+    else if (MNEMONIC_IS ("addq") || MNEMONIC_IS ("subq"))
+    {
+        if (ea == EA_DN)
+        {
+            return is_long ? 8 : 4;
+        }
+        else if (ea == EA_AN)
+        {
+            return 8;
+        }
+        return (is_long ? 12 : 8) + ea_time;
+    }
+    else if (MNEMONIC_IS ("clr") || MNEMONIC_IS ("neg") || MNEMONIC_IS ("not"))
+    {
+        if (ea == EA_DN)
+        {
+            return is_long ? 6 : 4;
+        }
+        return (is_long ? 12 : 8) + ea_time;
+    }
+    else if (MNEMONIC_IS ("tst"))
+    {
+        return 4 + ea_time;
+    }
+    else if (MNEMONIC_IS ("mulu") || MNEMONIC_IS ("muls"))
+    {
+        /* The handler adds 2 per bit of the source operand */
+        return 38 + ea_time;
+    }
+    else if (MNEMONIC_IS ("divu"))
+    {
+        /* Worst case */
+        return 140 + ea_time;
+    }
+    else if (MNEMONIC_IS ("divs"))
+    {
+        /* Worst case */
+        return 158 + ea_time;
+    }
+
+    /* Shift and rotate */
+    if (MNEMONIC_IS ("asl")  || MNEMONIC_IS ("asr")  || MNEMONIC_IS ("lsl")  || MNEMONIC_IS ("lsr") ||
+        MNEMONIC_IS ("rol")  || MNEMONIC_IS ("ror")  || MNEMONIC_IS ("roxl") || MNEMONIC_IS ("roxr"))
+    {
+        if ((opcode & 0x00c0) == 0x00c0)
+        {
+            /* Memory, shifted by one bit */
+            return 8 + ea_time;
+        }
+        else if (opcode & 0x0020)
+        {
+            /* The handler adds 2 per bit of the count register */
+            return is_long ? 8 : 6;
+        }
+
+        uint32_t count = ((opcode >> 9) & 0x07) ? ((opcode >> 9) & 0x07) : 8;
+        return (is_long ? 8 : 6) + 2 * count;
+    }
+
+    /* Bit manipulation. Times for data registers are for bit numbers above 15. */
+    if (MNEMONIC_IS ("btst") || MNEMONIC_IS ("bchg") || MNEMONIC_IS ("bclr") || MNEMONIC_IS ("bset"))
+    {
+        /* Static instructions have their bit number in an extension word */
+        uint32_t bit_number_time = (opcode & 0x0100) ? 0 : 4;
+
+        if (ea == EA_DN)
+        {
+            return bit_number_time + (MNEMONIC_IS ("btst") ? 6 : MNEMONIC_IS ("bclr") ? 10 : 8);
+        }
+        return bit_number_time + (MNEMONIC_IS ("btst") ? 4 : 8) + ea_time;
+    }
+
+    /* Program control */
+    if (MNEMONIC_IS ("jmp"))
+    {
+        return jmp_cycles [ea];
+    }
+    else if (MNEMONIC_IS ("jsr"))
+    {
+        return jsr_cycles [ea];
+    }
+    else if (MNEMONIC_IS ("lea"))
+    {
+        return lea_cycles [ea];
+    }
+    else if (MNEMONIC_IS ("pea"))
+    {
+        return pea_cycles [ea];
+    }
+    else if (MNEMONIC_IS ("link"))
+    {
+        return 16;
+    }
+    else if (MNEMONIC_IS ("unlink"))
+    {
+        return 12;
+    }
+    else if (MNEMONIC_IS ("rts"))
+    {
+        return 16;
+    }
+    else if (MNEMONIC_IS ("rte"))
+    {
+        return 20;
+    }
+
+    /* Exceptions */
+    if (MNEMONIC_IS ("trapv"))
+    {
+        /* The handler adds 30 if the exception is taken */
+        return 4;
+    }
+    else if (MNEMONIC_IS ("trap") || MNEMONIC_IS ("line"))
+    {
+        return 34;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Select the compact core's handler for an opcode.
+ * Returns NULL if there is no compact handler for the instruction.
+ */
+static const char *m68k_compact_handler (uint16_t opcode, const char *name)
+{
+    static char handler [32];
+    char mnemonic [16] = { '\0' };
+    char size = '\0';
+    M68000_EA_Mode ea = ea_mode (opcode & 0x3f);
+
+    sscanf (name, "m68k_%*4x_%15[a-z]", mnemonic);
+    const char *suffix = name + strlen ("m68k_0000_") + strlen (mnemonic);
+    if (suffix [0] == '_' && suffix [1] != '\0' && strchr ("bwl", suffix [1]) != NULL &&
+        (suffix [2] == '_' || suffix [2] == '\0'))
+    {
+        size = suffix [1];
+    }
+
+    /* Conditional instructions take the condition from the opcode */
+    if ((opcode & 0xf0f8) == 0x50c8)
+    {
+        return "m68k_dbcc";
+    }
+    else if ((opcode & 0xf0c0) == 0x50c0)
+    {
+        return "m68k_scc";
+    }
+    else if ((opcode & 0xf000) == 0x6000)
+    {
+        snprintf (handler, sizeof (handler), "m68k_%s_%s",
+                  ((opcode & 0x0f00) == 0x0000) ? "bra" :
+                  ((opcode & 0x0f00) == 0x0100) ? "bsr" : "bcc",
+                  (opcode & 0x00ff) ? "s" : "w");
+        return handler;
+    }
+
+    /* Instructions with a handler per size */
+    if (MNEMONIC_IS ("ori") || MNEMONIC_IS ("andi") || MNEMONIC_IS ("eori"))
+    {
+        if (ea == EA_IMM)
+        {
+            snprintf (handler, sizeof (handler), "m68k_%s_%s", mnemonic, (size == 'b') ? "ccr" : "sr");
+        }
+        else
+        {
+            snprintf (handler, sizeof (handler), "m68k_%s_%c", mnemonic, size);
+        }
+        return handler;
+    }
+    else if ((MNEMONIC_IS ("addq") || MNEMONIC_IS ("subq")) && ea == EA_AN)
+    {
+        snprintf (handler, sizeof (handler), "m68k_%s_an", mnemonic);
+        return handler;
+    }
+    else if (MNEMONIC_IS ("subi") || MNEMONIC_IS ("addi") || MNEMONIC_IS ("cmpi") ||
+             MNEMONIC_IS ("addq") || MNEMONIC_IS ("subq") ||
+             MNEMONIC_IS ("clr")  || MNEMONIC_IS ("neg")  || MNEMONIC_IS ("not") || MNEMONIC_IS ("tst") ||
+             MNEMONIC_IS ("ext")  || MNEMONIC_IS ("cmp")  || MNEMONIC_IS ("eor") ||
+             MNEMONIC_IS ("adda") || MNEMONIC_IS ("suba") || MNEMONIC_IS ("cmpa") ||
+             MNEMONIC_IS ("movea") || (MNEMONIC_IS ("move") && (opcode & 0xf000) != 0x4000))
+    {
+        snprintf (handler, sizeof (handler), "m68k_%s_%c", mnemonic, size);
+        return handler;
+    }
+    else if (MNEMONIC_IS ("add") || MNEMONIC_IS ("sub") || MNEMONIC_IS ("and") || MNEMONIC_IS ("or"))
+    {
+        /* Bit 8 selects whether the data register is the source or destination */
+        snprintf (handler, sizeof (handler), "m68k_%s_%c_%s", mnemonic, size, (opcode & 0x0100) ? "ea_dn" : "dn_ea");
+        return handler;
+    }
+    else if (MNEMONIC_IS ("movem"))
+    {
+        snprintf (handler, sizeof (handler), "m68k_movem_%c_%s", size, (opcode & 0x0400) ? "regs_ea" : "ea_regs");
+        return handler;
+    }
+    else if (MNEMONIC_IS ("movep"))
+    {
+        snprintf (handler, sizeof (handler), "m68k_movep_%c_%s", size, (opcode & 0x0080) ? "dan_dn" : "dn_dan");
+        return handler;
+    }
+
+    /* Bit manipulation, with the bit number from a data register or an extension word */
+    if (MNEMONIC_IS ("btst") || MNEMONIC_IS ("bchg") || MNEMONIC_IS ("bclr") || MNEMONIC_IS ("bset"))
+    {
+        snprintf (handler, sizeof (handler), "m68k_%s_%s", mnemonic, (opcode & 0x0100) ? "dn" : "imm");
+        return handler;
+    }
+
+    /* Shift and rotate, either a data register or a word in memory */
+    if (MNEMONIC_IS ("asl")  || MNEMONIC_IS ("asr")  || MNEMONIC_IS ("lsl")  || MNEMONIC_IS ("lsr") ||
+        MNEMONIC_IS ("rol")  || MNEMONIC_IS ("ror")  || MNEMONIC_IS ("roxl"))
+    {
+        if ((opcode & 0x00c0) == 0x00c0)
+        {
+            snprintf (handler, sizeof (handler), "m68k_%s_w_ea", mnemonic);
+        }
+        else
+        {
+            snprintf (handler, sizeof (handler), "m68k_%s_%c_dn", mnemonic, size);
+        }
+        return handler;
+    }
+
+    /* Status register and user stack pointer moves */
+    if (MNEMONIC_IS ("move"))
+    {
+        switch (opcode & 0xffc0)
+        {
+            case 0x40c0: return "m68k_move_ea_sr";
+            case 0x44c0: return "m68k_move_ccr_ea";
+            case 0x46c0: return "m68k_move_sr_ea";
+            default:     return (opcode & 0x0008) ? "m68k_move_usp_an" : "m68k_move_an_usp";
+        }
+    }
+
+    /* Unassigned opcodes */
+    if (MNEMONIC_IS ("line"))
+    {
+        return ((opcode & 0xf000) == 0xa000) ? "m68k_line_a" : "m68k_line_f";
+    }
+
+    /* Instructions with a single handler */
+    if (MNEMONIC_IS ("swap") || MNEMONIC_IS ("lea")  || MNEMONIC_IS ("pea")    || MNEMONIC_IS ("trap")  ||
+        MNEMONIC_IS ("link") || MNEMONIC_IS ("unlink") || MNEMONIC_IS ("nop")  || MNEMONIC_IS ("rte")   ||
+        MNEMONIC_IS ("rts")  || MNEMONIC_IS ("trapv")  || MNEMONIC_IS ("jsr")  || MNEMONIC_IS ("jmp")   ||
+        MNEMONIC_IS ("moveq") || MNEMONIC_IS ("mulu")  || MNEMONIC_IS ("muls") || MNEMONIC_IS ("divu")  ||
+        MNEMONIC_IS ("divs") || MNEMONIC_IS ("exg"))
+    {
+        snprintf (handler, sizeof (handler), "m68k_%s", mnemonic);
+        return handler;
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Find the compact core class for a handler and base cycle count,
+ * adding a new class if needed. Returns 0 if there are too many classes.
+ */
+static uint16_t m68k_compact_class (const char *handler, uint8_t cycles)
+{
+    for (uint32_t i = 1; i < class_count; i++)
+    {
+        if (class_cycles [i] == cycles && strcmp (class_handler [i], handler) == 0)
+        {
+            return i;
+        }
+    }
+
+    if (class_count == MAX_CLASSES)
+    {
+        return 0;
+    }
+
+    strcpy (class_handler [class_count], handler);
+    class_cycles [class_count] = cycles;
+
+    return class_count++;
+}
+
+
+/*
+ * Entry point.
+ */
+int main (int argc, char **argv)
+{
+    FILE *output;
+    uint32_t populated = 0;
+
+    if (argc != 2)
+    {
+        fprintf (stderr, "Usage: %s <output.h>\n", argv [0]);
+        return EXIT_FAILURE;
+    }
+
+    m68k_init_instructions ();
+
+    for (uint32_t i = 0; i < SIZE_64K; i++)
+    {
+        if (m68k_instruction [i] == NULL)
+        {
+            continue;
+        }
+
+        populated++;
+
+        uint32_t cycles = m68k_opcode_cycles (i, m68k_instruction [i]);
+        if (cycles == 0 || cycles > UINT8_MAX)
+        {
+            fprintf (stderr, "No timing for %s (opcode %04x).\n", m68k_instruction [i], i);
+            return EXIT_FAILURE;
+        }
+        m68k_cycles [i] = cycles;
+
+        const char *handler = m68k_compact_handler (i, m68k_instruction [i]);
+        if (handler == NULL)
+        {
+            fprintf (stderr, "No compact handler for %s (opcode %04x).\n", m68k_instruction [i], i);
+            return EXIT_FAILURE;
+        }
+
+        m68k_class [i] = m68k_compact_class (handler, cycles);
+        if (m68k_class [i] == 0)
+        {
+            fprintf (stderr, "Too many compact classes.\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    output = fopen (argv [1], "w");
+    if (output == NULL)
+    {
+        fprintf (stderr, "Unable to open %s for writing.\n", argv [1]);
+        return EXIT_FAILURE;
+    }
+
+    fprintf (output, "/*\n"
+                     " * Snepulator\n"
+                     " * Motorola 68000 opcode tables\n"
+                     " *\n"
+                     " * Generated by m68k_gen.c, do not edit.\n"
+                     " */\n\n");
+
+    fprintf (output, "#ifdef M68K_COMPACT\n\n");
+
+    /* Compact core classes */
+    fprintf (output, "const uint16_t m68k_class [SIZE_64K] = {\n");
+    for (uint32_t i = 0; i < SIZE_64K; i++)
+    {
+        fprintf (output, "%s%3u,%s", (i % 16 == 0) ? "    " : " ", m68k_class [i], (i % 16 == 15) ? "\n" : "");
+    }
+    fprintf (output, "};\n\n");
+
+    fprintf (output, "static const M68000_Class m68k_class_info [%u] = {\n", class_count);
+    for (uint32_t i = 0; i < class_count; i++)
+    {
+        fprintf (output, "    { %s, %u },\n", class_handler [i], class_cycles [i]);
+    }
+    fprintf (output, "};\n\n");
+
+    fprintf (output, "#else\n\n");
+
+    /* Handlers */
+    fprintf (output, "uint32_t (* const m68k_instruction [SIZE_64K]) (M68000_Context *, uint16_t) = {\n");
+    for (uint32_t i = 0; i < SIZE_64K; i++)
+    {
+        fprintf (output, "%s%s,%s", (i % 8 == 0) ? "    " : " ",
+                 (m68k_instruction [i] != NULL) ? m68k_instruction [i] : "NULL",
+                 (i % 8 == 7) ? "\n" : "");
+    }
+    fprintf (output, "};\n\n");
+
+    /* Cycles */
+    fprintf (output, "static const uint8_t m68k_cycles [SIZE_64K] = {\n");
+    for (uint32_t i = 0; i < SIZE_64K; i++)
+    {
+        fprintf (output, "%s%3u,%s", (i % 16 == 0) ? "    " : " ", m68k_cycles [i], (i % 16 == 15) ? "\n" : "");
+    }
+    fprintf (output, "};\n\n");
+
+    fprintf (output, "#endif\n");
+
+    fclose (output);
+
+    printf ("[m68k_gen] %d of %d opcodes populated. (%2.1f%%)\n",
+            populated, SIZE_64K, 100.0 * (populated / (float) SIZE_64K));
+    printf ("[m68k_gen] %d classes for the compact core.\n", class_count - 1);
+
+    return EXIT_SUCCESS;
+}
@@ -17,7 +17,7 @@ extern Snepulator_State state;
 
 #define SWAP(TYPE, X, Y) { TYPE tmp = X; X = Y; Y = tmp; }
 
-static void (*z80_instruction [256]) (Z80_Context *);
+void (*z80_instruction [256]) (Z80_Context *);
 
 /* TODO: Consider the accuracy of the R register */
 
@@ -41,6 +41,46 @@ static const uint8_t uint8_even_parity [256] = {
 };
 
 
+/* Sign, zero, and undocumented flags for an 8-bit result */
+static const uint8_t z80_flags_sz53 [256] = {
+    0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+};
+
+/* Sign, zero, undocumented, and parity flags for an 8-bit result */
+static const uint8_t z80_flags_sz53p [256] = {
+    0x44, 0x00, 0x00, 0x04, 0x00, 0x04, 0x04, 0x00, 0x08, 0x0c, 0x0c, 0x08, 0x0c, 0x08, 0x08, 0x0c,
+    0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x04, 0x0c, 0x08, 0x08, 0x0c, 0x08, 0x0c, 0x0c, 0x08,
+    0x20, 0x24, 0x24, 0x20, 0x24, 0x20, 0x20, 0x24, 0x2c, 0x28, 0x28, 0x2c, 0x28, 0x2c, 0x2c, 0x28,
+    0x24, 0x20, 0x20, 0x24, 0x20, 0x24, 0x24, 0x20, 0x28, 0x2c, 0x2c, 0x28, 0x2c, 0x28, 0x28, 0x2c,
+    0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x04, 0x0c, 0x08, 0x08, 0x0c, 0x08, 0x0c, 0x0c, 0x08,
+    0x04, 0x00, 0x00, 0x04, 0x00, 0x04, 0x04, 0x00, 0x08, 0x0c, 0x0c, 0x08, 0x0c, 0x08, 0x08, 0x0c,
+    0x24, 0x20, 0x20, 0x24, 0x20, 0x24, 0x24, 0x20, 0x28, 0x2c, 0x2c, 0x28, 0x2c, 0x28, 0x28, 0x2c,
+    0x20, 0x24, 0x24, 0x20, 0x24, 0x20, 0x20, 0x24, 0x2c, 0x28, 0x28, 0x2c, 0x28, 0x2c, 0x2c, 0x28,
+    0x80, 0x84, 0x84, 0x80, 0x84, 0x80, 0x80, 0x84, 0x8c, 0x88, 0x88, 0x8c, 0x88, 0x8c, 0x8c, 0x88,
+    0x84, 0x80, 0x80, 0x84, 0x80, 0x84, 0x84, 0x80, 0x88, 0x8c, 0x8c, 0x88, 0x8c, 0x88, 0x88, 0x8c,
+    0xa4, 0xa0, 0xa0, 0xa4, 0xa0, 0xa4, 0xa4, 0xa0, 0xa8, 0xac, 0xac, 0xa8, 0xac, 0xa8, 0xa8, 0xac,
+    0xa0, 0xa4, 0xa4, 0xa0, 0xa4, 0xa0, 0xa0, 0xa4, 0xac, 0xa8, 0xa8, 0xac, 0xa8, 0xac, 0xac, 0xa8,
+    0x84, 0x80, 0x80, 0x84, 0x80, 0x84, 0x84, 0x80, 0x88, 0x8c, 0x8c, 0x88, 0x8c, 0x88, 0x88, 0x8c,
+    0x80, 0x84, 0x84, 0x80, 0x84, 0x80, 0x80, 0x84, 0x8c, 0x88, 0x88, 0x8c, 0x88, 0x8c, 0x8c, 0x88,
+    0xa0, 0xa4, 0xa4, 0xa0, 0xa4, 0xa0, 0xa0, 0xa4, 0xac, 0xa8, 0xa8, 0xac, 0xa8, 0xac, 0xac, 0xa8,
+    0xa4, 0xa0, 0xa0, 0xa4, 0xa0, 0xa4, 0xa4, 0xa0, 0xa8, 0xac, 0xac, 0xa8, 0xac, 0xa8, 0xa8, 0xac,
+};
+
 /*
  * Restore registers to default values.
  */
@@ -56,6 +96,10 @@ void z80_reset (Z80_Context *context)
     context->state.iff2 = 0;
     context->state.wait_after_ei = 0;
     context->state.halt = 0;
+
+    context->interrupt_deadline = 0;
+
+    z80_jit_flush (context);
 }
 
 
@@ -93,113 +137,223 @@ Z80_Context *z80_init (void *parent,
 }
 
 
-#define SET_FLAGS_AND { context->state.flag_carry = 0; \
-                        context->state.flag_sub = 0; \
-                        context->state.flag_parity_overflow = uint8_even_parity [context->state.a]; \
-                        context->state.flag_half = 1; \
-                        context->state.flag_zero = (context->state.a == 0x00); \
-                        context->state.flag_sign = (context->state.a >> 7); }
-
-#define SET_FLAGS_OR_XOR { context->state.flag_carry = 0; \
-                           context->state.flag_sub = 0; \
-                           context->state.flag_parity_overflow = uint8_even_parity [context->state.a]; \
-                           context->state.flag_half = 0; \
-                           context->state.flag_zero = (context->state.a == 0x00); \
-                           context->state.flag_sign = (context->state.a >> 7); }
-
-#define SET_FLAGS_ADD(X,Y) { context->state.flag_carry = (X + Y) >> 8; \
-                             context->state.flag_sub = 0; \
-                             context->state.flag_parity_overflow = (((int8_t) X + (int8_t) Y) > 127 || ((int8_t) X + (int8_t) Y) < -128); \
-                             context->state.flag_half = ((X & 0x0f) + (Y & 0x0f)) >> 4; \
-                             context->state.flag_zero = (((X + Y) & 0xff) == 0x00); \
-                             context->state.flag_sign = (X + Y) >> 7; }
-
-#define SET_FLAGS_SUB(X,Y) { context->state.flag_carry = (X - Y) >> 8; \
-                             context->state.flag_sub = 1; \
-                             context->state.flag_parity_overflow = (((int8_t) X - (int8_t) Y) > 127 || ((int8_t) X - (int8_t) Y) < -128); \
-                             context->state.flag_half = ((X & 0x0f) - (Y & 0x0f)) >> 4; \
-                             context->state.flag_zero = (X == Y); \
-                             context->state.flag_sign = (X - Y) >> 7; }
-
-#define SET_FLAGS_ADC(X) { context->state.flag_sub = 0; \
-                           context->state.flag_parity_overflow = (((int8_t) context->state.a + (int8_t) X + context->state.flag_carry) > 127 || \
-                                                                 ((int8_t) context->state.a + (int8_t) X + context->state.flag_carry) < -128); \
-                           context->state.flag_half = ((context->state.a & 0x0f) + (X & 0x0f) + context->state.flag_carry) >> 4; \
-                           context->state.flag_zero = (((context->state.a + X + context->state.flag_carry) & 0xff) == 0x00); \
-                           context->state.flag_sign = (context->state.a + X + context->state.flag_carry) >> 7; \
-                           context->state.flag_carry = (context->state.a + X + context->state.flag_carry) >> 8; }
-
-#define SET_FLAGS_SBC(X) { context->state.flag_sub = 1; \
-                           context->state.flag_parity_overflow = (((int8_t) context->state.a - (int8_t) X - context->state.flag_carry) > 127 || \
-                                                                 ((int8_t) context->state.a - (int8_t) X - context->state.flag_carry) < -128); \
-                           context->state.flag_half = ((context->state.a & 0x0f) - (X & 0x0f) - context->state.flag_carry) >> 4; \
-                           context->state.flag_zero = (((context->state.a - X - context->state.flag_carry) & 0xff) == 0x00); \
-                           context->state.flag_sign = (context->state.a - X - context->state.flag_carry) >> 7; \
-                           context->state.flag_carry = (context->state.a - X - context->state.flag_carry) >> 8; }
-
-#define SET_FLAGS_INC(X) { context->state.flag_sub = 0; \
-                           context->state.flag_parity_overflow = (X == 0x80); \
-                           context->state.flag_half = ((X & 0x0f) == 0x00); \
-                           context->state.flag_zero = (X == 0x00); \
-                           context->state.flag_sign = X >> 7; }
-
-#define SET_FLAGS_DEC(X) { context->state.flag_sub = 1; \
-                           context->state.flag_parity_overflow = (X == 0x7f); \
-                           context->state.flag_half = ((X & 0x0f) == 0x0f); \
-                           context->state.flag_zero = (X == 0x00); \
-                           context->state.flag_sign = X >> 7; }
-
-#define SET_FLAGS_ADD_16(X,Y) { context->state.flag_carry = (X + Y) >> 16; \
-                                context->state.flag_sub = 0; \
-                                context->state.flag_half = ((X & 0x0fff) + (Y & 0xfff)) >> 12; }
-
-#define SET_FLAGS_ADC_16(X) { context->state.flag_sub = 0; \
-                              context->state.flag_parity_overflow = (((int16_t) context->state.hl + (int16_t) X + context->state.flag_carry) >  32767 || \
-                                                                    ((int16_t) context->state.hl + (int16_t) X + context->state.flag_carry) < -32768); \
-                              context->state.flag_half = ((context->state.hl & 0xfff) + (X & 0xfff) + context->state.flag_carry) >> 12; \
-                              context->state.flag_zero = (((context->state.hl + X + context->state.flag_carry) & 0xffff) == 0x0000); \
-                              context->state.flag_sign = (context->state.hl + X + context->state.flag_carry) >> 15; \
-                              context->state.flag_carry = (context->state.hl + X + context->state.flag_carry) >> 16; }
-
-#define SET_FLAGS_SBC_16(X) { context->state.flag_sub = 1; \
-                              context->state.flag_parity_overflow = (((int16_t) context->state.hl - (int16_t) X - context->state.flag_carry) >  32767 || \
-                                                                    ((int16_t) context->state.hl - (int16_t) X - context->state.flag_carry) < -32768); \
-                              context->state.flag_half = ((context->state.hl & 0xfff) - (X & 0xfff) - context->state.flag_carry) >> 12; \
-                              context->state.flag_zero = (((context->state.hl - X - context->state.flag_carry) & 0xffff) == 0x0000); \
-                              context->state.flag_sign = (context->state.hl - X - context->state.flag_carry) >> 15; \
-                              context->state.flag_carry = (context->state.hl - X - context->state.flag_carry) >> 16; }
-
-#define SET_FLAGS_RLC(X) { context->state.flag_carry = X; \
-                           context->state.flag_sub = 0; \
-                           context->state.flag_parity_overflow = uint8_even_parity [X]; \
-                           context->state.flag_half = 0; \
-                           context->state.flag_zero = (X == 0x00); \
-                           context->state.flag_sign = X >> 7; }
-
-#define SET_FLAGS_RRC(X) { context->state.flag_carry = X >> 7; \
-                           context->state.flag_sub = 0; \
-                           context->state.flag_parity_overflow = uint8_even_parity [X]; \
-                           context->state.flag_half = 0; \
-                           context->state.flag_zero = (X == 0x00); \
-                           context->state.flag_sign = X >> 7; }
-
-#define SET_FLAGS_RL_RR(X) { context->state.flag_sub = 0; \
-                             context->state.flag_parity_overflow = uint8_even_parity [X]; \
-                             context->state.flag_half = 0; \
-                             context->state.flag_zero = (X == 0x00); \
-                             context->state.flag_sign = X >> 7; }
-
-#define SET_FLAGS_RLD_RRD { context->state.flag_sub = 0; \
-                            context->state.flag_parity_overflow = uint8_even_parity [context->state.a]; \
-                            context->state.flag_half = 0; \
-                            context->state.flag_zero = (context->state.a == 0x00); \
-                            context->state.flag_sign = context->state.a >> 7; }
-
-#define SET_FLAGS_ED_IN(X) { context->state.flag_sub = 0; \
-                             context->state.flag_parity_overflow = uint8_even_parity [X]; \
-                             context->state.flag_half = 0; \
-                             context->state.flag_zero = (X == 0); \
-                             context->state.flag_sign = X >> 7; }
+/*
+ * Read from memory.
+ *
+ * Pages of plain ROM and RAM are read directly through the memory map, with
+ * the console's memory_read callback used for everything else.
+ */
+static inline uint8_t z80_memory_read (Z80_Context *context, uint16_t addr)
+{
+    uint8_t *page = context->memory_map [addr / Z80_PAGE_SIZE];
+
+    if (page != NULL)
+    {
+        return page [addr & (Z80_PAGE_SIZE - 1)];
+    }
+
+    context->side_effect_count++;
+    return context->memory_read (context->parent, addr);
+}
+
+
+/*
+ * Write to memory.
+ *
+ * While the recompiler is enabled, writes are checked for changes to code
+ * that has already been translated.
+ */
+static inline void z80_memory_write (Z80_Context *context, uint16_t addr, uint8_t data)
+{
+    context->side_effect_count++;
+
+    if (context->jit_enabled)
+    {
+        z80_jit_memory_write (context, addr, data);
+        return;
+    }
+
+    context->memory_write (context->parent, addr, data);
+}
+
+
+/*
+ * Read from an I/O port.
+ *
+ * Port accesses may change the interrupt lines, so they are checked again
+ * before the next instruction.
+ *
+ * For ports set with z80_idle_port_set, reading the same value again within a
+ * run has no further effect, so is not counted as a side effect.
+ */
+static inline uint8_t z80_io_read (Z80_Context *context, uint8_t addr)
+{
+    context->interrupt_deadline = 0;
+    uint8_t value = context->io_read (context->parent, addr);
+
+    if (!(context->idle_ports [addr / 32] & (1u << (addr % 32))) || context->idle_port_value [addr] != value)
+    {
+        context->side_effect_count++;
+        context->idle_port_value [addr] = value;
+    }
+
+    return value;
+}
+
+
+/*
+ * Write to an I/O port.
+ */
+static inline void z80_io_write (Z80_Context *context, uint8_t addr, uint8_t data)
+{
+    context->side_effect_count++;
+    context->interrupt_deadline = 0;
+    context->io_write (context->parent, addr, data);
+}
+
+
+/*
+ * Check for an idle loop, called after a backward relative jump is taken.
+ *
+ * Games often wait for an interrupt by polling a variable in RAM, or wait for
+ * the VDP by polling its status port. If a pass through the loop has no side
+ * effects, and returns to the top with the same register values, then every
+ * following pass will be identical until the interrupt is taken or the other
+ * hardware is next run. Those passes are skipped, up to the next interrupt
+ * check or the end of the run, with R and the counters advanced as if they
+ * had run. Consoles run the Z80 up to each scanline, or other VDP event.
+ */
+static void z80_idle_check (Z80_Context *context)
+{
+    if (!context->idle_skip)
+    {
+        return;
+    }
+
+    uint64_t now = context->cycle_count + context->used_cycles;
+    Z80_State current = context->state;
+    current.r = 0;
+
+    if (context->side_effect_count == context->idle_side_effect_count && now > context->idle_cycle_count &&
+        memcmp (&current, &context->idle_state, sizeof (Z80_State)) == 0)
+    {
+        uint64_t period = now - context->idle_cycle_count;
+        uint64_t limit = context->cycle_end - 1;
+
+        /* Passes may end at, but not cross, the interrupt deadline */
+        if (context->interrupt_deadline < limit)
+        {
+            limit = context->interrupt_deadline;
+        }
+
+        if (limit > now)
+        {
+            uint64_t passes = (limit - now) / period;
+            uint8_t r_increment = (context->state.r - context->idle_r) & 0x7f;
+
+            context->state.r = (context->state.r & 0x80) | ((context->state.r + passes * r_increment) & 0x7f);
+            context->instruction_count += passes * (context->instruction_count - context->idle_instruction_count);
+            context->used_cycles += passes * period;
+            now += passes * period;
+        }
+    }
+
+    context->idle_state = current;
+    context->idle_r = context->state.r;
+    context->idle_cycle_count = now;
+    context->idle_instruction_count = context->instruction_count;
+    context->idle_side_effect_count = context->side_effect_count;
+}
+
+
+/* Flags are computed together and assigned to F in a single store. Unless noted,
+ * the undocumented X and Y flags are also set from the result. */
+#define SET_FLAGS_AND { context->state.f = z80_flags_sz53p [context->state.a] | Z80_FLAG_HALF; }
+
+#define SET_FLAGS_OR_XOR { context->state.f = z80_flags_sz53p [context->state.a]; }
+
+/* Called before the result is stored */
+#define SET_FLAGS_ADD(X,Y) { uint32_t flags_result = (X) + (Y); \
+                             context->state.f = z80_flags_sz53 [flags_result & 0xff] | \
+                                                (((X) ^ (Y) ^ flags_result) & Z80_FLAG_HALF) | \
+                                                ((((X) ^ ~(Y)) & ((X) ^ flags_result) & 0x80) >> 5) | \
+                                                (flags_result >> 8); }
+
+/* Called before the result is stored */
+#define SET_FLAGS_SUB(X,Y) { uint32_t flags_result = (X) - (Y); \
+                             context->state.f = z80_flags_sz53 [flags_result & 0xff] | Z80_FLAG_SUB | \
+                                                (((X) ^ (Y) ^ flags_result) & Z80_FLAG_HALF) | \
+                                                ((((X) ^ (Y)) & ((X) ^ flags_result) & 0x80) >> 5) | \
+                                                ((flags_result >> 8) & Z80_FLAG_CARRY); }
+
+/* As SET_FLAGS_SUB, with the undocumented flags taken from the operand */
+#define SET_FLAGS_CP(X,Y) { uint32_t flags_result = (X) - (Y); \
+                            context->state.f = (z80_flags_sz53 [flags_result & 0xff] & ~(Z80_FLAG_X | Z80_FLAG_Y)) | \
+                                               ((Y) & (Z80_FLAG_X | Z80_FLAG_Y)) | Z80_FLAG_SUB | \
+                                               (((X) ^ (Y) ^ flags_result) & Z80_FLAG_HALF) | \
+                                               ((((X) ^ (Y)) & ((X) ^ flags_result) & 0x80) >> 5) | \
+                                               ((flags_result >> 8) & Z80_FLAG_CARRY); }
+
+/* Called before the result is stored */
+#define SET_FLAGS_ADC(X) { uint32_t flags_result = context->state.a + (X) + context->state.flag_carry; \
+                           context->state.f = z80_flags_sz53 [flags_result & 0xff] | \
+                                              ((context->state.a ^ (X) ^ flags_result) & Z80_FLAG_HALF) | \
+                                              (((context->state.a ^ ~(X)) & (context->state.a ^ flags_result) & 0x80) >> 5) | \
+                                              (flags_result >> 8); }
+
+/* Called before the result is stored */
+#define SET_FLAGS_SBC(X) { uint32_t flags_result = context->state.a - (X) - context->state.flag_carry; \
+                           context->state.f = z80_flags_sz53 [flags_result & 0xff] | Z80_FLAG_SUB | \
+                                              ((context->state.a ^ (X) ^ flags_result) & Z80_FLAG_HALF) | \
+                                              (((context->state.a ^ (X)) & (context->state.a ^ flags_result) & 0x80) >> 5) | \
+                                              ((flags_result >> 8) & Z80_FLAG_CARRY); }
+
+/* Called with the result, carry is unchanged */
+#define SET_FLAGS_INC(X) { context->state.f = (context->state.f & Z80_FLAG_CARRY) | z80_flags_sz53 [X] | \
+                                              (((X) == 0x80) ? Z80_FLAG_OVERFLOW : 0) | \
+                                              ((((X) & 0x0f) == 0x00) ? Z80_FLAG_HALF : 0); }
+
+/* Called with the result, carry is unchanged */
+#define SET_FLAGS_DEC(X) { context->state.f = (context->state.f & Z80_FLAG_CARRY) | z80_flags_sz53 [X] | Z80_FLAG_SUB | \
+                                              (((X) == 0x7f) ? Z80_FLAG_OVERFLOW : 0) | \
+                                              ((((X) & 0x0f) == 0x0f) ? Z80_FLAG_HALF : 0); }
+
+/* Called before the result is stored, sign, zero, and parity are unchanged */
+#define SET_FLAGS_ADD_16(X,Y) { uint32_t flags_result = (X) + (Y); \
+                                context->state.f = (context->state.f & (Z80_FLAG_SIGN | Z80_FLAG_ZERO | Z80_FLAG_PARITY)) | \
+                                                   ((flags_result >> 8) & (Z80_FLAG_X | Z80_FLAG_Y)) | \
+                                                   ((((X) ^ (Y) ^ flags_result) >> 8) & Z80_FLAG_HALF) | \
+                                                   (flags_result >> 16); }
+
+/* Called before the result is stored */
+#define SET_FLAGS_ADC_16(X) { uint32_t flags_result = context->state.hl + (X) + context->state.flag_carry; \
+                              context->state.f = ((flags_result >> 8) & (Z80_FLAG_SIGN | Z80_FLAG_X | Z80_FLAG_Y)) | \
+                                                 (((flags_result & 0xffff) == 0) ? Z80_FLAG_ZERO : 0) | \
+                                                 (((context->state.hl ^ (X) ^ flags_result) >> 8) & Z80_FLAG_HALF) | \
+                                                 (((context->state.hl ^ ~(X)) & (context->state.hl ^ flags_result) & 0x8000) >> 13) | \
+                                                 (flags_result >> 16); }
+
+/* Called before the result is stored */
+#define SET_FLAGS_SBC_16(X) { uint32_t flags_result = context->state.hl - (X) - context->state.flag_carry; \
+                              context->state.f = ((flags_result >> 8) & (Z80_FLAG_SIGN | Z80_FLAG_X | Z80_FLAG_Y)) | \
+                                                 (((flags_result & 0xffff) == 0) ? Z80_FLAG_ZERO : 0) | Z80_FLAG_SUB | \
+                                                 (((context->state.hl ^ (X) ^ flags_result) >> 8) & Z80_FLAG_HALF) | \
+                                                 (((context->state.hl ^ (X)) & (context->state.hl ^ flags_result) & 0x8000) >> 13) | \
+                                                 ((flags_result >> 16) & Z80_FLAG_CARRY); }
+
+#define SET_FLAGS_RLC(X) { context->state.f = z80_flags_sz53p [X] | ((X) & Z80_FLAG_CARRY); }
+
+#define SET_FLAGS_RRC(X) { context->state.f = z80_flags_sz53p [X] | ((X) >> 7); }
+
+/* Carry is unchanged */
+#define SET_FLAGS_RL_RR(X) { context->state.f = (context->state.f & Z80_FLAG_CARRY) | z80_flags_sz53p [X]; }
+
+/* Carry is unchanged */
+#define SET_FLAGS_RLD_RRD { context->state.f = (context->state.f & Z80_FLAG_CARRY) | z80_flags_sz53p [context->state.a]; }
+
+/* Carry and the undocumented flags are unchanged */
+#define SET_FLAGS_ED_IN(X) { context->state.f = (context->state.f & (Z80_FLAG_CARRY | Z80_FLAG_X | Z80_FLAG_Y)) | \
+                                                (z80_flags_sz53p [X] & ~(Z80_FLAG_X | Z80_FLAG_Y)); }
 
 #define SET_FLAGS_XY(X) { context->state.flag_x = (X) >> 3; \
                           context->state.flag_y = (X) >> 5; }
@@ -215,8 +369,8 @@ Z80_Context *z80_init (void *parent,
 void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
 {
     /* Note: The displacement comes first, then the instruction */
-    uint8_t displacement = context->memory_read (context->parent, context->state.pc++);
-    uint8_t instruction = context->memory_read (context->parent, context->state.pc++);
+    uint8_t displacement = z80_memory_read (context, context->state.pc++);
+    uint8_t instruction = z80_memory_read (context, context->state.pc++);
     uint16_t addr;
     uint8_t data;
     uint8_t bit;
@@ -228,21 +382,19 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
 
     /* Read data */
     addr = reg_ix_iy_w + (int8_t) displacement;
-    data = context->memory_read (context->parent, addr);
+    data = z80_memory_read (context, addr);
 
     switch (instruction & 0xf8)
     {
         case 0x00: /* RLC (ix+*) */
             data = (data << 1) | ((data & 0x80) ? 0x01 : 0x00);
             SET_FLAGS_RLC (data);
-            SET_FLAGS_XY (data);
             context->used_cycles += 23;
             break;
 
         case 0x08: /* RRC (ix+*) */
             data = (data >> 1) | (data << 7);
             SET_FLAGS_RRC (data);
-            SET_FLAGS_XY (data);
             context->used_cycles += 23;
             break;
 
@@ -250,7 +402,6 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
             temp = data;
             data = (data << 1) | context->state.flag_carry;
             SET_FLAGS_RL_RR (data);
-            SET_FLAGS_XY (data);
             context->state.flag_carry = temp >> 7;
             context->used_cycles += 23;
             break;
@@ -259,7 +410,6 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
             temp = data;
             data = (data >> 1) | (context->state.flag_carry << 7);
             SET_FLAGS_RL_RR (data);
-            SET_FLAGS_XY (data);
             context->state.flag_carry = temp;
             context->used_cycles += 23;
             break;
@@ -268,7 +418,6 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
             temp = data;
             data = (data << 1);
             SET_FLAGS_RL_RR (data);
-            SET_FLAGS_XY (data);
             context->state.flag_carry = temp >> 7;
             context->used_cycles += 23;
             break;
@@ -277,7 +426,6 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
             temp = data;
             data = (data >> 1) | (data & 0x80);
             SET_FLAGS_RL_RR (data);
-            SET_FLAGS_XY (data);
             context->state.flag_carry = temp;
             context->used_cycles += 23;
             break;
@@ -286,7 +434,6 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
             temp = data;
             data = (data << 1) | 0x01;
             SET_FLAGS_RL_RR (data);
-            SET_FLAGS_XY (data);
             context->state.flag_carry = temp >> 7;
             context->used_cycles += 23;
             break;
@@ -295,7 +442,6 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
             temp = data;
             data = (data >> 1);
             SET_FLAGS_RL_RR (data);
-            SET_FLAGS_XY (data);
             context->state.flag_carry = temp;
             context->used_cycles += 23;
             break;
@@ -338,7 +484,7 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
     /* Write data */
     if (write_data)
     {
-        context->memory_write (context->parent, reg_ix_iy_w + (int8_t) displacement, data);
+        z80_memory_write (context, reg_ix_iy_w + (int8_t) displacement, data);
 
         switch (instruction & 0x07)
         {
@@ -361,7 +507,7 @@ void z80_ix_iy_bit_instruction (Z80_Context *context, uint16_t reg_ix_iy_w)
 
 static uint16_t z80_ix_iy_fall_through (Z80_Context *context, uint16_t ix)
 {
-    uint8_t instruction = context->memory_read (context->parent, context->state.pc - 1);
+    uint8_t instruction = z80_memory_read (context, context->state.pc - 1);
     z80_instruction [instruction] (context);
     context->used_cycles += 4;
     return ix;
@@ -373,7 +519,6 @@ static uint16_t z80_ix_iy_09_add_ix_bc (Z80_Context *context, uint16_t ix)
 {
     SET_FLAGS_ADD_16 (ix, context->state.bc);
     ix += context->state.bc;
-    SET_FLAGS_XY_16 (ix);
     context->used_cycles += 15;
     return ix;
 }
@@ -384,7 +529,6 @@ static uint16_t z80_ix_iy_19_add_ix_de (Z80_Context *context, uint16_t ix)
 {
     SET_FLAGS_ADD_16 (ix, context->state.de);
     ix += context->state.de;
-    SET_FLAGS_XY_16 (ix);
     context->used_cycles += 15;
     return ix;
 }
@@ -394,8 +538,8 @@ static uint16_t z80_ix_iy_19_add_ix_de (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_21_ld_ix_xx (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t data;
-    data.l = context->memory_read (context->parent, context->state.pc++);
-    data.h = context->memory_read (context->parent, context->state.pc++);
+    data.l = z80_memory_read (context, context->state.pc++);
+    data.h = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 14;
     return data.w;
 }
@@ -406,10 +550,10 @@ static uint16_t z80_ix_iy_22_ld_xx_ix (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, addr.w,     _ix.l);
-    context->memory_write (context->parent, addr.w + 1, _ix.h);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, addr.w,     _ix.l);
+    z80_memory_write (context, addr.w + 1, _ix.h);
     context->used_cycles += 20;
     return ix;
 }
@@ -430,7 +574,6 @@ static uint16_t z80_ix_iy_24_inc_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     _ix.h++;
     SET_FLAGS_INC (_ix.h);
-    SET_FLAGS_XY (_ix.h);
     context->used_cycles += 8;
     return _ix.w;
 }
@@ -442,7 +585,6 @@ static uint16_t z80_ix_iy_25_dec_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     _ix.h--;
     SET_FLAGS_DEC (_ix.h);
-    SET_FLAGS_XY (_ix.h);
     context->used_cycles += 8;
     return _ix.w;
 }
@@ -452,7 +594,7 @@ static uint16_t z80_ix_iy_25_dec_ixh (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_26_ld_ixh_x (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
-    _ix.h = context->memory_read (context->parent, context->state.pc++);
+    _ix.h = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 11;
     return _ix.w;
 }
@@ -463,7 +605,6 @@ static uint16_t z80_ix_iy_29_add_ix_ix (Z80_Context *context, uint16_t ix)
 {
     SET_FLAGS_ADD_16 (ix, ix);
     ix += ix;
-    SET_FLAGS_XY_16 (ix);
     context->used_cycles += 15;
     return ix;
 }
@@ -474,10 +615,10 @@ static uint16_t z80_ix_iy_2a_ld_ix_xx (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    _ix.l = context->memory_read (context->parent, addr.w);
-    _ix.h = context->memory_read (context->parent, addr.w + 1);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    _ix.l = z80_memory_read (context, addr.w);
+    _ix.h = z80_memory_read (context, addr.w + 1);
     context->used_cycles += 20;
     return _ix.w;
 }
@@ -498,7 +639,6 @@ static uint16_t z80_ix_iy_2c_inc_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     _ix.l++;
     SET_FLAGS_INC (_ix.l);
-    SET_FLAGS_XY (_ix.l);
     context->used_cycles += 8;
     return _ix.w;
 }
@@ -510,7 +650,6 @@ static uint16_t z80_ix_iy_2d_dec_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     _ix.l--;
     SET_FLAGS_DEC (_ix.l);
-    SET_FLAGS_XY (_ix.l);
     context->used_cycles += 8;
     return _ix.w;
 }
@@ -520,7 +659,7 @@ static uint16_t z80_ix_iy_2d_dec_ixl (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_2e_ld_ixl_x (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
-    _ix.l = context->memory_read (context->parent, context->state.pc++);
+    _ix.l = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 11;
     return _ix.w;
 }
@@ -529,12 +668,11 @@ static uint16_t z80_ix_iy_2e_ld_ixl_x (Z80_Context *context, uint16_t ix)
 /* INC (IX + *) */
 static uint16_t z80_ix_iy_34_inc_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t data = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t data = z80_memory_read (context, ix + offset);
     data++;
     SET_FLAGS_INC (data);
-    SET_FLAGS_XY (data);
-    context->memory_write (context->parent, ix + offset, data);
+    z80_memory_write (context, ix + offset, data);
     context->used_cycles += 23;
     return ix;
 }
@@ -543,12 +681,11 @@ static uint16_t z80_ix_iy_34_inc_ixx (Z80_Context *context, uint16_t ix)
 /* DEC (IX + *) */
 static uint16_t z80_ix_iy_35_dec_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t data = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t data = z80_memory_read (context, ix + offset);
     data--;
     SET_FLAGS_DEC (data);
-    SET_FLAGS_XY (data);
-    context->memory_write (context->parent, ix + offset, data);
+    z80_memory_write (context, ix + offset, data);
     context->used_cycles += 23;
     return ix;
 }
@@ -557,9 +694,9 @@ static uint16_t z80_ix_iy_35_dec_ixx (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), * */
 static uint16_t z80_ix_iy_36_ld_ixx_x (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t data = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, data);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t data = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, data);
     context->used_cycles += 19;
     return ix;
 }
@@ -570,7 +707,6 @@ static uint16_t z80_ix_iy_39_add_ix_sp (Z80_Context *context, uint16_t ix)
 {
     SET_FLAGS_ADD_16 (ix, context->state.sp);
     ix += context->state.sp;
-    SET_FLAGS_XY_16 (ix);
     context->used_cycles += 15;
     return ix;
 }
@@ -599,8 +735,8 @@ static uint16_t z80_ix_iy_45_ld_b_ixl (Z80_Context *context, uint16_t ix)
 /* LD B, (IX + *) */
 static uint16_t z80_ix_iy_46_ld_b_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.b = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.b = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -629,8 +765,8 @@ static uint16_t z80_ix_iy_4d_ld_c_ixl (Z80_Context *context, uint16_t ix)
 /* LD C, (IX + *) */
 static uint16_t z80_ix_iy_4e_ld_c_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.c = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.c = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -659,8 +795,8 @@ static uint16_t z80_ix_iy_55_ld_d_ixl (Z80_Context *context, uint16_t ix)
 /* LD D, (IX + *) */
 static uint16_t z80_ix_iy_56_ld_d_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.d = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.d = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -689,8 +825,8 @@ static uint16_t z80_ix_iy_5d_ld_e_ixl (Z80_Context *context, uint16_t ix)
 /* LD E, (IX + *) */
 static uint16_t z80_ix_iy_5e_ld_e_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.e = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.e = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -757,8 +893,8 @@ static uint16_t z80_ix_iy_65_ld_ixh_ixl (Z80_Context *context, uint16_t ix)
 /* LD H, (IX + *) */
 static uint16_t z80_ix_iy_66_ld_h_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.h = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.h = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -835,8 +971,8 @@ static uint16_t z80_ix_iy_6d_ld_ixl_ixl (Z80_Context *context, uint16_t ix)
 /* LD L, (IX + *) */
 static uint16_t z80_ix_iy_6e_ld_l_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.l = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.l = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -855,8 +991,8 @@ static uint16_t z80_ix_iy_6f_ld_ixl_a (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), B */
 static uint16_t z80_ix_iy_70_ld_ixx_b (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.b);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.b);
     context->used_cycles += 19;
     return ix;
 }
@@ -865,8 +1001,8 @@ static uint16_t z80_ix_iy_70_ld_ixx_b (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), C */
 static uint16_t z80_ix_iy_71_ld_ixx_c (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.c);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.c);
     context->used_cycles += 19;
     return ix;
 }
@@ -875,8 +1011,8 @@ static uint16_t z80_ix_iy_71_ld_ixx_c (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), D */
 static uint16_t z80_ix_iy_72_ld_ixx_d (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.d);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.d);
     context->used_cycles += 19;
     return ix;
 }
@@ -885,8 +1021,8 @@ static uint16_t z80_ix_iy_72_ld_ixx_d (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), E */
 static uint16_t z80_ix_iy_73_ld_ixx_e (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.e);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.e);
     context->used_cycles += 19;
     return ix;
 }
@@ -895,8 +1031,8 @@ static uint16_t z80_ix_iy_73_ld_ixx_e (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), H */
 static uint16_t z80_ix_iy_74_ld_ixx_h (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.h);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.h);
     context->used_cycles += 19;
     return ix;
 }
@@ -905,8 +1041,8 @@ static uint16_t z80_ix_iy_74_ld_ixx_h (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), L */
 static uint16_t z80_ix_iy_75_ld_ixx_l (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.l);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.l);
     context->used_cycles += 19;
     return ix;
 }
@@ -915,8 +1051,8 @@ static uint16_t z80_ix_iy_75_ld_ixx_l (Z80_Context *context, uint16_t ix)
 /* LD (IX + *), A */
 static uint16_t z80_ix_iy_77_ld_ixx_a (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, ix + offset, context->state.a);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, ix + offset, context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -945,8 +1081,8 @@ static uint16_t z80_ix_iy_7d_ld_a_ixl (Z80_Context *context, uint16_t ix)
 /* LD A, (IX + *) */
 static uint16_t z80_ix_iy_7e_ld_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.a = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.a = z80_memory_read (context, ix + offset);
     context->used_cycles += 19;
     return ix;
 }
@@ -958,7 +1094,6 @@ static uint16_t z80_ix_iy_84_add_a_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     SET_FLAGS_ADD (context->state.a, _ix.h);
     context->state.a += _ix.h;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -970,7 +1105,6 @@ static uint16_t z80_ix_iy_85_add_a_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     SET_FLAGS_ADD (context->state.a, _ix.l);
     context->state.a += _ix.l;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -979,11 +1113,10 @@ static uint16_t z80_ix_iy_85_add_a_ixl (Z80_Context *context, uint16_t ix)
 /* ADD A, (IX + *) */
 static uint16_t z80_ix_iy_86_add_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t data = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t data = z80_memory_read (context, ix + offset);
     SET_FLAGS_ADD (context->state.a, data);
     context->state.a += data;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -996,7 +1129,6 @@ static uint16_t z80_ix_iy_8c_adc_a_ixh (Z80_Context *context, uint16_t ix)
     uint8_t value = _ix.h + context->state.flag_carry;
     SET_FLAGS_ADC (_ix.h);
     context->state.a += value;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1009,7 +1141,6 @@ static uint16_t z80_ix_iy_8d_adc_a_ixl (Z80_Context *context, uint16_t ix)
     uint8_t value = _ix.l + context->state.flag_carry;
     SET_FLAGS_ADC (_ix.l);
     context->state.a += value;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1018,12 +1149,11 @@ static uint16_t z80_ix_iy_8d_adc_a_ixl (Z80_Context *context, uint16_t ix)
 /* ADC A, (IX + *) */
 static uint16_t z80_ix_iy_8e_adc_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t value = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t value = z80_memory_read (context, ix + offset);
     uint8_t carry = context->state.flag_carry;
     SET_FLAGS_ADC (value);
     context->state.a += (value + carry);
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -1035,7 +1165,6 @@ static uint16_t z80_ix_iy_94_sub_a_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     SET_FLAGS_SUB (context->state.a, _ix.h);
     context->state.a -= _ix.h;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1047,7 +1176,6 @@ static uint16_t z80_ix_iy_95_sub_a_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     SET_FLAGS_SUB (context->state.a, _ix.l);
     context->state.a -= _ix.l;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1056,11 +1184,10 @@ static uint16_t z80_ix_iy_95_sub_a_ixl (Z80_Context *context, uint16_t ix)
 /* SUB A, (IX + *) */
 static uint16_t z80_ix_iy_96_sub_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t data = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t data = z80_memory_read (context, ix + offset);
     SET_FLAGS_SUB (context->state.a, data);
     context->state.a -= data;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -1073,7 +1200,6 @@ static uint16_t z80_ix_iy_9c_sbc_a_ixh (Z80_Context *context, uint16_t ix)
     uint8_t value = _ix.h + context->state.flag_carry;
     SET_FLAGS_SBC (_ix.h);
     context->state.a -= value;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1086,7 +1212,6 @@ static uint16_t z80_ix_iy_9d_sbc_a_ixl (Z80_Context *context, uint16_t ix)
     uint8_t value= _ix.l + context->state.flag_carry;
     SET_FLAGS_SBC (_ix.l);
     context->state.a -= value;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1095,12 +1220,11 @@ static uint16_t z80_ix_iy_9d_sbc_a_ixl (Z80_Context *context, uint16_t ix)
 /* SBC A, (IX + *) */
 static uint16_t z80_ix_iy_9e_sbc_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t value = context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t value = z80_memory_read (context, ix + offset);
     uint8_t carry = context->state.flag_carry;
     SET_FLAGS_SBC (value);
     context->state.a -= (value + carry);
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -1112,7 +1236,6 @@ static uint16_t z80_ix_iy_a4_and_a_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     context->state.a &= _ix.h;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1124,7 +1247,6 @@ static uint16_t z80_ix_iy_a5_and_a_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     context->state.a &= _ix.l;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1133,10 +1255,9 @@ static uint16_t z80_ix_iy_a5_and_a_ixl (Z80_Context *context, uint16_t ix)
 /* AND A, (IX + *) */
 static uint16_t z80_ix_iy_a6_and_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.a &= context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.a &= z80_memory_read (context, ix + offset);
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -1148,7 +1269,6 @@ static uint16_t z80_ix_iy_ac_xor_a_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     context->state.a ^= _ix.h;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1160,7 +1280,6 @@ static uint16_t z80_ix_iy_ad_xor_a_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     context->state.a ^= _ix.l;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1169,10 +1288,9 @@ static uint16_t z80_ix_iy_ad_xor_a_ixl (Z80_Context *context, uint16_t ix)
 /* XOR A, (IX + *) */
 static uint16_t z80_ix_iy_ae_xor_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.a ^= context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.a ^= z80_memory_read (context, ix + offset);
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -1184,7 +1302,6 @@ static uint16_t z80_ix_iy_b4_or_a_ixh (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     context->state.a |= _ix.h;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1196,7 +1313,6 @@ static uint16_t z80_ix_iy_b5_or_a_ixl (Z80_Context *context, uint16_t ix)
     uint16_split_t _ix = { .w = ix };
     context->state.a |= _ix.l;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 8;
     return ix;
 }
@@ -1205,10 +1321,9 @@ static uint16_t z80_ix_iy_b5_or_a_ixl (Z80_Context *context, uint16_t ix)
 /* OR A, (IX + *) */
 static uint16_t z80_ix_iy_b6_or_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    context->state.a |= context->memory_read (context->parent, ix + offset);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    context->state.a |= z80_memory_read (context, ix + offset);
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 19;
     return ix;
 }
@@ -1218,8 +1333,7 @@ static uint16_t z80_ix_iy_b6_or_a_ixx (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_bc_cp_a_ixh (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
-    SET_FLAGS_SUB (context->state.a, _ix.h);
-    SET_FLAGS_XY (_ix.h);
+    SET_FLAGS_CP (context->state.a, _ix.h);
     context->used_cycles += 8;
     return ix;
 }
@@ -1229,8 +1343,7 @@ static uint16_t z80_ix_iy_bc_cp_a_ixh (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_bd_cp_a_ixl (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
-    SET_FLAGS_SUB (context->state.a, _ix.l);
-    SET_FLAGS_XY (_ix.l);
+    SET_FLAGS_CP (context->state.a, _ix.l);
     context->used_cycles += 8;
     return ix;
 }
@@ -1239,10 +1352,9 @@ static uint16_t z80_ix_iy_bd_cp_a_ixl (Z80_Context *context, uint16_t ix)
 /* CP A, (IX + *) */
 static uint16_t z80_ix_iy_be_cp_a_ixx (Z80_Context *context, uint16_t ix)
 {
-    int8_t offset = context->memory_read (context->parent, context->state.pc++);
-    uint8_t data = context->memory_read (context->parent, ix + offset);
-    SET_FLAGS_SUB (context->state.a, data);
-    SET_FLAGS_XY (data);
+    int8_t offset = z80_memory_read (context, context->state.pc++);
+    uint8_t data = z80_memory_read (context, ix + offset);
+    SET_FLAGS_CP (context->state.a, data);
     context->used_cycles += 19;
     return ix;
 }
@@ -1260,8 +1372,8 @@ static uint16_t z80_ix_iy_cb_prefix (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_e1_pop_ix (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
-    _ix.l = context->memory_read (context->parent, context->state.sp++);
-    _ix.h = context->memory_read (context->parent, context->state.sp++);
+    _ix.l = z80_memory_read (context, context->state.sp++);
+    _ix.h = z80_memory_read (context, context->state.sp++);
     context->used_cycles += 14;
     return _ix.w;
 }
@@ -1272,11 +1384,11 @@ static uint16_t z80_ix_iy_e3_ex_sp_ix (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
     uint8_t temp = _ix.l;
-    _ix.l = context->memory_read (context->parent, context->state.sp);
-    context->memory_write (context->parent, context->state.sp, temp);
+    _ix.l = z80_memory_read (context, context->state.sp);
+    z80_memory_write (context, context->state.sp, temp);
     temp = _ix.h;
-    _ix.h = context->memory_read (context->parent, context->state.sp + 1);
-    context->memory_write (context->parent, context->state.sp + 1, temp);
+    _ix.h = z80_memory_read (context, context->state.sp + 1);
+    z80_memory_write (context, context->state.sp + 1, temp);
     context->used_cycles += 23;
     return _ix.w;
 }
@@ -1286,8 +1398,8 @@ static uint16_t z80_ix_iy_e3_ex_sp_ix (Z80_Context *context, uint16_t ix)
 static uint16_t z80_ix_iy_e5_push_ix (Z80_Context *context, uint16_t ix)
 {
     uint16_split_t _ix = { .w = ix };
-    context->memory_write (context->parent, --context->state.sp, _ix.h);
-    context->memory_write (context->parent, --context->state.sp, _ix.l);
+    z80_memory_write (context, --context->state.sp, _ix.h);
+    z80_memory_write (context, --context->state.sp, _ix.l);
     context->used_cycles += 15;
     return ix;
 }
@@ -1389,7 +1501,6 @@ static uint8_t z80_cb_00_rlc (Z80_Context *context, uint8_t value)
 {
     value = (value << 1) | (value >> 7);
     SET_FLAGS_RLC (value);
-    SET_FLAGS_XY (value);
     return value;
 }
 
@@ -1399,7 +1510,6 @@ static uint8_t z80_cb_08_rrc (Z80_Context *context, uint8_t value)
 {
     value = (value >> 1) | (value << 7);
     SET_FLAGS_RRC (value);
-    SET_FLAGS_XY (value);
     return value;
 }
 
@@ -1410,7 +1520,6 @@ static uint8_t z80_cb_10_rl (Z80_Context *context, uint8_t value)
     uint8_t result;
     result = (value << 1) | context->state.flag_carry;
     SET_FLAGS_RL_RR (result);
-    SET_FLAGS_XY (result);
     context->state.flag_carry = value >> 7;
     return result;
 }
@@ -1422,7 +1531,6 @@ static uint8_t z80_cb_18_rr (Z80_Context *context, uint8_t value)
     uint8_t result;
     result = (value >> 1) | (context->state.flag_carry << 7);
     SET_FLAGS_RL_RR (result);
-    SET_FLAGS_XY (result);
     context->state.flag_carry = value;
     return result;
 }
@@ -1434,7 +1542,6 @@ static uint8_t z80_cb_20_sla (Z80_Context *context, uint8_t value)
     uint8_t result;
     result = (value << 1);
     SET_FLAGS_RL_RR (result);
-    SET_FLAGS_XY (result);
     context->state.flag_carry = value >> 7;
     return result;
 }
@@ -1446,7 +1553,6 @@ static uint8_t z80_cb_28_sra (Z80_Context *context, uint8_t value)
     uint8_t result;
     result = (value >> 1) | (value & 0x80);
     SET_FLAGS_RL_RR (result);
-    SET_FLAGS_XY (result);
     context->state.flag_carry = value;
     return result;
 }
@@ -1457,7 +1563,6 @@ static uint8_t z80_cb_30_sll (Z80_Context *context, uint8_t value)
     uint8_t result;
     result = (value << 1) | 0x01;
     SET_FLAGS_RL_RR (result);
-    SET_FLAGS_XY (result);
     context->state.flag_carry = value >> 7;
     return result;
 }
@@ -1469,7 +1574,6 @@ static uint8_t z80_cb_38_srl (Z80_Context *context, uint8_t value)
     uint8_t result;
     result = (value >> 1);
     SET_FLAGS_RL_RR (result);
-    SET_FLAGS_XY (result);
     context->state.flag_carry = value;
     return result;
 }
@@ -1711,7 +1815,7 @@ uint8_t (*z80_cb_instruction [32]) (Z80_Context *, uint8_t) = {
 /* IN B, (C) */
 static void z80_ed_40_in_b_c (Z80_Context *context)
 {
-    context->state.b = context->io_read (context->parent, context->state.c);
+    context->state.b = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.b);
     context->used_cycles += 12;
 }
@@ -1720,7 +1824,7 @@ static void z80_ed_40_in_b_c (Z80_Context *context)
 /* OUT (C), B */
 static void z80_ed_41_out_c_b (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.b);
+    z80_io_write (context, context->state.c, context->state.b);
     context->used_cycles += 12;
 }
 
@@ -1732,7 +1836,6 @@ static void z80_ed_42_sbc_hl_bc (Z80_Context *context)
     temp = context->state.bc + context->state.flag_carry;
     SET_FLAGS_SBC_16 (context->state.bc);
     context->state.hl -= temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -1741,11 +1844,11 @@ static void z80_ed_42_sbc_hl_bc (Z80_Context *context)
 static void z80_ed_43_ld_xx_bc (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->memory_write (context->parent, addr.w,     context->state.c);
-    context->memory_write (context->parent, addr.w + 1, context->state.b);
+    z80_memory_write (context, addr.w,     context->state.c);
+    z80_memory_write (context, addr.w + 1, context->state.b);
     context->used_cycles += 20;
 }
 
@@ -1772,9 +1875,10 @@ static void z80_ed_44_neg (Z80_Context *context)
 /* RETN */
 static void z80_ed_45_retn (Z80_Context *context)
 {
-    context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-    context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+    context->state.pc_l = z80_memory_read (context, context->state.sp++);
+    context->state.pc_h = z80_memory_read (context, context->state.sp++);
     context->state.iff1 = context->state.iff2;
+    context->interrupt_deadline = 0;
     context->used_cycles += 14;
 }
 
@@ -1798,7 +1902,7 @@ static void z80_ed_47_ld_i_a (Z80_Context *context)
 /* IN C, (C) */
 static void z80_ed_48_in_c_c (Z80_Context *context)
 {
-    context->state.c = context->io_read (context->parent, context->state.c);
+    context->state.c = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.c);
     context->used_cycles += 12;
 }
@@ -1807,7 +1911,7 @@ static void z80_ed_48_in_c_c (Z80_Context *context)
 /* OUT (C), C */
 static void z80_ed_49_out_c_c (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.c);
+    z80_io_write (context, context->state.c, context->state.c);
     context->used_cycles += 12;
 }
 
@@ -1819,7 +1923,6 @@ static void z80_ed_4a_adc_hl_bc (Z80_Context *context)
     temp = context->state.bc + context->state.flag_carry;
     SET_FLAGS_ADC_16 (context->state.bc);
     context->state.hl += temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -1828,11 +1931,11 @@ static void z80_ed_4a_adc_hl_bc (Z80_Context *context)
 static void z80_ed_4b_ld_bc_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->state.c = context->memory_read (context->parent, addr.w);
-    context->state.b = context->memory_read (context->parent, addr.w + 1);
+    context->state.c = z80_memory_read (context, addr.w);
+    context->state.b = z80_memory_read (context, addr.w + 1);
     context->used_cycles += 20;
 }
 
@@ -1871,7 +1974,7 @@ static void z80_ed_4f_ld_r_a (Z80_Context *context)
 /* IN D, (C) */
 static void z80_ed_50_in_d_c (Z80_Context *context)
 {
-    context->state.d = context->io_read (context->parent, context->state.c);
+    context->state.d = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.d);
     context->used_cycles += 12;
 }
@@ -1880,7 +1983,7 @@ static void z80_ed_50_in_d_c (Z80_Context *context)
 /* OUT (C), D */
 static void z80_ed_51_out_c_d (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.d);
+    z80_io_write (context, context->state.c, context->state.d);
     context->used_cycles += 12;
 }
 
@@ -1892,7 +1995,6 @@ static void z80_ed_52_sbc_hl_de (Z80_Context *context)
     temp = context->state.de + context->state.flag_carry;
     SET_FLAGS_SBC_16 (context->state.de);
     context->state.hl -= temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -1901,11 +2003,11 @@ static void z80_ed_52_sbc_hl_de (Z80_Context *context)
 static void z80_ed_53_ld_xx_de (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->memory_write (context->parent, addr.w,     context->state.e);
-    context->memory_write (context->parent, addr.w + 1, context->state.d);
+    z80_memory_write (context, addr.w,     context->state.e);
+    z80_memory_write (context, addr.w + 1, context->state.d);
     context->used_cycles += 20;
 }
 
@@ -1948,7 +2050,7 @@ static void z80_ed_57_ld_a_i (Z80_Context *context)
 /* IN E, (C) */
 static void z80_ed_58_in_e_c (Z80_Context *context)
 {
-    context->state.e = context->io_read (context->parent, context->state.c);
+    context->state.e = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.e);
     context->used_cycles += 12;
 }
@@ -1957,7 +2059,7 @@ static void z80_ed_58_in_e_c (Z80_Context *context)
 /* OUT (C), E */
 static void z80_ed_59_out_c_e (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.e);
+    z80_io_write (context, context->state.c, context->state.e);
     context->used_cycles += 12;
 }
 
@@ -1968,7 +2070,6 @@ static void z80_ed_5a_adc_hl_de (Z80_Context *context)
     uint16_t temp = context->state.de + context->state.flag_carry;
     SET_FLAGS_ADC_16 (context->state.de);
     context->state.hl += temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -1977,11 +2078,11 @@ static void z80_ed_5a_adc_hl_de (Z80_Context *context)
 static void z80_ed_5b_ld_de_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->state.e = context->memory_read (context->parent, addr.w);
-    context->state.d = context->memory_read (context->parent, addr.w + 1);
+    context->state.e = z80_memory_read (context, addr.w);
+    context->state.d = z80_memory_read (context, addr.w + 1);
     context->used_cycles += 20;
 }
 
@@ -2024,7 +2125,7 @@ static void z80_ed_5f_ld_a_r (Z80_Context *context)
 /* IN H, (C) */
 static void z80_ed_60_in_h_c (Z80_Context *context)
 {
-    context->state.h = context->io_read (context->parent, context->state.c);
+    context->state.h = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.h);
     context->used_cycles += 12;
 }
@@ -2033,7 +2134,7 @@ static void z80_ed_60_in_h_c (Z80_Context *context)
 /* OUT (C), H */
 static void z80_ed_61_out_c_h (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.h);
+    z80_io_write (context, context->state.c, context->state.h);
     context->used_cycles += 12;
 }
 
@@ -2044,7 +2145,6 @@ static void z80_ed_62_sbc_hl_hl (Z80_Context *context)
     uint16_t temp = context->state.hl + context->state.flag_carry;
     SET_FLAGS_SBC_16 (context->state.hl);
     context->state.hl -= temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -2053,11 +2153,11 @@ static void z80_ed_62_sbc_hl_hl (Z80_Context *context)
 static void z80_ed_63_ld_xx_hl (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->memory_write (context->parent, addr.w,     context->state.l);
-    context->memory_write (context->parent, addr.w + 1, context->state.h);
+    z80_memory_write (context, addr.w,     context->state.l);
+    z80_memory_write (context, addr.w + 1, context->state.h);
     context->used_cycles += 20;
 }
 
@@ -2089,18 +2189,17 @@ static void z80_ed_67_rrd (Z80_Context *context)
     uint16_split_t shifted;
 
     /* Calculate 12-bit value */
-    shifted.l = context->memory_read (context->parent, context->state.hl);
+    shifted.l = z80_memory_read (context, context->state.hl);
     shifted.h = context->state.a & 0x0f;
     shifted.w = (shifted.w >> 4) | ((shifted.w & 0x000f) << 8);
 
     /* Lower 8 bits go to memory */
-    context->memory_write (context->parent, context->state.hl, shifted.l);
+    z80_memory_write (context, context->state.hl, shifted.l);
 
     /* Upper 4 bits go to A */
     context->state.a = (context->state.a & 0xf0) | shifted.h;
 
     SET_FLAGS_RLD_RRD;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 18;
 }
 
@@ -2108,7 +2207,7 @@ static void z80_ed_67_rrd (Z80_Context *context)
 /* IN L, (C) */
 static void z80_ed_68_in_l_c (Z80_Context *context)
 {
-    context->state.l = context->io_read (context->parent, context->state.c);
+    context->state.l = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.l);
     context->used_cycles += 12;
 }
@@ -2117,7 +2216,7 @@ static void z80_ed_68_in_l_c (Z80_Context *context)
 /* OUT (C), L */
 static void z80_ed_69_out_c_l (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.l);
+    z80_io_write (context, context->state.c, context->state.l);
     context->used_cycles += 12;
 }
 
@@ -2128,7 +2227,6 @@ static void z80_ed_6a_adc_hl_hl (Z80_Context *context)
     uint16_t temp = context->state.hl + context->state.flag_carry;
     SET_FLAGS_ADC_16 (context->state.hl);
     context->state.hl += temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -2137,11 +2235,11 @@ static void z80_ed_6a_adc_hl_hl (Z80_Context *context)
 static void z80_ed_6b_ld_hl_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->state.l = context->memory_read (context->parent, addr.w);
-    context->state.h = context->memory_read (context->parent, addr.w + 1);
+    context->state.l = z80_memory_read (context, addr.w);
+    context->state.h = z80_memory_read (context, addr.w + 1);
     context->used_cycles += 20;
 }
 
@@ -2173,16 +2271,15 @@ static void z80_ed_6f_rld (Z80_Context *context)
     uint16_split_t shifted;
 
     /* Calculate 12-bit value */
-    shifted.w = ((uint16_t) context->memory_read (context->parent, context->state.hl) << 4) | (context->state.a & 0x0f);
+    shifted.w = ((uint16_t) z80_memory_read (context, context->state.hl) << 4) | (context->state.a & 0x0f);
 
     /* Lower 8 bits go to memory */
-    context->memory_write (context->parent, context->state.hl, shifted.l);
+    z80_memory_write (context, context->state.hl, shifted.l);
 
     /* Upper 4 bits go to A */
     context->state.a = (context->state.a & 0xf0) | shifted.h;
 
     SET_FLAGS_RLD_RRD;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 18;
 }
 
@@ -2191,7 +2288,7 @@ static void z80_ed_6f_rld (Z80_Context *context)
 static void z80_ed_70_in_c (Z80_Context *context)
 {
     uint8_t throwaway;
-    throwaway = context->io_read (context->parent, context->state.c);
+    throwaway = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (throwaway);
     context->used_cycles += 12;
 }
@@ -2200,7 +2297,7 @@ static void z80_ed_70_in_c (Z80_Context *context)
 /* OUT (C), 0 (undocumented) */
 static void z80_ed_71_out_c_0 (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, 0);
+    z80_io_write (context, context->state.c, 0);
     context->used_cycles += 12;
 }
 
@@ -2211,7 +2308,6 @@ static void z80_ed_72_sbc_hl_sp (Z80_Context *context)
     uint16_t temp = context->state.sp + context->state.flag_carry;
     SET_FLAGS_SBC_16 (context->state.sp);
     context->state.hl -= temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -2220,11 +2316,11 @@ static void z80_ed_72_sbc_hl_sp (Z80_Context *context)
 static void z80_ed_73_ld_xx_sp (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->memory_write (context->parent, addr.w,     context->state.sp_l);
-    context->memory_write (context->parent, addr.w + 1, context->state.sp_h);
+    z80_memory_write (context, addr.w,     context->state.sp_l);
+    z80_memory_write (context, addr.w + 1, context->state.sp_h);
     context->used_cycles += 20;
 }
 
@@ -2253,7 +2349,7 @@ static void z80_ed_76_im_1 (Z80_Context *context)
 /* IN A, (C) */
 static void z80_ed_78_in_a_c (Z80_Context *context)
 {
-    context->state.a = context->io_read (context->parent, context->state.c);
+    context->state.a = z80_io_read (context, context->state.c);
     SET_FLAGS_ED_IN (context->state.a);
     context->used_cycles += 12;
 }
@@ -2262,7 +2358,7 @@ static void z80_ed_78_in_a_c (Z80_Context *context)
 /* OUT (C), A */
 static void z80_ed_79_out_c_a (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->state.a);
+    z80_io_write (context, context->state.c, context->state.a);
     context->used_cycles += 12;
 }
 
@@ -2273,7 +2369,6 @@ static void z80_ed_7a_adc_hl_sp (Z80_Context *context)
     uint16_t temp = context->state.sp + context->state.flag_carry;
     SET_FLAGS_ADC_16 (context->state.sp);
     context->state.hl += temp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 15;
 }
 
@@ -2282,11 +2377,11 @@ static void z80_ed_7a_adc_hl_sp (Z80_Context *context)
 static void z80_ed_7b_ld_sp_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
-    context->state.sp_l = context->memory_read (context->parent, addr.w);
-    context->state.sp_h = context->memory_read (context->parent, addr.w + 1);
+    context->state.sp_l = z80_memory_read (context, addr.w);
+    context->state.sp_h = z80_memory_read (context, addr.w + 1);
     context->used_cycles += 20;
 }
 
@@ -2315,8 +2410,8 @@ static void z80_ed_7e_im_2 (Z80_Context *context)
 /* LDI */
 static void z80_ed_a0_ldi (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
-    context->memory_write (context->parent, context->state.de, value);
+    uint8_t value = z80_memory_read (context, context->state.hl);
+    z80_memory_write (context, context->state.de, value);
     value += context->state.a;
     context->state.hl++;
     context->state.de++;
@@ -2333,7 +2428,7 @@ static void z80_ed_a0_ldi (Z80_Context *context)
 /* CPI */
 static void z80_ed_a1_cpi (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     context->state.hl++;
     context->state.bc--;
     context->state.flag_sub = 1;
@@ -2352,7 +2447,7 @@ static void z80_ed_a1_cpi (Z80_Context *context)
 /* INI */
 static void z80_ed_a2_ini (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->io_read (context->parent, context->state.c));
+    z80_memory_write (context, context->state.hl, z80_io_read (context, context->state.c));
     context->state.hl++;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2368,7 +2463,7 @@ static void z80_ed_a2_ini (Z80_Context *context)
 /* OUTI */
 static void z80_ed_a3_outi (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->memory_read (context->parent, context->state.hl));
+    z80_io_write (context, context->state.c, z80_memory_read (context, context->state.hl));
     context->state.hl++;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2383,8 +2478,8 @@ static void z80_ed_a3_outi (Z80_Context *context)
 /* LDD */
 static void z80_ed_a8_ldd (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
-    context->memory_write (context->parent, context->state.de, value);
+    uint8_t value = z80_memory_read (context, context->state.hl);
+    z80_memory_write (context, context->state.de, value);
     value += context->state.a;
     context->state.hl--;
     context->state.de--;
@@ -2401,7 +2496,7 @@ static void z80_ed_a8_ldd (Z80_Context *context)
 /* CPD */
 static void z80_ed_a9_cpd (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     context->state.hl--;
     context->state.bc--;
     context->state.flag_sub = 1;
@@ -2420,7 +2515,7 @@ static void z80_ed_a9_cpd (Z80_Context *context)
 /* IND */
 static void z80_ed_aa_ind (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->io_read (context->parent, context->state.c));
+    z80_memory_write (context, context->state.hl, z80_io_read (context, context->state.c));
     context->state.hl--;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2437,9 +2532,9 @@ static void z80_ed_ab_outd (Z80_Context *context)
 {
     /* TODO: Implement 'unknown' flag behaviour.
      *       Described in 'The Undocumented Z80 Documented'. */
-    uint8_t temp = context->memory_read (context->parent, context->state.hl);
+    uint8_t temp = z80_memory_read (context, context->state.hl);
     context->state.b--;
-    context->io_write (context->parent, context->state.c, temp);
+    z80_io_write (context, context->state.c, temp);
     context->state.hl--;
     context->state.flag_sub = 1;
     context->state.flag_zero = (context->state.b == 0);
@@ -2450,8 +2545,8 @@ static void z80_ed_ab_outd (Z80_Context *context)
 /* LDIR */
 static void z80_ed_b0_ldir (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
-    context->memory_write (context->parent, context->state.de, value);
+    uint8_t value = z80_memory_read (context, context->state.hl);
+    z80_memory_write (context, context->state.de, value);
     value += context->state.a;
     context->state.hl++;
     context->state.de++;
@@ -2476,7 +2571,7 @@ static void z80_ed_b0_ldir (Z80_Context *context)
 /* CPIR */
 static void z80_ed_b1_cpir (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     context->state.hl++;
     context->state.bc--;
     if (context->state.bc != 0 && context->state.a != value)
@@ -2503,7 +2598,7 @@ static void z80_ed_b1_cpir (Z80_Context *context)
 /* INIR */
 static void z80_ed_b2_inir (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->io_read (context->parent, context->state.c));
+    z80_memory_write (context, context->state.hl, z80_io_read (context, context->state.c));
     context->state.hl++;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2526,7 +2621,7 @@ static void z80_ed_b2_inir (Z80_Context *context)
 /* OTIR */
 static void z80_ed_b3_otir (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->memory_read (context->parent, context->state.hl));
+    z80_io_write (context, context->state.c, z80_memory_read (context, context->state.hl));
     context->state.hl++;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2549,8 +2644,8 @@ static void z80_ed_b3_otir (Z80_Context *context)
 /* LDDR */
 static void z80_ed_b8_lddr (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
-    context->memory_write (context->parent, context->state.de, value);
+    uint8_t value = z80_memory_read (context, context->state.hl);
+    z80_memory_write (context, context->state.de, value);
     value += context->state.a;
     context->state.hl--;
     context->state.de--;
@@ -2575,7 +2670,7 @@ static void z80_ed_b8_lddr (Z80_Context *context)
 /* CPDR */
 static void z80_ed_b9_cpdr (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     context->state.hl--;
     context->state.bc--;
     context->state.flag_sub = 1;
@@ -2602,7 +2697,7 @@ static void z80_ed_b9_cpdr (Z80_Context *context)
 /* INDR */
 static void z80_ed_ba_indr (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->io_read (context->parent, context->state.c));
+    z80_memory_write (context, context->state.hl, z80_io_read (context, context->state.c));
     context->state.hl--;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2625,7 +2720,7 @@ static void z80_ed_ba_indr (Z80_Context *context)
 /* OTDR */
 static void z80_ed_bb_otdr (Z80_Context *context)
 {
-    context->io_write (context->parent, context->state.c, context->memory_read (context->parent, context->state.hl));
+    z80_io_write (context, context->state.c, z80_memory_read (context, context->state.hl));
     context->state.hl--;
     context->state.b--;
     context->state.flag_sub = 1;
@@ -2734,8 +2829,8 @@ static void z80_00_nop (Z80_Context *context)
 /* LD BC, ** */
 static void z80_01_ld_bc_xx (Z80_Context *context)
 {
-    context->state.c = context->memory_read (context->parent, context->state.pc++);
-    context->state.b = context->memory_read (context->parent, context->state.pc++);
+    context->state.c = z80_memory_read (context, context->state.pc++);
+    context->state.b = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 10;
 }
 
@@ -2743,7 +2838,7 @@ static void z80_01_ld_bc_xx (Z80_Context *context)
 /* LD (BC), A */
 static void z80_02_ld_bc_a (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.bc, context->state.a);
+    z80_memory_write (context, context->state.bc, context->state.a);
     context->used_cycles += 7;
 }
 
@@ -2761,7 +2856,6 @@ static void z80_04_inc_b (Z80_Context *context)
 {
     context->state.b++;
     SET_FLAGS_INC (context->state.b);
-    SET_FLAGS_XY (context->state.b);
     context->used_cycles += 4;
 }
 
@@ -2771,7 +2865,6 @@ static void z80_05_dec_b (Z80_Context *context)
 {
     context->state.b--;
     SET_FLAGS_DEC (context->state.b);
-    SET_FLAGS_XY (context->state.b);
     context->used_cycles += 4;
 }
 
@@ -2779,7 +2872,7 @@ static void z80_05_dec_b (Z80_Context *context)
 /* LD B, * */
 static void z80_06_ld_b_x (Z80_Context *context)
 {
-    context->state.b = context->memory_read (context->parent, context->state.pc++);
+    context->state.b = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -2809,7 +2902,6 @@ static void z80_09_add_hl_bc (Z80_Context *context)
 {
     SET_FLAGS_ADD_16 (context->state.hl, context->state.bc);
     context->state.hl += context->state.bc;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 11;
 }
 
@@ -2817,7 +2909,7 @@ static void z80_09_add_hl_bc (Z80_Context *context)
 /* LD A, (BC) */
 static void z80_0a_ld_a_bc (Z80_Context *context)
 {
-    context->state.a = context->memory_read (context->parent, context->state.bc);
+    context->state.a = z80_memory_read (context, context->state.bc);
     context->used_cycles += 7;
 }
 
@@ -2835,7 +2927,6 @@ static void z80_0c_inc_c (Z80_Context *context)
 {
     context->state.c++;
     SET_FLAGS_INC (context->state.c);
-    SET_FLAGS_XY (context->state.c);
     context->used_cycles += 4;
 }
 
@@ -2845,7 +2936,6 @@ static void z80_0d_dec_c (Z80_Context *context)
 {
     context->state.c--;
     SET_FLAGS_DEC (context->state.c);
-    SET_FLAGS_XY (context->state.c);
     context->used_cycles += 4;
 }
 
@@ -2853,7 +2943,7 @@ static void z80_0d_dec_c (Z80_Context *context)
 /* LD C, * */
 static void z80_0e_ld_c_x (Z80_Context *context)
 {
-    context->state.c = context->memory_read (context->parent, context->state.pc++);
+    context->state.c = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -2873,7 +2963,7 @@ static void z80_0f_rrca (Z80_Context *context)
 /* DJNZ */
 static void z80_10_djnz (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
 
     if (--context->state.b)
     {
@@ -2890,8 +2980,8 @@ static void z80_10_djnz (Z80_Context *context)
 /* LD DE, ** */
 static void z80_11_ld_de_xx (Z80_Context *context)
 {
-    context->state.e = context->memory_read (context->parent, context->state.pc++);
-    context->state.d = context->memory_read (context->parent, context->state.pc++);
+    context->state.e = z80_memory_read (context, context->state.pc++);
+    context->state.d = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 10;
 }
 
@@ -2899,7 +2989,7 @@ static void z80_11_ld_de_xx (Z80_Context *context)
 /* LD (DE), A */
 static void z80_12_ld_de_a (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.de, context->state.a);
+    z80_memory_write (context, context->state.de, context->state.a);
     context->used_cycles += 7;
 }
 
@@ -2917,7 +3007,6 @@ static void z80_14_inc_d (Z80_Context *context)
 {
     context->state.d++;
     SET_FLAGS_INC (context->state.d);
-    SET_FLAGS_XY (context->state.d);
     context->used_cycles += 4;
 }
 
@@ -2927,7 +3016,6 @@ static void z80_15_dec_d (Z80_Context *context)
 {
     context->state.d--;
     SET_FLAGS_DEC (context->state.d);
-    SET_FLAGS_XY (context->state.d);
     context->used_cycles += 4;
 }
 
@@ -2935,7 +3023,7 @@ static void z80_15_dec_d (Z80_Context *context)
 /* LD D, * */
 static void z80_16_ld_d_x (Z80_Context *context)
 {
-    context->state.d = context->memory_read (context->parent, context->state.pc++);
+    context->state.d = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -2956,9 +3044,14 @@ static void z80_17_rla (Z80_Context *context)
 /* JR */
 static void z80_18_jr (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
     context->state.pc += (int8_t) imm;
     context->used_cycles += 12;
+
+    if ((int8_t) imm < 0)
+    {
+        z80_idle_check (context);
+    }
 }
 
 
@@ -2967,7 +3060,6 @@ static void z80_19_add_hl_de (Z80_Context *context)
 {
     SET_FLAGS_ADD_16 (context->state.hl, context->state.de);
     context->state.hl += context->state.de;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 11;
 }
 
@@ -2975,7 +3067,7 @@ static void z80_19_add_hl_de (Z80_Context *context)
 /* LD A, (DE) */
 static void z80_1a_ld_a_de (Z80_Context *context)
 {
-    context->state.a = context->memory_read (context->parent, context->state.de);
+    context->state.a = z80_memory_read (context, context->state.de);
     context->used_cycles += 7;
 }
 
@@ -2993,7 +3085,6 @@ static void z80_1c_inc_e (Z80_Context *context)
 {
     context->state.e++;
     SET_FLAGS_INC (context->state.e);
-    SET_FLAGS_XY (context->state.e);
     context->used_cycles += 4;
 }
 
@@ -3003,7 +3094,6 @@ static void z80_1d_dec_e (Z80_Context *context)
 {
     context->state.e--;
     SET_FLAGS_DEC (context->state.e);
-    SET_FLAGS_XY (context->state.e);
     context->used_cycles += 4;
 }
 
@@ -3011,7 +3101,7 @@ static void z80_1d_dec_e (Z80_Context *context)
 /* LD E, * */
 static void z80_1e_ld_e_x (Z80_Context *context)
 {
-    context->state.e = context->memory_read (context->parent, context->state.pc++);
+    context->state.e = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -3032,7 +3122,7 @@ static void z80_1f_rra (Z80_Context *context)
 /* JR NZ */
 static void z80_20_jr_nz (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_zero)
     {
@@ -3042,6 +3132,11 @@ static void z80_20_jr_nz (Z80_Context *context)
     {
         context->state.pc += (int8_t) imm;
         context->used_cycles += 12;
+
+        if ((int8_t) imm < 0)
+        {
+            z80_idle_check (context);
+        }
     }
 }
 
@@ -3049,8 +3144,8 @@ static void z80_20_jr_nz (Z80_Context *context)
 /* LD HL, ** */
 static void z80_21_ld_hl_xx (Z80_Context *context)
 {
-    context->state.l = context->memory_read (context->parent, context->state.pc++);
-    context->state.h = context->memory_read (context->parent, context->state.pc++);
+    context->state.l = z80_memory_read (context, context->state.pc++);
+    context->state.h = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 10;
 }
 
@@ -3059,10 +3154,10 @@ static void z80_21_ld_hl_xx (Z80_Context *context)
 static void z80_22_ld_xx_hl (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, addr.w,     context->state.l);
-    context->memory_write (context->parent, addr.w + 1, context->state.h);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, addr.w,     context->state.l);
+    z80_memory_write (context, addr.w + 1, context->state.h);
     context->used_cycles += 16;
 }
 
@@ -3080,7 +3175,6 @@ static void z80_24_inc_h (Z80_Context *context)
 {
     context->state.h++;
     SET_FLAGS_INC (context->state.h);
-    SET_FLAGS_XY (context->state.h);
     context->used_cycles += 4;
 }
 
@@ -3090,7 +3184,6 @@ static void z80_25_dec_h (Z80_Context *context)
 {
     context->state.h--;
     SET_FLAGS_DEC (context->state.h);
-    SET_FLAGS_XY (context->state.h);
     context->used_cycles += 4;
 }
 
@@ -3098,7 +3191,7 @@ static void z80_25_dec_h (Z80_Context *context)
 /* LD H, * */
 static void z80_26_ld_h_x (Z80_Context *context)
 {
-    context->state.h = context->memory_read (context->parent, context->state.pc++);
+    context->state.h = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -3173,12 +3266,17 @@ static void z80_27_daa (Z80_Context *context)
 /* JR Z */
 static void z80_28_jr_z (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_zero)
     {
         context->state.pc += (int8_t) imm;
         context->used_cycles += 12;
+
+        if ((int8_t) imm < 0)
+        {
+            z80_idle_check (context);
+        }
     }
     else
     {
@@ -3192,7 +3290,6 @@ static void z80_29_add_hl_hl (Z80_Context *context)
 {
     SET_FLAGS_ADD_16 (context->state.hl, context->state.hl);
     context->state.hl += context->state.hl;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 11;
 }
 
@@ -3201,10 +3298,10 @@ static void z80_29_add_hl_hl (Z80_Context *context)
 static void z80_2a_ld_hl_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    context->state.l = context->memory_read (context->parent, addr.w);
-    context->state.h = context->memory_read (context->parent, addr.w + 1);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    context->state.l = z80_memory_read (context, addr.w);
+    context->state.h = z80_memory_read (context, addr.w + 1);
     context->used_cycles += 16;
 }
 
@@ -3222,7 +3319,6 @@ static void z80_2c_inc_l (Z80_Context *context)
 {
     context->state.l++;
     SET_FLAGS_INC (context->state.l);
-    SET_FLAGS_XY (context->state.l);
     context->used_cycles += 4;
 }
 
@@ -3232,7 +3328,6 @@ static void z80_2d_dec_l (Z80_Context *context)
 {
     context->state.l--;
     SET_FLAGS_DEC (context->state.l);
-    SET_FLAGS_XY (context->state.l);
     context->used_cycles += 4;
 }
 
@@ -3240,7 +3335,7 @@ static void z80_2d_dec_l (Z80_Context *context)
 /* LD L, * */
 static void z80_2e_ld_l_x (Z80_Context *context)
 {
-    context->state.l = context->memory_read (context->parent, context->state.pc++);
+    context->state.l = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -3259,7 +3354,7 @@ static void z80_2f_cpl (Z80_Context *context)
 /* JR NC */
 static void z80_30_jr_nc (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_carry)
     {
@@ -3269,6 +3364,11 @@ static void z80_30_jr_nc (Z80_Context *context)
     {
         context->state.pc += (int8_t) imm;
         context->used_cycles += 12;
+
+        if ((int8_t) imm < 0)
+        {
+            z80_idle_check (context);
+        }
     }
 }
 
@@ -3276,8 +3376,8 @@ static void z80_30_jr_nc (Z80_Context *context)
 /* LD SP, ** */
 static void z80_31_ld_sp_xx (Z80_Context *context)
 {
-    context->state.sp_l = context->memory_read (context->parent, context->state.pc++);
-    context->state.sp_h = context->memory_read (context->parent, context->state.pc++);
+    context->state.sp_l = z80_memory_read (context, context->state.pc++);
+    context->state.sp_h = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 10;
 }
 
@@ -3286,9 +3386,9 @@ static void z80_31_ld_sp_xx (Z80_Context *context)
 static void z80_32_ld_xx_a (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, addr.w, context->state.a);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, addr.w, context->state.a);
     context->used_cycles += 13;
 }
 
@@ -3304,11 +3404,10 @@ static void z80_33_inc_sp (Z80_Context *context)
 /* INC (HL) */
 static void z80_34_inc_hl (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     value++;
-    context->memory_write (context->parent, context->state.hl, value);
+    z80_memory_write (context, context->state.hl, value);
     SET_FLAGS_INC (value);
-    SET_FLAGS_XY (value);
     context->used_cycles += 11;
 }
 
@@ -3316,11 +3415,10 @@ static void z80_34_inc_hl (Z80_Context *context)
 /* DEC (HL) */
 static void z80_35_dec_hl (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     value--;
-    context->memory_write (context->parent, context->state.hl, value);
+    z80_memory_write (context, context->state.hl, value);
     SET_FLAGS_DEC (value);
-    SET_FLAGS_XY (value);
     context->used_cycles += 11;
 }
 
@@ -3328,7 +3426,7 @@ static void z80_35_dec_hl (Z80_Context *context)
 /* LD (HL), * */
 static void z80_36_ld_hl_x (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->memory_read (context->parent, context->state.pc++));
+    z80_memory_write (context, context->state.hl, z80_memory_read (context, context->state.pc++));
     context->used_cycles += 10;
 }
 
@@ -3347,12 +3445,17 @@ static void z80_37_scf (Z80_Context *context)
 /* JR C, * */
 static void z80_38_jr_c_x (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_carry)
     {
         context->state.pc += (int8_t) imm;
         context->used_cycles += 12;
+
+        if ((int8_t) imm < 0)
+        {
+            z80_idle_check (context);
+        }
     }
     else
     {
@@ -3366,7 +3469,6 @@ static void z80_39_add_hl_sp (Z80_Context *context)
 {
     SET_FLAGS_ADD_16 (context->state.hl, context->state.sp);
     context->state.hl += context->state.sp;
-    SET_FLAGS_XY_16 (context->state.hl);
     context->used_cycles += 11;
 }
 
@@ -3375,9 +3477,9 @@ static void z80_39_add_hl_sp (Z80_Context *context)
 static void z80_3a_ld_a_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    context->state.a = context->memory_read (context->parent, addr.w);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    context->state.a = z80_memory_read (context, addr.w);
     context->used_cycles += 13;
 }
 
@@ -3395,7 +3497,6 @@ static void z80_3c_inc_a (Z80_Context *context)
 {
     context->state.a++;
     SET_FLAGS_INC (context->state.a);
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3404,7 +3505,6 @@ static void z80_3d_dec_a (Z80_Context *context)
 {
     context->state.a--;
     SET_FLAGS_DEC (context->state.a);
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3412,7 +3512,7 @@ static void z80_3d_dec_a (Z80_Context *context)
 /* LD A, * */
 static void z80_3e_ld_a_x (Z80_Context *context)
 {
-    context->state.a = context->memory_read (context->parent, context->state.pc++);
+    context->state.a = z80_memory_read (context, context->state.pc++);
     context->used_cycles += 7;
 }
 
@@ -3478,7 +3578,7 @@ static void z80_45_ld_b_l (Z80_Context *context)
 /* LD B, (HL) */
 static void z80_46_ld_b_hl (Z80_Context *context)
 {
-    context->state.b = context->memory_read (context->parent, context->state.hl);
+    context->state.b = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3541,7 +3641,7 @@ static void z80_4d_ld_c_l (Z80_Context *context)
 /* LD C, (HL) */
 static void z80_4e_ld_c_hl (Z80_Context *context)
 {
-    context->state.c = context->memory_read (context->parent, context->state.hl);
+    context->state.c = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3604,7 +3704,7 @@ static void z80_55_ld_d_l (Z80_Context *context)
 /* LD D, (HL) */
 static void z80_56_ld_d_hl (Z80_Context *context)
 {
-    context->state.d = context->memory_read (context->parent, context->state.hl);
+    context->state.d = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3667,7 +3767,7 @@ static void z80_5d_ld_e_l (Z80_Context *context)
 /* LD E, (HL) */
 static void z80_5e_ld_e_hl (Z80_Context *context)
 {
-    context->state.e = context->memory_read (context->parent, context->state.hl);
+    context->state.e = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3730,7 +3830,7 @@ static void z80_65_ld_h_l (Z80_Context *context)
 /* LD H, (HL) */
 static void z80_66_ld_h_hl (Z80_Context *context)
 {
-    context->state.h = context->memory_read (context->parent, context->state.hl);
+    context->state.h = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3793,7 +3893,7 @@ static void z80_6d_ld_l_l (Z80_Context *context)
 /* LD L, (HL) */
 static void z80_6e_ld_l_hl (Z80_Context *context)
 {
-    context->state.l = context->memory_read (context->parent, context->state.hl);
+    context->state.l = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3809,7 +3909,7 @@ static void z80_6f_ld_l_a (Z80_Context *context)
 /* LD (HL), B */
 static void z80_70_ld_hl_b (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.b);
+    z80_memory_write (context, context->state.hl, context->state.b);
     context->used_cycles += 7;
 }
 
@@ -3817,7 +3917,7 @@ static void z80_70_ld_hl_b (Z80_Context *context)
 /* LD (HL), C */
 static void z80_71_ld_hl_c (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.c);
+    z80_memory_write (context, context->state.hl, context->state.c);
     context->used_cycles += 7;
 }
 
@@ -3825,7 +3925,7 @@ static void z80_71_ld_hl_c (Z80_Context *context)
 /* LD (HL), D */
 static void z80_72_ld_hl_d (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.d);
+    z80_memory_write (context, context->state.hl, context->state.d);
     context->used_cycles += 7;
 }
 
@@ -3833,7 +3933,7 @@ static void z80_72_ld_hl_d (Z80_Context *context)
 /* LD (HL), E */
 static void z80_73_ld_hl_e (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.e);
+    z80_memory_write (context, context->state.hl, context->state.e);
     context->used_cycles += 7;
 }
 
@@ -3841,7 +3941,7 @@ static void z80_73_ld_hl_e (Z80_Context *context)
 /* LD (HL), H */
 static void z80_74_ld_hl_h (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.h);
+    z80_memory_write (context, context->state.hl, context->state.h);
     context->used_cycles += 7;
 }
 
@@ -3849,7 +3949,7 @@ static void z80_74_ld_hl_h (Z80_Context *context)
 /* LD (HL), L */
 static void z80_75_ld_hl_l (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.l);
+    z80_memory_write (context, context->state.hl, context->state.l);
     context->used_cycles += 7;
 }
 
@@ -3865,7 +3965,7 @@ static void z80_76_halt (Z80_Context *context)
 /* LD (HL), A */
 static void z80_77_ld_hl_a (Z80_Context *context)
 {
-    context->memory_write (context->parent, context->state.hl, context->state.a);
+    z80_memory_write (context, context->state.hl, context->state.a);
     context->used_cycles += 7;
 }
 
@@ -3921,7 +4021,7 @@ static void z80_7d_ld_a_l (Z80_Context *context)
 /* LD A, (HL) */
 static void z80_7e_ld_a_hl (Z80_Context *context)
 {
-    context->state.a = context->memory_read (context->parent, context->state.hl);
+    context->state.a = z80_memory_read (context, context->state.hl);
     context->used_cycles += 7;
 }
 
@@ -3938,7 +4038,6 @@ static void z80_80_add_a_b (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.b);
     context->state.a += context->state.b;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3947,7 +4046,6 @@ static void z80_81_add_a_c (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.c);
     context->state.a += context->state.c;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3957,7 +4055,6 @@ static void z80_82_add_a_d (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.d);
     context->state.a += context->state.d;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3967,7 +4064,6 @@ static void z80_83_add_a_e (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.e);
     context->state.a += context->state.e;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3976,7 +4072,6 @@ static void z80_84_add_a_h (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.h);
     context->state.a += context->state.h;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3986,7 +4081,6 @@ static void z80_85_add_a_l (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.l);
     context->state.a += context->state.l;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -3994,10 +4088,9 @@ static void z80_85_add_a_l (Z80_Context *context)
 /* ADD A, (HL) */
 static void z80_86_add_a_hl (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     SET_FLAGS_ADD (context->state.a, value);
     context->state.a += value;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4007,7 +4100,6 @@ static void z80_87_add_a_a (Z80_Context *context)
 {
     SET_FLAGS_ADD (context->state.a, context->state.a);
     context->state.a += context->state.a;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4018,7 +4110,6 @@ static void z80_88_adc_a_b (Z80_Context *context)
     uint8_t temp = context->state.b + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.b);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4029,7 +4120,6 @@ static void z80_89_adc_a_c (Z80_Context *context)
     uint8_t temp = context->state.c + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.c);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4040,7 +4130,6 @@ static void z80_8a_adc_a_d (Z80_Context *context)
     uint8_t temp = context->state.d + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.d);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4051,7 +4140,6 @@ static void z80_8b_adc_a_e (Z80_Context *context)
     uint8_t temp = context->state.e + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.e);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4062,7 +4150,6 @@ static void z80_8c_adc_a_h (Z80_Context *context)
     uint8_t temp = context->state.h + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.h);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4073,7 +4160,6 @@ static void z80_8d_adc_a_l (Z80_Context *context)
     uint8_t temp = context->state.l + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.l);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4081,11 +4167,10 @@ static void z80_8d_adc_a_l (Z80_Context *context)
 /* ADC A, (HL) */
 static void z80_8e_adc_a_hl (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     uint8_t temp = value + context->state.flag_carry;
     SET_FLAGS_ADC (value);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4096,7 +4181,6 @@ static void z80_8f_adc_a_a (Z80_Context *context)
     uint8_t temp = context->state.a + context->state.flag_carry;
     SET_FLAGS_ADC (context->state.a);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4106,7 +4190,6 @@ static void z80_90_sub_a_b (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.b);
     context->state.a -= context->state.b;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4116,7 +4199,6 @@ static void z80_91_sub_a_c (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.c);
     context->state.a -= context->state.c;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4126,7 +4208,6 @@ static void z80_92_sub_a_d (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.d);
     context->state.a -= context->state.d;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4136,7 +4217,6 @@ static void z80_93_sub_a_e (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.e);
     context->state.a -= context->state.e;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4146,7 +4226,6 @@ static void z80_94_sub_a_h (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.h);
     context->state.a -= context->state.h;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4156,7 +4235,6 @@ static void z80_95_sub_a_l (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.l);
     context->state.a -= context->state.l;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4164,10 +4242,9 @@ static void z80_95_sub_a_l (Z80_Context *context)
 /* SUB A, (HL) */
 static void z80_96_sub_a_hl (Z80_Context *context)
 {
-    uint8_t temp = context->memory_read (context->parent, context->state.hl);
+    uint8_t temp = z80_memory_read (context, context->state.hl);
     SET_FLAGS_SUB (context->state.a, temp);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4177,7 +4254,6 @@ static void z80_97_sub_a_a (Z80_Context *context)
 {
     SET_FLAGS_SUB (context->state.a, context->state.a);
     context->state.a -= context->state.a;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4188,7 +4264,6 @@ static void z80_98_sbc_a_b (Z80_Context *context)
     uint8_t temp = context->state.b + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.b);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4199,7 +4274,6 @@ static void z80_99_sbc_a_c (Z80_Context *context)
     uint8_t temp = context->state.c + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.c);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4210,7 +4284,6 @@ static void z80_9a_sbc_a_d (Z80_Context *context)
     uint8_t temp = context->state.d + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.d);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4221,7 +4294,6 @@ static void z80_9b_sbc_a_e (Z80_Context *context)
     uint8_t temp = context->state.e + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.e);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4232,7 +4304,6 @@ static void z80_9c_sbc_a_h (Z80_Context *context)
     uint8_t temp = context->state.h + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.h);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4243,7 +4314,6 @@ static void z80_9d_sbc_a_l (Z80_Context *context)
     uint8_t temp = context->state.l + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.l);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4251,11 +4321,10 @@ static void z80_9d_sbc_a_l (Z80_Context *context)
 /* SBC A, (HL) */
 static void z80_9e_sbc_a_hl (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
+    uint8_t value = z80_memory_read (context, context->state.hl);
     uint8_t temp = value + context->state.flag_carry;
     SET_FLAGS_SBC (value);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4266,7 +4335,6 @@ static void z80_9f_sbc_a_a (Z80_Context *context)
     uint8_t temp = context->state.a + context->state.flag_carry;
     SET_FLAGS_SBC (context->state.a);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4275,7 +4343,6 @@ static void z80_a0_and_a_b (Z80_Context *context)
 {
     context->state.a &= context->state.b;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4285,7 +4352,6 @@ static void z80_a1_and_a_c (Z80_Context *context)
 {
     context->state.a &= context->state.c;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4295,7 +4361,6 @@ static void z80_a2_and_a_d (Z80_Context *context)
 {
     context->state.a &= context->state.d;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4305,7 +4370,6 @@ static void z80_a3_and_a_e (Z80_Context *context)
 {
     context->state.a &= context->state.e;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4315,7 +4379,6 @@ static void z80_a4_and_a_h (Z80_Context *context)
 {
     context->state.a &= context->state.h;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4325,7 +4388,6 @@ static void z80_a5_and_a_l (Z80_Context *context)
 {
     context->state.a &= context->state.l;
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4333,9 +4395,8 @@ static void z80_a5_and_a_l (Z80_Context *context)
 /* AND A, (HL) */
 static void z80_a6_and_a_hl (Z80_Context *context)
 {
-    context->state.a &= context->memory_read (context->parent, context->state.hl);
+    context->state.a &= z80_memory_read (context, context->state.hl);
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4344,7 +4405,6 @@ static void z80_a6_and_a_hl (Z80_Context *context)
 static void z80_a7_and_a_a (Z80_Context *context)
 {
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4354,7 +4414,6 @@ static void z80_a8_xor_a_b (Z80_Context *context)
 {
     context->state.a ^= context->state.b;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4364,7 +4423,6 @@ static void z80_a9_xor_a_c (Z80_Context *context)
 {
     context->state.a ^= context->state.c;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4374,7 +4432,6 @@ static void z80_aa_xor_a_d (Z80_Context *context)
 {
     context->state.a ^= context->state.d;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4384,7 +4441,6 @@ static void z80_ab_xor_a_e (Z80_Context *context)
 {
     context->state.a ^= context->state.e;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4394,7 +4450,6 @@ static void z80_ac_xor_a_h (Z80_Context *context)
 {
     context->state.a ^= context->state.h;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4404,7 +4459,6 @@ static void z80_ad_xor_a_l (Z80_Context *context)
 {
     context->state.a ^= context->state.l;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4412,9 +4466,8 @@ static void z80_ad_xor_a_l (Z80_Context *context)
 /* XOR A, (HL) */
 static void z80_ae_xor_a_hl (Z80_Context *context)
 {
-    context->state.a ^= context->memory_read (context->parent, context->state.hl);
+    context->state.a ^= z80_memory_read (context, context->state.hl);
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4424,7 +4477,6 @@ static void z80_af_xor_a_a (Z80_Context *context)
 {
     context->state.a ^= context->state.a;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4434,7 +4486,6 @@ static void z80_b0_or_a_b (Z80_Context *context)
 {
     context->state.a |= context->state.b;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4444,7 +4495,6 @@ static void z80_b1_or_a_c (Z80_Context *context)
 {
     context->state.a |= context->state.c;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4454,7 +4504,6 @@ static void z80_b2_or_a_d (Z80_Context *context)
 {
     context->state.a |= context->state.d;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4464,7 +4513,6 @@ static void z80_b3_or_a_e (Z80_Context *context)
 {
     context->state.a |= context->state.e;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4474,7 +4522,6 @@ static void z80_b4_or_a_h (Z80_Context *context)
 {
     context->state.a |= context->state.h;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4484,7 +4531,6 @@ static void z80_b5_or_a_l (Z80_Context *context)
 {
     context->state.a |= context->state.l;
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4492,9 +4538,8 @@ static void z80_b5_or_a_l (Z80_Context *context)
 /* OR A, (HL) */
 static void z80_b6_or_a_hl (Z80_Context *context)
 {
-    context->state.a |= context->memory_read (context->parent, context->state.hl);
+    context->state.a |= z80_memory_read (context, context->state.hl);
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4503,7 +4548,6 @@ static void z80_b6_or_a_hl (Z80_Context *context)
 static void z80_b7_or_a_a (Z80_Context *context)
 {
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4511,8 +4555,7 @@ static void z80_b7_or_a_a (Z80_Context *context)
 /* CP A, B */
 static void z80_b8_cp_a_b (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.b);
-    SET_FLAGS_XY (context->state.b);
+    SET_FLAGS_CP (context->state.a, context->state.b);
     context->used_cycles += 4;
 }
 
@@ -4520,8 +4563,7 @@ static void z80_b8_cp_a_b (Z80_Context *context)
 /* CP A, C */
 static void z80_b9_cp_a_c (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.c);
-    SET_FLAGS_XY (context->state.c);
+    SET_FLAGS_CP (context->state.a, context->state.c);
     context->used_cycles += 4;
 }
 
@@ -4529,8 +4571,7 @@ static void z80_b9_cp_a_c (Z80_Context *context)
 /* CP A, D */
 static void z80_ba_cp_a_d (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.d);
-    SET_FLAGS_XY (context->state.d);
+    SET_FLAGS_CP (context->state.a, context->state.d);
     context->used_cycles += 4;
 }
 
@@ -4538,8 +4579,7 @@ static void z80_ba_cp_a_d (Z80_Context *context)
 /* CP A, E */
 static void z80_bb_cp_a_e (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.e);
-    SET_FLAGS_XY (context->state.e);
+    SET_FLAGS_CP (context->state.a, context->state.e);
     context->used_cycles += 4;
 }
 
@@ -4547,8 +4587,7 @@ static void z80_bb_cp_a_e (Z80_Context *context)
 /* CP A, H */
 static void z80_bc_cp_a_h (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.h);
-    SET_FLAGS_XY (context->state.h);
+    SET_FLAGS_CP (context->state.a, context->state.h);
     context->used_cycles += 4;
 }
 
@@ -4556,25 +4595,22 @@ static void z80_bc_cp_a_h (Z80_Context *context)
 /* CP A, L */
 static void z80_bd_cp_a_l (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.l);
-    SET_FLAGS_XY (context->state.l);
+    SET_FLAGS_CP (context->state.a, context->state.l);
     context->used_cycles += 4;
 }
 
 /* CP A, (HL) */
 static void z80_be_cp_a_hl (Z80_Context *context)
 {
-    uint8_t value = context->memory_read (context->parent, context->state.hl);
-    SET_FLAGS_SUB (context->state.a, value);
-    SET_FLAGS_XY (value);
+    uint8_t value = z80_memory_read (context, context->state.hl);
+    SET_FLAGS_CP (context->state.a, value);
     context->used_cycles += 7;
 }
 
 /* CP A, A */
 static void z80_bf_cp_a_a (Z80_Context *context)
 {
-    SET_FLAGS_SUB (context->state.a, context->state.a);
-    SET_FLAGS_XY (context->state.a);
+    SET_FLAGS_CP (context->state.a, context->state.a);
     context->used_cycles += 4;
 }
 
@@ -4588,8 +4624,8 @@ static void z80_c0_ret_nz (Z80_Context *context)
     }
     else
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
 }
@@ -4598,8 +4634,8 @@ static void z80_c0_ret_nz (Z80_Context *context)
 /* POP BC */
 static void z80_c1_pop_bc (Z80_Context *context)
 {
-    context->state.c = context->memory_read (context->parent, context->state.sp++);
-    context->state.b = context->memory_read (context->parent, context->state.sp++);
+    context->state.c = z80_memory_read (context, context->state.sp++);
+    context->state.b = z80_memory_read (context, context->state.sp++);
     context->used_cycles += 10;
 }
 
@@ -4608,8 +4644,8 @@ static void z80_c1_pop_bc (Z80_Context *context)
 static void z80_c2_jp_nz_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (!context->state.flag_zero)
     {
@@ -4623,8 +4659,8 @@ static void z80_c2_jp_nz_xx (Z80_Context *context)
 static void z80_c3_jp_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
     context->state.pc = addr.w;
     context->used_cycles += 10;
 }
@@ -4634,8 +4670,8 @@ static void z80_c3_jp_xx (Z80_Context *context)
 static void z80_c4_call_nz_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_zero)
     {
@@ -4643,8 +4679,8 @@ static void z80_c4_call_nz_xx (Z80_Context *context)
     }
     else
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -4654,8 +4690,8 @@ static void z80_c4_call_nz_xx (Z80_Context *context)
 /* PUSH BC */
 static void z80_c5_push_bc (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.b);
-    context->memory_write (context->parent, --context->state.sp, context->state.c);
+    z80_memory_write (context, --context->state.sp, context->state.b);
+    z80_memory_write (context, --context->state.sp, context->state.c);
     context->used_cycles += 11;
 }
 
@@ -4663,11 +4699,10 @@ static void z80_c5_push_bc (Z80_Context *context)
 /* ADD A, * */
 static void z80_c6_add_a_x (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
     /* ADD A,*    */
     SET_FLAGS_ADD (context->state.a, imm);
     context->state.a += imm;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4676,8 +4711,8 @@ static void z80_c6_add_a_x (Z80_Context *context)
 static void z80_c7_rst_00 (Z80_Context *context)
 {
     /* RST 00h    */
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0000;
     context->used_cycles += 11;
 }
@@ -4689,8 +4724,8 @@ static void z80_c8_ret_z (Z80_Context *context)
     /* RET Z      */
     if (context->state.flag_zero)
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
     else
@@ -4703,8 +4738,8 @@ static void z80_c8_ret_z (Z80_Context *context)
 /* RET */
 static void z80_c9_ret (Z80_Context *context)
 {
-    context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-    context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+    context->state.pc_l = z80_memory_read (context, context->state.sp++);
+    context->state.pc_h = z80_memory_read (context, context->state.sp++);
     context->used_cycles += 10;
 }
 
@@ -4713,8 +4748,8 @@ static void z80_c9_ret (Z80_Context *context)
 static void z80_ca_jp_z_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_zero)
     {
@@ -4730,7 +4765,7 @@ static void z80_cb_prefix (Z80_Context *context)
     /* Bump the R register */
     context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
 
-    uint8_t instruction = context->memory_read (context->parent, context->state.pc++);
+    uint8_t instruction = z80_memory_read (context, context->state.pc++);
 
     switch (instruction & 0x07)
     {
@@ -4768,12 +4803,12 @@ static void z80_cb_prefix (Z80_Context *context)
             if ((instruction & 0xc0) == 0x40)
             {
                 /* The BIT instruction is read-only */
-                z80_cb_instruction [instruction >> 3] (context, context->memory_read (context->parent, context->state.hl));
+                z80_cb_instruction [instruction >> 3] (context, z80_memory_read (context, context->state.hl));
                 context->used_cycles += 12;
             }
             else
             {
-                context->memory_write (context->parent, context->state.hl, z80_cb_instruction [instruction >> 3] (context, context->memory_read (context->parent, context->state.hl)));
+                z80_memory_write (context, context->state.hl, z80_cb_instruction [instruction >> 3] (context, z80_memory_read (context, context->state.hl)));
                 context->used_cycles += 15;
             }
             break;
@@ -4790,13 +4825,13 @@ static void z80_cb_prefix (Z80_Context *context)
 static void z80_cc_call_z_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_zero)
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -4811,10 +4846,10 @@ static void z80_cc_call_z_xx (Z80_Context *context)
 static void z80_cd_call_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = addr.w;
     context->used_cycles += 17;
 }
@@ -4823,11 +4858,10 @@ static void z80_cd_call_xx (Z80_Context *context)
 /* ADC A, * */
 static void z80_ce_adc_a_x (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
     uint8_t temp = imm + context->state.flag_carry;
     SET_FLAGS_ADC (imm);
     context->state.a += temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4835,8 +4869,8 @@ static void z80_ce_adc_a_x (Z80_Context *context)
 /* RST 08h */
 static void z80_cf_rst_08 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0008;
     context->used_cycles += 11;
 }
@@ -4851,8 +4885,8 @@ static void z80_d0_ret_nc (Z80_Context *context)
     }
     else
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
 }
@@ -4861,8 +4895,8 @@ static void z80_d0_ret_nc (Z80_Context *context)
 /* POP DE */
 static void z80_d1_pop_de (Z80_Context *context)
 {
-    context->state.e = context->memory_read (context->parent, context->state.sp++);
-    context->state.d = context->memory_read (context->parent, context->state.sp++);
+    context->state.e = z80_memory_read (context, context->state.sp++);
+    context->state.d = z80_memory_read (context, context->state.sp++);
     context->used_cycles += 10;
 }
 
@@ -4871,8 +4905,8 @@ static void z80_d1_pop_de (Z80_Context *context)
 static void z80_d2_jp_nc_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (!context->state.flag_carry)
     {
@@ -4885,7 +4919,7 @@ static void z80_d2_jp_nc_xx (Z80_Context *context)
 /* OUT (*), A */
 static void z80_d3_out_x_a (Z80_Context *context)
 {
-    context->io_write (context->parent, context->memory_read (context->parent, context->state.pc++), context->state.a);
+    z80_io_write (context, z80_memory_read (context, context->state.pc++), context->state.a);
     context->used_cycles += 11;
 }
 
@@ -4894,8 +4928,8 @@ static void z80_d3_out_x_a (Z80_Context *context)
 static void z80_d4_call_nc_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     /* CALL NC,** */
     if (context->state.flag_carry)
@@ -4904,8 +4938,8 @@ static void z80_d4_call_nc_xx (Z80_Context *context)
     }
     else
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -4915,8 +4949,8 @@ static void z80_d4_call_nc_xx (Z80_Context *context)
 /* PUSH DE */
 static void z80_d5_push_de (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.d);
-    context->memory_write (context->parent, --context->state.sp, context->state.e);
+    z80_memory_write (context, --context->state.sp, context->state.d);
+    z80_memory_write (context, --context->state.sp, context->state.e);
     context->used_cycles += 11;
 }
 
@@ -4924,10 +4958,9 @@ static void z80_d5_push_de (Z80_Context *context)
 /* SUB A, * */
 static void z80_d6_sub_a_x (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
     SET_FLAGS_SUB (context->state.a, imm);
     context->state.a -= imm;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -4935,8 +4968,8 @@ static void z80_d6_sub_a_x (Z80_Context *context)
 /* RST 10h */
 static void z80_d7_rst_10 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x10;
     context->used_cycles += 11;
 }
@@ -4947,8 +4980,8 @@ static void z80_d8_ret_c (Z80_Context *context)
 {
     if (context->state.flag_carry)
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
     else
@@ -4972,8 +5005,8 @@ static void z80_d9_exx (Z80_Context *context)
 static void z80_da_jp_c_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_carry)
     {
@@ -4986,7 +5019,7 @@ static void z80_da_jp_c_xx (Z80_Context *context)
 /* IN A, (*) */
 static void z80_db_in_a_x (Z80_Context *context)
 {
-    context->state.a = context->io_read (context->parent, context->memory_read (context->parent, context->state.pc++));
+    context->state.a = z80_io_read (context, z80_memory_read (context, context->state.pc++));
     context->used_cycles += 11;
 }
 
@@ -4995,13 +5028,13 @@ static void z80_db_in_a_x (Z80_Context *context)
 static void z80_dc_call_c_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_carry)
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -5019,7 +5052,7 @@ static void z80_dd_ix (Z80_Context *context)
     context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
 
     /* Fetch */
-    uint8_t instruction = context->memory_read (context->parent, context->state.pc++);
+    uint8_t instruction = z80_memory_read (context, context->state.pc++);
 
     /* Execute */
     context->state.ix = z80_ix_iy_instruction [instruction] (context, context->state.ix);
@@ -5029,11 +5062,10 @@ static void z80_dd_ix (Z80_Context *context)
 /* SBC A, * */
 static void z80_de_sbc_a_x (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
     uint8_t temp = imm + context->state.flag_carry;
     SET_FLAGS_SBC (imm);
     context->state.a -= temp;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -5041,8 +5073,8 @@ static void z80_de_sbc_a_x (Z80_Context *context)
 /* RST 18h */
 static void z80_df_rst_18 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0018;
     context->used_cycles += 11;
 }
@@ -5057,8 +5089,8 @@ static void z80_e0_ret_po (Z80_Context *context)
     }
     else
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
 }
@@ -5067,8 +5099,8 @@ static void z80_e0_ret_po (Z80_Context *context)
 /* POP HL */
 static void z80_e1_pop_hl (Z80_Context *context)
 {
-    context->state.l = context->memory_read (context->parent, context->state.sp++);
-    context->state.h = context->memory_read (context->parent, context->state.sp++);
+    context->state.l = z80_memory_read (context, context->state.sp++);
+    context->state.h = z80_memory_read (context, context->state.sp++);
     context->used_cycles += 10;
 }
 
@@ -5077,8 +5109,8 @@ static void z80_e1_pop_hl (Z80_Context *context)
 static void z80_e2_jp_po_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (!context->state.flag_parity_overflow)
     {
@@ -5092,11 +5124,11 @@ static void z80_e2_jp_po_xx (Z80_Context *context)
 static void z80_e3_ex_sp_hl (Z80_Context *context)
 {
     uint8_t temp = context->state.l;
-    context->state.l = context->memory_read (context->parent, context->state.sp);
-    context->memory_write (context->parent, context->state.sp, temp);
+    context->state.l = z80_memory_read (context, context->state.sp);
+    z80_memory_write (context, context->state.sp, temp);
     temp = context->state.h;
-    context->state.h = context->memory_read (context->parent, context->state.sp + 1);
-    context->memory_write (context->parent, context->state.sp + 1, temp);
+    context->state.h = z80_memory_read (context, context->state.sp + 1);
+    z80_memory_write (context, context->state.sp + 1, temp);
     context->used_cycles += 19;
 }
 
@@ -5105,8 +5137,8 @@ static void z80_e3_ex_sp_hl (Z80_Context *context)
 static void z80_e4_call_po_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_parity_overflow)
     {
@@ -5114,8 +5146,8 @@ static void z80_e4_call_po_xx (Z80_Context *context)
     }
     else
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -5125,8 +5157,8 @@ static void z80_e4_call_po_xx (Z80_Context *context)
 /* PUSH HL */
 static void z80_e5_push_hl (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.h);
-    context->memory_write (context->parent, --context->state.sp, context->state.l);
+    z80_memory_write (context, --context->state.sp, context->state.h);
+    z80_memory_write (context, --context->state.sp, context->state.l);
     context->used_cycles += 11;
 }
 
@@ -5134,9 +5166,8 @@ static void z80_e5_push_hl (Z80_Context *context)
 /* AND A, * */
 static void z80_e6_and_a_x (Z80_Context *context)
 {
-    context->state.a &= context->memory_read (context->parent, context->state.pc++);
+    context->state.a &= z80_memory_read (context, context->state.pc++);
     SET_FLAGS_AND;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -5144,8 +5175,8 @@ static void z80_e6_and_a_x (Z80_Context *context)
 /* RST 20h */
 static void z80_e7_rst_20 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0020;
     context->used_cycles += 11;
 }
@@ -5156,8 +5187,8 @@ static void z80_e8_ret_pe (Z80_Context *context)
 {
     if (context->state.flag_parity_overflow)
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
     else
@@ -5179,8 +5210,8 @@ static void z80_e9_jp_hl (Z80_Context *context)
 static void z80_ea_jp_pe_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_parity_overflow)
     {
@@ -5202,13 +5233,13 @@ static void z80_eb_ex_de_hl (Z80_Context *context)
 static void z80_ec_call_pe_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_parity_overflow)
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -5226,7 +5257,7 @@ static void z80_ed_prefix (Z80_Context *context)
     context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
 
     /* Fetch */
-    uint8_t instruction = context->memory_read (context->parent, context->state.pc++);
+    uint8_t instruction = z80_memory_read (context, context->state.pc++);
 
     /* Execute */
     z80_ed_instruction [instruction] (context);
@@ -5236,9 +5267,8 @@ static void z80_ed_prefix (Z80_Context *context)
 /* XOR A, * */
 static void z80_ee_xor_a_x (Z80_Context *context)
 {
-    context->state.a ^= context->memory_read (context->parent, context->state.pc++);
+    context->state.a ^= z80_memory_read (context, context->state.pc++);
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -5246,8 +5276,8 @@ static void z80_ee_xor_a_x (Z80_Context *context)
 /* RST 28h */
 static void z80_ef_rst_28 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0028;
     context->used_cycles += 11;
 }
@@ -5262,8 +5292,8 @@ static void z80_f0_ret_p (Z80_Context *context)
     }
     else
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
 }
@@ -5272,8 +5302,8 @@ static void z80_f0_ret_p (Z80_Context *context)
 /* POP AF */
 static void z80_f1_pop_af (Z80_Context *context)
 {
-    context->state.f = context->memory_read (context->parent, context->state.sp++);
-    context->state.a = context->memory_read (context->parent, context->state.sp++);
+    context->state.f = z80_memory_read (context, context->state.sp++);
+    context->state.a = z80_memory_read (context, context->state.sp++);
     context->used_cycles += 10;
 }
 
@@ -5282,8 +5312,8 @@ static void z80_f1_pop_af (Z80_Context *context)
 static void z80_f2_jp_p_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (!context->state.flag_sign)
     {
@@ -5306,8 +5336,8 @@ static void z80_f3_di (Z80_Context *context)
 static void z80_f4_call_p_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_sign)
     {
@@ -5315,8 +5345,8 @@ static void z80_f4_call_p_xx (Z80_Context *context)
     }
     else
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -5326,8 +5356,8 @@ static void z80_f4_call_p_xx (Z80_Context *context)
 /* PUSH AF */
 static void z80_f5_push_af (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.a);
-    context->memory_write (context->parent, --context->state.sp, context->state.f);
+    z80_memory_write (context, --context->state.sp, context->state.a);
+    z80_memory_write (context, --context->state.sp, context->state.f);
     context->used_cycles += 11;
 }
 
@@ -5335,9 +5365,8 @@ static void z80_f5_push_af (Z80_Context *context)
 /* OR A, * */
 static void z80_f6_or_a_x (Z80_Context *context)
 {
-    context->state.a |= context->memory_read (context->parent, context->state.pc++);
+    context->state.a |= z80_memory_read (context, context->state.pc++);
     SET_FLAGS_OR_XOR;
-    SET_FLAGS_XY (context->state.a);
     context->used_cycles += 7;
 }
 
@@ -5345,8 +5374,8 @@ static void z80_f6_or_a_x (Z80_Context *context)
 /* RST 30h */
 static void z80_f7_rst_30 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0030;
     context->used_cycles += 11;
 }
@@ -5357,8 +5386,8 @@ static void z80_f8_ret_m (Z80_Context *context)
 {
     if (context->state.flag_sign)
     {
-        context->state.pc_l = context->memory_read (context->parent, context->state.sp++);
-        context->state.pc_h = context->memory_read (context->parent, context->state.sp++);
+        context->state.pc_l = z80_memory_read (context, context->state.sp++);
+        context->state.pc_h = z80_memory_read (context, context->state.sp++);
         context->used_cycles += 11;
     }
     else
@@ -5380,8 +5409,8 @@ static void z80_f9_ld_sp_hl (Z80_Context *context)
 static void z80_fa_jp_m_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_sign)
     {
@@ -5405,13 +5434,13 @@ static void z80_fb_ei (Z80_Context *context)
 static void z80_fc_call_m_xx (Z80_Context *context)
 {
     uint16_split_t addr;
-    addr.l = context->memory_read (context->parent, context->state.pc++);
-    addr.h = context->memory_read (context->parent, context->state.pc++);
+    addr.l = z80_memory_read (context, context->state.pc++);
+    addr.h = z80_memory_read (context, context->state.pc++);
 
     if (context->state.flag_sign)
     {
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
         context->state.pc = addr.w;
         context->used_cycles += 17;
     }
@@ -5429,7 +5458,7 @@ static void z80_fd_prefix (Z80_Context *context)
     context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
 
     /* Fetch */
-    uint8_t instruction = context->memory_read (context->parent, context->state.pc++);
+    uint8_t instruction = z80_memory_read (context, context->state.pc++);
 
     /* Execute */
     context->state.iy = z80_ix_iy_instruction [instruction] (context, context->state.iy);
@@ -5439,9 +5468,8 @@ static void z80_fd_prefix (Z80_Context *context)
 /* CP A, * */
 static void z80_fe_cp_a_x (Z80_Context *context)
 {
-    uint8_t imm = context->memory_read (context->parent, context->state.pc++);
-    SET_FLAGS_SUB (context->state.a, imm);
-    SET_FLAGS_XY (imm);
+    uint8_t imm = z80_memory_read (context, context->state.pc++);
+    SET_FLAGS_CP (context->state.a, imm);
     context->used_cycles += 7;
 }
 
@@ -5449,14 +5477,14 @@ static void z80_fe_cp_a_x (Z80_Context *context)
 /* RST 38h */
 static void z80_ff_rst_38 (Z80_Context *context)
 {
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-    context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
+    z80_memory_write (context, --context->state.sp, context->state.pc_h);
+    z80_memory_write (context, --context->state.sp, context->state.pc_l);
     context->state.pc = 0x0038;
     context->used_cycles += 11;
 }
 
 
-static void (*z80_instruction [256]) (Z80_Context *) = {
+void (*z80_instruction [256]) (Z80_Context *) = {
     z80_00_nop,         z80_01_ld_bc_xx,    z80_02_ld_bc_a,     z80_03_inc_bc,
     z80_04_inc_b,       z80_05_dec_b,       z80_06_ld_b_x,      z80_07_rlca,
     z80_08_ex_af_af,    z80_09_add_hl_bc,   z80_0a_ld_a_bc,     z80_0b_dec_bc,
@@ -5523,6 +5551,7 @@ static void (*z80_instruction [256]) (Z80_Context *) = {
     z80_fc_call_m_xx,   z80_fd_prefix,      z80_fe_cp_a_x,      z80_ff_rst_38
 };
 
+#ifndef Z80_COMPUTED_GOTO
 /*
  * Execute a single Z80 instruction.
  */
@@ -5534,21 +5563,541 @@ static void z80_run_instruction (Z80_Context *context)
     context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
 
     /* Fetch */
-    instruction = context->memory_read (context->parent, context->state.pc++);
+    instruction = z80_memory_read (context, context->state.pc++);
+    context->instruction_count++;
 
     /* Execute */
     z80_instruction [instruction] (context);
 }
+#endif
+
+
+/*
+ * Remain in HALT until the interrupt lines are next checked.
+ *
+ * While halted, the Z80 executes NOPs, bumping R every 4 cycles. Rather than
+ * run them one at a time, they are run together up to the first instruction
+ * boundary that reaches the interrupt deadline or the end of the run.
+ */
+static inline void z80_halt_run (Z80_Context *context)
+{
+    uint64_t limit = context->cycle_end;
+    uint64_t nops = 1;
+
+    if (context->interrupt_deadline < limit)
+    {
+        limit = context->interrupt_deadline;
+    }
+
+    if (limit > context->cycle_count)
+    {
+        nops = (limit - context->cycle_count + 3) / 4;
+    }
+
+    context->state.r = (context->state.r & 0x80) | ((context->state.r + nops) & 0x7f);
+    context->used_cycles += nops * 4;
+}
+
+
+/*
+ * Bring forward the cycle count at which the interrupt lines are next checked.
+ *
+ * Consoles call this when other hardware raises an interrupt line, or when
+ * an external input such as a pause button may have changed.
+ */
+void z80_interrupt_deadline_set (Z80_Context *context, uint64_t cycle)
+{
+    if (cycle < context->interrupt_deadline)
+    {
+        context->interrupt_deadline = cycle;
+    }
+}
+
+
+/*
+ * Allow idle loops to poll a port.
+ *
+ * Only for ports where reading the same value again before the other hardware
+ * next runs has no further effect, such as the VDP status port.
+ */
+void z80_idle_port_set (Z80_Context *context, uint8_t port)
+{
+    context->idle_ports [port / 32] |= 1u << (port % 32);
+}
+
+
+/*
+ * Check for and service a pending interrupt.
+ *
+ * The interrupt lines only change when other hardware raises them, or when
+ * the Z80 accesses an I/O port, so there is no need to poll them before every
+ * instruction. Instead, they are checked once the cycle count reaches
+ * interrupt_deadline. The Z80 resets the deadline after port accesses and
+ * after instructions that enable interrupts. Consoles bring it forward with
+ * z80_interrupt_deadline_set when their hardware raises a line.
+ *
+ * Returns 1 if an interrupt was taken, 0 if there was nothing to service, or
+ * -1 if the interrupt could not be handled.
+ */
+static int z80_interrupt_check (Z80_Context *context)
+{
+    /* Nothing else to check until the lines may have changed */
+    context->interrupt_deadline = UINT64_MAX;
+
+    /* First, check for a non-maskable interrupt (edge-triggered) */
+    static bool nmi_previous = 0;
+    bool nmi = context->get_nmi (context->parent);
+    bool nmi_rising_edge = (nmi && !nmi_previous);
+    nmi_previous = nmi;
+
+    if (nmi_rising_edge)
+    {
+        /* Bump the R register */
+        context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
+
+        if (context->state.halt)
+        {
+            context->state.halt = false;
+        }
+        context->state.iff1 = false;
+        z80_memory_write (context, --context->state.sp, context->state.pc_h);
+        z80_memory_write (context, --context->state.sp, context->state.pc_l);
+        context->state.pc = 0x66;
+        context->used_cycles += 11;
+
+        return 1;
+    }
+
+    /* Then check for a maskable interrupt */
+    if (context->state.iff1 && context->get_int (context->parent))
+    {
+        /* Bump the R register */
+        context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
+
+        if (context->state.halt)
+        {
+            context->state.halt = false;
+        }
+
+        context->state.iff1 = false;
+        context->state.iff2 = false;
+
+        switch (context->state.im)
+        {
+            case 1:
+                z80_memory_write (context, --context->state.sp, context->state.pc_h);
+                z80_memory_write (context, --context->state.sp, context->state.pc_l);
+                context->state.pc = 0x38;
+                context->used_cycles += 13;
+                break;
+            default:
+                snprintf (state.error_buffer, 79, "Unsupported interrupt mode %d.", context->state.im);
+                snepulator_error ("Z80 Error", state.error_buffer);
+                return -1;
+        }
+
+        return 1;
+    }
+
+    return 0;
+}
 
 
+#ifdef Z80_COMPUTED_GOTO
 /*
  * Run the Z80 for the specified number of clock cycles.
+ *
+ * Threaded implementation using computed goto. Each opcode label calls its
+ * handler directly, allowing it to be inlined, and is followed by its own copy
+ * of the dispatch code. This avoids the call through the instruction table and
+ * gives the branch predictor a separate indirect jump for each opcode.
  */
 void z80_run_cycles (Z80_Context *context, int64_t cycles)
 {
+    static void *const dispatch [256] = {
+        &&op_00, &&op_01, &&op_02, &&op_03, &&op_04, &&op_05, &&op_06, &&op_07,
+        &&op_08, &&op_09, &&op_0a, &&op_0b, &&op_0c, &&op_0d, &&op_0e, &&op_0f,
+        &&op_10, &&op_11, &&op_12, &&op_13, &&op_14, &&op_15, &&op_16, &&op_17,
+        &&op_18, &&op_19, &&op_1a, &&op_1b, &&op_1c, &&op_1d, &&op_1e, &&op_1f,
+        &&op_20, &&op_21, &&op_22, &&op_23, &&op_24, &&op_25, &&op_26, &&op_27,
+        &&op_28, &&op_29, &&op_2a, &&op_2b, &&op_2c, &&op_2d, &&op_2e, &&op_2f,
+        &&op_30, &&op_31, &&op_32, &&op_33, &&op_34, &&op_35, &&op_36, &&op_37,
+        &&op_38, &&op_39, &&op_3a, &&op_3b, &&op_3c, &&op_3d, &&op_3e, &&op_3f,
+        &&op_40, &&op_41, &&op_42, &&op_43, &&op_44, &&op_45, &&op_46, &&op_47,
+        &&op_48, &&op_49, &&op_4a, &&op_4b, &&op_4c, &&op_4d, &&op_4e, &&op_4f,
+        &&op_50, &&op_51, &&op_52, &&op_53, &&op_54, &&op_55, &&op_56, &&op_57,
+        &&op_58, &&op_59, &&op_5a, &&op_5b, &&op_5c, &&op_5d, &&op_5e, &&op_5f,
+        &&op_60, &&op_61, &&op_62, &&op_63, &&op_64, &&op_65, &&op_66, &&op_67,
+        &&op_68, &&op_69, &&op_6a, &&op_6b, &&op_6c, &&op_6d, &&op_6e, &&op_6f,
+        &&op_70, &&op_71, &&op_72, &&op_73, &&op_74, &&op_75, &&op_76, &&op_77,
+        &&op_78, &&op_79, &&op_7a, &&op_7b, &&op_7c, &&op_7d, &&op_7e, &&op_7f,
+        &&op_80, &&op_81, &&op_82, &&op_83, &&op_84, &&op_85, &&op_86, &&op_87,
+        &&op_88, &&op_89, &&op_8a, &&op_8b, &&op_8c, &&op_8d, &&op_8e, &&op_8f,
+        &&op_90, &&op_91, &&op_92, &&op_93, &&op_94, &&op_95, &&op_96, &&op_97,
+        &&op_98, &&op_99, &&op_9a, &&op_9b, &&op_9c, &&op_9d, &&op_9e, &&op_9f,
+        &&op_a0, &&op_a1, &&op_a2, &&op_a3, &&op_a4, &&op_a5, &&op_a6, &&op_a7,
+        &&op_a8, &&op_a9, &&op_aa, &&op_ab, &&op_ac, &&op_ad, &&op_ae, &&op_af,
+        &&op_b0, &&op_b1, &&op_b2, &&op_b3, &&op_b4, &&op_b5, &&op_b6, &&op_b7,
+        &&op_b8, &&op_b9, &&op_ba, &&op_bb, &&op_bc, &&op_bd, &&op_be, &&op_bf,
+        &&op_c0, &&op_c1, &&op_c2, &&op_c3, &&op_c4, &&op_c5, &&op_c6, &&op_c7,
+        &&op_c8, &&op_c9, &&op_ca, &&op_cb, &&op_cc, &&op_cd, &&op_ce, &&op_cf,
+        &&op_d0, &&op_d1, &&op_d2, &&op_d3, &&op_d4, &&op_d5, &&op_d6, &&op_d7,
+        &&op_d8, &&op_d9, &&op_da, &&op_db, &&op_dc, &&op_dd, &&op_de, &&op_df,
+        &&op_e0, &&op_e1, &&op_e2, &&op_e3, &&op_e4, &&op_e5, &&op_e6, &&op_e7,
+        &&op_e8, &&op_e9, &&op_ea, &&op_eb, &&op_ec, &&op_ed, &&op_ee, &&op_ef,
+        &&op_f0, &&op_f1, &&op_f2, &&op_f3, &&op_f4, &&op_f5, &&op_f6, &&op_f7,
+        &&op_f8, &&op_f9, &&op_fa, &&op_fb, &&op_fc, &&op_fd, &&op_fe, &&op_ff
+    };
+    uint8_t instruction;
+    int interrupt;
+
+/* Fetch and jump to the next instruction, after checking for interrupts */
+#define Z80_DISPATCH_NEXT() \
+    { \
+        context->used_cycles = 0; \
+        if (context->state.wait_after_ei) \
+        { \
+            context->state.wait_after_ei = false; \
+            context->interrupt_deadline = 0; \
+        } \
+        else if (context->cycle_count >= context->interrupt_deadline && \
+                 (interrupt = z80_interrupt_check (context)) != 0) \
+        { \
+            goto interrupt_taken; \
+        } \
+        if (context->state.halt) \
+        { \
+            goto halted; \
+        } \
+        if (context->jit_enabled && z80_jit_run (context, cycles)) \
+        { \
+            goto translated; \
+        } \
+        context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f); \
+        instruction = z80_memory_read (context, context->state.pc++); \
+        context->instruction_count++; \
+        goto *dispatch [instruction]; \
+    }
+
+/* Account for the cycles used by the last instruction and continue */
+#define Z80_DISPATCH() \
+    { \
+        context->cycle_count += context->used_cycles; \
+        cycles -= context->used_cycles; \
+        if (cycles <= 0) \
+        { \
+            goto done; \
+        } \
+        Z80_DISPATCH_NEXT (); \
+    }
+
     /* Account for cycles used during the last run */
     cycles += context->state.excess_cycles;
 
+    context->cycle_end = context->cycle_count + cycles;
+
+    /* Other hardware has run since the ports were last read */
+    memset (context->idle_port_value, 0xff, sizeof (context->idle_port_value));
+
+    if (cycles <= 0)
+    {
+        goto done;
+    }
+    Z80_DISPATCH_NEXT ();
+
+interrupt_taken:
+    if (interrupt < 0)
+    {
+        return;
+    }
+    Z80_DISPATCH ();
+
+halted:
+    z80_halt_run (context);
+    Z80_DISPATCH ();
+
+translated:
+    /* A translated block has run, its cycles are in used_cycles */
+    Z80_DISPATCH ();
+
+    op_00: z80_00_nop (context); Z80_DISPATCH ();
+    op_01: z80_01_ld_bc_xx (context); Z80_DISPATCH ();
+    op_02: z80_02_ld_bc_a (context); Z80_DISPATCH ();
+    op_03: z80_03_inc_bc (context); Z80_DISPATCH ();
+    op_04: z80_04_inc_b (context); Z80_DISPATCH ();
+    op_05: z80_05_dec_b (context); Z80_DISPATCH ();
+    op_06: z80_06_ld_b_x (context); Z80_DISPATCH ();
+    op_07: z80_07_rlca (context); Z80_DISPATCH ();
+    op_08: z80_08_ex_af_af (context); Z80_DISPATCH ();
+    op_09: z80_09_add_hl_bc (context); Z80_DISPATCH ();
+    op_0a: z80_0a_ld_a_bc (context); Z80_DISPATCH ();
+    op_0b: z80_0b_dec_bc (context); Z80_DISPATCH ();
+    op_0c: z80_0c_inc_c (context); Z80_DISPATCH ();
+    op_0d: z80_0d_dec_c (context); Z80_DISPATCH ();
+    op_0e: z80_0e_ld_c_x (context); Z80_DISPATCH ();
+    op_0f: z80_0f_rrca (context); Z80_DISPATCH ();
+    op_10: z80_10_djnz (context); Z80_DISPATCH ();
+    op_11: z80_11_ld_de_xx (context); Z80_DISPATCH ();
+    op_12: z80_12_ld_de_a (context); Z80_DISPATCH ();
+    op_13: z80_13_inc_de (context); Z80_DISPATCH ();
+    op_14: z80_14_inc_d (context); Z80_DISPATCH ();
+    op_15: z80_15_dec_d (context); Z80_DISPATCH ();
+    op_16: z80_16_ld_d_x (context); Z80_DISPATCH ();
+    op_17: z80_17_rla (context); Z80_DISPATCH ();
+    op_18: z80_18_jr (context); Z80_DISPATCH ();
+    op_19: z80_19_add_hl_de (context); Z80_DISPATCH ();
+    op_1a: z80_1a_ld_a_de (context); Z80_DISPATCH ();
+    op_1b: z80_1b_dec_de (context); Z80_DISPATCH ();
+    op_1c: z80_1c_inc_e (context); Z80_DISPATCH ();
+    op_1d: z80_1d_dec_e (context); Z80_DISPATCH ();
+    op_1e: z80_1e_ld_e_x (context); Z80_DISPATCH ();
+    op_1f: z80_1f_rra (context); Z80_DISPATCH ();
+    op_20: z80_20_jr_nz (context); Z80_DISPATCH ();
+    op_21: z80_21_ld_hl_xx (context); Z80_DISPATCH ();
+    op_22: z80_22_ld_xx_hl (context); Z80_DISPATCH ();
+    op_23: z80_23_inc_hl (context); Z80_DISPATCH ();
+    op_24: z80_24_inc_h (context); Z80_DISPATCH ();
+    op_25: z80_25_dec_h (context); Z80_DISPATCH ();
+    op_26: z80_26_ld_h_x (context); Z80_DISPATCH ();
+    op_27: z80_27_daa (context); Z80_DISPATCH ();
+    op_28: z80_28_jr_z (context); Z80_DISPATCH ();
+    op_29: z80_29_add_hl_hl (context); Z80_DISPATCH ();
+    op_2a: z80_2a_ld_hl_xx (context); Z80_DISPATCH ();
+    op_2b: z80_2b_dec_hl (context); Z80_DISPATCH ();
+    op_2c: z80_2c_inc_l (context); Z80_DISPATCH ();
+    op_2d: z80_2d_dec_l (context); Z80_DISPATCH ();
+    op_2e: z80_2e_ld_l_x (context); Z80_DISPATCH ();
+    op_2f: z80_2f_cpl (context); Z80_DISPATCH ();
+    op_30: z80_30_jr_nc (context); Z80_DISPATCH ();
+    op_31: z80_31_ld_sp_xx (context); Z80_DISPATCH ();
+    op_32: z80_32_ld_xx_a (context); Z80_DISPATCH ();
+    op_33: z80_33_inc_sp (context); Z80_DISPATCH ();
+    op_34: z80_34_inc_hl (context); Z80_DISPATCH ();
+    op_35: z80_35_dec_hl (context); Z80_DISPATCH ();
+    op_36: z80_36_ld_hl_x (context); Z80_DISPATCH ();
+    op_37: z80_37_scf (context); Z80_DISPATCH ();
+    op_38: z80_38_jr_c_x (context); Z80_DISPATCH ();
+    op_39: z80_39_add_hl_sp (context); Z80_DISPATCH ();
+    op_3a: z80_3a_ld_a_xx (context); Z80_DISPATCH ();
+    op_3b: z80_3b_dec_sp (context); Z80_DISPATCH ();
+    op_3c: z80_3c_inc_a (context); Z80_DISPATCH ();
+    op_3d: z80_3d_dec_a (context); Z80_DISPATCH ();
+    op_3e: z80_3e_ld_a_x (context); Z80_DISPATCH ();
+    op_3f: z80_3f_ccf (context); Z80_DISPATCH ();
+    op_40: z80_40_ld_b_b (context); Z80_DISPATCH ();
+    op_41: z80_41_ld_b_c (context); Z80_DISPATCH ();
+    op_42: z80_42_ld_b_d (context); Z80_DISPATCH ();
+    op_43: z80_43_ld_b_e (context); Z80_DISPATCH ();
+    op_44: z80_44_ld_b_h (context); Z80_DISPATCH ();
+    op_45: z80_45_ld_b_l (context); Z80_DISPATCH ();
+    op_46: z80_46_ld_b_hl (context); Z80_DISPATCH ();
+    op_47: z80_47_ld_b_a (context); Z80_DISPATCH ();
+    op_48: z80_48_ld_c_b (context); Z80_DISPATCH ();
+    op_49: z80_49_ld_c_c (context); Z80_DISPATCH ();
+    op_4a: z80_4a_ld_c_d (context); Z80_DISPATCH ();
+    op_4b: z80_4b_ld_c_e (context); Z80_DISPATCH ();
+    op_4c: z80_4c_ld_c_h (context); Z80_DISPATCH ();
+    op_4d: z80_4d_ld_c_l (context); Z80_DISPATCH ();
+    op_4e: z80_4e_ld_c_hl (context); Z80_DISPATCH ();
+    op_4f: z80_4f_ld_c_a (context); Z80_DISPATCH ();
+    op_50: z80_50_ld_d_b (context); Z80_DISPATCH ();
+    op_51: z80_51_ld_d_c (context); Z80_DISPATCH ();
+    op_52: z80_52_ld_d_d (context); Z80_DISPATCH ();
+    op_53: z80_53_ld_d_e (context); Z80_DISPATCH ();
+    op_54: z80_54_ld_d_h (context); Z80_DISPATCH ();
+    op_55: z80_55_ld_d_l (context); Z80_DISPATCH ();
+    op_56: z80_56_ld_d_hl (context); Z80_DISPATCH ();
+    op_57: z80_57_ld_d_a (context); Z80_DISPATCH ();
+    op_58: z80_58_ld_e_b (context); Z80_DISPATCH ();
+    op_59: z80_59_ld_e_c (context); Z80_DISPATCH ();
+    op_5a: z80_5a_ld_e_d (context); Z80_DISPATCH ();
+    op_5b: z80_5b_ld_e_e (context); Z80_DISPATCH ();
+    op_5c: z80_5c_ld_e_h (context); Z80_DISPATCH ();
+    op_5d: z80_5d_ld_e_l (context); Z80_DISPATCH ();
+    op_5e: z80_5e_ld_e_hl (context); Z80_DISPATCH ();
+    op_5f: z80_5f_ld_e_a (context); Z80_DISPATCH ();
+    op_60: z80_60_ld_h_b (context); Z80_DISPATCH ();
+    op_61: z80_61_ld_h_c (context); Z80_DISPATCH ();
+    op_62: z80_62_ld_h_d (context); Z80_DISPATCH ();
+    op_63: z80_63_ld_h_e (context); Z80_DISPATCH ();
+    op_64: z80_64_ld_h_h (context); Z80_DISPATCH ();
+    op_65: z80_65_ld_h_l (context); Z80_DISPATCH ();
+    op_66: z80_66_ld_h_hl (context); Z80_DISPATCH ();
+    op_67: z80_67_ld_h_a (context); Z80_DISPATCH ();
+    op_68: z80_68_ld_l_b (context); Z80_DISPATCH ();
+    op_69: z80_69_ld_l_c (context); Z80_DISPATCH ();
+    op_6a: z80_6a_ld_l_d (context); Z80_DISPATCH ();
+    op_6b: z80_6b_ld_l_e (context); Z80_DISPATCH ();
+    op_6c: z80_6c_ld_l_h (context); Z80_DISPATCH ();
+    op_6d: z80_6d_ld_l_l (context); Z80_DISPATCH ();
+    op_6e: z80_6e_ld_l_hl (context); Z80_DISPATCH ();
+    op_6f: z80_6f_ld_l_a (context); Z80_DISPATCH ();
+    op_70: z80_70_ld_hl_b (context); Z80_DISPATCH ();
+    op_71: z80_71_ld_hl_c (context); Z80_DISPATCH ();
+    op_72: z80_72_ld_hl_d (context); Z80_DISPATCH ();
+    op_73: z80_73_ld_hl_e (context); Z80_DISPATCH ();
+    op_74: z80_74_ld_hl_h (context); Z80_DISPATCH ();
+    op_75: z80_75_ld_hl_l (context); Z80_DISPATCH ();
+    op_76: z80_76_halt (context); Z80_DISPATCH ();
+    op_77: z80_77_ld_hl_a (context); Z80_DISPATCH ();
+    op_78: z80_78_ld_a_b (context); Z80_DISPATCH ();
+    op_79: z80_79_ld_a_c (context); Z80_DISPATCH ();
+    op_7a: z80_7a_ld_a_d (context); Z80_DISPATCH ();
+    op_7b: z80_7b_ld_a_e (context); Z80_DISPATCH ();
+    op_7c: z80_7c_ld_a_h (context); Z80_DISPATCH ();
+    op_7d: z80_7d_ld_a_l (context); Z80_DISPATCH ();
+    op_7e: z80_7e_ld_a_hl (context); Z80_DISPATCH ();
+    op_7f: z80_7f_ld_a_a (context); Z80_DISPATCH ();
+    op_80: z80_80_add_a_b (context); Z80_DISPATCH ();
+    op_81: z80_81_add_a_c (context); Z80_DISPATCH ();
+    op_82: z80_82_add_a_d (context); Z80_DISPATCH ();
+    op_83: z80_83_add_a_e (context); Z80_DISPATCH ();
+    op_84: z80_84_add_a_h (context); Z80_DISPATCH ();
+    op_85: z80_85_add_a_l (context); Z80_DISPATCH ();
+    op_86: z80_86_add_a_hl (context); Z80_DISPATCH ();
+    op_87: z80_87_add_a_a (context); Z80_DISPATCH ();
+    op_88: z80_88_adc_a_b (context); Z80_DISPATCH ();
+    op_89: z80_89_adc_a_c (context); Z80_DISPATCH ();
+    op_8a: z80_8a_adc_a_d (context); Z80_DISPATCH ();
+    op_8b: z80_8b_adc_a_e (context); Z80_DISPATCH ();
+    op_8c: z80_8c_adc_a_h (context); Z80_DISPATCH ();
+    op_8d: z80_8d_adc_a_l (context); Z80_DISPATCH ();
+    op_8e: z80_8e_adc_a_hl (context); Z80_DISPATCH ();
+    op_8f: z80_8f_adc_a_a (context); Z80_DISPATCH ();
+    op_90: z80_90_sub_a_b (context); Z80_DISPATCH ();
+    op_91: z80_91_sub_a_c (context); Z80_DISPATCH ();
+    op_92: z80_92_sub_a_d (context); Z80_DISPATCH ();
+    op_93: z80_93_sub_a_e (context); Z80_DISPATCH ();
+    op_94: z80_94_sub_a_h (context); Z80_DISPATCH ();
+    op_95: z80_95_sub_a_l (context); Z80_DISPATCH ();
+    op_96: z80_96_sub_a_hl (context); Z80_DISPATCH ();
+    op_97: z80_97_sub_a_a (context); Z80_DISPATCH ();
+    op_98: z80_98_sbc_a_b (context); Z80_DISPATCH ();
+    op_99: z80_99_sbc_a_c (context); Z80_DISPATCH ();
+    op_9a: z80_9a_sbc_a_d (context); Z80_DISPATCH ();
+    op_9b: z80_9b_sbc_a_e (context); Z80_DISPATCH ();
+    op_9c: z80_9c_sbc_a_h (context); Z80_DISPATCH ();
+    op_9d: z80_9d_sbc_a_l (context); Z80_DISPATCH ();
+    op_9e: z80_9e_sbc_a_hl (context); Z80_DISPATCH ();
+    op_9f: z80_9f_sbc_a_a (context); Z80_DISPATCH ();
+    op_a0: z80_a0_and_a_b (context); Z80_DISPATCH ();
+    op_a1: z80_a1_and_a_c (context); Z80_DISPATCH ();
+    op_a2: z80_a2_and_a_d (context); Z80_DISPATCH ();
+    op_a3: z80_a3_and_a_e (context); Z80_DISPATCH ();
+    op_a4: z80_a4_and_a_h (context); Z80_DISPATCH ();
+    op_a5: z80_a5_and_a_l (context); Z80_DISPATCH ();
+    op_a6: z80_a6_and_a_hl (context); Z80_DISPATCH ();
+    op_a7: z80_a7_and_a_a (context); Z80_DISPATCH ();
+    op_a8: z80_a8_xor_a_b (context); Z80_DISPATCH ();
+    op_a9: z80_a9_xor_a_c (context); Z80_DISPATCH ();
+    op_aa: z80_aa_xor_a_d (context); Z80_DISPATCH ();
+    op_ab: z80_ab_xor_a_e (context); Z80_DISPATCH ();
+    op_ac: z80_ac_xor_a_h (context); Z80_DISPATCH ();
+    op_ad: z80_ad_xor_a_l (context); Z80_DISPATCH ();
+    op_ae: z80_ae_xor_a_hl (context); Z80_DISPATCH ();
+    op_af: z80_af_xor_a_a (context); Z80_DISPATCH ();
+    op_b0: z80_b0_or_a_b (context); Z80_DISPATCH ();
+    op_b1: z80_b1_or_a_c (context); Z80_DISPATCH ();
+    op_b2: z80_b2_or_a_d (context); Z80_DISPATCH ();
+    op_b3: z80_b3_or_a_e (context); Z80_DISPATCH ();
+    op_b4: z80_b4_or_a_h (context); Z80_DISPATCH ();
+    op_b5: z80_b5_or_a_l (context); Z80_DISPATCH ();
+    op_b6: z80_b6_or_a_hl (context); Z80_DISPATCH ();
+    op_b7: z80_b7_or_a_a (context); Z80_DISPATCH ();
+    op_b8: z80_b8_cp_a_b (context); Z80_DISPATCH ();
+    op_b9: z80_b9_cp_a_c (context); Z80_DISPATCH ();
+    op_ba: z80_ba_cp_a_d (context); Z80_DISPATCH ();
+    op_bb: z80_bb_cp_a_e (context); Z80_DISPATCH ();
+    op_bc: z80_bc_cp_a_h (context); Z80_DISPATCH ();
+    op_bd: z80_bd_cp_a_l (context); Z80_DISPATCH ();
+    op_be: z80_be_cp_a_hl (context); Z80_DISPATCH ();
+    op_bf: z80_bf_cp_a_a (context); Z80_DISPATCH ();
+    op_c0: z80_c0_ret_nz (context); Z80_DISPATCH ();
+    op_c1: z80_c1_pop_bc (context); Z80_DISPATCH ();
+    op_c2: z80_c2_jp_nz_xx (context); Z80_DISPATCH ();
+    op_c3: z80_c3_jp_xx (context); Z80_DISPATCH ();
+    op_c4: z80_c4_call_nz_xx (context); Z80_DISPATCH ();
+    op_c5: z80_c5_push_bc (context); Z80_DISPATCH ();
+    op_c6: z80_c6_add_a_x (context); Z80_DISPATCH ();
+    op_c7: z80_c7_rst_00 (context); Z80_DISPATCH ();
+    op_c8: z80_c8_ret_z (context); Z80_DISPATCH ();
+    op_c9: z80_c9_ret (context); Z80_DISPATCH ();
+    op_ca: z80_ca_jp_z_xx (context); Z80_DISPATCH ();
+    op_cb: z80_cb_prefix (context); Z80_DISPATCH ();
+    op_cc: z80_cc_call_z_xx (context); Z80_DISPATCH ();
+    op_cd: z80_cd_call_xx (context); Z80_DISPATCH ();
+    op_ce: z80_ce_adc_a_x (context); Z80_DISPATCH ();
+    op_cf: z80_cf_rst_08 (context); Z80_DISPATCH ();
+    op_d0: z80_d0_ret_nc (context); Z80_DISPATCH ();
+    op_d1: z80_d1_pop_de (context); Z80_DISPATCH ();
+    op_d2: z80_d2_jp_nc_xx (context); Z80_DISPATCH ();
+    op_d3: z80_d3_out_x_a (context); Z80_DISPATCH ();
+    op_d4: z80_d4_call_nc_xx (context); Z80_DISPATCH ();
+    op_d5: z80_d5_push_de (context); Z80_DISPATCH ();
+    op_d6: z80_d6_sub_a_x (context); Z80_DISPATCH ();
+    op_d7: z80_d7_rst_10 (context); Z80_DISPATCH ();
+    op_d8: z80_d8_ret_c (context); Z80_DISPATCH ();
+    op_d9: z80_d9_exx (context); Z80_DISPATCH ();
+    op_da: z80_da_jp_c_xx (context); Z80_DISPATCH ();
+    op_db: z80_db_in_a_x (context); Z80_DISPATCH ();
+    op_dc: z80_dc_call_c_xx (context); Z80_DISPATCH ();
+    op_dd: z80_dd_ix (context); Z80_DISPATCH ();
+    op_de: z80_de_sbc_a_x (context); Z80_DISPATCH ();
+    op_df: z80_df_rst_18 (context); Z80_DISPATCH ();
+    op_e0: z80_e0_ret_po (context); Z80_DISPATCH ();
+    op_e1: z80_e1_pop_hl (context); Z80_DISPATCH ();
+    op_e2: z80_e2_jp_po_xx (context); Z80_DISPATCH ();
+    op_e3: z80_e3_ex_sp_hl (context); Z80_DISPATCH ();
+    op_e4: z80_e4_call_po_xx (context); Z80_DISPATCH ();
+    op_e5: z80_e5_push_hl (context); Z80_DISPATCH ();
+    op_e6: z80_e6_and_a_x (context); Z80_DISPATCH ();
+    op_e7: z80_e7_rst_20 (context); Z80_DISPATCH ();
+    op_e8: z80_e8_ret_pe (context); Z80_DISPATCH ();
+    op_e9: z80_e9_jp_hl (context); Z80_DISPATCH ();
+    op_ea: z80_ea_jp_pe_xx (context); Z80_DISPATCH ();
+    op_eb: z80_eb_ex_de_hl (context); Z80_DISPATCH ();
+    op_ec: z80_ec_call_pe_xx (context); Z80_DISPATCH ();
+    op_ed: z80_ed_prefix (context); Z80_DISPATCH ();
+    op_ee: z80_ee_xor_a_x (context); Z80_DISPATCH ();
+    op_ef: z80_ef_rst_28 (context); Z80_DISPATCH ();
+    op_f0: z80_f0_ret_p (context); Z80_DISPATCH ();
+    op_f1: z80_f1_pop_af (context); Z80_DISPATCH ();
+    op_f2: z80_f2_jp_p_xx (context); Z80_DISPATCH ();
+    op_f3: z80_f3_di (context); Z80_DISPATCH ();
+    op_f4: z80_f4_call_p_xx (context); Z80_DISPATCH ();
+    op_f5: z80_f5_push_af (context); Z80_DISPATCH ();
+    op_f6: z80_f6_or_a_x (context); Z80_DISPATCH ();
+    op_f7: z80_f7_rst_30 (context); Z80_DISPATCH ();
+    op_f8: z80_f8_ret_m (context); Z80_DISPATCH ();
+    op_f9: z80_f9_ld_sp_hl (context); Z80_DISPATCH ();
+    op_fa: z80_fa_jp_m_xx (context); Z80_DISPATCH ();
+    op_fb: z80_fb_ei (context); Z80_DISPATCH ();
+    op_fc: z80_fc_call_m_xx (context); Z80_DISPATCH ();
+    op_fd: z80_fd_prefix (context); Z80_DISPATCH ();
+    op_fe: z80_fe_cp_a_x (context); Z80_DISPATCH ();
+    op_ff: z80_ff_rst_38 (context); Z80_DISPATCH ();
+
+done:
+    context->state.excess_cycles = cycles;
+
+#undef Z80_DISPATCH
+#undef Z80_DISPATCH_NEXT
+}
+
+#else
+/*
+ * Run the Z80 for the specified number of clock cycles.
+ */
+void z80_run_cycles (Z80_Context *context, int64_t cycles)
+{
+    /* Account for cycles used during the last run */
+    cycles += context->state.excess_cycles;
+
+    context->cycle_end = context->cycle_count + cycles;
+
+    /* Other hardware has run since the ports were last read */
+    memset (context->idle_port_value, 0xff, sizeof (context->idle_port_value));
+
     /* As long as we have a positive number of cycles, run an instruction */
     for ( ; cycles > 0; cycles -= context->used_cycles)
     {
@@ -5558,62 +6107,18 @@ void z80_run_cycles (Z80_Context *context, int64_t cycles)
         if (context->state.wait_after_ei)
         {
             context->state.wait_after_ei = false;
+            context->interrupt_deadline = 0;
         }
-        else
+        else if (context->cycle_count >= context->interrupt_deadline)
         {
-            /* First, check for a non-maskable interrupt (edge-triggered) */
-            static bool nmi_previous = 0;
-            bool nmi = context->get_nmi (context->parent);
-            bool nmi_rising_edge = (nmi && !nmi_previous);
-            nmi_previous = nmi;
+            int interrupt = z80_interrupt_check (context);
 
-            if (nmi_rising_edge)
+            if (interrupt < 0)
             {
-                /* Bump the R register */
-                context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
-
-                if (context->state.halt)
-                {
-                    context->state.halt = false;
-                }
-                context->state.iff1 = false;
-                context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-                context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
-                context->state.pc = 0x66;
-                context->used_cycles += 11;
-
-                context->cycle_count += context->used_cycles;
-                continue;
+                return;
             }
-
-            /* Then check for a maskable interrupt */
-            if (context->state.iff1 && context->get_int (context->parent))
+            else if (interrupt > 0)
             {
-                /* Bump the R register */
-                context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
-
-                if (context->state.halt)
-                {
-                    context->state.halt = false;
-                }
-
-                context->state.iff1 = false;
-                context->state.iff2 = false;
-
-                switch (context->state.im)
-                {
-                    case 1:
-                        context->memory_write (context->parent, --context->state.sp, context->state.pc_h);
-                        context->memory_write (context->parent, --context->state.sp, context->state.pc_l);
-                        context->state.pc = 0x38;
-                        context->used_cycles += 13;
-                        break;
-                    default:
-                        snprintf (state.error_buffer, 79, "Unsupported interrupt mode %d.", context->state.im);
-                        snepulator_error ("Z80 Error", state.error_buffer);
-                        return;
-                }
-
                 context->cycle_count += context->used_cycles;
                 continue;
             }
@@ -5622,9 +6127,11 @@ void z80_run_cycles (Z80_Context *context, int64_t cycles)
         /* If there was no interrupts, run an instruction or remain in HALT. */
         if (context->state.halt)
         {
-            /* Bump the R register */
-            context->state.r = (context->state.r & 0x80) | ((context->state.r + 1) & 0x7f);
-            context->used_cycles += 4;
+            z80_halt_run (context);
+        }
+        else if (context->jit_enabled && z80_jit_run (context, cycles))
+        {
+            /* A translated block has run, its cycles are in used_cycles */
         }
         else
         {
@@ -5636,6 +6143,7 @@ void z80_run_cycles (Z80_Context *context, int64_t cycles)
 
     context->state.excess_cycles = cycles;
 }
+#endif
 
 
 #ifdef HAVE_SAVE_STATES
@@ -5700,6 +6208,10 @@ void z80_state_load (Z80_Context *context, uint32_t version, uint32_t size, void
         context->state.wait_after_ei = z80_state_be.wait_after_ei;
         context->state.halt =          z80_state_be.halt;
         context->state.excess_cycles = util_ntoh32 (z80_state_be.excess_cycles);
+        context->interrupt_deadline = 0;
+
+        /* Memory is also being replaced, so translated code cannot be trusted */
+        z80_jit_flush (context);
     }
     else
     {
@@ -3,6 +3,10 @@
  * Zilog Z80 header
  */
 
+/* Memory map used for fast-path reads */
+#define Z80_PAGE_SIZE       SIZE_1K
+#define Z80_PAGE_COUNT      (SIZE_64K / Z80_PAGE_SIZE)
+
 /* Structs */
 typedef struct Z80_State_s {
 
@@ -97,6 +101,8 @@ typedef struct Z80_Context_s {
     Z80_State state;
     uint64_t cycle_count; /* Cycle counter since power-on */
     uint64_t used_cycles; /* Cycles used by the current instruction */
+    uint64_t instruction_count; /* Instructions executed since power-on */
+    uint64_t interrupt_deadline; /* Cycle count at which the interrupt lines are next checked */
 
     /* Connections to the rest of the system */
     uint8_t (* memory_read)  (void *, uint16_t);
@@ -106,6 +112,26 @@ typedef struct Z80_Context_s {
     bool    (* get_int)      (void *);
     bool    (* get_nmi)      (void *);
 
+    /* Host memory backing each page of the address space, maintained by the
+     * console. Reads from pages left as NULL go through memory_read. */
+    uint8_t *memory_map [Z80_PAGE_COUNT];
+
+    /* Idle loop detection, enabled with idle_skip */
+    bool idle_skip;
+    uint64_t cycle_end;                 /* Cycle count at which the current call to z80_run_cycles ends */
+    uint64_t side_effect_count;         /* Memory writes, port accesses, and reads through memory_read */
+    uint32_t idle_ports [8];            /* Ports that may be polled, set with z80_idle_port_set */
+    uint16_t idle_port_value [256];     /* Last value read from each port during this run, 0xffff if none */
+    Z80_State idle_state;               /* State at the top of the last backward jump, with R cleared */
+    uint8_t idle_r;
+    uint64_t idle_cycle_count;
+    uint64_t idle_instruction_count;
+    uint64_t idle_side_effect_count;
+
+    /* Dynamic recompiler, enabled with z80_jit_set */
+    bool jit_enabled;
+    bool jit_exit; /* Set to leave the running block after the current instruction */
+
 } Z80_Context;
 
 /* Z80 FLAGS */
@@ -135,6 +161,24 @@ Z80_Context *z80_init (void *parent,
 /* Simulate the Z80 for the specified number of clock cycles. */
 void z80_run_cycles (Z80_Context *context, int64_t cycles);
 
+/* Bring forward the cycle count at which the interrupt lines are next checked. */
+void z80_interrupt_deadline_set (Z80_Context *context, uint64_t cycle);
+
+/* Allow idle loops to poll a port. */
+void z80_idle_port_set (Z80_Context *context, uint8_t port);
+
+/* Enable or disable the dynamic recompiler. */
+void z80_jit_set (Z80_Context *context, bool enable);
+
+/* Discard all translated code. */
+void z80_jit_flush (Z80_Context *context);
+
+/* Run a translated block from the current PC, returns false if the interpreter is needed. */
+bool z80_jit_run (Z80_Context *context, int64_t cycles);
+
+/* Write to memory, discarding any translated code that the write modifies. */
+void z80_jit_memory_write (Z80_Context *context, uint16_t addr, uint8_t data);
+
 #ifdef HAVE_SAVE_STATES
 /* Export Z80 state. */
 void z80_state_save (Z80_Context *context);
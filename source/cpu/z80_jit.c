@@ -0,0 +1,852 @@
+/*
+ * Snepulator
+ * Zilog Z80 dynamic recompiler
+ *
+ * Basic blocks of Z80 code are translated into x86-64 host code. A handful of
+ * simple instructions are translated directly, and the rest become calls to the
+ * interpreter's handler for that instruction, removing the fetch and dispatch.
+ *
+ * Blocks end at branches, I/O, and instructions that affect interrupts. After
+ * each instruction, the block also checks the cycle budget, the interrupt
+ * deadline, and whether its code has been modified or banked out, so it always
+ * stops where the interpreter would have.
+ *
+ * Code is only translated from pages in the memory map. Host memory that has
+ * been modified is assumed to be RAM and is left to the interpreter, as is
+ * anything else that cannot be translated.
+ *
+ * The code buffer is never writable and executable at the same time. The pages
+ * being translated into are made writable, and then executable again once the
+ * block is complete.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../snepulator.h"
+#include "z80.h"
+
+#if defined (__x86_64__) && !defined (TARGET_WINDOWS)
+#define Z80_JIT_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef Z80_JIT_X86_64
+
+extern void (*z80_instruction [256]) (Z80_Context *);
+
+#define JIT_BUFFER_SIZE         (16 << 20)
+#define JIT_BLOCK_LENGTH        64                      /* Maximum instructions per block */
+#define JIT_INSTRUCTION_BYTES   160                     /* Maximum host code per instruction */
+#define JIT_BLOCK_BYTES         (JIT_BLOCK_LENGTH * JIT_INSTRUCTION_BYTES + 64)
+#define JIT_CHUNK_COUNT         4096                    /* Host memory is tracked in 1 KiB chunks, hashed into this many bits */
+
+/* x86-64 condition codes for jumps to the block exit */
+#define JIT_JAE     0x83
+#define JIT_JNE     0x85
+#define JIT_JLE     0x8e
+
+#define JIT_OFFSET(FIELD) ((uint32_t) offsetof (Z80_Context, FIELD))
+
+typedef void (*Z80_JIT_Code) (Z80_Context *, int64_t);
+
+/* A translated block, indexed by the Z80 address it starts at */
+typedef struct Z80_JIT_Block_s {
+    Z80_JIT_Code code;      /* NULL if the block is left to the interpreter */
+    uint8_t *page;          /* Host memory the block was translated from */
+    uint32_t generation;    /* Blocks from earlier generations have been discarded */
+} Z80_JIT_Block;
+
+static Z80_Context *jit_context = NULL;
+static uint8_t *jit_buffer = NULL;
+static uint32_t jit_buffer_used = 0;
+static uintptr_t jit_host_page_size = 0;
+static uint32_t jit_generation = 1;
+static Z80_JIT_Block jit_blocks [SIZE_64K];
+
+/* Page that the running block was translated from */
+static uint32_t jit_block_page_index = 0;
+static uint8_t *jit_block_page = NULL;
+
+/* Host memory that has been modified, and host memory that code has been translated from */
+static uint32_t jit_chunk_modified [JIT_CHUNK_COUNT / 32];
+static uint32_t jit_chunk_code [JIT_CHUNK_COUNT / 32];
+
+/* Code generation */
+static uint8_t *jit_emit_ptr;
+static uint8_t *jit_exit_fixup [JIT_BLOCK_LENGTH * 4];
+static uint32_t jit_exit_fixup_count;
+
+/* Offsets of the 8-bit registers, indexed as in the instruction encoding. Index 6 is (hl). */
+static const uint32_t jit_register_offset [8] = {
+    JIT_OFFSET (state.b), JIT_OFFSET (state.c), JIT_OFFSET (state.d), JIT_OFFSET (state.e),
+    JIT_OFFSET (state.h), JIT_OFFSET (state.l), 0,                    JIT_OFFSET (state.a)
+};
+
+/* Offsets of the 16-bit registers, indexed as in the instruction encoding */
+static const uint32_t jit_register_pair_offset [4] = {
+    JIT_OFFSET (state.bc), JIT_OFFSET (state.de), JIT_OFFSET (state.hl), JIT_OFFSET (state.sp)
+};
+
+
+/*
+ * Index into the chunk bitmaps for a host address.
+ */
+static inline uint32_t z80_jit_chunk (const uint8_t *ptr)
+{
+    return ((uintptr_t) ptr / SIZE_1K) % JIT_CHUNK_COUNT;
+}
+
+
+/*
+ * Change the protection of the host pages holding part of the code buffer.
+ */
+static bool z80_jit_protect (uint8_t *start, uint32_t length, int protection)
+{
+    uintptr_t first = (uintptr_t) start & ~(jit_host_page_size - 1);
+    uintptr_t end = ((uintptr_t) start + length + jit_host_page_size - 1) & ~(jit_host_page_size - 1);
+
+    return mprotect ((void *) first, end - first, protection) == 0;
+}
+
+
+/*
+ * Discard all translated code.
+ */
+static void z80_jit_discard (void)
+{
+    jit_generation++;
+
+    /* On wrapping, old blocks could appear current again */
+    if (jit_generation == 0)
+    {
+        memset (jit_blocks, 0, sizeof (jit_blocks));
+        jit_generation = 1;
+    }
+
+    jit_buffer_used = 0;
+    memset (jit_chunk_code, 0, sizeof (jit_chunk_code));
+}
+
+
+/*
+ * Emit bytes of host code.
+ */
+static inline void z80_jit_emit_8 (uint8_t value)
+{
+    *jit_emit_ptr++ = value;
+}
+
+static inline void z80_jit_emit_16 (uint16_t value)
+{
+    memcpy (jit_emit_ptr, &value, sizeof (value));
+    jit_emit_ptr += sizeof (value);
+}
+
+static inline void z80_jit_emit_32 (uint32_t value)
+{
+    memcpy (jit_emit_ptr, &value, sizeof (value));
+    jit_emit_ptr += sizeof (value);
+}
+
+static inline void z80_jit_emit_64 (uint64_t value)
+{
+    memcpy (jit_emit_ptr, &value, sizeof (value));
+    jit_emit_ptr += sizeof (value);
+}
+
+
+/*
+ * Emit the ModRM byte and displacement for an operand at [rbx + offset].
+ * The context pointer is kept in rbx while a block runs.
+ */
+static inline void z80_jit_emit_context_operand (uint8_t reg, uint32_t offset)
+{
+    z80_jit_emit_8 (0x83 | (reg << 3));
+    z80_jit_emit_32 (offset);
+}
+
+
+/*
+ * Emit a conditional jump to the block exit, to be patched once the exit is placed.
+ */
+static void z80_jit_emit_exit_jump (uint8_t condition)
+{
+    z80_jit_emit_8 (0x0f);
+    z80_jit_emit_8 (condition);
+    jit_exit_fixup [jit_exit_fixup_count++] = jit_emit_ptr;
+    z80_jit_emit_32 (0);
+}
+
+
+/*
+ * Emit the start of an instruction: Bump the R register and count the instruction.
+ */
+static void z80_jit_emit_instruction_start (void)
+{
+    /* movzx eax, byte [rbx + r] */
+    z80_jit_emit_8 (0x0f);
+    z80_jit_emit_8 (0xb6);
+    z80_jit_emit_context_operand (0, JIT_OFFSET (state.r));
+
+    /* lea ecx, [rax + 1] */
+    z80_jit_emit_8 (0x8d);
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0x01);
+
+    /* and ecx, 0x7f */
+    z80_jit_emit_8 (0x83);
+    z80_jit_emit_8 (0xe1);
+    z80_jit_emit_8 (0x7f);
+
+    /* and eax, 0x80 */
+    z80_jit_emit_8 (0x25);
+    z80_jit_emit_32 (0x80);
+
+    /* or eax, ecx */
+    z80_jit_emit_8 (0x09);
+    z80_jit_emit_8 (0xc8);
+
+    /* mov [rbx + r], al */
+    z80_jit_emit_8 (0x88);
+    z80_jit_emit_context_operand (0, JIT_OFFSET (state.r));
+
+    /* inc qword [rbx + instruction_count] */
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0xff);
+    z80_jit_emit_context_operand (0, JIT_OFFSET (instruction_count));
+}
+
+
+/*
+ * Emit a store of an immediate value to a 16-bit register.
+ */
+static void z80_jit_emit_store_16 (uint32_t offset, uint16_t value)
+{
+    /* mov word [rbx + offset], value */
+    z80_jit_emit_8 (0x66);
+    z80_jit_emit_8 (0xc7);
+    z80_jit_emit_context_operand (0, offset);
+    z80_jit_emit_16 (value);
+}
+
+
+/*
+ * Emit the end of an instruction.
+ *
+ * The cycle count is updated, and the block is left if the cycle budget has
+ * run out or the interrupt lines need checking.
+ *
+ * If cycles is zero, the cycle count is taken from used_cycles.
+ */
+static void z80_jit_emit_instruction_end (uint32_t cycles)
+{
+    if (cycles)
+    {
+        /* add qword [rbx + cycle_count], cycles */
+        z80_jit_emit_8 (0x48);
+        z80_jit_emit_8 (0x81);
+        z80_jit_emit_context_operand (0, JIT_OFFSET (cycle_count));
+        z80_jit_emit_32 (cycles);
+
+        /* sub r12, cycles */
+        z80_jit_emit_8 (0x49);
+        z80_jit_emit_8 (0x81);
+        z80_jit_emit_8 (0xec);
+        z80_jit_emit_32 (cycles);
+    }
+    else
+    {
+        /* mov rax, [rbx + used_cycles] */
+        z80_jit_emit_8 (0x48);
+        z80_jit_emit_8 (0x8b);
+        z80_jit_emit_context_operand (0, JIT_OFFSET (used_cycles));
+
+        /* add [rbx + cycle_count], rax */
+        z80_jit_emit_8 (0x48);
+        z80_jit_emit_8 (0x01);
+        z80_jit_emit_context_operand (0, JIT_OFFSET (cycle_count));
+
+        /* sub r12, rax */
+        z80_jit_emit_8 (0x49);
+        z80_jit_emit_8 (0x29);
+        z80_jit_emit_8 (0xc4);
+    }
+    z80_jit_emit_exit_jump (JIT_JLE);
+
+    /* mov rax, [rbx + cycle_count] */
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0x8b);
+    z80_jit_emit_context_operand (0, JIT_OFFSET (cycle_count));
+
+    /* cmp rax, [rbx + interrupt_deadline] */
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0x3b);
+    z80_jit_emit_context_operand (0, JIT_OFFSET (interrupt_deadline));
+    z80_jit_emit_exit_jump (JIT_JAE);
+}
+
+
+/*
+ * Emit a call to the interpreter's handler for an instruction.
+ *
+ * Handlers fetch their own operands, so the PC is left pointing after the
+ * opcode. If the block continues, the PC is checked afterwards to confirm
+ * that the instruction was the expected length and did not branch.
+ */
+static void z80_jit_emit_handler (uint16_t addr, uint8_t opcode, uint32_t length, bool end_block)
+{
+    z80_jit_emit_instruction_start ();
+    z80_jit_emit_store_16 (JIT_OFFSET (state.pc), addr + 1);
+
+    /* mov qword [rbx + used_cycles], 0 */
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0xc7);
+    z80_jit_emit_context_operand (0, JIT_OFFSET (used_cycles));
+    z80_jit_emit_32 (0);
+
+    /* mov rdi, rbx */
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0x89);
+    z80_jit_emit_8 (0xdf);
+
+    /* mov rax, handler */
+    z80_jit_emit_8 (0x48);
+    z80_jit_emit_8 (0xb8);
+    z80_jit_emit_64 ((uintptr_t) z80_instruction [opcode]);
+
+    /* call rax */
+    z80_jit_emit_8 (0xff);
+    z80_jit_emit_8 (0xd0);
+
+    z80_jit_emit_instruction_end (0);
+
+    /* The handler may have written to memory, modifying code or changing banks */
+    /* cmp byte [rbx + jit_exit], 0 */
+    z80_jit_emit_8 (0x80);
+    z80_jit_emit_context_operand (7, JIT_OFFSET (jit_exit));
+    z80_jit_emit_8 (0);
+    z80_jit_emit_exit_jump (JIT_JNE);
+
+    if (!end_block)
+    {
+        /* cmp word [rbx + pc], next */
+        z80_jit_emit_8 (0x66);
+        z80_jit_emit_8 (0x81);
+        z80_jit_emit_context_operand (7, JIT_OFFSET (state.pc));
+        z80_jit_emit_16 (addr + length);
+        z80_jit_emit_exit_jump (JIT_JNE);
+    }
+}
+
+
+/*
+ * Emit host code for an instruction that can be translated directly.
+ *
+ * Returns false if the instruction needs the interpreter's handler.
+ */
+static bool z80_jit_emit_direct (uint16_t addr, const uint8_t *code)
+{
+    uint8_t opcode = code [0];
+    uint16_t next_pc;
+    uint32_t cycles;
+
+    if (opcode == 0x00) /* nop */
+    {
+        z80_jit_emit_instruction_start ();
+        next_pc = addr + 1;
+        cycles = 4;
+    }
+    else if ((opcode & 0xc0) == 0x40 && (opcode & 0x07) != 0x06 && (opcode & 0x38) != 0x30) /* ld r, r */
+    {
+        z80_jit_emit_instruction_start ();
+
+        /* movzx eax, byte [rbx + source] */
+        z80_jit_emit_8 (0x0f);
+        z80_jit_emit_8 (0xb6);
+        z80_jit_emit_context_operand (0, jit_register_offset [opcode & 0x07]);
+
+        /* mov [rbx + destination], al */
+        z80_jit_emit_8 (0x88);
+        z80_jit_emit_context_operand (0, jit_register_offset [(opcode >> 3) & 0x07]);
+
+        next_pc = addr + 1;
+        cycles = 4;
+    }
+    else if ((opcode & 0xc7) == 0x06 && opcode != 0x36) /* ld r, x */
+    {
+        z80_jit_emit_instruction_start ();
+
+        /* mov byte [rbx + destination], x */
+        z80_jit_emit_8 (0xc6);
+        z80_jit_emit_context_operand (0, jit_register_offset [(opcode >> 3) & 0x07]);
+        z80_jit_emit_8 (code [1]);
+
+        next_pc = addr + 2;
+        cycles = 7;
+    }
+    else if ((opcode & 0xcf) == 0x01) /* ld rr, xx */
+    {
+        z80_jit_emit_instruction_start ();
+        z80_jit_emit_store_16 (jit_register_pair_offset [opcode >> 4], code [1] | (code [2] << 8));
+        next_pc = addr + 3;
+        cycles = 10;
+    }
+    else if ((opcode & 0xc7) == 0x03) /* inc rr, dec rr */
+    {
+        z80_jit_emit_instruction_start ();
+
+        /* inc / dec word [rbx + rr] */
+        z80_jit_emit_8 (0x66);
+        z80_jit_emit_8 (0xff);
+        z80_jit_emit_context_operand ((opcode & 0x08) ? 1 : 0, jit_register_pair_offset [(opcode >> 4) & 0x03]);
+
+        next_pc = addr + 1;
+        cycles = 6;
+    }
+    else if (opcode == 0xeb) /* ex de, hl */
+    {
+        z80_jit_emit_instruction_start ();
+
+        /* rol dword [rbx + de], 16 - hl is stored immediately after de */
+        z80_jit_emit_8 (0xc1);
+        z80_jit_emit_context_operand (0, JIT_OFFSET (state.de));
+        z80_jit_emit_8 (16);
+
+        next_pc = addr + 1;
+        cycles = 4;
+    }
+    else if (opcode == 0xc3) /* jp xx */
+    {
+        z80_jit_emit_instruction_start ();
+        next_pc = code [1] | (code [2] << 8);
+        cycles = 10;
+    }
+    else if (opcode == 0x18 && (int8_t) code [1] >= 0) /* jr x, backward jumps use the handler to check for idle loops */
+    {
+        z80_jit_emit_instruction_start ();
+        next_pc = addr + 2 + (int8_t) code [1];
+        cycles = 12;
+    }
+    else
+    {
+        return false;
+    }
+
+    z80_jit_emit_store_16 (JIT_OFFSET (state.pc), next_pc);
+    z80_jit_emit_instruction_end (cycles);
+
+    return true;
+}
+
+
+/*
+ * Length of an unprefixed instruction.
+ */
+static uint32_t z80_jit_length (uint8_t opcode)
+{
+    if ((opcode & 0xcf) == 0x01 ||                          /* ld rr, xx */
+        (opcode & 0xe7) == 0x22 ||                          /* ld (xx), hl / a and ld hl / a, (xx) */
+        (opcode & 0xc7) == 0xc2 || opcode == 0xc3 ||        /* jp */
+        (opcode & 0xc7) == 0xc4 || opcode == 0xcd)          /* call */
+    {
+        return 3;
+    }
+
+    if ((opcode & 0xc7) == 0x06 ||                          /* ld r, x */
+        (opcode & 0xc7) == 0xc6 ||                          /* alu a, x */
+        (opcode & 0xe7) == 0x20 ||                          /* jr cc, x */
+        opcode == 0x10 || opcode == 0x18 ||                 /* djnz, jr */
+        opcode == 0xd3 || opcode == 0xdb ||                 /* out, in */
+        opcode == 0xcb)
+    {
+        return 2;
+    }
+
+    return 1;
+}
+
+
+/*
+ * Check if an unprefixed instruction ends a block.
+ *
+ * This covers branches, I/O, halt, and ei.
+ */
+static bool z80_jit_ends_block (uint8_t opcode)
+{
+    switch (opcode & 0xc7)
+    {
+        case 0xc0: /* ret cc */
+        case 0xc2: /* jp cc */
+        case 0xc4: /* call cc */
+        case 0xc7: /* rst */
+            return true;
+        default:
+            break;
+    }
+
+    return opcode == 0xc3 || opcode == 0xc9 || opcode == 0xcd || opcode == 0xe9 ||
+           opcode == 0x10 || opcode == 0x18 || (opcode & 0xe7) == 0x20 ||
+           opcode == 0x76 || opcode == 0xd3 || opcode == 0xdb || opcode == 0xfb;
+}
+
+
+/*
+ * Check if an instruction using hl becomes (ix + d) when prefixed, adding a displacement byte.
+ */
+static bool z80_jit_has_displacement (uint8_t opcode)
+{
+    if (opcode == 0x34 || opcode == 0x35 || opcode == 0x36)
+    {
+        return true;
+    }
+
+    if ((opcode & 0xc0) == 0x40 && opcode != 0x76)
+    {
+        return (opcode & 0x07) == 0x06 || (opcode & 0x38) == 0x30;
+    }
+
+    return (opcode & 0xc7) == 0x86;
+}
+
+
+/*
+ * Decode the length of the instruction, and whether it ends the block.
+ *
+ * Returns 0 if the instruction does not fit in the bytes available.
+ */
+static uint32_t z80_jit_decode (const uint8_t *code, uint32_t available, bool *end_block)
+{
+    uint32_t length;
+
+    switch (code [0])
+    {
+        case 0xed:
+            /* Includes I/O, block instructions, retn, and interrupt modes */
+            if (available < 2)
+            {
+                return 0;
+            }
+            *end_block = true;
+            length = ((code [1] & 0xc7) == 0x43) ? 4 : 2;
+            break;
+
+        case 0xdd:
+        case 0xfd:
+            if (available < 2)
+            {
+                return 0;
+            }
+
+            if (code [1] == 0xcb)
+            {
+                *end_block = false;
+                length = 4;
+            }
+            else if (code [1] == 0xdd || code [1] == 0xfd || code [1] == 0xed)
+            {
+                *end_block = true;
+                length = 2;
+            }
+            else
+            {
+                *end_block = z80_jit_ends_block (code [1]);
+                length = 1 + z80_jit_length (code [1]) + z80_jit_has_displacement (code [1]);
+            }
+            break;
+
+        default:
+            *end_block = z80_jit_ends_block (code [0]);
+            length = z80_jit_length (code [0]);
+            break;
+    }
+
+    return (length <= available) ? length : 0;
+}
+
+
+/*
+ * Translate the block starting at addr.
+ *
+ * Returns NULL if the block should be left to the interpreter.
+ */
+static Z80_JIT_Code z80_jit_translate (uint16_t addr, uint8_t *page)
+{
+    uint32_t first_chunk = z80_jit_chunk (page);
+    uint32_t last_chunk = z80_jit_chunk (page + Z80_PAGE_SIZE - 1);
+
+    /* Modified memory is assumed to be RAM */
+    if ((jit_chunk_modified [first_chunk / 32] & (1u << (first_chunk % 32))) ||
+        (jit_chunk_modified [last_chunk / 32] & (1u << (last_chunk % 32))))
+    {
+        return NULL;
+    }
+
+    if (jit_buffer_used + JIT_BLOCK_BYTES > JIT_BUFFER_SIZE)
+    {
+        z80_jit_discard ();
+    }
+
+    uint8_t *block_start = jit_buffer + jit_buffer_used;
+    uint32_t count = 0;
+
+    if (!z80_jit_protect (block_start, JIT_BLOCK_BYTES, PROT_READ | PROT_WRITE))
+    {
+        return NULL;
+    }
+
+    jit_emit_ptr = block_start;
+    jit_exit_fixup_count = 0;
+
+    /* Prologue: The context is kept in rbx and the remaining cycles in r12 */
+    z80_jit_emit_8 (0x53);                          /* push rbx */
+    z80_jit_emit_8 (0x41);                          /* push r12 */
+    z80_jit_emit_8 (0x54);
+    z80_jit_emit_8 (0x48);                          /* sub rsp, 8 */
+    z80_jit_emit_8 (0x83);
+    z80_jit_emit_8 (0xec);
+    z80_jit_emit_8 (0x08);
+    z80_jit_emit_8 (0x48);                          /* mov rbx, rdi */
+    z80_jit_emit_8 (0x89);
+    z80_jit_emit_8 (0xfb);
+    z80_jit_emit_8 (0x49);                          /* mov r12, rsi */
+    z80_jit_emit_8 (0x89);
+    z80_jit_emit_8 (0xf4);
+
+    /* Blocks do not cross into the next page */
+    while (count < JIT_BLOCK_LENGTH)
+    {
+        uint32_t offset = addr & (Z80_PAGE_SIZE - 1);
+        const uint8_t *code = &page [offset];
+        bool end_block;
+
+        uint32_t length = z80_jit_decode (code, Z80_PAGE_SIZE - offset, &end_block);
+        if (length == 0)
+        {
+            break;
+        }
+
+        if (!z80_jit_emit_direct (addr, code))
+        {
+            z80_jit_emit_handler (addr, code [0], length, end_block);
+        }
+
+        count++;
+        addr += length;
+
+        if (end_block || offset + length == Z80_PAGE_SIZE)
+        {
+            break;
+        }
+    }
+
+    if (count == 0)
+    {
+        z80_jit_protect (block_start, JIT_BLOCK_BYTES, PROT_READ | PROT_EXEC);
+        return NULL;
+    }
+
+    /* Exit */
+    uint8_t *block_exit = jit_emit_ptr;
+    z80_jit_emit_8 (0x48);                          /* add rsp, 8 */
+    z80_jit_emit_8 (0x83);
+    z80_jit_emit_8 (0xc4);
+    z80_jit_emit_8 (0x08);
+    z80_jit_emit_8 (0x41);                          /* pop r12 */
+    z80_jit_emit_8 (0x5c);
+    z80_jit_emit_8 (0x5b);                          /* pop rbx */
+    z80_jit_emit_8 (0xc3);                          /* ret */
+
+    for (uint32_t i = 0; i < jit_exit_fixup_count; i++)
+    {
+        int32_t displacement = block_exit - (jit_exit_fixup [i] + 4);
+        memcpy (jit_exit_fixup [i], &displacement, sizeof (displacement));
+    }
+
+    if (!z80_jit_protect (block_start, JIT_BLOCK_BYTES, PROT_READ | PROT_EXEC))
+    {
+        return NULL;
+    }
+
+    jit_buffer_used += jit_emit_ptr - block_start;
+
+    /* Writes to this page now need to discard the translated code */
+    jit_chunk_code [first_chunk / 32] |= 1u << (first_chunk % 32);
+    jit_chunk_code [last_chunk / 32] |= 1u << (last_chunk % 32);
+
+    return (Z80_JIT_Code) block_start;
+}
+
+
+/*
+ * Enable or disable the dynamic recompiler.
+ *
+ * Only one Z80 uses the recompiler at a time. Enabling it discards any code
+ * translated for a previous Z80.
+ */
+void z80_jit_set (Z80_Context *context, bool enable)
+{
+    /* Consoles call this on every settings change, so only act if the state changes */
+    if (enable == context->jit_enabled)
+    {
+        return;
+    }
+
+    if (enable && jit_buffer == NULL)
+    {
+        jit_host_page_size = sysconf (_SC_PAGESIZE);
+        jit_buffer = mmap (NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_EXEC,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (jit_buffer == MAP_FAILED)
+        {
+            fprintf (stderr, "Unable to allocate memory for the Z80 recompiler, using the interpreter.\n");
+            jit_buffer = NULL;
+        }
+    }
+
+    context->jit_enabled = enable && (jit_buffer != NULL);
+
+    if (context->jit_enabled)
+    {
+        jit_context = context;
+        z80_jit_flush (context);
+    }
+    else if (jit_context == context)
+    {
+        jit_context = NULL;
+    }
+}
+
+
+/*
+ * Discard all translated code.
+ *
+ * Called when the Z80 is reset, or when memory is replaced without going
+ * through the Z80, such as when loading a save-state.
+ */
+void z80_jit_flush (Z80_Context *context)
+{
+    if (context == jit_context)
+    {
+        z80_jit_discard ();
+        memset (jit_chunk_modified, 0, sizeof (jit_chunk_modified));
+    }
+}
+
+
+/*
+ * Run a translated block from the current PC.
+ *
+ * On return, used_cycles holds the number of cycles used by the block, as
+ * though it were a single instruction. Returns false if the interpreter is
+ * needed for the current PC.
+ */
+bool z80_jit_run (Z80_Context *context, int64_t cycles)
+{
+    uint16_t pc = context->state.pc;
+    uint32_t page_index = pc / Z80_PAGE_SIZE;
+    uint8_t *page = context->memory_map [page_index];
+    Z80_JIT_Block *block = &jit_blocks [pc];
+
+    if (context != jit_context || page == NULL)
+    {
+        return false;
+    }
+
+    /* Blocks are translated on first use, and again if the memory has been re-mapped */
+    if (block->generation != jit_generation || block->page != page)
+    {
+        block->code = z80_jit_translate (pc, page);
+        block->page = page;
+        block->generation = jit_generation;
+    }
+
+    if (block->code == NULL)
+    {
+        return false;
+    }
+
+    jit_block_page_index = page_index;
+    jit_block_page = page;
+    context->jit_exit = false;
+
+    uint64_t start_cycle = context->cycle_count;
+    block->code (context, cycles);
+    context->used_cycles = context->cycle_count - start_cycle;
+    context->cycle_count = start_cycle;
+
+    return true;
+}
+
+
+/*
+ * Write to memory, discarding any translated code that the write modifies.
+ */
+void z80_jit_memory_write (Z80_Context *context, uint16_t addr, uint8_t data)
+{
+    uint8_t *page = context->memory_map [addr / Z80_PAGE_SIZE];
+
+    if (page != NULL)
+    {
+        uint8_t *byte = &page [addr & (Z80_PAGE_SIZE - 1)];
+        uint8_t previous = *byte;
+
+        context->memory_write (context->parent, addr, data);
+
+        /* Writes that change memory are assumed to be RAM. The first change to
+         * a chunk holding translated code causes all code to be discarded. */
+        uint32_t chunk = z80_jit_chunk (byte);
+        if (*byte != previous && !(jit_chunk_modified [chunk / 32] & (1u << (chunk % 32))))
+        {
+            jit_chunk_modified [chunk / 32] |= 1u << (chunk % 32);
+
+            if (jit_chunk_code [chunk / 32] & (1u << (chunk % 32)))
+            {
+                z80_jit_discard ();
+                context->jit_exit = true;
+            }
+        }
+    }
+    else
+    {
+        context->memory_write (context->parent, addr, data);
+    }
+
+    /* The write may have changed banks, replacing the running block */
+    if (context->memory_map [jit_block_page_index] != jit_block_page)
+    {
+        context->jit_exit = true;
+    }
+}
+
+#else
+
+/*
+ * The recompiler is only available for x86-64, other hosts use the interpreter.
+ */
+void z80_jit_set (Z80_Context *context, bool enable)
+{
+    context->jit_enabled = false;
+}
+
+void z80_jit_flush (Z80_Context *context)
+{
+    return;
+}
+
+bool z80_jit_run (Z80_Context *context, int64_t cycles)
+{
+    return false;
+}
+
+void z80_jit_memory_write (Z80_Context *context, uint16_t addr, uint8_t data)
+{
+    context->memory_write (context->parent, addr, data);
+}
+
+#endif
@@ -3,6 +3,7 @@
  * ImGui Main Menu-bar implementation
  */
 
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdio.h>
 
@@ -219,6 +220,16 @@ static void snepulator_console_menu ()
         {
             snepulator_disable_blanking_set (!state.disable_blanking);
         }
+        ImGui::Separator ();
+
+        if (ImGui::MenuItem ("Z80 Recompiler", NULL, state.z80_jit))
+        {
+            snepulator_z80_jit_set (!state.z80_jit);
+        }
+        if (ImGui::MenuItem ("Skip Z80 Idle Loops", NULL, state.z80_idle_skip))
+        {
+            snepulator_z80_idle_skip_set (!state.z80_idle_skip);
+        }
 
 #ifdef DEVELOPER_BUILD
         ImGui::Separator ();
@@ -244,6 +255,7 @@ static void snepulator_console_menu ()
             ImGui::Separator ();
             ImGui::Text ("Audio");
             ImGui::Text ("Ring buffer: %.2f%% full", state.audio_ring_utilisation * 100.0);
+            ImGui::Text ("Overruns:    %" PRIu64 " samples", __atomic_load_n (&state.audio_ring_overruns, __ATOMIC_RELAXED));
 
             ImGui::EndMenu ();
         }
@@ -518,6 +530,29 @@ static void snepulator_video_menu (void)
             ImGui::EndMenu ();
         }
 
+        if (ImGui::BeginMenu ("Frame Skip"))
+        {
+            if (ImGui::MenuItem ("Off", NULL, state.frame_skip == 0))
+            {
+                snepulator_frame_skip_set (0);
+            }
+            for (uint32_t frame_skip = 1; frame_skip <= 3; frame_skip++)
+            {
+                char label [20];
+                snprintf (label, sizeof (label), "Skip %u", frame_skip);
+                if (ImGui::MenuItem (label, NULL, state.frame_skip == frame_skip))
+                {
+                    snepulator_frame_skip_set (frame_skip);
+                }
+            }
+            if (ImGui::MenuItem ("Auto", NULL, state.frame_skip == VIDEO_FRAME_SKIP_AUTO))
+            {
+                snepulator_frame_skip_set (VIDEO_FRAME_SKIP_AUTO);
+            }
+
+            ImGui::EndMenu ();
+        }
+
         ImGui::Separator ();
 
         if (ImGui::BeginMenu ("TMS Mode Palette"))
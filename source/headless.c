@@ -0,0 +1,150 @@
+/*
+ * Snepulator
+ * Main (Headless)
+ *
+ * Runs a ROM without video, audio, or input devices. Emulation runs as fast as
+ * the host allows, and the emulated framerate is reported when finished.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snepulator.h"
+#include "util.h"
+#include "headless_run.h"
+
+/* Global state */
+Snepulator_State state;
+
+
+/*
+ * Display usage.
+ */
+static void usage (void)
+{
+    fprintf (stdout, "Usage: Snepulator-headless [--frames <count>] [--frame-skip <count|auto>] [--z80-jit] [--no-idle-skip] <rom>\n");
+}
+
+
+/*
+ * Entry point.
+ */
+int main (int argc, char **argv)
+{
+    const char *arg_filename = NULL;
+    uint64_t frames = 600;
+    const char *arg_frame_skip = NULL;
+    bool arg_z80_jit = false;
+    bool arg_no_idle_skip = false;
+
+    /* Initialise Snepulator state */
+    headless_init ();
+
+    /* Parse all CLI arguments */
+    while (*(++argv))
+    {
+        if (strcmp (*argv, "--frames") == 0 && argv [1] != NULL)
+        {
+            frames = strtoull (*(++argv), NULL, 0);
+        }
+        else if (strcmp (*argv, "--frame-skip") == 0 && argv [1] != NULL)
+        {
+            arg_frame_skip = *(++argv);
+        }
+        else if (strcmp (*argv, "--z80-jit") == 0)
+        {
+            arg_z80_jit = true;
+        }
+        else if (strcmp (*argv, "--no-idle-skip") == 0)
+        {
+            arg_no_idle_skip = true;
+        }
+        else if (!arg_filename)
+        {
+            /* ROM to load */
+            arg_filename = *(argv);
+        }
+        else
+        {
+            usage ();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (arg_filename == NULL || frames == 0)
+    {
+        usage ();
+        return EXIT_FAILURE;
+    }
+
+    /* Import configuration */
+    if (snepulator_config_import () == -1)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Command line options override the configuration file */
+    if (arg_z80_jit)
+    {
+        state.z80_jit = true;
+    }
+    if (arg_no_idle_skip)
+    {
+        state.z80_idle_skip = false;
+    }
+    if (arg_frame_skip != NULL)
+    {
+        state.frame_skip = (strcmp (arg_frame_skip, "auto") == 0) ? VIDEO_FRAME_SKIP_AUTO
+                                                                   : strtoul (arg_frame_skip, NULL, 0);
+    }
+
+    snepulator_rom_set (arg_filename);
+
+    if (state.run != RUN_STATE_RUNNING)
+    {
+        fprintf (stderr, "Unable to start %s.\n", arg_filename);
+        snepulator_reset ();
+        return EXIT_FAILURE;
+    }
+
+    /* Run as fast as possible */
+    uint64_t start_time = util_get_ticks_us ();
+    uint64_t emulated_cycles = headless_run (frames);
+
+    uint64_t run_time_us = util_get_ticks_us () - start_time;
+
+    /* Hash the final frame, allowing the output to be compared between builds.
+     * The hash is taken over packed RGB, independent of the pixel format. */
+    Video_Frame *frame = snepulator_get_current_frame ();
+    static uint8_t frame_rgb [VIDEO_MAX_WIDTH * VIDEO_MAX_LINES * 3];
+    uint8_t frame_hash [HASH_LENGTH];
+    for (uint32_t i = 0; i < frame->width * frame->height; i++)
+    {
+        frame_rgb [i * 3 + 0] = frame->active_area [i].r;
+        frame_rgb [i * 3 + 1] = frame->active_area [i].g;
+        frame_rgb [i * 3 + 2] = frame->active_area [i].b;
+    }
+    util_hash_rom (frame_rgb, frame->width * frame->height * 3, frame_hash);
+    double emulated_seconds = (state.clock_rate != 0) ? (double) emulated_cycles / state.clock_rate : 0.0;
+    double run_seconds = run_time_us / 1000000.0;
+    bool error = (state.run == RUN_STATE_ERROR);
+
+    fprintf (stdout, "%" PRIu64 " frames in %.3f s: %.2f fps, %.2fx real-time.\n",
+             state.frame_count, run_seconds,
+             state.frame_count / run_seconds,
+             emulated_seconds / run_seconds);
+
+    fprintf (stdout, "Final frame hash: ");
+    for (uint32_t i = 0; i < HASH_LENGTH; i++)
+    {
+        fprintf (stdout, "%02x", frame_hash [i]);
+    }
+    fprintf (stdout, "\n");
+
+    /* Tidy up */
+    snepulator_reset ();
+
+    return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
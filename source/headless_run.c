@@ -0,0 +1,118 @@
+/*
+ * Snepulator
+ * Headless run loop implementation.
+ *
+ * Runs the emulator core without video, audio, or input devices. This is shared
+ * by the headless runner and the benchmark harness, so that both measure the
+ * same work.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snepulator.h"
+#include "util.h"
+#include "headless_run.h"
+
+extern Snepulator_State state;
+
+
+/*
+ * Display an error message.
+ */
+void snepulator_error (const char *title, const char *format, ...)
+{
+    va_list args;
+    char message [240] = { '\0' };
+
+    if (state.run != RUN_STATE_EXIT)
+    {
+        state.run = RUN_STATE_ERROR;
+    }
+
+    va_start (args, format);
+    vsnprintf (message, 240, format, args);
+    va_end (args);
+
+    fprintf (stderr, "%s: %s\n", title, message);
+}
+
+
+/*
+ * No audio device is available.
+ */
+void snepulator_audio_device_open (const char *device)
+{
+    return;
+}
+
+
+/*
+ * Consume the audio generated during the last step.
+ *
+ * There is no sound card to pass the samples to, but they are still collected
+ * so that the sound chips do the same work they would in the GUI build.
+ */
+static void headless_audio_drain (uint32_t count)
+{
+    if (state.audio_callback != NULL)
+    {
+        memset (state.audio_buffer, 0, sizeof (state.audio_buffer));
+        state.audio_callback (state.console_context, state.audio_buffer, count);
+    }
+}
+
+
+/*
+ * Initialise Snepulator state for running without video, audio, or input devices.
+ */
+void headless_init (void)
+{
+    memset (&state, 0, sizeof (state));
+    state.video_3d_mode = VIDEO_3D_RED_CYAN;
+    state.video_3d_saturation = 0.25;
+
+    /* Initialise mutexes */
+    pthread_mutex_init (&state.run_mutex, NULL);
+    pthread_mutex_init (&state.video_mutex, NULL);
+
+    /* Initialise the video buffers */
+    snepulator_clear_video ();
+
+    /* Initialise timers */
+    util_ticks_init ();
+}
+
+
+/*
+ * Run the loaded ROM as fast as possible, until the frame count is reached or emulation stops.
+ *
+ * Each step runs one millisecond of emulated time. Returns the number of clock cycles run.
+ * On return, the most recently completed frame is the current frame.
+ */
+uint64_t headless_run (uint64_t frames)
+{
+    uint64_t emulated_cycles = 0;
+    uint64_t micro_clocks = 0;
+
+    while (state.frame_count < frames && state.run == RUN_STATE_RUNNING)
+    {
+        micro_clocks += HEADLESS_STEP_US * state.clock_rate;
+        uint64_t clocks_to_run = micro_clocks / 1000000;
+        micro_clocks -= clocks_to_run * 1000000;
+
+        snepulator_run (clocks_to_run);
+        headless_audio_drain (HEADLESS_STEP_AUDIO);
+
+        emulated_cycles += clocks_to_run;
+    }
+
+    /* Frames are not presented while running, only the final frame is taken.
+     * With no renderer picking up frames, automatic frame-skip sees it as
+     * always behind, and skips as many frames as it is allowed to. */
+    snepulator_get_next_frame ();
+
+    return emulated_cycles;
+}
@@ -0,0 +1,16 @@
+/*
+ * Snepulator
+ * Headless run loop header.
+ *
+ * Shared by the headless runner and the benchmark harness.
+ */
+
+/* Emulated time per call to snepulator_run */
+#define HEADLESS_STEP_US    1000
+#define HEADLESS_STEP_AUDIO (AUDIO_SAMPLE_RATE * HEADLESS_STEP_US / 1000000)
+
+/* Initialise Snepulator state for running without video, audio, or input devices. */
+void headless_init (void);
+
+/* Run the loaded ROM as fast as possible, until the frame count is reached or emulation stops. */
+uint64_t headless_run (uint64_t frames);
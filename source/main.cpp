@@ -521,12 +521,6 @@ int main (int argc, char **argv)
     state.video_3d_mode = VIDEO_3D_RED_CYAN;
     state.video_3d_saturation = 0.25;
 
-    for (uint32_t i = 0; i < VIDEO_RING_SIZE; i++)
-    {
-        state.video_ring [i].width = 256;
-        state.video_ring [i].height = 192;
-    }
-
     /* Parse all CLI arguments */
     const char *arg_filename = NULL;
     while (*(++argv))
@@ -627,6 +621,9 @@ int main (int argc, char **argv)
     pthread_mutex_init (&state.run_mutex, NULL);
     pthread_mutex_init (&state.video_mutex, NULL);
 
+    /* Initialise the video buffers */
+    snepulator_clear_video ();
+
     /* Initialise timers */
     util_ticks_init ();
 
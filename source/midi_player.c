@@ -475,7 +475,7 @@ static void draw_rect (MIDI_Player_Context *context,
     {
         for (uint32_t x = start_x; x < end_x; x++)
         {
-            context->frame_buffer.active_area [x + y * context->frame_buffer.width] = colour;
+            context->frame_buffer->active_area [x + y * context->frame_buffer->width] = colour;
         }
     }
 }
@@ -486,15 +486,19 @@ static void draw_rect (MIDI_Player_Context *context,
  */
 static void midi_player_draw_frame (MIDI_Player_Context *context)
 {
-    context->frame_buffer.width = 256;
-    context->frame_buffer.height = 224;
+    /* Draw directly into the frame that will be passed on for display */
+    context->frame_buffer = snepulator_get_draw_frame ();
+    memset (context->frame_buffer->active_area, 0, sizeof (context->frame_buffer->active_area));
+    memset (context->frame_buffer->backdrop, 0, sizeof (context->frame_buffer->backdrop));
+    context->frame_buffer->width = 256;
+    context->frame_buffer->height = 224;
 
     /* Horizontal layout of the bars */
     /* MIDI playback uses ym2413 rhythm mode, so 11 bars per chip. */
     uint32_t bar_width = 12;
     uint32_t bar_gap = 8;
     uint32_t bar_area_width = bar_width * 11 + bar_gap * (11 - 1);
-    uint32_t first_bar = (context->frame_buffer.width - bar_area_width) / 2;
+    uint32_t first_bar = (context->frame_buffer->width - bar_area_width) / 2;
 
     for (uint32_t i = 0; i < MIDI_YM2413_COUNT; i++)
     {
@@ -571,11 +575,7 @@ static void midi_player_draw_frame (MIDI_Player_Context *context)
     draw_rect (context, 32 + progress, 216, 8, 1, light_grey);
 
     /* Pass the completed frame on for rendering */
-    snepulator_frame_done (&context->frame_buffer);
-
-    /* Clear the buffer for the next frame. */
-    memset (context->frame_buffer.active_area, 0, sizeof (context->frame_buffer.active_area));
-    memset (context->frame_buffer.backdrop, 0, sizeof (context->frame_buffer.backdrop));
+    snepulator_frame_done (context->frame_buffer);
 }
 
 
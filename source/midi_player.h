@@ -92,7 +92,7 @@ typedef struct MIDI_Player_Context_s {
 
     /* Visualisation */
     uint32_t frame_clock_counter;
-    Video_Frame frame_buffer;
+    Video_Frame *frame_buffer;
 
 } MIDI_Player_Context;
 
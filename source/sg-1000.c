@@ -31,6 +31,7 @@ static uint8_t  sg_1000_io_read (void *context_ptr, uint8_t addr);
 static void     sg_1000_io_write (void *context_ptr, uint8_t addr, uint8_t data);
 static uint8_t  sg_1000_memory_read (void *context_ptr, uint16_t addr);
 static void     sg_1000_memory_write (void *context_ptr, uint16_t addr, uint8_t data);
+static void     sg_1000_memory_map_update (SG_1000_Context *context);
 static void     sg_1000_run (void *context_ptr, uint32_t ms);
 #ifdef HAVE_SAVE_STATES
 static void     sg_1000_state_load (void *context_ptr, const char *filename);
@@ -129,7 +130,7 @@ static void sg_1000_frame_done (void *context_ptr)
     SG_1000_Context *context = (SG_1000_Context *) context_ptr;
     TMS9928A_Context *vdp_context = context->vdp_context;
 
-    snepulator_frame_done (&vdp_context->frame_buffer);
+    snepulator_frame_done (vdp_context->frame_buffer);
 }
 
 
@@ -188,6 +189,12 @@ SG_1000_Context *sg_1000_init (void)
                             sg_1000_get_int, sg_1000_get_nmi);
     context->z80_context = z80_context;
 
+    /* Idle loops may poll the VDP status */
+    for (uint32_t port = 0x81; port <= 0xbf; port += 0x02)
+    {
+        z80_idle_port_set (z80_context, port);
+    }
+
     /* Initialise VDP */
     vdp_context = tms9928a_init (context, sg_1000_frame_done);
     context->vdp_context = vdp_context;
@@ -241,6 +248,8 @@ SG_1000_Context *sg_1000_init (void)
         }
     }
 
+    sg_1000_memory_map_update (context);
+
     /* Hook up the callbacks */
     state.audio_callback = sg_1000_audio_callback;
     state.cleanup = sg_1000_cleanup;
@@ -371,6 +380,57 @@ static void sg_1000_io_write (void *context_ptr, uint8_t addr, uint8_t data)
 }
 
 
+/*
+ * Find the host memory that backs an address.
+ *
+ * Returns NULL for addresses that are not mapped to memory.
+ */
+static uint8_t *sg_1000_memory_pointer (SG_1000_Context *context, uint16_t addr)
+{
+    /* Taiwanese RAM Expander, 8 KiB at 0x2000 (DahJee) */
+    if (context->hw_state.mapper == SG_MAPPER_DAHJEE_RAM)
+    {
+        if (addr >= 0x2000 && addr <= 0x3fff)
+        {
+            return &context->sram [addr & (SG_1000_SRAM_SIZE - 1)];
+        }
+    }
+
+    /* Taiwanese RAM Expander, 8 KB at 0xc000 */
+    if (context->hw_state.mapper == SG_MAPPER_EXTRA_RAM)
+    {
+        if (addr >= 0xc000 && addr <= 0xffff)
+        {
+            return &context->sram [addr & (SG_1000_SRAM_SIZE - 1)];
+        }
+    }
+
+    /* Cartridge slot */
+    if (addr >= 0x0000 && addr <= 0xbfff && addr < context->rom_size)
+    {
+        uint8_t slot = (addr >> 14);
+        uint32_t bank_base = context->hw_state.mapper_bank [slot] * ((uint32_t) 16 << 10);
+        uint16_t offset    = addr & 0x3fff;
+
+        return &context->rom [(bank_base + offset) & context->rom_mask];
+    }
+
+    /* Up to 8 KiB of on-cartridge sram */
+    if (addr >= 0x8000 && addr <= 0xbfff)
+    {
+        return &context->sram [addr & (SG_1000_SRAM_SIZE - 1)];
+    }
+
+    /* 1 KiB RAM (mirrored) */
+    if (addr >= 0xc000 && addr <= 0xffff)
+    {
+        return &context->ram [addr & (SG_1000_RAM_SIZE - 1)];
+    }
+
+    return NULL;
+}
+
+
 /*
  * Handle SG-1000 memory reads.
  */
@@ -409,47 +469,46 @@ static uint8_t sg_1000_memory_read (void *context_ptr, uint16_t addr)
         }
     }
 
-    /* Taiwanese RAM Expander, 8 KiB at 0x2000 (DahJee) */
-    if (context->hw_state.mapper == SG_MAPPER_DAHJEE_RAM)
-    {
-        if (addr >= 0x2000 && addr <= 0x3fff)
-        {
-            return context->sram [addr & (SG_1000_SRAM_SIZE - 1)];
-        }
-    }
+    uint8_t *pointer = sg_1000_memory_pointer (context, addr);
 
-    /* Taiwanese RAM Expander, 8 KB at 0xc000 */
-    if (context->hw_state.mapper == SG_MAPPER_EXTRA_RAM)
+    if (pointer == NULL)
     {
-        if (addr >= 0xc000 && addr <= 0xffff)
-        {
-            return context->sram [addr & (SG_1000_SRAM_SIZE - 1)];
-        }
+        return 0xff;
     }
 
-    /* Cartridge slot */
-    if (addr >= 0x0000 && addr <= 0xbfff && addr < context->rom_size)
-    {
-        uint8_t slot = (addr >> 14);
-        uint32_t bank_base = context->hw_state.mapper_bank [slot] * ((uint32_t) 16 << 10);
-        uint16_t offset    = addr & 0x3fff;
+    return *pointer;
+}
 
-        return context->rom [(bank_base + offset) & context->rom_mask];
-    }
 
-    /* Up to 8 KiB of on-cartridge sram */
-    if (addr >= 0x8000 && addr <= 0xbfff)
+/*
+ * Rebuild the Z80 memory map after a change to the mapper.
+ *
+ * Pages are only mapped if they are backed by contiguous host memory.
+ */
+static void sg_1000_memory_map_update (SG_1000_Context *context)
+{
+    for (uint32_t page = 0; page < Z80_PAGE_COUNT; page++)
     {
-        return context->sram [addr & (SG_1000_SRAM_SIZE - 1)];
-    }
+        uint16_t addr = page * Z80_PAGE_SIZE;
+        uint8_t *first = sg_1000_memory_pointer (context, addr);
+        uint8_t *last = sg_1000_memory_pointer (context, addr + Z80_PAGE_SIZE - 1);
 
-    /* 1 KiB RAM (mirrored) */
-    if (addr >= 0xc000 && addr <= 0xffff)
-    {
-        return context->ram [addr & (SG_1000_RAM_SIZE - 1)];
-    }
+        /* The Graphic Board registers are handled by sg_1000_memory_read */
+        if (context->hw_state.mapper == SG_MAPPER_GRAPHIC_BOARD &&
+            (page == 0x8000 / Z80_PAGE_SIZE || page == 0xa000 / Z80_PAGE_SIZE))
+        {
+            first = NULL;
+        }
 
-    return 0xff;
+        if (first != NULL && last == first + Z80_PAGE_SIZE - 1)
+        {
+            context->z80_context->memory_map [page] = first;
+        }
+        else
+        {
+            context->z80_context->memory_map [page] = NULL;
+        }
+    }
 }
 
 
@@ -464,6 +523,7 @@ static void sg_1000_memory_write (void *context_ptr, uint16_t addr, uint8_t data
     if (context->hw_state.mapper == SG_MAPPER_SEGA && addr == 0xffff)
     {
         context->hw_state.mapper_bank [2] = data & 0x3f;
+        sg_1000_memory_map_update (context);
     }
 
     /* Graphic Board */
@@ -522,12 +582,21 @@ static void sg_1000_run (void *context_ptr, uint32_t cycles)
     lines = context->pending_cycles / 228;
     context->pending_cycles -= lines * 228;
 
+    /* The pause button may have changed since the last run */
+    z80_interrupt_deadline_set (context->z80_context, context->z80_context->cycle_count);
+
     while (lines--)
     {
         /* 228 CPU cycles per scanline */
         z80_run_cycles (context->z80_context, 228 + context->overclock);
         sn76489_run_cycles (context->psg_context, state.clock_rate, 228);
         tms9928a_run_one_scanline (context->vdp_context);
+
+        /* If the VDP is raising an interrupt, have the Z80 check before its next instruction */
+        if (tms9928a_get_interrupt (context->vdp_context))
+        {
+            z80_interrupt_deadline_set (context->z80_context, context->z80_context->cycle_count);
+        }
     }
 }
 
@@ -615,6 +684,7 @@ static void sg_1000_state_load (void *context_ptr, const char *filename)
             if (size == TMS9928A_VRAM_SIZE)
             {
                 memcpy (context->vdp_context->vram, data, TMS9928A_VRAM_SIZE);
+                tms9928a_sprite_lines_invalidate (context->vdp_context);
             }
             else
             {
@@ -631,6 +701,8 @@ static void sg_1000_state_load (void *context_ptr, const char *filename)
         }
     }
 
+    sg_1000_memory_map_update (context);
+
     load_state_end ();
 }
 
@@ -674,6 +746,8 @@ static void sg_1000_update_settings (void *context_ptr)
 
     /* Update console */
     context->overclock = state.overclock;
+    context->z80_context->idle_skip = state.z80_idle_skip;
+    z80_jit_set (context->z80_context, state.z80_jit);
 
     if (state.format_auto)
     {
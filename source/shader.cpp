@@ -6,12 +6,10 @@
 /*
  * Video path:
  *
+ * The console draws directly into the triple-buffer.
+ *
  *   ╭────────────────────────╮
- *   │    VDP frame-buffer    │
- *   ╰───────────┬────────────╯
- *               │ memcpy
- *   ╭───────────┴────────────╮
- *   │    state.video_ring    │
+ *   │   state.video_frames   │
  *   ╰───────────┬────────────╯
  *               │ glTexImage2D
  *   ╭───────────┴────────────╮
@@ -172,16 +170,19 @@ void snepulator_shader_callback (const ImDrawList *parent_list, const ImDrawCmd
         glUniform1i (location, 2);
     }
 
-    /* Copy the most recent frame into the textures */
+    /* Copy the most recent frame into the textures.
+     * Note: The internal format is always RGB, so the unused byte of RGBX pixels is not read as alpha. */
     Video_Frame *frame = snepulator_get_current_frame ();
 
     glActiveTexture (GL_TEXTURE1);
     glBindTexture (GL_TEXTURE_2D, active_area_texture);
-    glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB, frame->width, frame->height, 0, GL_RGB, GL_UNSIGNED_BYTE, frame->active_area);
+    glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB, frame->width, frame->height, 0,
+                  VIDEO_PIXEL_GL_FORMAT, GL_UNSIGNED_BYTE, frame->active_area);
 
     glActiveTexture (GL_TEXTURE2);
     glBindTexture (GL_TEXTURE_2D, backdrop_texture);
-    glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB, frame->height, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, state.disable_border ? black_backdrop : frame->backdrop);
+    glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB, frame->height, 1, 0,
+                  VIDEO_PIXEL_GL_FORMAT, GL_UNSIGNED_BYTE, state.disable_border ? black_backdrop : frame->backdrop);
 
     /* Set the uniforms */
     location = glGetUniformLocation (shader_program, "frame_resolution");
@@ -29,6 +29,7 @@ extern Snepulator_Gamepad gamepad [3];
  */
 static uint8_t smd_z80_memory_read (void *context_ptr, uint16_t addr);
 static void    smd_z80_memory_write (void *context_ptr, uint16_t addr, uint8_t data);
+static void    smd_memory_map_update (SMD_Context *context);
 
 
 /*
@@ -51,7 +52,38 @@ static void smd_frame_done (void *context_ptr)
     SMD_Context *context = (SMD_Context *) context_ptr;
     SMD_VDP_Context *vdp_context = context->vdp_context;
 
-    snepulator_frame_done (&vdp_context->frame_buffer);
+    snepulator_frame_done (vdp_context->frame_buffer);
+}
+
+
+/*
+ * Read a 16-bit word from ROM or RAM, which are stored as host-endian words.
+ * Words at odd addresses are assembled from bytes.
+ */
+static inline uint16_t smd_buffer_read_16 (const uint8_t *buffer, uint32_t mask, uint32_t addr)
+{
+    if (addr & 1)
+    {
+        return (buffer [(addr & mask) ^ 1] << 8) | buffer [((addr + 1) & mask) ^ 1];
+    }
+
+    return * (const uint16_t *) &buffer [addr & mask];
+}
+
+
+/*
+ * Write a 16-bit word to RAM, which is stored as host-endian words.
+ */
+static inline void smd_buffer_write_16 (uint8_t *buffer, uint32_t mask, uint32_t addr, uint16_t data)
+{
+    if (addr & 1)
+    {
+        buffer [(addr & mask) ^ 1] = data >> 8;
+        buffer [((addr + 1) & mask) ^ 1] = data;
+        return;
+    }
+
+    * (uint16_t *) &buffer [addr & mask] = data;
 }
 
 
@@ -68,7 +100,7 @@ static uint8_t smd_memory_read_8 (void *context_ptr, uint32_t addr)
     {
         if (context->rom != NULL)
         {
-            return context->rom [addr & context->rom_mask];
+            return context->rom [(addr & context->rom_mask) ^ 1];
         }
         else
         {
@@ -197,7 +229,7 @@ static uint8_t smd_memory_read_8 (void *context_ptr, uint32_t addr)
     /* RAM: 0xff0000 -- 0xffffff */
     else
     {
-        return context->ram [addr & 0x00ffff];
+        return context->ram [(addr & 0x00ffff) ^ 1];
     }
 
     snepulator_error (__func__, "Unmapped address %06x.", addr);
@@ -217,7 +249,7 @@ static uint16_t smd_memory_read_16 (void *context_ptr, uint32_t addr)
     {
         if (context->rom != NULL)
         {
-            return util_ntoh16 (* (uint16_t *) &context->rom [addr & context->rom_mask]);
+            return smd_buffer_read_16 (context->rom, context->rom_mask, addr);
         }
         else
         {
@@ -287,7 +319,7 @@ static uint16_t smd_memory_read_16 (void *context_ptr, uint32_t addr)
     /* RAM: 0xff0000 -- 0xffffff */
     else
     {
-        return util_ntoh16 (* (uint16_t *) &context->ram [addr & 0x00ffff]);
+        return smd_buffer_read_16 (context->ram, 0x00ffff, addr);
     }
 
     snepulator_error (__func__, "Unmapped address %06x.", addr);
@@ -430,7 +462,7 @@ static void smd_memory_write_8 (void *context_ptr, uint32_t addr, uint8_t data)
     /* RAM */
     else if (addr >= 0xe00000 && addr <= 0xffffff)
     {
-        context->ram [addr & 0x00ffff] = data;
+        context->ram [(addr & 0x00ffff) ^ 1] = data;
     }
 
     else
@@ -519,7 +551,7 @@ static void smd_memory_write_16 (void *context_ptr, uint32_t addr, uint16_t data
     /* RAM */
     else if (addr >= 0xe00000 && addr <= 0xffffff)
     {
-        * (uint16_t *) &context->ram [addr & 0x00ffff] = util_hton16 (data);
+        smd_buffer_write_16 (context->ram, 0x00ffff, addr, data);
     }
 
     /* Invalid write */
@@ -530,6 +562,67 @@ static void smd_memory_write_16 (void *context_ptr, uint32_t addr, uint16_t data
 }
 
 
+/*
+ * Build the 68000 memory map.
+ *
+ * Cartridge ROM and work RAM are accessed directly by the 68000. ROM pages
+ * are only mapped where the full 64 KiB is backed by the loaded image. The
+ * remaining pages, such as the Z80 space, I/O, and the VDP, are left to the
+ * smd_memory_ callbacks.
+ */
+static void smd_memory_map_update (SMD_Context *context)
+{
+    M68000_Context *m68k_context = context->m68k_context;
+
+    for (uint32_t page = 0; page < M68K_PAGE_COUNT; page++)
+    {
+        uint32_t addr = page * M68K_PAGE_SIZE;
+
+        m68k_context->memory_map [page] = NULL;
+        m68k_context->memory_map_write [page] = NULL;
+
+        /* Cartridge ROM: 0x000000 -- 0x3fffff */
+        if (addr <= 0x3fffff && context->rom != NULL)
+        {
+            uint32_t offset = addr & context->rom_mask;
+
+            if (offset + M68K_PAGE_SIZE <= context->rom_size)
+            {
+                m68k_context->memory_map [page] = &context->rom [offset];
+            }
+        }
+
+        /* RAM: 0xe00000 -- 0xffffff */
+        else if (addr >= 0xe00000)
+        {
+            m68k_context->memory_map [page] = context->ram;
+            m68k_context->memory_map_write [page] = context->ram;
+        }
+    }
+}
+
+
+/*
+ * Find host memory for a VDP DMA source, using the 68000 memory map.
+ * Returns a pointer to the word at addr and the number of words that follow
+ * it in the same page, or NULL if the page is not mapped.
+ */
+static const uint16_t *smd_dma_memory_pointer (void *context_ptr, uint32_t addr, uint32_t *words)
+{
+    SMD_Context *context = (SMD_Context *) context_ptr;
+    uint8_t *page = context->m68k_context->memory_map [(addr >> 16) & (M68K_PAGE_COUNT - 1)];
+    uint32_t offset = addr & (M68K_PAGE_SIZE - 1);
+
+    if (page == NULL || (offset & 1))
+    {
+        return NULL;
+    }
+
+    *words = (M68K_PAGE_SIZE - offset) >> 1;
+    return (const uint16_t *) &page [offset];
+}
+
+
 /*
  * Handle Z80 address-space memory reads.
  */
@@ -655,14 +748,63 @@ static bool smd_z80_get_nmi (void *context_ptr)
 }
 
 
+/*
+ * Run the CPUs up to the specified master clock time.
+ */
+static void smd_run_cpus (SMD_Context *context, uint64_t time)
+{
+    uint64_t cycles;
+
+    if (time > context->m68k_clock)
+    {
+        cycles = (time - context->m68k_clock) / SMD_M68K_CLOCK_DIVIDER;
+        m68k_run_cycles (context->m68k_context, cycles);
+        context->m68k_clock += cycles * SMD_M68K_CLOCK_DIVIDER;
+    }
+
+    if (time > context->z80_clock)
+    {
+        cycles = (time - context->z80_clock) / SMD_Z80_CLOCK_DIVIDER;
+        if (context->state.z80_reset_n && !context->state.z80_busreq)
+        {
+            z80_run_cycles (context->z80_context, cycles);
+        }
+        context->z80_clock += cycles * SMD_Z80_CLOCK_DIVIDER;
+    }
+}
+
+
+/*
+ * Bring the sound chips up to the current master clock time.
+ */
+static void smd_sound_sync (SMD_Context *context)
+{
+    uint64_t cycles;
+
+    /* TODO: Variable clock rate when able to switch between PAL and NTSC */
+    cycles = (context->clock - context->ym2612_clock) / SMD_M68K_CLOCK_DIVIDER;
+    ym2612_run_cycles (context->ym2612_context, SMD_NTSC_MASTER_CLOCK / SMD_M68K_CLOCK_DIVIDER, cycles);
+    context->ym2612_clock += cycles * SMD_M68K_CLOCK_DIVIDER;
+
+    cycles = (context->clock - context->psg_clock) / SMD_Z80_CLOCK_DIVIDER;
+    sn76489_run_cycles (context->psg_context, SMD_NTSC_MASTER_CLOCK / SMD_Z80_CLOCK_DIVIDER, cycles);
+    context->psg_clock += cycles * SMD_Z80_CLOCK_DIVIDER;
+}
+
+
 /*
  * Emulate the Mega Drive for the specified number of clock cycles.
  * Called with the run_mutex held.
+ *
+ * The CPUs run until the next VDP scanline is due, or the end of the call.
+ * The VDP raises the line and vblank interrupts from its own line counter
+ * when running the scanline, so lines are the only deadline the CPUs need
+ * to stop at.
  */
 static void smd_run (void *context_ptr, uint32_t cycles)
 {
     SMD_Context *context = (SMD_Context *) context_ptr;
-    uint32_t lines;
+    uint64_t end = context->clock + cycles;
 
     /*
      * Clock Notes:
@@ -679,31 +821,29 @@ static void smd_run (void *context_ptr, uint32_t cycles)
      *   some modes, but not all. Things may get funky around different
      *   combinations of resolution and internal vs external pixel-clocks.
      *   This does however result in a non-integer number of m68k cycles
-     *   per scanline.
+     *   per scanline, which is carried from line to line.
      */
 
-    /* Convert cycles into lines to run, storing the remainder for next time. */
-    context->pending_cycles += cycles;
-    lines = context->pending_cycles / 3420;
-    context->pending_cycles -= lines * 3420;
-
-    while (lines--)
+    while (context->clock < end)
     {
-        /* TODO: 489 is rounded up. A better solution is to add 3420 master_clock
-         *       cycles to a pool and subtract as many full m68k cycles as we can,
-         *       saving any leftovers for the next line. */
-        m68k_run_cycles (context->m68k_context, 489);
+        uint64_t target = (context->line_clock < end) ? context->line_clock : end;
 
-        if (context->state.z80_reset_n && !context->state.z80_busreq)
+        smd_run_cpus (context, target);
+        context->clock = target;
+
+        if (context->clock == context->line_clock)
         {
-            z80_run_cycles (context->z80_context, 228);
-        }
+            smd_vdp_run_one_scanline (context->vdp_context);
 
-        smd_vdp_run_one_scanline (context->vdp_context);
+            /* If the VDP is raising the Z80 interrupt, have the Z80 check before its next instruction */
+            if (context->vdp_context->state.z80_interrupt)
+            {
+                z80_interrupt_deadline_set (context->z80_context, context->z80_context->cycle_count);
+            }
 
-        /* TODO: Variable clock rate when able to switch between PAL and NTSC */
-        ym2612_run_cycles (context->ym2612_context, SMD_NTSC_MASTER_CLOCK / 7, 489); /* TODO: Same note as m68k */
-        sn76489_run_cycles (context->psg_context, SMD_NTSC_MASTER_CLOCK / 15 , 228);
+            smd_sound_sync (context);
+            context->line_clock += SMD_LINE_MASTER_CLOCKS;
+        }
     }
 }
 
@@ -815,6 +955,7 @@ SMD_Context *smd_init (void)
                             smd_z80_io_read, smd_z80_io_write,
                             smd_z80_get_int, smd_z80_get_nmi);
     context->z80_context = z80_context;
+    z80_context->idle_skip = state.z80_idle_skip;
 
     context->state.z80_reset_n = false;
     context->state.z80_busreq = false;
@@ -826,7 +967,7 @@ SMD_Context *smd_init (void)
      *       needed, but only use what is needed. Remove the start-x / start-y
      *       and always start at zero. Pass around a struct to describe the
      *       size that has been used.  */
-    vdp_context = smd_vdp_init (context, smd_memory_read_16, smd_frame_done);
+    vdp_context = smd_vdp_init (context, smd_memory_read_16, smd_dma_memory_pointer, smd_frame_done);
     context->vdp_context = vdp_context;
 
     /* Initialise sound chips */
@@ -848,8 +989,18 @@ SMD_Context *smd_init (void)
         fprintf (stdout, "%d KiB ROM %s loaded.\n", context->rom_size >> 10, state.cart_filename);
         context->rom_mask = util_round_up (context->rom_size) - 1;
         util_hash_rom (context->rom, context->rom_size, context->rom_hash);
+
+        /* Store the ROM as host-endian words, to match the 68000 memory map */
+        for (uint32_t i = 0; i + 1 < context->rom_size; i += 2)
+        {
+            uint16_t *word = (uint16_t *) &context->rom [i];
+            *word = util_ntoh16 (*word);
+        }
     }
 
+    /* Map ROM and RAM for direct access by the 68000 */
+    smd_memory_map_update (context);
+
     /* Hook up callbacks */
     state.audio_callback = smd_audio_callback;
     state.cleanup = smd_cleanup;
@@ -869,6 +1020,7 @@ SMD_Context *smd_init (void)
     gamepad [2].group = GAMEPAD_MAPPING_GROUP_SMD;
 
     /* Begin emulation */
+    context->line_clock = SMD_LINE_MASTER_CLOCKS;
     m68k_reset (m68k_context);
     state.run = RUN_STATE_RUNNING;
 
@@ -9,6 +9,11 @@
 #define SMD_RAM_SIZE        SIZE_64K
 #define SMD_Z80_RAM_SIZE    SIZE_8K
 
+/* Master clock dividers */
+#define SMD_M68K_CLOCK_DIVIDER  7
+#define SMD_Z80_CLOCK_DIVIDER   15
+#define SMD_LINE_MASTER_CLOCKS  3420
+
 
 typedef struct SMD_State_s {
 
@@ -35,7 +40,16 @@ typedef struct SMD_Context_s {
     SMD_VDP_Context *vdp_context;
     YM2612_Context *ym2612_context;
     SN76489_Context *psg_context;
-    uint64_t pending_cycles;
+
+    /* Timing. Times are in master clock cycles since power-on. Each
+     * component keeps the time it has been run up to, so that the fraction
+     * of a cycle left over by its clock divider is carried to the next run. */
+    uint64_t clock;
+    uint64_t m68k_clock;
+    uint64_t z80_clock;
+    uint64_t ym2612_clock;
+    uint64_t psg_clock;
+    uint64_t line_clock;    /* Time at which the next VDP scanline is due */
 
     /* Settings */
     Video_Format format;
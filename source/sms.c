@@ -53,6 +53,7 @@ static uint8_t     sms_io_read (void *context_ptr, uint8_t addr);
 static void        sms_io_write (void *context_ptr, uint8_t addr, uint8_t data);
 static uint8_t     sms_memory_read (void *context_ptr, uint16_t addr);
 static void        sms_memory_write (void *context_ptr, uint16_t addr, uint8_t data);
+static void        sms_memory_map_update (SMS_Context *context);
 static void        sms_process_3d_field (SMS_Context *context);
 static void        sms_run (void *context_ptr, uint32_t ms);
 static void        sms_soft_reset (void);
@@ -95,7 +96,7 @@ static void sms_cleanup (void *context_ptr)
 
     if (context->vdp_context != NULL)
     {
-        free (context->vdp_context);
+        sms_vdp_cleanup (context->vdp_context);
         context->vdp_context = NULL;
     }
 
@@ -215,14 +216,22 @@ static void sms_frame_done (void *context_ptr)
     SMS_Context *context = (SMS_Context *) context_ptr;
     TMS9928A_Context *vdp_context = context->vdp_context;
 
-    if (context->video_3d_field != SMS_3D_FIELD_NONE)
+    /* Skipped frames leave the 3D image unchanged */
+    if (context->video_3d_field != SMS_3D_FIELD_NONE && !vdp_context->frame_buffer->skip)
     {
         sms_process_3d_field (context);
         snepulator_frame_done (&context->frame_buffer_3d);
     }
     else
     {
-        snepulator_frame_done (&vdp_context->frame_buffer);
+        snepulator_frame_done (vdp_context->frame_buffer);
+    }
+
+    /* The 3D glasses alternate between eyes each frame. Skipping frames
+     * would leave one eye's image unchanged, so draw every frame. */
+    if (context->video_3d_field != SMS_3D_FIELD_NONE)
+    {
+        snepulator_get_draw_frame ()->skip = false;
     }
 }
 
@@ -238,6 +247,18 @@ static bool sms_get_int (void *context_ptr)
 }
 
 
+/*
+ * If the VDP is raising an interrupt, have the Z80 check before its next instruction.
+ */
+static inline void sms_interrupt_update (SMS_Context *context)
+{
+    if (sms_vdp_get_interrupt (context->vdp_context))
+    {
+        z80_interrupt_deadline_set (context->z80_context, context->z80_context->cycle_count);
+    }
+}
+
+
 /*
  * Returns true if there is a non-maskable interrupt.
  */
@@ -291,6 +312,12 @@ SMS_Context *sms_init (void)
                             sms_get_int, sms_get_nmi);
     context->z80_context = z80_context;
 
+    /* Idle loops may poll the VDP status and V counter */
+    for (uint32_t port = 0x40; port <= 0xbf; port += 0x02)
+    {
+        z80_idle_port_set (z80_context, (port < 0x80) ? port : port + 1);
+    }
+
     /* Initialise VDP */
     vdp_context = sms_vdp_init (context, sms_frame_done, state.console);
     context->vdp_context = vdp_context;
@@ -482,6 +509,8 @@ SMS_Context *sms_init (void)
         sms_vdp_control_write (vdp_context, TMS9928A_CODE_REG_WRITE | 0x0a);
     }
 
+    sms_memory_map_update (context);
+
     /* Set controller mapping */
     gamepad [1].group = GAMEPAD_MAPPING_GROUP_SMS;
     gamepad [2].group = GAMEPAD_MAPPING_GROUP_SMS;
@@ -726,6 +755,7 @@ static void sms_io_write (void *context_ptr, uint8_t addr, uint8_t data)
                 return;
             }
             context->hw_state.memory_control = data;
+            sms_memory_map_update (context);
         }
         else
         {
@@ -815,19 +845,19 @@ static void sms_io_write (void *context_ptr, uint8_t addr, uint8_t data)
 
 
 /*
- * Handle SMS memory reads.
+ * Find the host memory that backs an address.
+ *
+ * Returns NULL for addresses that are not mapped to memory. If the data must be
+ * bit-reversed when read (Janggun mapper), bit_reverse is set to true.
  */
-static uint8_t sms_memory_read (void *context_ptr, uint16_t addr)
+static uint8_t *sms_memory_pointer (SMS_Context *context, uint16_t addr, bool *bit_reverse)
 {
-    SMS_Context *context = (SMS_Context *) context_ptr;
-
     /* Cartridge, card, BIOS, expansion slot */
     if (addr >= 0x0000 && addr <= 0xbfff)
     {
         uint8_t slot = 0;
         uint32_t bank_base;
         uint32_t rom_address;
-        bool bit_reverse = false;
 
         switch (context->hw_state.mapper)
         {
@@ -899,7 +929,7 @@ static uint8_t sms_memory_read (void *context_ptr, uint16_t addr)
                 {
                     slot = (addr - SIZE_16K) / SIZE_8K;
                     bank_base = (context->hw_state.mapper_bank [slot] & 0x3f) * SIZE_8K;
-                    bit_reverse = !!(context->hw_state.mapper_bank [slot] & 0x40);
+                    *bit_reverse = !!(context->hw_state.mapper_bank [slot] & 0x40);
                     rom_address = bank_base + (addr & 0x1fff);
                 }
                 break;
@@ -913,40 +943,83 @@ static uint8_t sms_memory_read (void *context_ptr, uint16_t addr)
         if (context->bios != NULL && !(context->hw_state.memory_control & SMS_MEMORY_CTRL_BIOS))
         {
             /* Assumes a power-of-two BIOS size */
-            return context->bios [rom_address & context->bios_mask];
+            return &context->bios [rom_address & context->bios_mask];
         }
 
         /* On-cartridge SRAM */
         if (context->hw_state.sram_enable && slot == 2)
         {
-            return context->sram [context->hw_state.sram_bank | (addr & SMS_SRAM_BANK_MASK)];
+            return &context->sram [context->hw_state.sram_bank | (addr & SMS_SRAM_BANK_MASK)];
         }
 
         /* Cartridge ROM */
         if (context->rom != NULL && !(context->hw_state.memory_control & SMS_MEMORY_CTRL_CART))
         {
-            if (bit_reverse)
-            {
-                uint8_t value = context->rom [rom_address & context->rom_mask];
-                return ((value & BIT_0) << 7) | ((value & BIT_1) << 5) |
-                       ((value & BIT_2) << 3) | ((value & BIT_3) << 1) |
-                       ((value & BIT_4) >> 1) | ((value & BIT_5) >> 3) |
-                       ((value & BIT_6) >> 5) | ((value & BIT_7) >> 7);
-            }
-            else
-            {
-                return context->rom [rom_address & context->rom_mask];
-            }
+            return &context->rom [rom_address & context->rom_mask];
         }
     }
 
     /* 8 KiB RAM + mirror */
     if (addr >= 0xc000 && addr <= 0xffff)
     {
-        return context->ram [addr & (SMS_RAM_SIZE - 1)];
+        return &context->ram [addr & (SMS_RAM_SIZE - 1)];
     }
 
-    return 0xff;
+    return NULL;
+}
+
+
+/*
+ * Handle SMS memory reads.
+ */
+static uint8_t sms_memory_read (void *context_ptr, uint16_t addr)
+{
+    SMS_Context *context = (SMS_Context *) context_ptr;
+    bool bit_reverse = false;
+    uint8_t *pointer = sms_memory_pointer (context, addr, &bit_reverse);
+
+    if (pointer == NULL)
+    {
+        return 0xff;
+    }
+
+    if (bit_reverse)
+    {
+        uint8_t value = *pointer;
+        return ((value & BIT_0) << 7) | ((value & BIT_1) << 5) |
+               ((value & BIT_2) << 3) | ((value & BIT_3) << 1) |
+               ((value & BIT_4) >> 1) | ((value & BIT_5) >> 3) |
+               ((value & BIT_6) >> 5) | ((value & BIT_7) >> 7);
+    }
+
+    return *pointer;
+}
+
+
+/*
+ * Rebuild the Z80 memory map after a change to the mapper or memory control.
+ *
+ * Pages are only mapped if they are backed by contiguous host memory. Anything
+ * else, such as bit-reversed banks, is left to sms_memory_read.
+ */
+static void sms_memory_map_update (SMS_Context *context)
+{
+    for (uint32_t page = 0; page < Z80_PAGE_COUNT; page++)
+    {
+        uint16_t addr = page * Z80_PAGE_SIZE;
+        bool bit_reverse = false;
+        uint8_t *first = sms_memory_pointer (context, addr, &bit_reverse);
+        uint8_t *last = sms_memory_pointer (context, addr + Z80_PAGE_SIZE - 1, &bit_reverse);
+
+        if (first != NULL && !bit_reverse && last == first + Z80_PAGE_SIZE - 1)
+        {
+            context->z80_context->memory_map [page] = first;
+        }
+        else
+        {
+            context->z80_context->memory_map [page] = NULL;
+        }
+    }
 }
 
 
@@ -956,6 +1029,12 @@ static uint8_t sms_memory_read (void *context_ptr, uint16_t addr)
 static void sms_memory_write (void *context_ptr, uint16_t addr, uint8_t data)
 {
     SMS_Context *context = (SMS_Context *) context_ptr;
+    uint8_t mapper = context->hw_state.mapper;
+    uint8_t mapper_banks [4];
+    uint16_t sram_bank = context->hw_state.sram_bank;
+    bool sram_enable = context->hw_state.sram_enable;
+
+    memcpy (mapper_banks, context->hw_state.mapper_bank, sizeof (context->hw_state.mapper_bank));
 
     /* No early breaks - Register writes also affect RAM */
 
@@ -1140,6 +1219,14 @@ static void sms_memory_write (void *context_ptr, uint16_t addr, uint8_t data)
     {
         context->ram [addr & (SMS_RAM_SIZE - 1)] = data;
     }
+
+    /* Only rebuild the memory map if a mapper register has changed it */
+    if (mapper != context->hw_state.mapper ||
+        memcmp (mapper_banks, context->hw_state.mapper_bank, sizeof (context->hw_state.mapper_bank)) != 0 ||
+        sram_bank != context->hw_state.sram_bank || sram_enable != context->hw_state.sram_enable)
+    {
+        sms_memory_map_update (context);
+    }
 }
 
 
@@ -1211,12 +1298,31 @@ static void sms_process_3d_field (SMS_Context *context)
             break;
     }
 
-    context->frame_buffer_3d.width = vdp_context->frame_buffer.width;
-    context->frame_buffer_3d.height = vdp_context->frame_buffer.height;
+    context->frame_buffer_3d.width = vdp_context->frame_buffer->width;
+    context->frame_buffer_3d.height = vdp_context->frame_buffer->height;
+
+    /* Neighbouring pixels are usually the same colour, so re-use the previous conversion where possible */
+    uint_pixel_t source = { };
+    bool converted = false;
+
+    /* The field is combined as RGB, one line at a time */
+    uint_pixel_t line_rgb [VIDEO_MAX_WIDTH];
 
     for (uint32_t i = 0; i < (context->frame_buffer_3d.width * context->frame_buffer_3d.height); i++)
     {
-        pixel = util_colour_saturation (vdp_context->frame_buffer.active_area [i], state.video_3d_saturation);
+        uint32_t x = i % context->frame_buffer_3d.width;
+
+        if (x == 0)
+        {
+            snepulator_frame_expand_line (vdp_context->frame_buffer, i / context->frame_buffer_3d.width, line_rgb);
+        }
+
+        if (!converted || memcmp (&source, &line_rgb [x], sizeof (uint_pixel_t)) != 0)
+        {
+            source = line_rgb [x];
+            pixel = util_colour_saturation (source, state.video_3d_saturation);
+            converted = true;
+        }
 
         if (update_red)
         {
@@ -1259,6 +1365,9 @@ static void sms_run (void *context_ptr, uint32_t cycles)
         gamepad_paddle_tick (cycles);
     }
 
+    /* The pause button may have changed since the last run */
+    z80_interrupt_deadline_set (context->z80_context, context->z80_context->cycle_count);
+
     while (lines--)
     {
         /* 228 CPU cycles per scanline */
@@ -1266,8 +1375,10 @@ static void sms_run (void *context_ptr, uint32_t cycles)
         sms_vdp_update_x_scroll_latch (context->vdp_context);
         z80_run_cycles (context->z80_context, 12);
         sms_vdp_run_one_scanline (context->vdp_context);
+        sms_interrupt_update (context);
         z80_run_cycles (context->z80_context, 1);
         sms_vdp_update_line_interrupt (context->vdp_context);
+        sms_interrupt_update (context);
         z80_run_cycles (context->z80_context, 201);
         sn76489_run_cycles (context->psg_context, state.clock_rate, 228);
 
@@ -1282,6 +1393,9 @@ static void sms_run (void *context_ptr, uint32_t cycles)
         }
     }
 
+    /* Finish drawing any deferred lines, as the frame may be used once the run_mutex is released */
+    sms_vdp_finish (context->vdp_context);
+
     if (context->reset_button)
     {
         if (util_get_ticks () > context->reset_button_timeout)
@@ -1399,6 +1513,7 @@ static void sms_state_load (void *context_ptr, const char *filename)
             if (size == TMS9928A_VRAM_SIZE)
             {
                 memcpy (context->vdp_context->vram, data, TMS9928A_VRAM_SIZE);
+                sms_vdp_pattern_cache_invalidate (context->vdp_context);
             }
             else
             {
@@ -1421,6 +1536,8 @@ static void sms_state_load (void *context_ptr, const char *filename)
         }
     }
 
+    sms_memory_map_update (context);
+
     load_state_end ();
 }
 
@@ -1530,6 +1647,8 @@ static void sms_update_settings (void *context_ptr)
     /* Update console */
     context->overclock           = state.overclock;
     context->region              = state.region;
+    context->z80_context->idle_skip = state.z80_idle_skip;
+    z80_jit_set (context->z80_context, state.z80_jit);
 
     if (state.format_auto)
     {
@@ -166,6 +166,20 @@ int snepulator_config_import (void)
         state.remove_sprite_limit = uint;
     }
 
+    /* Z80 recompiler - Defaults to off */
+    state.z80_jit = false;
+    if (config_uint_get ("cpu", "z80-jit", &uint) == 0)
+    {
+        state.z80_jit = uint;
+    }
+
+    /* Z80 idle loop skipping - Defaults to on */
+    state.z80_idle_skip = true;
+    if (config_uint_get ("cpu", "z80-idle-skip", &uint) == 0)
+    {
+        state.z80_idle_skip = uint;
+    }
+
     /* Disable blanking - Defaults to off */
     state.disable_blanking = false;
     if (config_uint_get ("hacks", "disable-blanking", &uint) == 0)
@@ -173,6 +187,20 @@ int snepulator_config_import (void)
         state.disable_blanking = uint;
     }
 
+    /* Frame skip - Defaults to off */
+    state.frame_skip = 0;
+    if (config_string_get ("video", "frame-skip", &string) == 0)
+    {
+        if (strcmp (string, "Auto") == 0)
+        {
+            state.frame_skip = VIDEO_FRAME_SKIP_AUTO;
+        }
+        else
+        {
+            state.frame_skip = strtoul (string, NULL, 10);
+        }
+    }
+
     /* Disable border - Defaults to off */
     state.disable_border = false;
     if (config_uint_get ("video", "disable-border", &uint) == 0)
@@ -292,21 +320,36 @@ int snepulator_config_import (void)
 }
 
 
+/*
+ * Mark a frame as RGB, ready for it to be drawn again. The indexed
+ * state is set up by the first call to snepulator_frame_line_palette.
+ */
+static void snepulator_frame_index_reset (Video_Frame *frame)
+{
+    frame->indexed = false;
+}
+
+
 /*
  * Clear the screen.
  */
 void snepulator_clear_video (void)
 {
     pthread_mutex_lock (&state.video_mutex);
-    for (uint32_t i = 0; i < VIDEO_RING_SIZE; i++)
-    {
-        memset (state.video_ring[i].active_area, 0, sizeof (state.video_ring[i].active_area));
-        memset (state.video_ring[i].backdrop, 0, sizeof (state.video_ring[i].backdrop));
-        state.video_ring [i].width = 256;
-        state.video_ring [i].height = 192;
-    }
-    state.video_read_index = 0;
-    state.video_write_index = 0;
+    for (uint32_t i = 0; i < VIDEO_FRAME_COUNT; i++)
+    {
+        memset (state.video_frames[i].active_area, 0, sizeof (state.video_frames[i].active_area));
+        memset (state.video_frames[i].backdrop, 0, sizeof (state.video_frames[i].backdrop));
+        snepulator_frame_index_reset (&state.video_frames [i]);
+        state.video_frames [i].width = 256;
+        state.video_frames [i].height = 192;
+        state.video_frames [i].skip = false;
+    }
+    state.video_draw_index = 0;
+    state.video_skip_count = 0;
+    __atomic_store_n (&state.video_ready_index, 1, __ATOMIC_RELEASE);
+    state.video_read_index = 2;
+    state.video_output_valid = false;
     pthread_mutex_unlock (&state.video_mutex);
 }
 
@@ -478,27 +521,122 @@ void snepulator_paddle_sensitivity_set (double sensitivity)
 }
 
 
+/*
+ * Get one line of a frame as RGB.
+ *
+ * Lines of an indexed frame that the VDP did not draw are filled with the backdrop.
+ */
+void snepulator_frame_expand_line (const Video_Frame *frame, uint32_t line, uint_pixel_t *dest)
+{
+    if (!frame->indexed)
+    {
+        memcpy (dest, &frame->active_area [line * frame->width], frame->width * sizeof (uint_pixel_t));
+    }
+    else if (frame->line_palette [line] == VIDEO_LINE_NONE)
+    {
+        for (uint32_t x = 0; x < frame->width; x++)
+        {
+            dest [x] = frame->backdrop [line];
+        }
+    }
+    else
+    {
+        const uint_pixel_t *palette = frame->palettes [frame->line_palette [line]];
+        const uint8_t *source = &frame->active_area_index [line * frame->width];
+
+        for (uint32_t x = 0; x < frame->width; x++)
+        {
+            dest [x] = palette [source [x] & (VIDEO_PALETTE_SIZE - 1)];
+        }
+    }
+}
+
+
+/*
+ * Write a frame into another as RGB.
+ */
+static void snepulator_frame_expand (const Video_Frame *source, Video_Frame *dest)
+{
+    snepulator_frame_index_reset (dest);
+    memcpy (dest->backdrop, source->backdrop, sizeof (dest->backdrop));
+    dest->width = source->width;
+    dest->height = source->height;
+
+    for (uint32_t y = 0; y < source->height; y++)
+    {
+        snepulator_frame_expand_line (source, y, &dest->active_area [y * source->width]);
+    }
+}
+
+
+/*
+ * Decide whether the next frame should be skipped.
+ *
+ * renderer_behind is true if the renderer had not picked up the previously
+ * published frame by the time this one was completed.
+ */
+static bool snepulator_frame_skip_next (bool renderer_behind)
+{
+    if (state.frame_skip == 0 || state.run != RUN_STATE_RUNNING || state.step_single_frame)
+    {
+        return false;
+    }
+
+    /* Automatic frame-skip skips while the renderer is falling behind */
+    if (state.frame_skip == VIDEO_FRAME_SKIP_AUTO)
+    {
+        return renderer_behind && state.video_skip_count < VIDEO_FRAME_SKIP_AUTO_MAX - 1;
+    }
+
+    return state.video_skip_count < state.frame_skip;
+}
+
+
 /*
  * Send a completed frame for display.
  *
- * A buffer is used to avoid skipping frames when
- * the host and emulated console have a similar framerate.
+ * Frames drawn into the buffer from snepulator_get_draw_frame are published
+ * without being copied. Frames from any other buffer are first copied in.
+ *
+ * If the frame was skipped, nothing was drawn and nothing is published.
  */
 void snepulator_frame_done (Video_Frame *frame)
 {
-    /* Queue the frame.
-     *  -> If there are already two frames queued, replace the last frame.
-     *  -> Otherwise, append the new frame to the queue. */
-    pthread_mutex_lock (&state.video_mutex);
-    if (state.video_write_index < state.video_read_index + 2)
+    Video_Frame *draw_frame = &state.video_frames [state.video_draw_index];
+    bool renderer_behind;
+
+    if (draw_frame->skip)
     {
-        state.video_write_index++;
+        /* Nothing new has been published, so check if the last frame is still waiting */
+        renderer_behind = __atomic_load_n (&state.video_ready_index, __ATOMIC_ACQUIRE) & VIDEO_FRAME_NEW;
+        state.video_skip_count++;
     }
-    memcpy (state.video_ring [state.video_write_index % VIDEO_RING_SIZE].active_area, frame->active_area, sizeof (state.video_ring [0].active_area));
-    memcpy (state.video_ring [state.video_write_index % VIDEO_RING_SIZE].backdrop,    frame->backdrop,    sizeof (state.video_ring [0].backdrop));
-    state.video_ring [state.video_write_index % VIDEO_RING_SIZE].width = frame->width;
-    state.video_ring [state.video_write_index % VIDEO_RING_SIZE].height = frame->height;
-    pthread_mutex_unlock (&state.video_mutex);
+    else
+    {
+        if (frame != draw_frame)
+        {
+            snepulator_frame_expand (frame, draw_frame);
+        }
+
+        /* Swap the completed frame in as the most recent, taking whichever buffer
+         * it replaces to draw the next frame. If the renderer never picked up the
+         * previous frame, it is dropped. */
+        uint32_t previous = __atomic_exchange_n (&state.video_ready_index, state.video_draw_index | VIDEO_FRAME_NEW,
+                                                 __ATOMIC_ACQ_REL);
+        state.video_draw_index = previous & ~VIDEO_FRAME_NEW;
+        renderer_behind = previous & VIDEO_FRAME_NEW;
+
+        /* Consoles set the frame size at the start of each frame, so carry it over */
+        state.video_frames [state.video_draw_index].width = draw_frame->width;
+        state.video_frames [state.video_draw_index].height = draw_frame->height;
+        snepulator_frame_index_reset (&state.video_frames [state.video_draw_index]);
+
+        state.video_skip_count = 0;
+    }
+
+    state.video_frames [state.video_draw_index].skip = snepulator_frame_skip_next (renderer_behind);
+
+    state.frame_count++;
 
     if (state.step_single_frame && state.run == RUN_STATE_RUNNING)
     {
@@ -508,28 +646,114 @@ void snepulator_frame_done (Video_Frame *frame)
 
 
 /*
- * Get a pointer to the currently displayed frame.
+ * Select the palette used by a line of indexed output.
+ *
+ * Called by the VDP as it draws each line. A snapshot of the palette is only
+ * taken if it differs from the one used by the previous indexed line, so
+ * frames without raster palette effects only store one palette.
+ */
+void snepulator_frame_line_palette (Video_Frame *frame, uint32_t line, const uint_pixel_t *palette, uint32_t size)
+{
+    /* The first indexed line of the frame replaces any RGB output */
+    if (!frame->indexed)
+    {
+        memset (frame->line_palette, VIDEO_LINE_NONE, sizeof (frame->line_palette));
+        frame->palette_count = 0;
+        frame->indexed = true;
+    }
+
+    if (frame->palette_count == 0 ||
+        memcmp (frame->palettes [frame->palette_count - 1], palette, size * sizeof (uint_pixel_t)) != 0)
+    {
+        /* Frames never have more palettes than lines, but re-use the last if they do */
+        if (frame->palette_count < VIDEO_MAX_LINES)
+        {
+            frame->palette_count++;
+        }
+        memcpy (frame->palettes [frame->palette_count - 1], palette, size * sizeof (uint_pixel_t));
+    }
+
+    frame->line_palette [line] = frame->palette_count - 1;
+}
+
+
+/*
+ * Set the number of frames to skip drawing after each drawn frame.
+ *
+ * Skipped frames still run the VDP, so that status flags seen by the game
+ * are unchanged, but no pixels are drawn. VIDEO_FRAME_SKIP_AUTO skips
+ * frames only while the renderer has yet to display the previous frame.
+ */
+void snepulator_frame_skip_set (uint32_t frame_skip)
+{
+    state.frame_skip = frame_skip;
+
+    if (frame_skip == VIDEO_FRAME_SKIP_AUTO)
+    {
+        config_string_set ("video", "frame-skip", "Auto");
+    }
+    else
+    {
+        char buf [12];
+        sprintf (buf, "%u", frame_skip);
+        config_string_set ("video", "frame-skip", buf);
+    }
+
+    config_write ();
+}
+
+
+/*
+ * Get a pointer to the currently displayed frame, as RGB.
  */
 Video_Frame *snepulator_get_current_frame (void)
 {
-    return &state.video_ring [state.video_read_index % VIDEO_RING_SIZE];
+    Video_Frame *frame = &state.video_frames [state.video_read_index];
+
+    if (!frame->indexed)
+    {
+        return frame;
+    }
+
+    /* Indexed frames are expanded when first presented */
+    if (!state.video_output_valid)
+    {
+        snepulator_frame_expand (frame, &state.video_output_frame);
+        state.video_output_valid = true;
+    }
+
+    return &state.video_output_frame;
+}
+
+
+/*
+ * Get a pointer to the frame that the console should draw into.
+ *
+ * This changes each time a frame is completed, so should not be kept
+ * across calls to snepulator_frame_done.
+ */
+Video_Frame *snepulator_get_draw_frame (void)
+{
+    return &state.video_frames [state.video_draw_index];
 }
 
 
 /*
- * Advance the video_read_index and get a pointer
- * to the new frame.
+ * If a new frame has been completed, swap it in
+ * and get a pointer to the new frame.
+ *
+ * The frame may be indexed, use snepulator_get_current_frame for its pixels.
  */
 Video_Frame *snepulator_get_next_frame (void)
 {
-    pthread_mutex_lock (&state.video_mutex);
-    if (state.video_read_index < state.video_write_index)
+    if (__atomic_load_n (&state.video_ready_index, __ATOMIC_RELAXED) & VIDEO_FRAME_NEW)
     {
-        state.video_read_index++;
+        uint32_t ready = __atomic_exchange_n (&state.video_ready_index, state.video_read_index, __ATOMIC_ACQ_REL);
+        state.video_read_index = ready & ~VIDEO_FRAME_NEW;
+        state.video_output_valid = false;
     }
-    pthread_mutex_unlock (&state.video_mutex);
 
-    return &state.video_ring [state.video_read_index % VIDEO_RING_SIZE];
+    return &state.video_frames [state.video_read_index];
 }
 
 
@@ -616,17 +840,20 @@ void snepulator_override_tms9928a_palette (uint_pixel_t *palette)
  */
 void snepulator_pause_animate (void)
 {
-    Video_Frame frame_buffer;
+    /* The console may still be finishing its last run_callback */
+    pthread_mutex_lock (&state.run_mutex);
+    Video_Frame *frame_buffer = snepulator_get_draw_frame ();
 
     /* Draw over a greyscale copy of the last-drawn frame */
-    memcpy (frame_buffer.active_area, state.video_pause_data.active_area, sizeof (frame_buffer.active_area));
-    memcpy (frame_buffer.backdrop, state.video_pause_data.backdrop, sizeof (frame_buffer.backdrop));
-    frame_buffer.width = state.video_pause_data.width;
-    frame_buffer.height = state.video_pause_data.height;
+    snepulator_frame_index_reset (frame_buffer);
+    memcpy (frame_buffer->active_area, state.video_pause_data.active_area, sizeof (frame_buffer->active_area));
+    memcpy (frame_buffer->backdrop, state.video_pause_data.backdrop, sizeof (frame_buffer->backdrop));
+    frame_buffer->width = state.video_pause_data.width;
+    frame_buffer->height = state.video_pause_data.height;
 
     /* Each letter overlaps by one pixel */
-    uint32_t x_base = frame_buffer.width / 2 - (snepulator_paused.width - 5) / 2;
-    uint32_t y_base = frame_buffer.height / 2 - snepulator_paused.height / 2;
+    uint32_t x_base = frame_buffer->width / 2 - (snepulator_paused.width - 5) / 2;
+    uint32_t y_base = frame_buffer->height / 2 - snepulator_paused.height / 2;
     const uint32_t letter_position [7] = {  0, 23, 46, 69,  92, 115, 138 };
 
     uint32_t frame_time = util_get_ticks ();
@@ -647,17 +874,18 @@ void snepulator_pause_animate (void)
                     continue;
                 }
 
-                frame_buffer.active_area [(x + x_base - letter) + (uint32_t) (y + y_base + y_offset) * frame_buffer.width].r =
+                frame_buffer->active_area [(x + x_base - letter) + (uint32_t) (y + y_base + y_offset) * frame_buffer->width].r =
                     snepulator_paused.pixel_data [(x + y * snepulator_paused.width) * 3 + 0];
-                frame_buffer.active_area [(x + x_base - letter) + (uint32_t) (y + y_base + y_offset) * frame_buffer.width].g =
+                frame_buffer->active_area [(x + x_base - letter) + (uint32_t) (y + y_base + y_offset) * frame_buffer->width].g =
                     snepulator_paused.pixel_data [(x + y * snepulator_paused.width) * 3 + 1];
-                frame_buffer.active_area [(x + x_base - letter) + (uint32_t) (y + y_base + y_offset) * frame_buffer.width].b =
+                frame_buffer->active_area [(x + x_base - letter) + (uint32_t) (y + y_base + y_offset) * frame_buffer->width].b =
                     snepulator_paused.pixel_data [(x + y * snepulator_paused.width) * 3 + 2];
             }
         }
     }
 
-    snepulator_frame_done (&frame_buffer);
+    snepulator_frame_done (frame_buffer);
+    pthread_mutex_unlock (&state.run_mutex);
 }
 
 
@@ -679,9 +907,15 @@ void snepulator_pause_set (bool pause)
         state.video_pause_data.width = current_frame->width;
         state.video_pause_data.height = current_frame->height;
 
-        /* Convert the screen to black and white, and sore in the pause buffer */
+        /* Convert the screen to black and white, and sore in the pause buffer.
+         * Neighbouring pixels are usually the same colour, so re-use the previous conversion where possible. */
         for (int x = 0; x < (current_frame->width * current_frame->height); x++)
         {
+            if (x > 0 && memcmp (&current_frame->active_area [x], &current_frame->active_area [x - 1], sizeof (uint_pixel_t)) == 0)
+            {
+                state.video_pause_data.active_area [x] = state.video_pause_data.active_area [x - 1];
+                continue;
+            }
             state.video_pause_data.active_area [x] = util_to_greyscale (current_frame->active_area [x]);
         }
         for (int x = 0; x < (current_frame->height); x++)
@@ -689,7 +923,7 @@ void snepulator_pause_set (bool pause)
             state.video_pause_data.backdrop [x] = util_to_greyscale (current_frame->backdrop [x]);
         }
 
-        snepulator_frame_done (&state.video_pause_data);
+        /* The pause buffer is passed on for display by snepulator_pause_animate */
     }
 
     /* Un-pause */
@@ -807,6 +1041,7 @@ void snepulator_reset (void)
     state.run_timer = util_get_ticks_us ();
     state.micro_clocks = 0;
     state.clock_rate = 0;
+    state.frame_count = 0;
 
     /* Clean up any gamepad state */
     for (uint32_t i = 0; i < 3; i++)
@@ -1124,3 +1359,40 @@ void snepulator_video_par_set (Video_PAR par)
 
     config_write ();
 }
+
+
+/*
+ * Set whether or not to use the Z80 recompiler.
+ */
+void snepulator_z80_jit_set (bool z80_jit)
+{
+    state.z80_jit = z80_jit;
+    config_uint_set ("cpu", "z80-jit", z80_jit);
+
+    /* Translated code must not be discarded while the emulation thread may be running it */
+    pthread_mutex_lock (&state.run_mutex);
+    if (state.update_settings != NULL)
+    {
+        state.update_settings (state.console_context);
+    }
+    pthread_mutex_unlock (&state.run_mutex);
+
+    config_write ();
+}
+
+
+/*
+ * Set whether or not to skip Z80 idle loops.
+ */
+void snepulator_z80_idle_skip_set (bool z80_idle_skip)
+{
+    state.z80_idle_skip = z80_idle_skip;
+    config_uint_set ("cpu", "z80-idle-skip", z80_idle_skip);
+
+    if (state.update_settings != NULL)
+    {
+        state.update_settings (state.console_context);
+    }
+
+    config_write ();
+}
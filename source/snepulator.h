@@ -14,7 +14,14 @@
 #define VIDEO_MAX_WIDTH 320
 #define VIDEO_MAX_LINES 240
 
-#define VIDEO_RING_SIZE 3
+#define VIDEO_FRAME_COUNT 3
+#define VIDEO_FRAME_NEW   0x80
+
+#define VIDEO_FRAME_SKIP_AUTO       UINT32_MAX  /* frame_skip value to skip frames while the renderer is behind */
+#define VIDEO_FRAME_SKIP_AUTO_MAX   8           /* Automatic frame-skip draws at least one in this many frames */
+
+#define VIDEO_PALETTE_SIZE  64
+#define VIDEO_LINE_NONE     0xff    /* line_palette value for lines of an indexed frame that were not drawn */
 
 #define AUDIO_SAMPLE_RATE 48000
 
@@ -81,10 +88,28 @@ typedef enum Video_3D_Mode_e {
 } Video_3D_Mode;
 
 typedef struct Video_Frame_s {
-    uint_pixel_t active_area [VIDEO_MAX_WIDTH * VIDEO_MAX_LINES];
     uint_pixel_t backdrop [VIDEO_MAX_LINES];
     uint32_t   width;
     uint32_t   height;
+    bool       skip;    /* The frame will not be displayed. VDPs only update their status flags. */
+
+    /* Output */
+    /* Note: A frame holds either RGB pixels in active_area, or palette indices
+     *       in active_area_index. VDPs draw indices, and select a palette for
+     *       each line with snepulator_frame_line_palette. The palette is only
+     *       copied when it changes. The two formats share storage, so indexed
+     *       frames carry no RGB. They are expanded into a separate buffer by
+     *       snepulator_get_current_frame, once, when the frame is presented. */
+    bool indexed;
+    union {
+        uint_pixel_t active_area [VIDEO_MAX_WIDTH * VIDEO_MAX_LINES];
+        struct {
+            uint8_t      active_area_index [VIDEO_MAX_WIDTH * VIDEO_MAX_LINES];
+            uint8_t      line_palette [VIDEO_MAX_LINES];
+            uint32_t     palette_count;
+            uint_pixel_t palettes [VIDEO_MAX_LINES] [VIDEO_PALETTE_SIZE];
+        };
+    };
 } Video_Frame;
 
 
@@ -111,6 +136,7 @@ typedef struct Snepulator_State_s {
     bool            disable_blanking;       /* Don't blank the screen when the blank bit is set. */
     bool            disable_border;         /* Don't show the border surrounding the active area. */
     uint32_t        overclock;              /* Extra CPU cycles to run per line. */
+    uint32_t        frame_skip;             /* Frames to skip after each drawn frame, or VIDEO_FRAME_SKIP_AUTO. */
     uint_pixel_t   *override_tms_palette;   /* Override default tms9928a palette. NULL for default. */
     Video_Format    format;                 /* 50 Hz PAL / 60 Hz NTSC. */
     bool            format_auto;            /* Automatically select PAL for games that require it. */
@@ -122,6 +148,8 @@ typedef struct Snepulator_State_s {
     float           trackball_sensitivity;  /* Portion of a sport-pad pixel moved per host mouse pixel */
     bool            trackball_button_swap;  /* Swap left and right mouse buttons when used for trackball input */
     float           paddle_sensitivity;     /* Portion of a 1/256 step moved per host moues pixel */
+    bool            z80_jit;                /* Translate Z80 code to host code rather than interpreting it. */
+    bool            z80_idle_skip;          /* Skip passes through Z80 loops that are waiting for an interrupt or the VDP. */
 
     /* Development Tools */
     bool            step_single_frame;      /* Enable single-frame mode. */
@@ -163,18 +191,19 @@ typedef struct Snepulator_State_s {
     int32_t audio_buffer [512 * 2];
 
     /* Console video output */
-    /* Note: Unlike the audio rings, in this case the read index is not
-     *       the next frame to be read; but rather the frame currently
-     *       being shown. This is because the frame may be shown a second
-     *       time, but we don't want to wait for another memcpy.
-     *       To simplify the comparisons, the write index will also point
-     *       to the most recently written frame rather than the next frame
-     *       to be written.
-     *       This should change to match the audio rings when we start
-     *       passing pointers instead of copying buffers. */
-    Video_Frame video_ring [VIDEO_RING_SIZE];
+    /* Note: This is a lock-free triple buffer. The console draws directly into
+     *       video_draw_index, and publishes a completed frame by swapping it
+     *       with video_ready_index. The renderer swaps video_read_index with
+     *       video_ready_index when VIDEO_FRAME_NEW is set, and otherwise keeps
+     *       showing the same frame. Only video_ready_index is shared between
+     *       the two threads, and it is only accessed with atomic operations. */
+    Video_Frame video_frames [VIDEO_FRAME_COUNT];
+    uint32_t    video_draw_index;
+    uint32_t    video_ready_index;
     uint32_t    video_read_index;
-    uint32_t    video_write_index;
+    uint32_t    video_skip_count;           /* Frames skipped since the last drawn frame */
+    Video_Frame video_output_frame;         /* RGB expansion of the current frame, if it is indexed */
+    bool        video_output_valid;
 
     /* Mouse Input */
     bool        capture_mouse;              /* Cursor locked into the Snepulator window for relative input */
@@ -195,10 +224,12 @@ typedef struct Snepulator_State_s {
     float       video_par;
 
     /* Statistics */
+    uint64_t frame_count;   /* Frames completed since the console was initialised. */
 #ifdef DEVELOPER_BUILD
     double host_framerate;
     double vdp_framerate;
     double audio_ring_utilisation;
+    uint64_t audio_ring_overruns;
 #endif
 
     /* Error reporting */
@@ -233,9 +264,21 @@ void snepulator_fm_sound_set (bool enable);
 /* Send a completed frame for display. */
 void snepulator_frame_done (Video_Frame *frame);
 
+/* Get one line of a frame as RGB. */
+void snepulator_frame_expand_line (const Video_Frame *frame, uint32_t line, uint_pixel_t *dest);
+
+/* Select the palette used by a line of indexed output. */
+void snepulator_frame_line_palette (Video_Frame *frame, uint32_t line, const uint_pixel_t *palette, uint32_t size);
+
+/* Set the number of frames to skip drawing after each drawn frame. */
+void snepulator_frame_skip_set (uint32_t frame_skip);
+
 /* Get a pointer to the currently displayed frame. */
 Video_Frame *snepulator_get_current_frame (void);
 
+/* Get a pointer to the frame that the console should draw into. */
+Video_Frame *snepulator_get_draw_frame (void);
+
 /* Get a pointer to the currently displayed frame. */
 Video_Frame *snepulator_get_next_frame (void);
 
@@ -302,6 +345,12 @@ void snepulator_video_format_set (Video_Format format);
 /* Set the pixel aspect ratio. */
 void snepulator_video_par_set (Video_PAR par);
 
+/* Set whether or not to use the Z80 recompiler. */
+void snepulator_z80_jit_set (bool z80_jit);
+
+/* Set whether or not to skip Z80 idle loops. */
+void snepulator_z80_idle_skip_set (bool z80_idle_skip);
+
 /***************************
  *  Implemented in main.c  *
  ***************************/
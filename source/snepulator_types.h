@@ -75,8 +75,21 @@ typedef struct double_point_s {
 } double_point_t;
 
 
+/* Pixels are packed RGB by default. Building with VIDEO_PIXEL_RGBX pads each
+ * pixel to an aligned 32 bits, which is cheaper to store and to upload. */
+#ifdef VIDEO_PIXEL_RGBX
+typedef struct __attribute__ ((aligned (4))) uint_pixel_s {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t x;  /* Unused */
+} uint_pixel_t;
+#define VIDEO_PIXEL_GL_FORMAT GL_RGBA
+#else
 typedef struct uint_pixel_s {
     uint8_t r;
     uint8_t g;
     uint8_t b;
 } uint_pixel_t;
+#define VIDEO_PIXEL_GL_FORMAT GL_RGB
+#endif
@@ -9,6 +9,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined (__AVX2__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "../snepulator_types.h"
 #include "band_limit.h"
 
@@ -23,6 +29,9 @@ static double master_step [MASTER_SAMPLE_COUNT] = {};
  * Each step has a magnitude of +1.0 and is stored as differences. */
 static double step [PHASE_COUNT] [PHASE_SAMPLES] = {};
 
+/* The same steps in fixed-point, with a magnitude of (1 << BAND_LIMIT_SHIFT) */
+static int16_t step_fixed [PHASE_COUNT] [PHASE_SAMPLES] = {};
+
 /*
  * Calculate the band-limited master step.
  *
@@ -130,6 +139,67 @@ void calculate_phase_steps (void)
             step [phase] [sample] += (1.0 - phase_sum) / PHASE_SAMPLES;
         }
     }
+
+    /* Convert to fixed-point. The running total of each step is rounded rather
+     * than each difference, so that quantisation error does not accumulate along
+     * the step, and the output settles to exactly the input level afterwards. */
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        double total = 0.0;
+        int32_t previous_total_fixed = 0;
+
+        for (int sample = 0; sample < PHASE_SAMPLES; sample++)
+        {
+            total += step [phase] [sample];
+            int32_t total_fixed = (sample == PHASE_SAMPLES - 1) ? (1 << BAND_LIMIT_SHIFT) : lround (total * (1 << BAND_LIMIT_SHIFT));
+            step_fixed [phase] [sample] = total_fixed - previous_total_fixed;
+            previous_total_fixed = total_fixed;
+        }
+    }
+}
+
+
+/*
+ * Add a band-limited transition to the difference buffer.
+ */
+static inline void band_limit_add_step (Bandlimit_Context *context, int phase, int16_t delta)
+{
+    const int16_t *step = step_fixed [phase];
+    int32_t *diff = &context->diff_buffer [context->diff_index];
+
+#if defined (__AVX2__)
+    __m256i delta_x8 = _mm256_set1_epi32 (delta);
+
+    for (int j = 0; j < PHASE_SAMPLES; j += 8)
+    {
+        __m256i step_x8 = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) &step [j]));
+        __m256i diff_x8 = _mm256_loadu_si256 ((const __m256i *) &diff [j]);
+        diff_x8 = _mm256_add_epi32 (diff_x8, _mm256_mullo_epi32 (step_x8, delta_x8));
+        _mm256_storeu_si256 ((__m256i *) &diff [j], diff_x8);
+    }
+#elif defined (__SSE2__)
+    __m128i delta_x8 = _mm_set1_epi16 (delta);
+
+    for (int j = 0; j < PHASE_SAMPLES; j += 8)
+    {
+        /* Multiply eight 16-bit values, then interleave the halves into 32-bit products */
+        __m128i step_x8 = _mm_loadu_si128 ((const __m128i *) &step [j]);
+        __m128i product_low = _mm_mullo_epi16 (step_x8, delta_x8);
+        __m128i product_high = _mm_mulhi_epi16 (step_x8, delta_x8);
+
+        __m128i diff_0 = _mm_loadu_si128 ((const __m128i *) &diff [j]);
+        __m128i diff_1 = _mm_loadu_si128 ((const __m128i *) &diff [j + 4]);
+        diff_0 = _mm_add_epi32 (diff_0, _mm_unpacklo_epi16 (product_low, product_high));
+        diff_1 = _mm_add_epi32 (diff_1, _mm_unpackhi_epi16 (product_low, product_high));
+        _mm_storeu_si128 ((__m128i *) &diff [j], diff_0);
+        _mm_storeu_si128 ((__m128i *) &diff [j + 4], diff_1);
+    }
+#else
+    for (int j = 0; j < PHASE_SAMPLES; j++)
+    {
+        diff [j] += step [j] * delta;
+    }
+#endif
 }
 
 
@@ -137,38 +207,35 @@ void calculate_phase_steps (void)
  * Apply band-limited synthesis to non-limited input.
  *
  * Note: a 24 sample delay is introduced, as samples are affected by future input.
- *
- * TODO: For lower end devices, consider only using integers during emulation.
- *       eg, use uint32 phase steps from 0 -> 32768 and arithmetic right-shift the result.
  */
 void band_limit_samples (Bandlimit_Context *context, int16_t *sample_buf, int16_t *phase_buf, int count)
 {
     for (int i = 0; i < count; i++)
     {
         /* First, take any steps in our square-wave input and convert them to band-limited differences */
-        double delta = sample_buf [i] - context->previous_input;
+        int32_t delta = sample_buf [i] - context->previous_input;
         context->previous_input = sample_buf [i];
 
-        if (delta)
+        /* Steps larger than 16 bits are applied in two parts */
+        while (delta != 0)
         {
-            int phase = phase_buf [i];
-
-            /* Apply the transition */
-            for (int j = 0; j < PHASE_SAMPLES; j++)
-            {
-                context->diff_ring [(context->diff_ring_index + j) % DIFF_RING_SIZE] += step [phase] [j] * delta;
-            }
+            int16_t part = (delta > INT16_MAX) ? INT16_MAX : (delta < -INT16_MAX) ? -INT16_MAX : delta;
+            band_limit_add_step (context, phase_buf [i], part);
+            delta -= part;
         }
 
         /* Now, we have a sample that is ready for conversion from difference to value */
-        context->output += context->diff_ring [context->diff_ring_index];
-        sample_buf [i] = context->output;
+        context->output += context->diff_buffer [context->diff_index];
+        int32_t output = (context->output + (1 << (BAND_LIMIT_SHIFT - 1))) >> BAND_LIMIT_SHIFT;
+        sample_buf [i] = (output > INT16_MAX) ? INT16_MAX : (output < INT16_MIN) ? INT16_MIN : output;
 
-        /* Now that the value has been used, zero it for the next trip around the ring */
-        context->diff_ring [context->diff_ring_index] = 0.0;
-
-        /* Advance to the next index in the diff ring */
-        context->diff_ring_index = (context->diff_ring_index + 1) % DIFF_RING_SIZE;
+        /* Once the first half of the buffer has been used, move the remaining differences down */
+        if (++context->diff_index == PHASE_SAMPLES)
+        {
+            memcpy (&context->diff_buffer [0], &context->diff_buffer [PHASE_SAMPLES], PHASE_SAMPLES * sizeof (int32_t));
+            memset (&context->diff_buffer [PHASE_SAMPLES], 0, PHASE_SAMPLES * sizeof (int32_t));
+            context->diff_index = 0;
+        }
     }
 }
 
@@ -190,7 +257,7 @@ Bandlimit_Context *band_limit_init (void)
 
     Bandlimit_Context *context = calloc (1, sizeof (Bandlimit_Context));
     context->previous_input = 0;
-    context->output = 0.0;
+    context->output = 0;
 
     return context;
 }
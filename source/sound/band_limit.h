@@ -3,13 +3,20 @@
  * Band-limited sound synthesis header.
  */
 
-#define DIFF_RING_SIZE 48
+#define DIFF_BUFFER_SIZE 96
 
+/* Fixed-point precision of the step table and difference buffer. The largest
+ * step difference is about 0.87, so 15 bits is the most that fits in int16. */
+#define BAND_LIMIT_SHIFT 15
+
+/* Each transition is added to the 48 differences following diff_index. Rather
+ * than wrapping around a ring, the buffer is twice this length, and the upper
+ * half is moved down once the lower half has been consumed. */
 typedef struct Bandlimit_Context_s {
-    double diff_ring [DIFF_RING_SIZE];
-    uint32_t diff_ring_index;
+    int32_t diff_buffer [DIFF_BUFFER_SIZE];
+    uint32_t diff_index;
     int16_t previous_input;
-    double output;
+    int32_t output;
 } Bandlimit_Context;
 
 /* Apply band-limited synthesis to non-limited input. */
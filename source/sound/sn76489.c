@@ -132,7 +132,6 @@ SN76489_Context *sn76489_init (void)
     }
 
     SN76489_Context *context = calloc (1, sizeof (SN76489_Context));
-    pthread_mutex_init (&context->mutex, NULL); /* TODO: mutex_destroy */
 
     context->clock_rate = NTSC_COLOURBURST_FREQ;
 
@@ -156,9 +155,110 @@ SN76489_Context *sn76489_init (void)
 
 
 /*
- * Run the PSG for a number of CPU clock cycles
+ * Run the PSG for a single clock, updating the counters and outputs.
  */
-void _sn76489_run_cycles (SN76489_Context *context, uint32_t clock_rate, uint32_t cycles)
+static inline void sn76489_clock (SN76489_Context *context)
+{
+    /* Decrement counters */
+    if (context->state.counter_0) { context->state.counter_0--; }
+    if (context->state.counter_1) { context->state.counter_1--; }
+    if (context->state.counter_2) { context->state.counter_2--; }
+    if (context->state.counter_3) { context->state.counter_3--; }
+
+    /* Toggle outputs */
+    if (context->state.counter_0 == 0)
+    {
+        context->state.counter_0 = context->state.tone_0;
+        context->state.output_0 *= -1;
+    }
+    if (context->state.counter_1 == 0)
+    {
+        context->state.counter_1 = context->state.tone_1;
+        context->state.output_1 *= -1;
+    }
+    if (context->state.counter_2 == 0)
+    {
+        context->state.counter_2 = context->state.tone_2;
+        context->state.output_2 *= -1;
+    }
+    if (context->state.counter_3 == 0)
+    {
+        switch (context->state.noise & 0x03)
+        {
+            case 0x00:  context->state.counter_3 = 0x10;                    break;
+            case 0x01:  context->state.counter_3 = 0x20;                    break;
+            case 0x02:  context->state.counter_3 = 0x40;                    break;
+            case 0x03:  context->state.counter_3 = context->state.tone_2;   break;
+            default:    break;
+        }
+        context->state.output_3 *= -1;
+
+        /* On transition from -1 to 1, shift the LFSR */
+        /* TODO: Allow selection of Sega LFSR vs TI LFSR.
+         * Sega: 16-bit tap 0 & 3
+         * TI:   15-bit tap 0 & 1 */
+        if (context->state.output_3 == 1)
+        {
+            context->state.output_lfsr = (context->state.lfsr & 0x0001);
+
+            if (context->state.noise & (1 << 2))
+            {
+                /* White noise - Tap bits 0 and 3 */
+                context->state.lfsr >>= 1;
+                context->state.lfsr ^= (context->state.output_lfsr) ? 0x9000 : 0;
+            }
+            else
+            {
+                /* Periodic noise - Tap bit 0 */
+                context->state.lfsr >>= 1;
+                context->state.lfsr ^= (context->state.output_lfsr) ? 0x8000 : 0;
+            }
+        }
+    }
+
+    /* Tone channels output +1 if their tone register is zero */
+    if (context->state.tone_0 <= 1) { context->state.output_0 = 1; }
+    if (context->state.tone_1 <= 1) { context->state.output_1 = 1; }
+    if (context->state.tone_2 <= 1) { context->state.output_2 = 1; }
+}
+
+
+/*
+ * Calculate the output level from the current channel outputs.
+ */
+static inline void sn76489_mix (SN76489_Context *context, int16_t *level_l, int16_t *level_r)
+{
+    if (context->has_gg_stereo)
+    {
+        *level_l = (context->state.gg_stereo & GG_CH0_LEFT ? context->state.output_0 * volume_table [context->state.vol_0] : 0)
+                 + (context->state.gg_stereo & GG_CH1_LEFT ? context->state.output_1 * volume_table [context->state.vol_1] : 0)
+                 + (context->state.gg_stereo & GG_CH2_LEFT ? context->state.output_2 * volume_table [context->state.vol_2] : 0)
+                 + (context->state.gg_stereo & GG_CH3_LEFT ? (context->state.output_lfsr ? 1 : -1) * volume_table [context->state.vol_3] : 0);
+
+        *level_r = (context->state.gg_stereo & GG_CH0_RIGHT ? context->state.output_0 * volume_table [context->state.vol_0] : 0)
+                 + (context->state.gg_stereo & GG_CH1_RIGHT ? context->state.output_1 * volume_table [context->state.vol_1] : 0)
+                 + (context->state.gg_stereo & GG_CH2_RIGHT ? context->state.output_2 * volume_table [context->state.vol_2] : 0)
+                 + (context->state.gg_stereo & GG_CH3_RIGHT ? (context->state.output_lfsr ? 1 : -1) * volume_table [context->state.vol_3] : 0);
+    }
+    else
+    {
+        *level_l = context->state.output_0 * volume_table [context->state.vol_0]
+                 + context->state.output_1 * volume_table [context->state.vol_1]
+                 + context->state.output_2 * volume_table [context->state.vol_2]
+                 + (context->state.output_lfsr ? 1 : -1) * volume_table [context->state.vol_3];
+        *level_r = *level_l;
+    }
+}
+
+
+/*
+ * Run the PSG for a number of CPU clock cycles.
+ *
+ * Between register writes the channel transitions are predictable, so rather
+ * than stepping every PSG clock, emulation jumps from one counter expiry to the
+ * next. The output level only needs to be stored once per sound card sample.
+ */
+void sn76489_run_cycles (SN76489_Context *context, uint32_t clock_rate, uint32_t cycles)
 {
     /* Divide the system clock by 16, store the excess cycles for next time */
     static uint32_t excess = 0;
@@ -166,197 +266,212 @@ void _sn76489_run_cycles (SN76489_Context *context, uint32_t clock_rate, uint32_
     uint32_t psg_cycles = cycles >> 4;
     excess = cycles - (psg_cycles << 4);
 
-    /* Reset the ring buffer if the clock rate changes */
+    /* The write_index is only advanced at the end of this function, so the
+     * sample currently being built is not visible to the audio thread. */
+    uint64_t write_index = context->write_index;
+
+    /* If the clock rate changes, continue the ring from where it is. The read_index
+     * belongs to the audio thread, so rather than resetting the ring, the cycle count
+     * is chosen to map to the current write_index under the new clock rate. */
     if (state.console_context != NULL &&
         clock_rate != context->clock_rate)
     {
         context->clock_rate = clock_rate;
-        context->read_index = 0;
-        context->write_index = 0;
-        context->completed_cycles = 0;
+        context->completed_cycles = (write_index * (clock_rate >> 4) + AUDIO_SAMPLE_RATE - 1) / AUDIO_SAMPLE_RATE;
     }
 
-    /* If we're about to overwrite samples that haven't been read yet,
-     * skip the read_index forward to discard some of the backlog. */
-    if (context->write_index + ((uint64_t) psg_cycles * AUDIO_SAMPLE_RATE / (context->clock_rate >> 4)) >= context->read_index + SN76489_RING_SIZE)
+    /* Map from the amount of time emulated (completed cycles / psg clock) to the sound card sample rate */
+    uint32_t psg_clock = context->clock_rate >> 4;
+    uint64_t completed_cycles = context->completed_cycles;
+    uint64_t first_index = write_index;
+    uint64_t next_sample_cycle = ((write_index + 1) * psg_clock + AUDIO_SAMPLE_RATE - 1) / AUDIO_SAMPLE_RATE;
+
+    /* Register writes since the last call may have changed the output level */
+    if (psg_cycles)
     {
-        context->read_index += SN76489_RING_SIZE / 4;
+        if (context->state.tone_0 <= 1) { context->state.output_0 = 1; }
+        if (context->state.tone_1 <= 1) { context->state.output_1 = 1; }
+        if (context->state.tone_2 <= 1) { context->state.output_2 = 1; }
     }
+    int16_t level_l;
+    int16_t level_r;
+    sn76489_mix (context, &level_l, &level_r);
 
-    while (psg_cycles--)
+    while (psg_cycles)
     {
-        /* Decrement counters */
-        if (context->state.counter_0) { context->state.counter_0--; }
-        if (context->state.counter_1) { context->state.counter_1--; }
-        if (context->state.counter_2) { context->state.counter_2--; }
-        if (context->state.counter_3) { context->state.counter_3--; }
-
-        /* Toggle outputs */
-        if (context->state.counter_0 == 0)
+        /* Find the number of clocks before the next counter expires. During these,
+         * the output level is constant and the counters only need decrementing. */
+        uint32_t quiet = psg_cycles;
+        if (context->state.counter_0 <= quiet) { quiet = (context->state.counter_0) ? context->state.counter_0 - 1 : 0; }
+        if (context->state.counter_1 <= quiet) { quiet = (context->state.counter_1) ? context->state.counter_1 - 1 : 0; }
+        if (context->state.counter_2 <= quiet) { quiet = (context->state.counter_2) ? context->state.counter_2 - 1 : 0; }
+        if (context->state.counter_3 <= quiet) { quiet = (context->state.counter_3) ? context->state.counter_3 - 1 : 0; }
+
+        if (quiet)
         {
-            context->state.counter_0 = context->state.tone_0;
-            context->state.output_0 *= -1;
-        }
-        if (context->state.counter_1 == 0)
-        {
-            context->state.counter_1 = context->state.tone_1;
-            context->state.output_1 *= -1;
-        }
-        if (context->state.counter_2 == 0)
-        {
-            context->state.counter_2 = context->state.tone_2;
-            context->state.output_2 *= -1;
-        }
-        if (context->state.counter_3 == 0)
-        {
-            switch (context->state.noise & 0x03)
+            if (context->state.counter_0) { context->state.counter_0 -= quiet; }
+            if (context->state.counter_1) { context->state.counter_1 -= quiet; }
+            if (context->state.counter_2) { context->state.counter_2 -= quiet; }
+            if (context->state.counter_3) { context->state.counter_3 -= quiet; }
+
+            /* Phase ranges from 0 (no delay) to 31 (0.97 samples delay) */
+            if (level_l != context->previous_sample_l)
+            {
+                context->phase_ring_l [write_index % SN76489_RING_SIZE] = (completed_cycles * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
+                context->previous_sample_l = level_l;
+            }
+            if (level_r != context->previous_sample_r)
             {
-                case 0x00:  context->state.counter_3 = 0x10;                    break;
-                case 0x01:  context->state.counter_3 = 0x20;                    break;
-                case 0x02:  context->state.counter_3 = 0x40;                    break;
-                case 0x03:  context->state.counter_3 = context->state.tone_2;   break;
-                default:    break;
+                context->phase_ring_r [write_index % SN76489_RING_SIZE] = (completed_cycles * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
+                context->previous_sample_r = level_r;
             }
-            context->state.output_3 *= -1;
 
-            /* On transition from -1 to 1, shift the LFSR */
-            /* TODO: Allow selection of Sega LFSR vs TI LFSR.
-             * Sega: 16-bit tap 0 & 3
-             * TI:   15-bit tap 0 & 1 */
-            if (context->state.output_3 == 1)
+            /* Store each sample that is completed during the quiet period */
+            while (next_sample_cycle <= completed_cycles + quiet)
             {
-                context->state.output_lfsr = (context->state.lfsr & 0x0001);
+                uint64_t final_cycle = next_sample_cycle - 1;
+
+                context->sample_ring_l [write_index % SN76489_RING_SIZE] = level_l;
+                context->sample_ring_r [write_index % SN76489_RING_SIZE] = level_r;
 
-                if (context->state.noise & (1 << 2))
+                /* Negative levels never compare equal to the unsigned previous sample,
+                 * so their phase follows the final clock of each sample. */
+                if (level_l != context->previous_sample_l)
                 {
-                    /* White noise - Tap bits 0 and 3 */
-                    context->state.lfsr >>= 1;
-                    context->state.lfsr ^= (context->state.output_lfsr) ? 0x9000 : 0;
+                    context->phase_ring_l [write_index % SN76489_RING_SIZE] = (final_cycle * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
                 }
-                else
+                if (level_r != context->previous_sample_r)
                 {
-                    /* Periodic noise - Tap bit 0 */
-                    context->state.lfsr >>= 1;
-                    context->state.lfsr ^= (context->state.output_lfsr) ? 0x8000 : 0;
+                    context->phase_ring_r [write_index % SN76489_RING_SIZE] = (final_cycle * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
                 }
-            }
-        }
-
-        /* Tone channels output +1 if their tone register is zero */
-        if (context->state.tone_0 <= 1) { context->state.output_0 = 1; }
-        if (context->state.tone_1 <= 1) { context->state.output_1 = 1; }
-        if (context->state.tone_2 <= 1) { context->state.output_2 = 1; }
 
-        /* Store this sample in the ring */
-        if (context->has_gg_stereo)
-        {
-            context->sample_ring_l [context->write_index % SN76489_RING_SIZE] =
-                (context->state.gg_stereo & GG_CH0_LEFT ? context->state.output_0 * volume_table [context->state.vol_0] : 0)
-              + (context->state.gg_stereo & GG_CH1_LEFT ? context->state.output_1 * volume_table [context->state.vol_1] : 0)
-              + (context->state.gg_stereo & GG_CH2_LEFT ? context->state.output_2 * volume_table [context->state.vol_2] : 0)
-              + (context->state.gg_stereo & GG_CH3_LEFT ? (context->state.output_lfsr ? 1 : -1) * volume_table [context->state.vol_3] : 0);
+                write_index++;
+                next_sample_cycle = ((write_index + 1) * psg_clock + AUDIO_SAMPLE_RATE - 1) / AUDIO_SAMPLE_RATE;
+            }
 
-            if (context->sample_ring_l [context->write_index % SN76489_RING_SIZE] != context->previous_sample_l)
+            /* Likewise for the partial sample at the end of the quiet period */
+            if (level_l != context->previous_sample_l)
             {
-                /* Phase ranges from 0 (no delay) to 31 (0.97 samples delay) */
-                context->phase_ring_l [context->write_index % SN76489_RING_SIZE] =
-                    (context->completed_cycles * AUDIO_SAMPLE_RATE * 32 / (context->clock_rate >> 4)) % 32;
-                context->previous_sample_l = context->sample_ring_l [context->write_index % SN76489_RING_SIZE];
+                context->phase_ring_l [write_index % SN76489_RING_SIZE] = ((completed_cycles + quiet - 1) * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
             }
-
-            context->sample_ring_r [context->write_index % SN76489_RING_SIZE] =
-                (context->state.gg_stereo & GG_CH0_RIGHT ? context->state.output_0 * volume_table [context->state.vol_0] : 0)
-              + (context->state.gg_stereo & GG_CH1_RIGHT ? context->state.output_1 * volume_table [context->state.vol_1] : 0)
-              + (context->state.gg_stereo & GG_CH2_RIGHT ? context->state.output_2 * volume_table [context->state.vol_2] : 0)
-              + (context->state.gg_stereo & GG_CH3_RIGHT ? (context->state.output_lfsr ? 1 : -1) * volume_table [context->state.vol_3] : 0);
-
-            if (context->sample_ring_r [context->write_index % SN76489_RING_SIZE] != context->previous_sample_r)
+            if (level_r != context->previous_sample_r)
             {
-                /* Phase ranges from 0 (no delay) to 31 (0.97 samples delay) */
-                context->phase_ring_r [context->write_index % SN76489_RING_SIZE] =
-                    (context->completed_cycles * AUDIO_SAMPLE_RATE * 32 / (context->clock_rate >> 4)) % 32;
-                context->previous_sample_r = context->sample_ring_r [context->write_index % SN76489_RING_SIZE];
+                context->phase_ring_r [write_index % SN76489_RING_SIZE] = ((completed_cycles + quiet - 1) * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
             }
 
-            /* If this is the final value for this sample, pass it to the band limiter */
-            if ((context->completed_cycles + 1) * AUDIO_SAMPLE_RATE / (context->clock_rate >> 4) > context->write_index)
+            completed_cycles += quiet;
+            psg_cycles -= quiet;
+
+            if (psg_cycles == 0)
             {
-                band_limit_samples (context->bandlimit_context_l, &context->sample_ring_l [context->write_index % SN76489_RING_SIZE],
-                                                                  &context->phase_ring_l [context->write_index % SN76489_RING_SIZE], 1);
-                band_limit_samples (context->bandlimit_context_r, &context->sample_ring_r [context->write_index % SN76489_RING_SIZE],
-                                                                  &context->phase_ring_r [context->write_index % SN76489_RING_SIZE], 1);
+                break;
             }
         }
-        else
+
+        /* At least one counter expires on this clock */
+        sn76489_clock (context);
+        sn76489_mix (context, &level_l, &level_r);
+
+        if (level_l != context->previous_sample_l)
+        {
+            context->phase_ring_l [write_index % SN76489_RING_SIZE] = (completed_cycles * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
+            context->previous_sample_l = level_l;
+        }
+        if (level_r != context->previous_sample_r)
         {
-            context->sample_ring_l [context->write_index % SN76489_RING_SIZE] =
-                context->state.output_0 * volume_table [context->state.vol_0]
-              + context->state.output_1 * volume_table [context->state.vol_1]
-              + context->state.output_2 * volume_table [context->state.vol_2]
-              + (context->state.output_lfsr ? 1 : -1) * volume_table [context->state.vol_3];
+            context->phase_ring_r [write_index % SN76489_RING_SIZE] = (completed_cycles * AUDIO_SAMPLE_RATE * 32 / psg_clock) % 32;
+            context->previous_sample_r = level_r;
+        }
 
-            if (context->sample_ring_l [context->write_index % SN76489_RING_SIZE] != context->previous_sample_l)
-            {
-                /* Phase ranges from 0 (no delay) to 31 (0.97 samples delay) */
-                context->phase_ring_l [context->write_index % SN76489_RING_SIZE] =
-                    (context->completed_cycles * AUDIO_SAMPLE_RATE * 32 / (context->clock_rate >> 4)) % 32;
-                context->previous_sample_l = context->sample_ring_l [context->write_index % SN76489_RING_SIZE];
-            }
+        /* If this is the final clock for this sample, store it */
+        if (completed_cycles + 1 == next_sample_cycle)
+        {
+            context->sample_ring_l [write_index % SN76489_RING_SIZE] = level_l;
+            context->sample_ring_r [write_index % SN76489_RING_SIZE] = level_r;
+            write_index++;
+            next_sample_cycle = ((write_index + 1) * psg_clock + AUDIO_SAMPLE_RATE - 1) / AUDIO_SAMPLE_RATE;
+        }
 
-            /* If this is the final value for this sample, pass it to the band limiter */
-            if ((context->completed_cycles + 1) * AUDIO_SAMPLE_RATE / (context->clock_rate >> 4) > context->write_index)
-            {
-                band_limit_samples (context->bandlimit_context_l, &context->sample_ring_l [context->write_index % SN76489_RING_SIZE],
-                                                                  &context->phase_ring_l [context->write_index % SN76489_RING_SIZE], 1);
-            }
+        completed_cycles++;
+        psg_cycles--;
+    }
+
+    context->completed_cycles = completed_cycles;
+
+#ifdef DEVELOPER_BUILD
+    /* Count any samples that overwrote ones the audio thread had not yet read */
+    uint64_t read_limit = __atomic_load_n (&context->read_index, __ATOMIC_ACQUIRE) + SN76489_RING_SIZE;
+    if (write_index > read_limit)
+    {
+        __atomic_fetch_add (&state.audio_ring_overruns,
+                            write_index - ((first_index > read_limit) ? first_index : read_limit), __ATOMIC_RELAXED);
+    }
+#endif
+
+    /* Pass the completed samples to the band limiter in blocks, splitting where the ring wraps */
+    while (first_index < write_index)
+    {
+        uint32_t ring_index = first_index % SN76489_RING_SIZE;
+        uint32_t count = write_index - first_index;
+        if (count > SN76489_RING_SIZE - ring_index)
+        {
+            count = SN76489_RING_SIZE - ring_index;
         }
 
-        /* Map from the amount of time emulated (completed cycles / clock rate) to the sound card sample rate */
-        context->completed_cycles++;
-        context->write_index = context->completed_cycles * AUDIO_SAMPLE_RATE / (context->clock_rate >> 4);
+        band_limit_samples (context->bandlimit_context_l, &context->sample_ring_l [ring_index], &context->phase_ring_l [ring_index], count);
+        if (context->has_gg_stereo)
+        {
+            band_limit_samples (context->bandlimit_context_r, &context->sample_ring_r [ring_index], &context->phase_ring_r [ring_index], count);
+        }
+
+        first_index += count;
     }
 
+    /* Publish the completed samples to the audio thread */
+    __atomic_store_n (&context->write_index, write_index, __ATOMIC_RELEASE);
+
 #ifdef DEVELOPER_BUILD
     /* Update statistics (rolling average) */
+    uint64_t read_index = __atomic_load_n (&context->read_index, __ATOMIC_RELAXED);
     state.audio_ring_utilisation *= 0.9995;
-    state.audio_ring_utilisation += 0.0005 * ((context->write_index - context->read_index) / (double) SN76489_RING_SIZE);
+    state.audio_ring_utilisation += 0.0005 * ((write_index - read_index) / (double) SN76489_RING_SIZE);
 #endif
 }
 
 
-/*
- * Run the PSG for a number of CPU clock cycles (mutex-wrapper)
- *
- * Allows two threads to request sound to be generated:
- *  1. The emulation loop, this is the usual case.
- *  2. SDL may request additional samples to keep the sound card from running out.
- */
-void sn76489_run_cycles (SN76489_Context *context, uint32_t clock_rate, uint32_t cycles)
-{
-    pthread_mutex_lock (&context->mutex);
-    _sn76489_run_cycles (context, clock_rate, cycles);
-    pthread_mutex_unlock (&context->mutex);
-}
-
-
 /*
  * Retrieves a block of samples from the sample-ring.
  * Assumes that the number of samples requested fits evenly into the ring buffer.
+ *
+ * Called from the audio thread. Only the read_index is modified here, the chip
+ * itself is never run, so there is no need to lock against the emulation thread.
  */
 void sn76489_get_samples (SN76489_Context *context, int32_t *stream, uint32_t count)
 {
-    if (context->read_index + count > context->write_index)
-    {
-        uint32_t shortfall = count - (context->write_index - context->read_index);
+    uint64_t write_index = __atomic_load_n (&context->write_index, __ATOMIC_ACQUIRE);
+    uint64_t read_index = context->read_index;
 
-        /* Note: We add one to the shortfall to account for integer division */
-        sn76489_run_cycles (context, context->clock_rate, (shortfall + 1) * context->clock_rate / AUDIO_SAMPLE_RATE);
+    /* If the emulation has run far enough ahead that it may be about to overwrite
+     * samples that haven't been read yet, discard some of the backlog. */
+    if (write_index - read_index > SN76489_RING_SIZE - count)
+    {
+#ifdef DEVELOPER_BUILD
+        /* Count the discarded samples, apart from any already counted as overwritten */
+        uint64_t discard_from = (write_index - read_index > SN76489_RING_SIZE) ? (write_index - SN76489_RING_SIZE) : read_index;
+        if (write_index - SN76489_RING_SIZE / 2 > discard_from)
+        {
+            __atomic_fetch_add (&state.audio_ring_overruns, write_index - SN76489_RING_SIZE / 2 - discard_from, __ATOMIC_RELAXED);
+        }
+#endif
+        read_index = write_index - SN76489_RING_SIZE / 2;
     }
 
+    uint32_t available = (write_index - read_index < count) ? (write_index - read_index) : count;
+
     /* Take samples and pass them to the sound card */
-    for (int i = 0; i < count; i++)
+    for (int i = 0; i < available; i++)
     {
-        size_t sample_index = (context->read_index + i) & (SN76489_RING_SIZE - 1);
+        size_t sample_index = (read_index + i) & (SN76489_RING_SIZE - 1);
 
         /* Left, Right */
         if (context->has_gg_stereo)
@@ -371,7 +486,23 @@ void sn76489_get_samples (SN76489_Context *context, int32_t *stream, uint32_t co
         }
     }
 
-    context->read_index += count;
+    /* If the emulation hasn't caught up, hold the most recent sample for the shortfall */
+    size_t last_index = (write_index - 1) & (SN76489_RING_SIZE - 1);
+    for (int i = available; i < count; i++)
+    {
+        if (context->has_gg_stereo)
+        {
+            stream [2 * i    ] += context->sample_ring_l [last_index];
+            stream [2 * i + 1] += context->sample_ring_r [last_index];
+        }
+        else
+        {
+            stream [2 * i    ] += context->sample_ring_l [last_index];
+            stream [2 * i + 1] += context->sample_ring_l [last_index];
+        }
+    }
+
+    __atomic_store_n (&context->read_index, read_index + available, __ATOMIC_RELEASE);
 }
 
 
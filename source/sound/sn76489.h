@@ -67,13 +67,18 @@ typedef struct SN76489_State_s {
 
 typedef struct SN76489_Context_s {
 
-    pthread_mutex_t mutex;
     SN76489_State state;
 
     /* Chip variant */
     bool has_gg_stereo;
 
     /* Ring buffer */
+    /* Note: Single-producer, single-consumer. The emulation thread owns write_index,
+     *       and the audio thread owns read_index. Each is only modified by its owner,
+     *       and is read by the other thread using atomic operations. The producer
+     *       does not wait for the consumer: if the audio thread stalls for longer
+     *       than the ring, unread samples are overwritten. The consumer then skips
+     *       ahead to recent samples. Developer builds count the lost samples. */
     int16_t sample_ring_l [SN76489_RING_SIZE];
     int16_t sample_ring_r [SN76489_RING_SIZE];
     uint16_t previous_sample_l;
@@ -185,7 +185,6 @@ typedef struct YM2413_State_s {
 
 typedef struct YM2413_Context_s {
 
-    pthread_mutex_t mutex;
     YM2413_State state;
 
     /* Calculated Values */
@@ -195,6 +194,7 @@ typedef struct YM2413_Context_s {
     } calculated [9];
 
     /* Ring buffer */
+    /* Note: Shares the ring design of the SN76489, described in sn76489.h */
     int16_t sample_ring [YM2413_RING_SIZE];
     int16_t previous_output_level; /* For linear interpolation */
     uint64_t write_index;
@@ -30,28 +30,51 @@ extern Snepulator_State state;
 /*
  * Retrieves a block of samples from the sample-ring.
  * Assumes that the number of samples requested fits evenly into the ring buffer.
+ *
+ * Called from the audio thread. Only the read_index is modified here, the chip
+ * itself is never run, so there is no need to lock against the emulation thread.
  */
 void ym2612_get_samples (YM2612_Context *context, int32_t *stream, uint32_t count)
 {
-    if (context->read_index + count > context->write_index)
-    {
-        uint32_t shortfall = count - (context->write_index - context->read_index);
+    uint64_t write_index = __atomic_load_n (&context->write_index, __ATOMIC_ACQUIRE);
+    uint64_t read_index = context->read_index;
 
-        /* Note: We add one to the shortfall to account for integer division */
-        ym2612_run_cycles (context, context->clock_rate, (shortfall + 1) * context->clock_rate / AUDIO_SAMPLE_RATE);
+    /* If the emulation has run far enough ahead that it may be about to overwrite
+     * samples that haven't been read yet, discard some of the backlog. */
+    if (write_index - read_index > YM2612_RING_SIZE - count)
+    {
+#ifdef DEVELOPER_BUILD
+        /* Count the discarded samples, apart from any already counted as overwritten */
+        uint64_t discard_from = (write_index - read_index > YM2612_RING_SIZE) ? (write_index - YM2612_RING_SIZE) : read_index;
+        if (write_index - YM2612_RING_SIZE / 2 > discard_from)
+        {
+            __atomic_fetch_add (&state.audio_ring_overruns, write_index - YM2612_RING_SIZE / 2 - discard_from, __ATOMIC_RELAXED);
+        }
+#endif
+        read_index = write_index - YM2612_RING_SIZE / 2;
     }
 
+    uint32_t available = (write_index - read_index < count) ? (write_index - read_index) : count;
+
     /* Take samples and pass them to the sound card */
-    for (int i = 0; i < count; i++)
+    for (int i = 0; i < available; i++)
     {
-        size_t sample_index = (context->read_index + i) & (YM2612_RING_SIZE - 1);
+        size_t sample_index = (read_index + i) & (YM2612_RING_SIZE - 1);
 
         /* Left, Right */
         stream [2 * i    ] += context->sample_ring [sample_index];
         stream [2 * i + 1] += context->sample_ring [sample_index];
     }
 
-    context->read_index += count;
+    /* If the emulation hasn't caught up, hold the most recent sample for the shortfall */
+    int16_t last_sample = context->sample_ring [(write_index - 1) & (YM2612_RING_SIZE - 1)];
+    for (int i = available; i < count; i++)
+    {
+        stream [2 * i    ] += last_sample;
+        stream [2 * i + 1] += last_sample;
+    }
+
+    __atomic_store_n (&context->read_index, read_index + available, __ATOMIC_RELEASE);
 }
 
 
@@ -80,8 +103,6 @@ void ym2612_data_write (YM2612_Context *context, uint8_t data)
 {
     uint8_t addr = context->state.addr_latch;
 
-    pthread_mutex_lock (&context->mutex);
-
     switch (addr)
     {
         case 0x2a:
@@ -93,15 +114,13 @@ void ym2612_data_write (YM2612_Context *context, uint8_t data)
         default:
             break;
     }
-
-    pthread_mutex_unlock (&context->mutex);
 }
 
 
 /*
  * Run the YM2612 for a number of CPU clock cycles.
  */
-void _ym2612_run_cycles (YM2612_Context *context, uint32_t clock_rate, uint32_t cycles)
+void ym2612_run_cycles (YM2612_Context *context, uint32_t clock_rate, uint32_t cycles)
 {
     /* The YM2612 takes 144 cycles to update all 6 channels:
      *  - Internally divides input clock by 6
@@ -111,21 +130,20 @@ void _ym2612_run_cycles (YM2612_Context *context, uint32_t clock_rate, uint32_t
     uint32_t ym_samples = cycles / 144;
     excess = cycles - (ym_samples * 144);
 
-    /* Reset the ring buffer if the clock rate changes */
+    /* The write_index is only advanced at the end of this function */
+    uint64_t write_index = context->write_index;
+#ifdef DEVELOPER_BUILD
+    uint64_t first_index = write_index;
+#endif
+
+    /* If the clock rate changes, continue the ring from where it is. The read_index
+     * belongs to the audio thread, so rather than resetting the ring, the sample count
+     * is chosen to line up with the current write_index under the new clock rate. */
     if (state.console_context != NULL &&
         clock_rate != context->clock_rate)
     {
         context->clock_rate = clock_rate;
-        context->read_index = 0;
-        context->write_index = 0;
-        context->completed_samples = 0;
-    }
-
-    /* If we're about to overwrite samples that haven't been read yet,
-     * skip the read_index forward to discard some of the backlog. */
-    if (context->write_index + (ym_samples * AUDIO_SAMPLE_RATE * 144 / context->clock_rate) >= context->read_index + YM2612_RING_SIZE)
-    {
-        context->read_index += YM2612_RING_SIZE / 4;
+        context->completed_samples = write_index * clock_rate / (AUDIO_SAMPLE_RATE * 144);
     }
 
     while (ym_samples--)
@@ -142,36 +160,34 @@ void _ym2612_run_cycles (YM2612_Context *context, uint32_t clock_rate, uint32_t
 
         /* Propagate new samples into ring buffer.
          * Linear interpolation to get 48 kHz from 53.267… kHz */
-        if (context->completed_samples * AUDIO_SAMPLE_RATE * 144 > context->write_index * context->clock_rate)
+        if (context->completed_samples * AUDIO_SAMPLE_RATE * 144 > write_index * context->clock_rate)
         {
-            float portion = (float) ((context->write_index * context->clock_rate) % (AUDIO_SAMPLE_RATE * 144)) /
+            float portion = (float) ((write_index * context->clock_rate) % (AUDIO_SAMPLE_RATE * 144)) /
                             (float) (AUDIO_SAMPLE_RATE * 144);
 
             int16_t sample = roundf (portion * output_level + (1.0 - portion) * context->previous_output_level);
             /* TODO: 128 constant is just the maximum amplitude of the DAC, once converted to signed,
              *       this will need sorting out once FM channels are added in. */
-            context->sample_ring [context->write_index % YM2612_RING_SIZE] = BASE_VOLUME * sample / 128;
-            context->write_index++;
+            context->sample_ring [write_index % YM2612_RING_SIZE] = BASE_VOLUME * sample / 128;
+            write_index++;
         }
 
         context->previous_output_level = output_level;
         context->completed_samples++;
     }
-}
 
+#ifdef DEVELOPER_BUILD
+    /* Count any samples that overwrote ones the audio thread had not yet read */
+    uint64_t read_limit = __atomic_load_n (&context->read_index, __ATOMIC_ACQUIRE) + YM2612_RING_SIZE;
+    if (write_index > read_limit)
+    {
+        __atomic_fetch_add (&state.audio_ring_overruns,
+                            write_index - ((first_index > read_limit) ? first_index : read_limit), __ATOMIC_RELAXED);
+    }
+#endif
 
-/*
- * Run the YM2612 for a number of CPU clock cycles (mutex-wrapper)
- *
- * Allows two threads to request sound to be generated:
- *  1. The emulation loop, this is the usual case.
- *  2. Additional samples needed to keep the sound card from running out.
- */
-void ym2612_run_cycles (YM2612_Context *context, uint32_t clock_rate, uint32_t cycles)
-{
-    pthread_mutex_lock (&context->mutex);
-    _ym2612_run_cycles (context, clock_rate, cycles);
-    pthread_mutex_unlock (&context->mutex);
+    /* Publish the completed samples to the audio thread */
+    __atomic_store_n (&context->write_index, write_index, __ATOMIC_RELEASE);
 }
 
 
@@ -181,7 +197,6 @@ void ym2612_run_cycles (YM2612_Context *context, uint32_t clock_rate, uint32_t c
 YM2612_Context *ym2612_init (void)
 {
     YM2612_Context *context = calloc (1, sizeof (YM2612_Context));
-    pthread_mutex_init (&context->mutex, NULL); /* TODO: mutex_destroy */
 
     /* Initialize assuming NTSC Mega Drive - Will be updated when the run callback is made. */
     context->clock_rate = 7670453;
@@ -16,10 +16,10 @@ typedef struct YM2612_State_s {
 
 typedef struct YM2612_Context_s {
 
-    pthread_mutex_t mutex;
     YM2612_State state;
 
     /* Ring buffer */
+    /* Note: Shares the ring design of the SN76489, described in sn76489.h */
     int16_t sample_ring [YM2612_RING_SIZE];
     int16_t previous_output_level; /* For linear interpolation */
     uint64_t write_index;
@@ -13,8 +13,6 @@
 #include <sys/time.h>
 #include <zlib.h>
 
-#include <SDL2/SDL.h>
-
 #include "snepulator.h"
 #include "path.h"
 
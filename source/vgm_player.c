@@ -90,7 +90,7 @@ static void draw_rect (VGM_Player_Context *context,
     {
         for (uint32_t x = start_x; x < end_x; x++)
         {
-            context->frame_buffer.active_area [x + y * context->frame_buffer.width] = colour;
+            context->frame_buffer->active_area [x + y * context->frame_buffer->width] = colour;
         }
     }
 }
@@ -104,8 +104,12 @@ static void vgm_player_draw_frame (VGM_Player_Context *context)
     uint32_t bar_count = 0;
     uint32_t bar_value [15] = { };
 
-    context->frame_buffer.width = 256;
-    context->frame_buffer.height = 192;
+    /* Draw directly into the frame that will be passed on for display */
+    context->frame_buffer = snepulator_get_draw_frame ();
+    memset (context->frame_buffer->active_area, 0, sizeof (context->frame_buffer->active_area));
+    memset (context->frame_buffer->backdrop, 0, sizeof (context->frame_buffer->backdrop));
+    context->frame_buffer->width = 256;
+    context->frame_buffer->height = 192;
 
     if (context->sn76489_clock)
     {
@@ -180,7 +184,7 @@ static void vgm_player_draw_frame (VGM_Player_Context *context)
 
     /* Bars */
     uint32_t bar_area_width = bar_width * bar_count + bar_gap * (bar_count - 1);
-    uint32_t first_bar = (context->frame_buffer.width - bar_area_width) / 2;
+    uint32_t first_bar = (context->frame_buffer->width - bar_area_width) / 2;
 
     for (uint32_t i = 0; i < bar_count; i++)
     {
@@ -200,10 +204,7 @@ static void vgm_player_draw_frame (VGM_Player_Context *context)
     draw_rect (context, 32 + progress, 176, 8, 1, light_grey);
 
     /* Pass the completed frame on for rendering */
-    snepulator_frame_done (&context->frame_buffer);
-
-    /* Clear the buffer for the next frame. */
-    memset (context->frame_buffer.active_area, 0, sizeof (context->frame_buffer.active_area));
+    snepulator_frame_done (context->frame_buffer);
 }
 
 
@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../snepulator.h"
 #include "../util.h"
@@ -48,6 +49,277 @@ uint16_t smd_vdp_status_read (SMD_VDP_Context *context)
 }
 
 
+/* DMA bytes per line, indexed by operation, H40, and blanking */
+static const uint16_t smd_vdp_dma_bandwidth [SMD_VDP_DMA_TYPE_COUNT] [2] [2] = {
+    [SMD_VDP_DMA_TRANSFER] = { { 16, 167 }, { 18, 205 } },
+    [SMD_VDP_DMA_FILL]     = { { 15, 166 }, { 17, 204 } },
+    [SMD_VDP_DMA_COPY]     = { {  8,  83 }, {  9, 102 } }
+};
+
+
+/*
+ * Number of bytes that DMA can move during the current line.
+ */
+uint32_t smd_vdp_dma_line_capacity (SMD_VDP_Context *context)
+{
+    bool h40 = (context->screen_width == 320);
+    bool blank = (context->state.line >= context->lines_active) || !context->state.mode_2_blank;
+
+    return smd_vdp_dma_bandwidth [context->state.dma_type] [h40] [blank];
+}
+
+
+/*
+ * Account for the bytes moved by a DMA operation.
+ */
+static void smd_vdp_dma_account (SMD_VDP_Context *context, SMD_VDP_DMA_Type type, uint32_t bytes)
+{
+    context->state.dma_type = type;
+    context->state.dma_backlog += bytes;
+}
+
+
+/*
+ * Number of words or bytes to be moved by a DMA operation. A length of zero is
+ * treated as 64 Ki.
+ */
+static inline uint32_t smd_vdp_dma_length (SMD_VDP_Context *context)
+{
+    return (context->state.dma_length == 0) ? SIZE_64K : context->state.dma_length;
+}
+
+
+/*
+ * Advance the DMA registers after an operation. The length register is left
+ * at zero and the low 16 bits of the source register are incremented,
+ * wrapping within the upper bits.
+ */
+static void smd_vdp_dma_done (SMD_VDP_Context *context, uint32_t length)
+{
+    context->state.dma_source = (context->state.dma_source & 0x7f0000) |
+                                ((context->state.dma_source + length) & 0x00ffff);
+    context->state.dma_length = 0;
+}
+
+
+/*
+ * Write a colour to CRAM at the current address.
+ */
+static inline void smd_vdp_cram_write (SMD_VDP_Context *context, uint16_t data)
+{
+    uint32_t index = (context->state.address >> 1) & 0x3f;
+
+    context->state.cram [index] = (uint_pixel_t) { .r = ((data >> 1) & 0x07) * 0xff / 7,
+                                                   .g = ((data >> 5) & 0x07) * 0xff / 7,
+                                                   .b = ((data >> 9) & 0x07) * 0xff / 7};
+}
+
+
+/*
+ * Write a scroll value to VSRAM at the current address.
+ */
+static inline void smd_vdp_vsram_write (SMD_VDP_Context *context, uint16_t data)
+{
+    uint32_t index = (context->state.address >> 1) & 0x3f;
+
+    if (index < 40)
+    {
+        context->state.vsram [index] = data & 0x03ff;
+    }
+}
+
+
+/*
+ * Write a run of host-endian words from a memory transfer to the destination.
+ */
+static void smd_vdp_dma_write_run (SMD_VDP_Context *context, const uint16_t *data, uint32_t words)
+{
+    switch (context->state.code & 0x07)
+    {
+        case 1: /* VRAM */
+            /* TODO: For VRAM, if source-address bit 0 is set, data may be byte-swapped */
+
+            /* Consecutive words that do not wrap are converted to big-endian in bulk */
+            if (context->state.auto_increment == 2 && (context->state.address & 1) == 0 &&
+                context->state.address + words * 2 <= SMD_VDP_VRAM_SIZE)
+            {
+                uint16_t *vram = (uint16_t *) &context->state.vram [context->state.address];
+
+                for (uint32_t i = 0; i < words; i++)
+                {
+                    vram [i] = (data [i] << 8) | (data [i] >> 8);
+                }
+                context->state.address += words * 2;
+                break;
+            }
+
+            for (uint32_t i = 0; i < words; i++)
+            {
+                *(uint16_t *) &context->state.vram [context->state.address] = (data [i] << 8) | (data [i] >> 8);
+                context->state.address += context->state.auto_increment;
+            }
+            break;
+
+        case 3: /* CRAM */
+            /* TODO: Does the auto-incremented address used for DMA get written
+             *       back to the address register? */
+            for (uint32_t i = 0; i < words; i++)
+            {
+                smd_vdp_cram_write (context, data [i]);
+                context->state.address += context->state.auto_increment;
+            }
+            break;
+
+        case 5: /* VSRAM */
+            for (uint32_t i = 0; i < words; i++)
+            {
+                smd_vdp_vsram_write (context, data [i]);
+                context->state.address += context->state.auto_increment;
+            }
+            break;
+    }
+}
+
+
+/*
+ * Transfer data from 68000 memory to VRAM, CRAM, or VSRAM.
+ *
+ * The source is resolved to host memory once per run of contiguous words,
+ * rather than once per word. Sources without host memory are read through
+ * memory_read_16 into a buffer. The source address wraps within 128 KiB.
+ */
+static void smd_vdp_dma_transfer (SMD_VDP_Context *context)
+{
+    uint32_t length = smd_vdp_dma_length (context);
+    uint32_t source = context->state.dma_source;
+    uint32_t remaining = length;
+    uint16_t buffer [256];
+
+    switch (context->state.code & 0x07)
+    {
+        case 1: /* VRAM */
+        case 3: /* CRAM */
+        case 5: /* VSRAM */
+            break;
+
+        default:
+            printf ("[%s] Invalid DMA Operation: M68k Memory -> ???\n", __func__);
+            return;
+    }
+
+    while (remaining > 0)
+    {
+        uint32_t address = (source << 1) & 0xfffffe;
+        uint32_t run = SIZE_64K - (source & 0xffff);
+        uint32_t available = 0;
+        const uint16_t *data = NULL;
+
+        if (run > remaining)
+        {
+            run = remaining;
+        }
+
+        if (context->memory_pointer != NULL)
+        {
+            data = context->memory_pointer (context->parent, address, &available);
+        }
+
+        if (data != NULL)
+        {
+            if (run > available)
+            {
+                run = available;
+            }
+        }
+        else
+        {
+            if (run > 256)
+            {
+                run = 256;
+            }
+
+            for (uint32_t i = 0; i < run; i++)
+            {
+                buffer [i] = context->memory_read_16 (context->parent, (address + i * 2) & 0xffffff);
+            }
+            data = buffer;
+        }
+
+        smd_vdp_dma_write_run (context, data, run);
+
+        source = (source & 0x7f0000) | ((source + run) & 0x00ffff);
+        remaining -= run;
+    }
+
+    smd_vdp_dma_account (context, SMD_VDP_DMA_TRANSFER, length * 2);
+    smd_vdp_dma_done (context, length);
+}
+
+
+/*
+ * Fill VRAM with the most-significant byte of a data port write.
+ */
+static void smd_vdp_dma_fill (SMD_VDP_Context *context, uint16_t data)
+{
+    uint32_t length = smd_vdp_dma_length (context);
+    uint8_t fill_value = data >> 8;
+
+    /* TODO: Currently, only using the most-significant data byte.. Real
+     *       hardware may write the least-significant to the very first
+     *       address. */
+    if (context->state.auto_increment == 1 && context->state.address + length <= SMD_VDP_VRAM_SIZE)
+    {
+        memset (&context->state.vram [context->state.address], fill_value, length);
+        context->state.address += length;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < length; i++)
+        {
+            context->state.vram [context->state.address] = fill_value;
+            context->state.address += context->state.auto_increment;
+        }
+    }
+
+    smd_vdp_dma_account (context, SMD_VDP_DMA_FILL, length);
+    smd_vdp_dma_done (context, length);
+}
+
+
+/*
+ * Copy bytes within VRAM. The low 16 bits of the source register hold the
+ * source address.
+ */
+static void smd_vdp_dma_copy (SMD_VDP_Context *context)
+{
+    uint32_t length = smd_vdp_dma_length (context);
+    uint32_t source = context->state.dma_source & 0xffff;
+    uint32_t dest = context->state.address;
+
+    /* The hardware copies one byte at a time, so an overlapping copy to a
+     * higher address repeats the pattern. memmove is only used where the
+     * result is the same. */
+    if (context->state.auto_increment == 1 &&
+        source + length <= SMD_VDP_VRAM_SIZE && dest + length <= SMD_VDP_VRAM_SIZE &&
+        (dest <= source || dest >= source + length))
+    {
+        memmove (&context->state.vram [dest], &context->state.vram [source], length);
+        context->state.address += length;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < length; i++)
+        {
+            context->state.vram [context->state.address] = context->state.vram [(source + i) & 0xffff];
+            context->state.address += context->state.auto_increment;
+        }
+    }
+
+    smd_vdp_dma_account (context, SMD_VDP_DMA_COPY, length);
+    smd_vdp_dma_done (context, length);
+}
+
+
 /*
  * Write to the VDP control port.
  */
@@ -64,83 +336,24 @@ void smd_vdp_control_write (SMD_VDP_Context *context, uint16_t data)
 
         context->state.second_half_pending = false;
 
-        uint16_t dma_length;
-        uint32_t source_address;
-
         /* Begin DMA */
         if (context->state.mode_2_dma_en && (context->state.code & ADDRESS_CODE_DMA))
         {
-            /* TODO: Initial implementation ignores timing */
             switch (context->state.dma_operation)
             {
                 case 0x0: /* Memory Transfer */
                 case 0x1:
-                    switch (context->state.code & 0x07)
-                    {
-                        case 1: /* VRAM */
-                            /* TODO: For VRAM, if source-address bit 0 is set, data may be byte-swapped */
-                            dma_length = context->state.dma_length;
-                            source_address = context->state.dma_source << 1;
-                            do {
-                                uint16_t data = context->memory_read_16 (context->parent, source_address);
-
-                                /* TODO: Consider moving any endian-changes into m68k.c
-                                 *       to avoid changing twice during dma. */
-                                *(uint16_t *) (&context->state.vram [context->state.address]) = util_hton16 (data);
-
-                                source_address += 2;
-                                context->state.address += context->state.auto_increment;
-                                dma_length--;
-                            } while (dma_length > 0);
-                            break;
-
-                        case 3: /* CRAM */
-                            dma_length = context->state.dma_length;
-                            source_address = context->state.dma_source << 1;
-
-                            /* TODO: Does the auto-incremented address used for DMA get written
-                             *       back to the address register? */
-                            do {
-                                uint32_t cram_index = (context->state.address >> 1) & 0x3f;
-                                uint16_t data = context->memory_read_16 (context->parent, source_address);
-
-                                context->state.cram [cram_index] = (uint_pixel_t) { .r = ((data >> 1) & 0x07) * 0xff / 7,
-                                                                                    .g = ((data >> 5) & 0x07) * 0xff / 7,
-                                                                                    .b = ((data >> 9) & 0x07) * 0xff / 7};
-
-                                source_address += 2;
-                                context->state.address += context->state.auto_increment;
-                                dma_length--;
-                            } while (dma_length > 0);
-                            break;
-
-                        case 5: /* VSRAM */
-                            printf ("[%s] DMA Operation: M68k Memory -> VSRAM transfer. (Not implemented)\n", __func__);
-                            printf ("[%s] DMA Source: 0x%06x.\n", __func__, context->state.dma_source << 1);
-                            printf ("[%s] DMA Dest:   0x%04x.\n", __func__, context->state.address);
-                            printf ("[%s] DMA Length: %d words.\n", __func__, context->state.dma_length);
-                            printf ("[%s] Increment:  %d.\n", __func__, context->state.auto_increment);
-                            break;
-
-                        default:
-                            printf ("[%s] Invalid DMA Operation: M68k Memory -> ???\n", __func__);
-                            break;
-                    }
-
+                    smd_vdp_dma_transfer (context);
                     break;
-                case 0x2: /* VRAM Fill */
+
+                case 0x2: /* VRAM Fill, started by the next data port write */
                     context->state.fill_pending = true;
                     break;
 
                 case 0x3: /* VRAM Copy */
-                    printf ("[%s] DMA Operation: VRAM Copy. (Not implemented)\n", __func__);
-                    printf ("[%s] DMA Source Address = %06x.\n", __func__, context->state.dma_source);
-                    printf ("[%s] DMA Dest Address = %04x.\n", __func__, context->state.address);
-                    printf ("[%s] DMA Length = %04x words.\n", __func__, context->state.dma_length);
-                    printf ("[%s] Increment = %d.\n", __func__, context->state.auto_increment);
+                    smd_vdp_dma_copy (context);
                     break;
             }
-
         }
     }
 
@@ -217,18 +430,10 @@ void smd_vdp_data_write (SMD_VDP_Context *context, uint16_t data)
 {
     context->state.second_half_pending = false;
 
-    /* TODO: Initial fill implementation. 'instant', no timing considered. */
-    /* TODO: Currently, only using the most-significant data byte.. Real
-     *       hardware may write the least-significant to the very first
-     *       address. */
+    /* VRAM Fill */
     if (context->state.mode_2_dma_en && context->state.fill_pending)
     {
-        uint8_t fill_value = data >> 8;
-        for (uint16_t length = context->state.dma_length; length > 0; length--)
-        {
-            context->state.vram [context->state.address] = fill_value;
-            context->state.address += context->state.auto_increment;
-        }
+        smd_vdp_dma_fill (context, data);
         context->state.fill_pending = false;
     }
 
@@ -242,23 +447,15 @@ void smd_vdp_data_write (SMD_VDP_Context *context, uint16_t data)
     /* CRAM Write */
     else if (context->state.code == 0x03)
     {
-        uint32_t index = (context->state.address >> 1) & 0x3f;
-
-        context->state.cram [index] = (uint_pixel_t) { .r = ((data >> 1) & 0x07) * 0xff / 7,
-                                                       .g = ((data >> 5) & 0x07) * 0xff / 7,
-                                                       .b = ((data >> 9) & 0x07) * 0xff / 7};
+        smd_vdp_cram_write (context, data);
         context->state.address += context->state.auto_increment;
     }
 
     /* VSRAM Write */
     else if (context->state.code == 0x05)
     {
-        uint32_t index = (context->state.address >> 1) & 0x3f;
+        smd_vdp_vsram_write (context, data);
         context->state.address += context->state.auto_increment;
-        if (index < 40)
-        {
-            context->state.vsram [index] = data & 0x03ff;
-        }
     }
 
     else
@@ -300,7 +497,7 @@ bool smd_vdp_get_z80_interrupt (SMD_VDP_Context *context)
  * Note: This assumes that the pattern requested is on the line.
  */
 static void smd_vdp_draw_pattern_line (SMD_VDP_Context *context, uint16_t line, SMD_VDP_Pattern *pattern,
-                                       uint_pixel_t *palette, int_point_t position, bool flip_h, bool flip_v)
+                                       uint8_t palette, int_point_t position, bool flip_h, bool flip_v)
 {
 
     /* Get the line within the pattern. Endian is chosen such that the
@@ -308,7 +505,7 @@ static void smd_vdp_draw_pattern_line (SMD_VDP_Context *context, uint16_t line,
     uint32_t pattern_line_index = (flip_v) ? position.y - line + 7 : line - position.y;
     uint32_t pattern_line = util_ntoh32 (pattern->line [pattern_line_index]);
 
-    int32_t destination_start = position.x + line * context->frame_buffer.width;
+    int32_t destination_start = position.x + line * context->frame_buffer->width;
 
     for (int32_t x = 0; x < 8; x++)
     {
@@ -328,7 +525,7 @@ static void smd_vdp_draw_pattern_line (SMD_VDP_Context *context, uint16_t line,
 
         if (colour_index != 0)
         {
-            context->frame_buffer.active_area [destination_start + x] = palette [colour_index];
+            context->frame_buffer->active_area_index [destination_start + x] = palette + colour_index;
         }
     }
 }
@@ -395,7 +592,7 @@ static void smd_vdp_draw_sprites (SMD_VDP_Context *context, uint16_t line, bool
             continue;
         }
 
-        uint_pixel_t *palette = &context->state.cram [sprite.palette << 4];
+        uint8_t palette = sprite.palette << 4;
         int_point_t position = { .x = sprite.x - 128, .y=sprite.y - 128};
 
         uint32_t tile_y = (line - position.y) / 8;
@@ -497,7 +694,7 @@ static void smd_vdp_draw_background (SMD_VDP_Context *context, uint16_t line, ui
 
         SMD_VDP_Pattern *pattern = (SMD_VDP_Pattern *) &context->state.vram [(tile.pattern) * sizeof (SMD_VDP_Pattern)];
 
-        uint_pixel_t *palette = &context->state.cram [tile.palette << 4];
+        uint8_t palette = tile.palette << 4;
 
         position.x = 8 * screen_tile_x + h_scroll_fine;
         smd_vdp_draw_pattern_line (context, line, pattern, palette, position, tile.h_flip, tile.v_flip);
@@ -511,16 +708,16 @@ static void smd_vdp_draw_background (SMD_VDP_Context *context, uint16_t line, ui
  */
 void smd_vdp_render_line (SMD_VDP_Context *context, uint16_t line)
 {
+    /* The line is drawn as CRAM indices */
+    snepulator_frame_line_palette (context->frame_buffer, line, context->state.cram, 64);
+
     /* Backdrop */
-    uint_pixel_t video_backdrop = context->state.cram [context->state.backdrop_colour & 0x3f];
-    context->frame_buffer.backdrop [line] = video_backdrop;
+    uint8_t video_backdrop = context->state.backdrop_colour & 0x3f;
+    context->frame_buffer->backdrop [line] = context->state.cram [video_backdrop];
 
     /* Start by filling the screen with the backdrop colour */
-    uint32_t line_start = line * context->frame_buffer.width;
-    for (int x = 0; x < context->frame_buffer.width; x++)
-    {
-        context->frame_buffer.active_area [line_start + x] = video_backdrop;
-    }
+    memset (&context->frame_buffer->active_area_index [line * context->frame_buffer->width], video_backdrop,
+            context->frame_buffer->width);
 
     /* If blanking is enabled, stop now, leaving the active area with only the backdrop colour. */
     if (!context->state.mode_2_blank)
@@ -632,9 +829,9 @@ void smd_vdp_update_mode (SMD_VDP_Context *context)
         context->sprites_max = 80;
     }
 
-    context->frame_buffer.width = context->screen_width;
+    context->frame_buffer->width = context->screen_width;
     /* TODO: For now, assuming 224 active lines. */
-    context->frame_buffer.height = 224;
+    context->frame_buffer->height = 224;
     context->lines_active = 224;
 
 }
@@ -645,18 +842,26 @@ void smd_vdp_update_mode (SMD_VDP_Context *context)
  */
 void smd_vdp_run_one_scanline (SMD_VDP_Context *context)
 {
+    /* Lines are drawn directly into the frame that will be passed on for display */
+    context->frame_buffer = snepulator_get_draw_frame ();
+
     /* Update the V-Counter */
     /* TODO: For now, hard-coded for NTSC mode. PAL is 313 lines. */
     context->state.line = (context->state.line + 1) % 262;
 
+    /* Drain the DMA backlog at this line's bandwidth */
+    uint32_t dma_capacity = smd_vdp_dma_line_capacity (context);
+    context->state.dma_backlog = (context->state.dma_backlog > dma_capacity) ? context->state.dma_backlog - dma_capacity : 0;
+
     /* If this is the first line, update the mode */
     if (context->state.line == 0)
     {
         smd_vdp_update_mode (context);
     }
 
-    /* If this is an active line, render it */
-    if (context->state.line < context->lines_active)
+    /* If this is an active line, render it. Lines of skipped frames
+     * are not drawn, as sprite overflow and collision are not emulated. */
+    if (context->state.line < context->lines_active && !context->frame_buffer->skip)
     {
         smd_vdp_render_line (context, context->state.line);
     }
@@ -664,7 +869,7 @@ void smd_vdp_run_one_scanline (SMD_VDP_Context *context)
     /* If this the final active line, copy the frame for output to the user */
     if (context->state.line == context->lines_active - 1)
     {
-        snepulator_frame_done (&context->frame_buffer);
+        snepulator_frame_done (context->frame_buffer);
     }
 
     /* Line Interrupt */
@@ -709,6 +914,7 @@ void smd_vdp_run_one_scanline (SMD_VDP_Context *context)
  */
 SMD_VDP_Context *smd_vdp_init (void *parent,
                                uint16_t (* memory_read_16)  (void *, uint32_t),
+                               const uint16_t *(* memory_pointer) (void *, uint32_t, uint32_t *),
                                void (* frame_done) (void *))
 {
     SMD_VDP_Context *context;
@@ -722,7 +928,9 @@ SMD_VDP_Context *smd_vdp_init (void *parent,
 
     context->parent = parent;
     context->memory_read_16  = memory_read_16;
+    context->memory_pointer  = memory_pointer;
     context->frame_done = frame_done;
+    context->frame_buffer = snepulator_get_draw_frame ();
 
     smd_vdp_update_mode (context);
 
@@ -7,6 +7,14 @@
 
 #define ADDRESS_CODE_DMA 0x20
 
+/* DMA operations, for bandwidth accounting */
+typedef enum SMD_VDP_DMA_Type_e {
+    SMD_VDP_DMA_TRANSFER = 0,   /* 68000 memory to VRAM, CRAM, or VSRAM */
+    SMD_VDP_DMA_FILL,
+    SMD_VDP_DMA_COPY,
+    SMD_VDP_DMA_TYPE_COUNT
+} SMD_VDP_DMA_Type;
+
 typedef struct SMD_VDP_Pattern_t {
     uint32_t line [8];
 } SMD_VDP_Pattern;
@@ -53,6 +61,12 @@ typedef struct SMD_VDP_State_s {
     uint8_t code;
     bool second_half_pending;
     bool fill_pending;
+
+    /* DMA is performed immediately, but the number of bytes a real VDP would
+     * still be moving is kept here, and drained at each line's bandwidth. */
+    uint8_t dma_type;
+    uint32_t dma_backlog;
+
     uint8_t line_interrupt_counter;
     uint8_t interrupt;              /* Contains the highest priority pending interrupt */
     bool z80_interrupt;             /* Interrupt for the z80 */
@@ -122,6 +136,11 @@ typedef struct SMD_VDP_Context_s {
     void *parent;
     uint16_t (* memory_read_16) (void *, uint32_t);
 
+    /* Host memory for a DMA source. Returns a pointer to the host-endian word
+     * at the address and the number of contiguous words, or NULL for sources
+     * that must be read through memory_read_16. */
+    const uint16_t *(* memory_pointer) (void *, uint32_t, uint32_t *);
+
     SMD_VDP_State state;
 
     /* Mode data */
@@ -132,7 +151,7 @@ typedef struct SMD_VDP_Context_s {
     uint32_t lines_active;
 
     /* Video output */
-    Video_Frame frame_buffer;
+    Video_Frame *frame_buffer;
     void (* frame_done) (void *);
 
 } SMD_VDP_Context;
@@ -149,6 +168,9 @@ uint16_t smd_vdp_data_read (SMD_VDP_Context *context);
 /* Write to the VDP data port. */
 void smd_vdp_data_write (SMD_VDP_Context *context, uint16_t data);
 
+/* Number of bytes that DMA can move during the current line. */
+uint32_t smd_vdp_dma_line_capacity (SMD_VDP_Context *context);
+
 /* Check if the VDP is currently requesting an interrupt. */
 uint8_t smd_vdp_get_interrupt (SMD_VDP_Context *context);
 
@@ -161,4 +183,5 @@ void smd_vdp_run_one_scanline (SMD_VDP_Context *context);
 /* Create an SMD VDP context with power-on defaults. */
 SMD_VDP_Context *smd_vdp_init (void *parent,
                                uint16_t (* memory_read_16)  (void *, uint32_t),
+                               const uint16_t *(* memory_pointer) (void *, uint32_t, uint32_t *),
                                void (* frame_done) (void *));
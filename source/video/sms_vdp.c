@@ -22,6 +22,10 @@ extern Snepulator_Gamepad gamepad [3];
 /* Constants */
 #define SMS_VDP_CRAM_SIZE (32)
 
+/* Frame palette layout: The legacy palette, followed by CRAM */
+#define SMS_VDP_INDEX_LEGACY (0)
+#define SMS_VDP_INDEX_CRAM   (16)
+
 /* Macros */
 #define SMS_VDP_TO_UINT_PIXEL(C) { .r = ((((C) >> 0) & 0x03) * (0xff / 3)), \
                                    .g = ((((C) >> 2) & 0x03) * (0xff / 3)), \
@@ -156,6 +160,132 @@ static const TMS9928A_ModeInfo Mode4_NTSC240 = {
 };
 
 
+#ifdef SMS_VDP_DEFERRED
+/* Deferred rendering log, must be a power of two */
+#define SMS_VDP_LOG_SIZE SIZE_64K
+
+typedef enum SMS_VDP_Log_Type_e {
+    SMS_VDP_LOG_VRAM = 0,   /* One byte written to VRAM */
+    SMS_VDP_LOG_LINE,       /* Draw the line described by lines [address] */
+} SMS_VDP_Log_Type;
+
+typedef struct SMS_VDP_Log_Entry_s {
+    uint16_t address;
+    uint8_t  value;
+    uint8_t  type;
+} SMS_VDP_Log_Entry;
+
+/* Everything other than VRAM that is needed to draw a line.
+ * Registers and CRAM are small enough to copy for each line. */
+typedef struct SMS_VDP_Line_s {
+    TMS9928A_State state;
+    TMS9928A_Mode mode;
+    uint16_t lines_active;
+    int_point_t crop_start;
+    Video_Frame *frame_buffer;
+    uint_pixel_t *palette;
+    bool remove_sprite_limit;
+    bool disable_blanking;
+    bool sms1_vdp_hint;
+} SMS_VDP_Line;
+
+typedef struct SMS_VDP_Deferred_s {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t work;    /* Signalled when new entries are published */
+    pthread_cond_t idle;    /* Signalled when the rendering thread has caught up */
+    bool exit;
+
+    /* The emulation thread appends entries at head, and publishes them to the
+     * rendering thread, which consumes them from tail. The emulation thread
+     * only reads tail with the mutex held, keeping a copy in tail_cache. */
+    uint32_t head;
+    uint32_t published;
+    uint32_t tail;
+    uint32_t tail_cache;
+    SMS_VDP_Log_Entry log [SMS_VDP_LOG_SIZE];
+    SMS_VDP_Line lines [VIDEO_MAX_LINES];
+
+    /* The rendering thread's copy of the VDP */
+    TMS9928A_Context shadow;
+} SMS_VDP_Deferred;
+
+
+/*
+ * Make all logged entries visible to the rendering thread.
+ * Called with the mutex held.
+ */
+static void sms_vdp_deferred_publish_locked (SMS_VDP_Deferred *deferred)
+{
+    deferred->published = deferred->head;
+    deferred->tail_cache = deferred->tail;
+    pthread_cond_signal (&deferred->work);
+}
+
+
+/*
+ * Wait for the rendering thread to finish all logged entries.
+ */
+static void sms_vdp_deferred_wait (SMS_VDP_Deferred *deferred)
+{
+    pthread_mutex_lock (&deferred->mutex);
+    sms_vdp_deferred_publish_locked (deferred);
+
+    while (deferred->tail != deferred->published)
+    {
+        pthread_cond_wait (&deferred->idle, &deferred->mutex);
+    }
+
+    deferred->tail_cache = deferred->tail;
+    pthread_mutex_unlock (&deferred->mutex);
+}
+
+
+/*
+ * Append one entry to the log.
+ */
+static void sms_vdp_deferred_log (SMS_VDP_Deferred *deferred, SMS_VDP_Log_Type type, uint16_t address, uint8_t value)
+{
+    uint32_t next = (deferred->head + 1) & (SMS_VDP_LOG_SIZE - 1);
+
+    /* If the log is full, wait for the rendering thread to make space */
+    if (next == deferred->tail_cache)
+    {
+        pthread_mutex_lock (&deferred->mutex);
+        sms_vdp_deferred_publish_locked (deferred);
+
+        while (next == deferred->tail)
+        {
+            pthread_cond_wait (&deferred->idle, &deferred->mutex);
+        }
+
+        deferred->tail_cache = deferred->tail;
+        pthread_mutex_unlock (&deferred->mutex);
+    }
+
+    deferred->log [deferred->head] = (SMS_VDP_Log_Entry) { .address = address, .value = value, .type = type };
+    deferred->head = next;
+}
+#endif
+
+
+/*
+ * Write one byte to VRAM.
+ */
+static inline void sms_vdp_vram_write (TMS9928A_Context *context, uint16_t address, uint8_t value)
+{
+    context->vram [address] = value;
+    context->pattern_cache_dirty [address >> 10] |= 1 << ((address >> 5) & 0x1f);
+
+    /* Writing to the sprite attribute table changes which sprites are on each line */
+    if ((uint16_t) (address - context->sprite_lines.table.base) <
+        context->sprite_lines.table.entries * context->sprite_lines.table.stride)
+    {
+        context->sprite_lines.valid = false;
+    }
+}
+
+
 /* TODO: Use tms9928a versions where identical */
 /*
  * Read one byte from the VDP data port.
@@ -188,7 +318,13 @@ void sms_vdp_data_write (TMS9928A_Context *context, uint8_t value)
         case TMS9928A_CODE_VRAM_READ:
         case TMS9928A_CODE_VRAM_WRITE:
         case TMS9928A_CODE_REG_WRITE:
-            context->vram [context->state.address] = value;
+            sms_vdp_vram_write (context, context->state.address, value);
+#ifdef SMS_VDP_DEFERRED
+            if (context->deferred != NULL)
+            {
+                sms_vdp_deferred_log (context->deferred, SMS_VDP_LOG_VRAM, context->state.address, value);
+            }
+#endif
             break;
 
         case SMS_VDP_CODE_CRAM_WRITE:
@@ -393,34 +529,98 @@ bool sms_vdp_get_interrupt (TMS9928A_Context *context)
 #define SMS_VDP_PATTERN_VERTICAL_FLIP       BIT_10
 
 
+/*
+ * Mark all cached patterns as needing to be decoded again.
+ * Called when VRAM has been replaced, eg, by loading a save-state.
+ */
+void sms_vdp_pattern_cache_invalidate (TMS9928A_Context *context)
+{
+    memset (context->pattern_cache_dirty, 0xff, sizeof (context->pattern_cache_dirty));
+    tms9928a_sprite_lines_invalidate (context);
+
+#ifdef SMS_VDP_DEFERRED
+    /* The rendering thread needs a copy of the new VRAM */
+    if (context->deferred != NULL)
+    {
+        sms_vdp_deferred_wait (context->deferred);
+        memcpy (context->deferred->shadow.vram, context->vram, TMS9928A_VRAM_SIZE);
+        sms_vdp_pattern_cache_invalidate (&context->deferred->shadow);
+    }
+#endif
+}
+
+
+/*
+ * Decode a planar Mode 4 pattern into the pattern cache.
+ */
+static void sms_vdp_mode4_decode_pattern (TMS9928A_Context *context, uint16_t pattern_index)
+{
+    uint32_t *pattern_base = (uint32_t *) &context->vram [pattern_index * sizeof (SMS_VDP_Mode4_Pattern)];
+
+    for (uint32_t y = 0; y < 8; y++)
+    {
+        uint32_t pattern_line = pattern_base [y];
+
+        for (uint32_t x = 0; x < 8; x++)
+        {
+            uint32_t pixel_bit = 7 - x;
+
+            uint8_t colour_index = ((pattern_line >> (pixel_bit     )) & 0x01) |
+                                   ((pattern_line >> (pixel_bit +  7)) & 0x02) |
+                                   ((pattern_line >> (pixel_bit + 14)) & 0x04) |
+                                   ((pattern_line >> (pixel_bit + 21)) & 0x08);
+
+            context->pattern_cache [pattern_index] [0] [y] [x] = colour_index;
+            context->pattern_cache [pattern_index] [1] [y] [7 - x] = colour_index;
+        }
+    }
+
+    context->pattern_cache_dirty [pattern_index >> 5] &= ~(1 << (pattern_index & 0x1f));
+}
+
+
+/*
+ * Get one decoded line of a pattern, updating the cache if VRAM has changed.
+ */
+static inline uint8_t *sms_vdp_mode4_pattern_line (TMS9928A_Context *context, uint16_t pattern_index,
+                                                   uint32_t line, bool flip_h)
+{
+    if (context->pattern_cache_dirty [pattern_index >> 5] & (1 << (pattern_index & 0x1f)))
+    {
+        sms_vdp_mode4_decode_pattern (context, pattern_index);
+    }
+
+    return context->pattern_cache [pattern_index] [flip_h] [line];
+}
+
+
 /*
  * Render one line of an 8×8 pattern.
  * Background version.
  * Supports vertical and horizontal mirroring.
  */
-static void sms_vdp_mode4_draw_pattern_background (TMS9928A_Context *context, uint16_t line, SMS_VDP_Mode4_Pattern *pattern_base,
+static void sms_vdp_mode4_draw_pattern_background (TMS9928A_Context *context, uint16_t line, uint16_t pattern_index,
                                                    SMS_VDP_Palette palette, int_point_t position, bool flip_h, bool flip_v, bool priority)
 {
-    uint32_t pattern_line;
-    uint32_t pixel_bit;
+    uint8_t *pattern_line;
+
+    /* Account for the destination frame-buffer start position, which may be smaller than
+     * the native SMS VDP resolution. Eg, due to left-column-blanking or Game Gear cropping */
+    if (line < context->crop_start.y || line - context->crop_start.y >= context->frame_buffer->height)
+    {
+        return;
+    }
+    int32_t destination_start = position.x - context->crop_start.x + (line - context->crop_start.y) * context->frame_buffer->width;
 
     /* Get the line within the pattern */
     if (flip_v)
     {
-        pattern_line = ((uint32_t *) pattern_base) [position.y - line + 7];
+        pattern_line = sms_vdp_mode4_pattern_line (context, pattern_index, position.y - line + 7, flip_h);
     }
     else
     {
-        pattern_line = ((uint32_t *) pattern_base) [line - position.y];
-    }
-
-    /* Account for the destination frame-buffer start position, which may be smaller than
-     * the native SMS VDP resolution. Eg, due to left-column-blanking or Game Gear cropping */
-    if (line < context->crop_start.y || line - context->crop_start.y >= context->frame_buffer.height)
-    {
-        return;
+        pattern_line = sms_vdp_mode4_pattern_line (context, pattern_index, line - position.y, flip_h);
     }
-    int32_t destination_start = position.x - context->crop_start.x + (line - context->crop_start.y) * context->frame_buffer.width;
 
     for (int32_t x = 0; x < 8; x++)
     {
@@ -430,24 +630,12 @@ static void sms_vdp_mode4_draw_pattern_background (TMS9928A_Context *context, ui
         {
             continue;
         }
-        else if (x + position.x - context->crop_start.x >= context->frame_buffer.width)
+        else if (x + position.x - context->crop_start.x >= context->frame_buffer->width)
         {
             return;
         }
 
-        if (flip_h)
-        {
-            pixel_bit = x;
-        }
-        else
-        {
-            pixel_bit = 7 - x;
-        }
-
-        uint8_t colour_index = ((pattern_line >> (pixel_bit     )) & 0x01) |
-                               ((pattern_line >> (pixel_bit +  7)) & 0x02) |
-                               ((pattern_line >> (pixel_bit + 14)) & 0x04) |
-                               ((pattern_line >> (pixel_bit + 21)) & 0x08);
+        uint8_t colour_index = pattern_line [x];
 
         /* Colour 0 is transparency */
         if (colour_index == 0 && priority)
@@ -455,8 +643,7 @@ static void sms_vdp_mode4_draw_pattern_background (TMS9928A_Context *context, ui
             continue;
         }
 
-        uint_pixel_t pixel = context->state.cram [palette + colour_index];
-        context->frame_buffer.active_area [destination_start + x] = pixel;
+        context->frame_buffer->active_area_index [destination_start + x] = SMS_VDP_INDEX_CRAM + palette + colour_index;
     }
 }
 
@@ -495,7 +682,9 @@ static void sms_vdp_mode4_draw_background (TMS9928A_Context *context, uint16_t l
         fine_scroll_x = 0;
     }
 
-    for (uint32_t tile_x = 0; tile_x < 32; tile_x++)
+    /* With fine scrolling, the leftmost pixels show the tile that has wrapped
+     * around from the right edge. This is column -1. */
+    for (int32_t tile_x = (fine_scroll_x) ? -1 : 0; tile_x < 32; tile_x++)
     {
         /* Bit 7 in ctrl_0 can disable vertical scrolling for the rightmost eight columns */
         if (tile_x == 24 && context->state.regs.ctrl_0_lock_col_24_31)
@@ -505,7 +694,7 @@ static void sms_vdp_mode4_draw_background (TMS9928A_Context *context, uint16_t l
             fine_scroll_y = 0;
         }
 
-        uint16_t tile_address = name_table_base + ((table_row << 6) | ((table_col + tile_x) % 32 << 1));
+        uint16_t tile_address = name_table_base + ((table_row << 6) | ((table_col + tile_x + 32) % 32 << 1));
 
         /* SMS1 VDP name-table mirroring */
         if (context->sms1_vdp_hint && !(context->state.regs.name_table_base & 0x01))
@@ -527,13 +716,11 @@ static void sms_vdp_mode4_draw_background (TMS9928A_Context *context, uint16_t l
         bool flip_h = !!(tile & SMS_VDP_PATTERN_HORIZONTAL_FLIP);
         bool flip_v = !!(tile & SMS_VDP_PATTERN_VERTICAL_FLIP);
 
-        SMS_VDP_Mode4_Pattern *pattern = (SMS_VDP_Mode4_Pattern *) &context->vram [(tile & 0x1ff) * sizeof (SMS_VDP_Mode4_Pattern)];
-
         SMS_VDP_Palette palette = (tile & BIT_11) ? SMS_VDP_PALETTE_SPRITE : SMS_VDP_PALETTE_BACKGROUND;
 
         position.x = 8 * tile_x + fine_scroll_x;
         position.y = 8 * tile_y - fine_scroll_y;
-        sms_vdp_mode4_draw_pattern_background (context, line, pattern, palette, position, flip_h, flip_v, priority);
+        sms_vdp_mode4_draw_pattern_background (context, line, tile & 0x1ff, palette, position, flip_h, flip_v, priority);
     }
 }
 
@@ -543,14 +730,17 @@ static void sms_vdp_mode4_draw_background (TMS9928A_Context *context, uint16_t l
  * Sprite version.
  * Supports magnification.
  */
-static void sms_vdp_mode4_draw_pattern_sprite (TMS9928A_Context *context, uint16_t line, SMS_VDP_Mode4_Pattern *pattern_base,
-                                               int_point_t position, bool magnify)
+static void sms_vdp_mode4_draw_pattern_sprite (TMS9928A_Context *context, uint16_t line, uint16_t pattern_index,
+                                               int_point_t position, bool magnify, bool draw)
 {
     uint32_t draw_width = (magnify) ? 16 : 8;
-    uint32_t pattern_line = ((uint32_t *) pattern_base) [(line - position.y) >> magnify];
-    uint32_t pixel_bit;
+    int32_t row = (line - position.y) >> magnify;
+
+    /* Rows outside of the pattern belong to its neighbours in VRAM */
+    pattern_index = (pattern_index + (row >> 3)) & 0x1ff;
+    uint8_t *pattern_line = sms_vdp_mode4_pattern_line (context, pattern_index, row & 0x07, false);
 
-    int32_t destination_start = position.x - context->crop_start.x + (line - context->crop_start.y) * context->frame_buffer.width;
+    int32_t destination_start = position.x - context->crop_start.x + (line - context->crop_start.y) * context->frame_buffer->width;
 
     for (uint32_t x = 0; x < draw_width; x++)
     {
@@ -560,12 +750,7 @@ static void sms_vdp_mode4_draw_pattern_sprite (TMS9928A_Context *context, uint16
             return;
         }
 
-        pixel_bit = 7 - (x >> magnify);
-
-        uint8_t colour_index = ((pattern_line >> (pixel_bit     )) & 0x01) |
-                               ((pattern_line >> (pixel_bit +  7)) & 0x02) |
-                               ((pattern_line >> (pixel_bit + 14)) & 0x04) |
-                               ((pattern_line >> (pixel_bit + 21)) & 0x08);
+        uint8_t colour_index = pattern_line [x >> magnify];
 
         /* Colour 0 is transparency */
         if (colour_index == 0)
@@ -581,32 +766,48 @@ static void sms_vdp_mode4_draw_pattern_sprite (TMS9928A_Context *context, uint16
         context->state.collision_buffer [x + position.x] = true;
 
         /* Don't actually render to the outside of the active area. */
-        if (x + position.x < context->crop_start.x ||
-            x + position.x - context->crop_start.x >= context->frame_buffer.width ||
+        if (!draw ||
+            x + position.x < context->crop_start.x ||
+            x + position.x - context->crop_start.x >= context->frame_buffer->width ||
             line < context->crop_start.y ||
-            line - context->crop_start.y >= context->frame_buffer.height)
+            line - context->crop_start.y >= context->frame_buffer->height)
         {
             continue;
         }
 
-        uint_pixel_t pixel = context->state.cram [SMS_VDP_PALETTE_SPRITE + colour_index];
-        context->frame_buffer.active_area [destination_start + x] = pixel;
+        context->frame_buffer->active_area_index [destination_start + x] = SMS_VDP_INDEX_CRAM + SMS_VDP_PALETTE_SPRITE + colour_index;
     }
 }
 
 
+/*
+ * Evaluate the sprites on each line from the mode 4 sprite attribute table, if it has changed.
+ */
+static void sms_vdp_mode4_update_sprite_lines (TMS9928A_Context *context)
+{
+    uint8_t pattern_height = context->state.regs.ctrl_1_sprite_mag ? 16 : 8;
+
+    tms9928a_sprite_lines_update (context, &(TMS9928A_Sprite_Table) {
+        .base = (((uint16_t) context->state.regs.sprite_attr_table_base) << 7) & 0x3f00,
+        .stride = 1,
+        .entries = 64,
+        .height = context->state.regs.ctrl_1_sprite_size ? (pattern_height << 1) : pattern_height,
+        .limit = context->remove_sprite_limit ? 64 : 8,
+        .terminator = (context->lines_active == 192)
+    });
+}
+
+
 /*
  * Render one line of the sprite layer.
+ *
+ * If draw is false, only the overflow and collision flags are updated.
  */
-static void sms_vdp_mode4_draw_sprites (TMS9928A_Context *context, uint16_t line)
+static void sms_vdp_mode4_draw_sprites (TMS9928A_Context *context, uint16_t line, bool draw)
 {
     uint16_t sprite_attribute_table_base = (((uint16_t) context->state.regs.sprite_attr_table_base) << 7) & 0x3f00;
     uint16_t sprite_pattern_offset = (context->state.regs.sprite_pg_base & 0x04) ? 256 : 0;
     uint8_t pattern_height = context->state.regs.ctrl_1_sprite_mag ? 16 : 8;
-    uint8_t sprite_height = context->state.regs.ctrl_1_sprite_size ? (pattern_height << 1) : pattern_height;
-    uint8_t line_sprite_buffer [64];
-    uint8_t line_sprite_count = 0;
-    SMS_VDP_Mode4_Pattern *pattern;
     int_point_t position;
     bool magnify = false;
 
@@ -616,45 +817,25 @@ static void sms_vdp_mode4_draw_sprites (TMS9928A_Context *context, uint16_t line
         magnify = true;
     }
 
-    /* Traverse the sprite list, filling the line sprite buffer */
-    for (int i = 0; i < 64; i++)
-    {
-        uint8_t y = context->vram [sprite_attribute_table_base + i];
-
-        /* Break if there are no more sprites */
-        if (context->lines_active == 192 && y == 0xd0)
-            break;
+    /* Find the sprites on this line */
+    sms_vdp_mode4_update_sprite_lines (context);
+    uint8_t line_sprite_count = context->sprite_lines.count [line];
 
-        /* This number is treated as unsigned when the first line of
-         * the sprite is on the screen, but signed when it is not */
-        if (y >= 0xe0)
-            position.y = ((int8_t) y) + 1;
-        else
-            position.y = y + 1;
-
-        /* If the sprite is on this line, add it to the buffer */
-        if (line >= position.y && line < position.y + sprite_height)
-        {
-            if (line_sprite_count == 8 && !context->remove_sprite_limit)
-            {
-                context->state.status |= TMS9928A_SPRITE_OVERFLOW;
-                break;
-            }
-            line_sprite_buffer [line_sprite_count++] = i;
-        }
+    if (context->sprite_lines.overflow [line] != 0xff)
+    {
+        context->state.status |= TMS9928A_SPRITE_OVERFLOW;
     }
 
     /* Clear the sprite collision buffer */
     memset (context->state.collision_buffer, 0, sizeof (context->state.collision_buffer));
 
-    /* Render the sprites in the line sprite buffer.
+    /* Render the sprites on this line.
      * Done in reverse order so that the first sprite is the one left on the screen */
     while (line_sprite_count--)
     {
-        uint16_t i = line_sprite_buffer [line_sprite_count];
-        uint8_t y = context->vram [sprite_attribute_table_base + i];
-        uint8_t x = context->vram [sprite_attribute_table_base + 0x80 + i * 2];
-        uint8_t pattern_index = context->vram [sprite_attribute_table_base + 0x80 + i * 2 + 1];
+        TMS9928A_Line_Sprite *line_sprite = &context->sprite_lines.sprites [line] [line_sprite_count];
+        uint8_t x = context->vram [sprite_attribute_table_base + 0x80 + line_sprite->index * 2];
+        uint8_t pattern_index = context->vram [sprite_attribute_table_base + 0x80 + line_sprite->index * 2 + 1];
 
         position.x = x;
 
@@ -664,65 +845,32 @@ static void sms_vdp_mode4_draw_sprites (TMS9928A_Context *context, uint16_t line
             position.x -= 8;
         }
 
-        /* TODO: Can we remove these duplicated lines? */
-        if (y >= 0xe0)
-            position.y = ((int8_t) y) + 1;
-        else
-            position.y = y + 1;
+        position.y = line - line_sprite->row;
 
         if (context->state.regs.ctrl_1_sprite_size)
             pattern_index &= 0xfe;
 
-        pattern = (SMS_VDP_Mode4_Pattern *) &context->vram [(sprite_pattern_offset + pattern_index) * sizeof (SMS_VDP_Mode4_Pattern)];
-        sms_vdp_mode4_draw_pattern_sprite (context, line, pattern, position, magnify);
+        sms_vdp_mode4_draw_pattern_sprite (context, line, sprite_pattern_offset + pattern_index, position, magnify, draw);
 
         if (context->state.regs.ctrl_1_sprite_size)
         {
             position.y += pattern_height;
-            pattern = (SMS_VDP_Mode4_Pattern *) &context->vram [(sprite_pattern_offset + pattern_index + 1) * sizeof (SMS_VDP_Mode4_Pattern)];
-            sms_vdp_mode4_draw_pattern_sprite (context, line, pattern, position, magnify);
+            sms_vdp_mode4_draw_pattern_sprite (context, line, sprite_pattern_offset + pattern_index + 1, position, magnify, draw);
         }
     }
 }
 
 
 /*
- * A simplified copy of the sprite overflow check to use when blanking is enabled.
+ * Check for sprite overflow without drawing, for use when blanking is enabled.
  */
 static void sms_vdp_mode4_check_sprite_overflow (TMS9928A_Context *context, uint16_t line)
 {
-    uint16_t sprite_attribute_table_base = (((uint16_t) context->state.regs.sprite_attr_table_base) << 7) & 0x3f00;
-    uint8_t pattern_height = context->state.regs.ctrl_1_sprite_mag ? 16 : 8;
-    uint8_t sprite_height = context->state.regs.ctrl_1_sprite_size ? (pattern_height << 1) : pattern_height;
-    uint8_t line_sprite_count = 0;
-    int_point_t position;
+    sms_vdp_mode4_update_sprite_lines (context);
 
-    /* Traverse the sprite list, filling the line sprite buffer */
-    for (int i = 0; i < 64; i++)
+    if (context->sprite_lines.overflow [line] != 0xff)
     {
-        uint8_t y = context->vram [sprite_attribute_table_base + i];
-
-        /* Break if there are no more sprites */
-        if (context->lines_active == 192 && y == 0xd0)
-            break;
-
-        /* This number is treated as unsigned when the first line of
-         * the sprite is on the screen, but signed when it is not */
-        if (y >= 0xe0)
-            position.y = ((int8_t) y) + 1;
-        else
-            position.y = y + 1;
-
-        /* If the sprite is on this line, add it to the buffer */
-        if (line >= position.y && line < position.y + sprite_height)
-        {
-            if (line_sprite_count == 8 && !context->remove_sprite_limit)
-            {
-                context->state.status |= TMS9928A_SPRITE_OVERFLOW;
-                break;
-            }
-            line_sprite_count++;
-        }
+        context->state.status |= TMS9928A_SPRITE_OVERFLOW;
     }
 }
 
@@ -732,33 +880,37 @@ static void sms_vdp_mode4_check_sprite_overflow (TMS9928A_Context *context, uint
  */
 static void sms_vdp_render_line (TMS9928A_Context *context, uint16_t line)
 {
-    uint_pixel_t video_backdrop;
+    uint8_t video_backdrop;
 
     if (context->mode & SMS_VDP_MODE_4)
     {
-        video_backdrop = context->state.cram [16 + (context->state.regs.background_colour & 0x0f)];
+        video_backdrop = SMS_VDP_INDEX_CRAM + 16 + (context->state.regs.background_colour & 0x0f);
     }
     else
     {
-        video_backdrop = context->palette [context->state.regs.background_colour & 0x0f];
+        video_backdrop = SMS_VDP_INDEX_LEGACY + (context->state.regs.background_colour & 0x0f);
     }
 
     /* Only draw the backdrop if this line is included in the active area */
     if (line >= context->crop_start.y &&
-        line - context->crop_start.y < context->frame_buffer.height)
+        line - context->crop_start.y < context->frame_buffer->height)
     {
+        /* The line is drawn as indices into both the legacy palette and CRAM */
+        uint_pixel_t palette [SMS_VDP_INDEX_CRAM + SMS_VDP_CRAM_SIZE];
+        memcpy (&palette [SMS_VDP_INDEX_LEGACY], context->palette, sizeof (uint_pixel_t) * 16);
+        memcpy (&palette [SMS_VDP_INDEX_CRAM], context->state.cram, sizeof (uint_pixel_t) * SMS_VDP_CRAM_SIZE);
+        snepulator_frame_line_palette (context->frame_buffer, line - context->crop_start.y,
+                                       palette, SMS_VDP_INDEX_CRAM + SMS_VDP_CRAM_SIZE);
+
         /* Note: For now the top/bottom borders just copy the background from the first
          *       and last active lines. Do any games change the value outside of this? */
-        context->frame_buffer.backdrop [line - context->crop_start.y] = video_backdrop;
+        context->frame_buffer->backdrop [line - context->crop_start.y] = palette [video_backdrop];
 
         /* If blanking is enabled, fill the active area with the backdrop colour. */
         if (!context->state.regs.ctrl_1_blank && !context->disable_blanking)
         {
-            uint32_t line_start = (line - context->crop_start.y) * context->frame_buffer.width;
-            for (int x = 0; x < context->frame_buffer.width; x++)
-            {
-                context->frame_buffer.active_area [line_start + x] = video_backdrop;
-            }
+            memset (&context->frame_buffer->active_area_index [(line - context->crop_start.y) * context->frame_buffer->width],
+                    video_backdrop, context->frame_buffer->width);
         }
     }
 
@@ -773,13 +925,13 @@ static void sms_vdp_render_line (TMS9928A_Context *context, uint16_t line)
     if (context->state.regs.ctrl_0_mode_4)
     {
         sms_vdp_mode4_draw_background (context, line, false);
-        sms_vdp_mode4_draw_sprites (context, line);
+        sms_vdp_mode4_draw_sprites (context, line, true);
         sms_vdp_mode4_draw_background (context, line, true);
     }
     else if (context->mode == TMS9928A_MODE_0)
     {
         tms9928a_mode0_draw_background (context, line);
-        tms9928a_draw_sprites (context, line);
+        tms9928a_draw_sprites (context, line, true);
     }
     else if (context->mode == TMS9928A_MODE_1)
     {
@@ -788,16 +940,163 @@ static void sms_vdp_render_line (TMS9928A_Context *context, uint16_t line)
     else if (context->mode == TMS9928A_MODE_2)
     {
         tms9928a_mode2_draw_background (context, line);
-        tms9928a_draw_sprites (context, line);
+        tms9928a_draw_sprites (context, line, true);
     }
     else if (context->mode == TMS9928A_MODE_3)
     {
         tms9928a_mode3_draw_background (context, line);
-        tms9928a_draw_sprites (context, line);
+        tms9928a_draw_sprites (context, line, true);
     }
 }
 
 
+/*
+ * Update the sprite overflow and collision flags for one active line, without
+ * drawing it. Used for frames that will not be displayed, and when drawing is
+ * deferred, as the flags are visible to the CPU so must stay on the emulation thread.
+ *
+ * This follows the same path through the modes as sms_vdp_render_line.
+ */
+static void sms_vdp_update_line_status (TMS9928A_Context *context, uint16_t line)
+{
+    if (!context->state.regs.ctrl_1_blank && !context->disable_blanking && context->state.regs.ctrl_0_mode_4)
+    {
+        sms_vdp_mode4_check_sprite_overflow (context, line);
+    }
+    else if (context->state.regs.ctrl_0_mode_4)
+    {
+        sms_vdp_mode4_draw_sprites (context, line, false);
+    }
+    else if (context->mode == TMS9928A_MODE_0 || context->mode == TMS9928A_MODE_2 || context->mode == TMS9928A_MODE_3)
+    {
+        tms9928a_draw_sprites (context, line, false);
+    }
+}
+
+
+#ifdef SMS_VDP_DEFERRED
+/*
+ * Rendering thread, replays the log into its copy of the VDP.
+ */
+static void *sms_vdp_deferred_thread (void *deferred_ptr)
+{
+    SMS_VDP_Deferred *deferred = (SMS_VDP_Deferred *) deferred_ptr;
+    TMS9928A_Context *shadow = &deferred->shadow;
+
+    pthread_mutex_lock (&deferred->mutex);
+
+    while (!deferred->exit)
+    {
+        if (deferred->tail == deferred->published)
+        {
+            pthread_cond_wait (&deferred->work, &deferred->mutex);
+            continue;
+        }
+
+        uint32_t tail = deferred->tail;
+        uint32_t published = deferred->published;
+        pthread_mutex_unlock (&deferred->mutex);
+
+        for (; tail != published; tail = (tail + 1) & (SMS_VDP_LOG_SIZE - 1))
+        {
+            SMS_VDP_Log_Entry *entry = &deferred->log [tail];
+
+            if (entry->type == SMS_VDP_LOG_VRAM)
+            {
+                sms_vdp_vram_write (shadow, entry->address, entry->value);
+            }
+            else
+            {
+                SMS_VDP_Line *line = &deferred->lines [entry->address];
+
+                shadow->state               = line->state;
+                shadow->mode                = line->mode;
+                shadow->lines_active        = line->lines_active;
+                shadow->crop_start          = line->crop_start;
+                shadow->frame_buffer        = line->frame_buffer;
+                shadow->palette             = line->palette;
+                shadow->remove_sprite_limit = line->remove_sprite_limit;
+                shadow->disable_blanking    = line->disable_blanking;
+                shadow->sms1_vdp_hint       = line->sms1_vdp_hint;
+
+                sms_vdp_render_line (shadow, entry->address);
+            }
+        }
+
+        pthread_mutex_lock (&deferred->mutex);
+        deferred->tail = tail;
+        pthread_cond_signal (&deferred->idle);
+    }
+
+    pthread_mutex_unlock (&deferred->mutex);
+
+    return NULL;
+}
+
+
+/*
+ * Pass one active line to the rendering thread.
+ */
+static void sms_vdp_deferred_line (TMS9928A_Context *context, uint16_t line)
+{
+    SMS_VDP_Deferred *deferred = context->deferred;
+
+    /* The rendering thread has finished with the previous frame's
+     * copy of this line, as frames end with sms_vdp_deferred_wait. */
+    deferred->lines [line] = (SMS_VDP_Line) {
+        .state =               context->state,
+        .mode =                context->mode,
+        .lines_active =        context->lines_active,
+        .crop_start =          context->crop_start,
+        .frame_buffer =        context->frame_buffer,
+        .palette =             context->palette,
+        .remove_sprite_limit = context->remove_sprite_limit,
+        .disable_blanking =    context->disable_blanking,
+        .sms1_vdp_hint =       context->sms1_vdp_hint
+    };
+
+    sms_vdp_deferred_log (deferred, SMS_VDP_LOG_LINE, line, 0);
+
+    pthread_mutex_lock (&deferred->mutex);
+    sms_vdp_deferred_publish_locked (deferred);
+    pthread_mutex_unlock (&deferred->mutex);
+}
+
+
+/*
+ * Start the rendering thread.
+ * If the thread cannot be started, lines are drawn as they are run.
+ */
+static void sms_vdp_deferred_start (TMS9928A_Context *context)
+{
+    SMS_VDP_Deferred *deferred = calloc (1, sizeof (SMS_VDP_Deferred));
+    if (deferred == NULL)
+    {
+        return;
+    }
+
+    deferred->shadow = *context;
+    deferred->shadow.deferred = NULL;
+    sms_vdp_pattern_cache_invalidate (&deferred->shadow);
+
+    pthread_mutex_init (&deferred->mutex, NULL);
+    pthread_cond_init (&deferred->work, NULL);
+    pthread_cond_init (&deferred->idle, NULL);
+
+    if (pthread_create (&deferred->thread, NULL, sms_vdp_deferred_thread, deferred) != 0)
+    {
+        pthread_cond_destroy (&deferred->idle);
+        pthread_cond_destroy (&deferred->work);
+        pthread_mutex_destroy (&deferred->mutex);
+        free (deferred);
+        return;
+    }
+
+    context->deferred = deferred;
+}
+#endif
+
+
 /*
  * Called once per frame to update parameters based on the mode.
  */
@@ -867,6 +1166,9 @@ void sms_vdp_update_x_scroll_latch (TMS9928A_Context *context)
  */
 void sms_vdp_run_one_scanline (TMS9928A_Context *context)
 {
+    /* Lines are drawn directly into the frame that will be passed on for display */
+    context->frame_buffer = snepulator_get_draw_frame ();
+
     /* Update the V-Counter */
     context->state.line = (context->state.line + 1) % context->lines_total;
 
@@ -880,8 +1182,8 @@ void sms_vdp_run_one_scanline (TMS9928A_Context *context)
         /* The Master System supports multiple resolutions that can be changed on the fly. */
         if (context->is_game_gear)
         {
-            context->frame_buffer.width = 160;
-            context->frame_buffer.height = 144;
+            context->frame_buffer->width = 160;
+            context->frame_buffer->height = 144;
             context->crop_start.x = 48;
             context->crop_start.y = 24;
         }
@@ -890,18 +1192,18 @@ void sms_vdp_run_one_scanline (TMS9928A_Context *context)
             /* Treat mode-4's left-column-blanking as a lower resolution mode */
             if (context->state.regs.ctrl_0_mode_4 && context->state.regs.ctrl_0_mask_col_1)
             {
-                context->frame_buffer.width = 248;
+                context->frame_buffer->width = 248;
                 context->crop_start.x = 8;
             }
             else if (context->mode == TMS9928A_MODE_1)
             {
-                context->frame_buffer.width = 240;
+                context->frame_buffer->width = 240;
             }
             else
             {
-                context->frame_buffer.width = 256;
+                context->frame_buffer->width = 256;
             }
-            context->frame_buffer.height = context->lines_active;
+            context->frame_buffer->height = context->lines_active;
         }
     }
 
@@ -923,13 +1225,27 @@ void sms_vdp_run_one_scanline (TMS9928A_Context *context)
     /* If this is an active line, render it */
     if (context->state.line < context->lines_active)
     {
-        sms_vdp_render_line (context, context->state.line);
+        if (context->frame_buffer->skip)
+        {
+            sms_vdp_update_line_status (context, context->state.line);
+        }
+#ifdef SMS_VDP_DEFERRED
+        else if (context->deferred != NULL)
+        {
+            sms_vdp_update_line_status (context, context->state.line);
+            sms_vdp_deferred_line (context, context->state.line);
+        }
+#endif
+        else
+        {
+            sms_vdp_render_line (context, context->state.line);
+        }
     }
 
     /* If this the final active line, copy the frame for output to the user */
-    /* TODO: This is okay for single-threaded code, but locking may be needed if multi-threading is added */
     if (context->state.line == context->lines_active - 1)
     {
+        sms_vdp_finish (context);
         context->frame_done (context->parent);
 
 #ifdef DEVELOPER_BUILD
@@ -1004,8 +1320,56 @@ TMS9928A_Context *sms_vdp_init (void *parent, void (* frame_done) (void *), Cons
     context->palette = sms_vdp_legacy_palette;
     context->parent = parent;
     context->frame_done = frame_done;
+    context->frame_buffer = snepulator_get_draw_frame ();
+
+    sms_vdp_pattern_cache_invalidate (context);
 
     sms_vdp_update_mode (context);
 
+#ifdef SMS_VDP_DEFERRED
+    sms_vdp_deferred_start (context);
+#endif
+
     return context;
 }
+
+
+/*
+ * Wait for any deferred lines to be drawn.
+ */
+void sms_vdp_finish (TMS9928A_Context *context)
+{
+#ifdef SMS_VDP_DEFERRED
+    if (context->deferred != NULL)
+    {
+        sms_vdp_deferred_wait (context->deferred);
+    }
+#endif
+}
+
+
+/*
+ * Free the SMS VDP context.
+ */
+void sms_vdp_cleanup (TMS9928A_Context *context)
+{
+#ifdef SMS_VDP_DEFERRED
+    SMS_VDP_Deferred *deferred = context->deferred;
+
+    if (deferred != NULL)
+    {
+        pthread_mutex_lock (&deferred->mutex);
+        deferred->exit = true;
+        pthread_cond_signal (&deferred->work);
+        pthread_mutex_unlock (&deferred->mutex);
+        pthread_join (deferred->thread, NULL);
+
+        pthread_cond_destroy (&deferred->idle);
+        pthread_cond_destroy (&deferred->work);
+        pthread_mutex_destroy (&deferred->mutex);
+        free (deferred);
+    }
+#endif
+
+    free (context);
+}
@@ -45,6 +45,9 @@ bool sms_vdp_get_interrupt (TMS9928A_Context *context);
 /* Assemble the four mode-bits. */
 uint8_t sms_vdp_get_mode (TMS9928A_Context *context);
 
+/* Mark all cached patterns as needing to be decoded again. */
+void sms_vdp_pattern_cache_invalidate (TMS9928A_Context *context);
+
 /* Check if the light phaser is receiving light */
 bool sms_vdp_get_phaser_th (TMS9928A_Context *context, uint64_t z80_cycle);
 
@@ -54,6 +57,12 @@ uint8_t sms_vdp_get_v_counter (TMS9928A_Context *context);
 /* Create a SMS VDP context with power-on defaults. */
 TMS9928A_Context *sms_vdp_init (void *parent, void (* frame_done) (void *), Console console);
 
+/* Free the SMS VDP context. */
+void sms_vdp_cleanup (TMS9928A_Context *context);
+
+/* Wait for any deferred lines to be drawn. */
+void sms_vdp_finish (TMS9928A_Context *context);
+
 /* Read one byte from the VDP control (status) port. */
 uint8_t sms_vdp_status_read (TMS9928A_Context *context);
 
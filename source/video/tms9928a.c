@@ -162,6 +162,13 @@ void tms9928a_data_write (TMS9928A_Context *context, uint8_t value)
         case TMS9928A_CODE_VRAM_WRITE:
         case TMS9928A_CODE_REG_WRITE:
             context->vram [context->state.address] = value;
+
+            /* Writing to the sprite attribute table changes which sprites are on each line */
+            if ((uint16_t) (context->state.address - context->sprite_lines.table.base) <
+                context->sprite_lines.table.entries * context->sprite_lines.table.stride)
+            {
+                context->sprite_lines.valid = false;
+            }
             break;
 
         default:
@@ -265,8 +272,7 @@ static void tms9928a_draw_pattern_background (TMS9928A_Context *context, uint16_
             colour_index = context->state.regs.background_colour & 0x0f;
         }
 
-        uint_pixel_t pixel = context->palette [colour_index];
-        context->frame_buffer.active_area [(offset.x + x) + line * context->frame_buffer.width] = pixel;
+        context->frame_buffer->active_area_index [(offset.x + x) + line * context->frame_buffer->width] = colour_index;
     }
 }
 
@@ -296,8 +302,7 @@ static void tms9928a_draw_pattern_text (TMS9928A_Context *context, uint16_t line
             colour_index = context->state.regs.background_colour & 0x0f;
         }
 
-        uint_pixel_t pixel = context->palette [colour_index];
-        context->frame_buffer.active_area [(offset.x + x) + line * context->frame_buffer.width] = pixel;
+        context->frame_buffer->active_area_index [(offset.x + x) + line * context->frame_buffer->width] = colour_index;
     }
 }
 
@@ -307,7 +312,7 @@ static void tms9928a_draw_pattern_text (TMS9928A_Context *context, uint16_t line
  * Sprite version.
  */
 static void tms9928a_draw_pattern_sprite (TMS9928A_Context *context, uint16_t line, TMS9928A_Pattern *pattern_base,
-                                          uint8_t tile_colours, int_point_t position, bool magnify)
+                                          uint8_t tile_colours, int_point_t position, bool magnify, bool draw)
 {
     uint8_t line_data;
 
@@ -336,78 +341,138 @@ static void tms9928a_draw_pattern_sprite (TMS9928A_Context *context, uint16_t li
         }
         context->state.collision_buffer [x + position.x] = true;
 
-        uint_pixel_t pixel = context->palette [colour_index];
-        context->frame_buffer.active_area [(position.x + x) + line * context->frame_buffer.width] = pixel;
+        if (!draw)
+        {
+            continue;
+        }
+
+        context->frame_buffer->active_area_index [(position.x + x) + line * context->frame_buffer->width] = colour_index;
     }
 }
 
 
 /*
- * Render one line of the sprite layer.
- * Sprites can be either 8×8 pixels, or 16×16.
+ * Evaluate which sprites appear on each line, in a single pass over the sprite attribute table.
+ *
+ * The result is kept until the table is written to, or the way it is read changes.
  */
-void tms9928a_draw_sprites (TMS9928A_Context *context, uint16_t line)
+void tms9928a_sprite_lines_update (TMS9928A_Context *context, const TMS9928A_Sprite_Table *table)
 {
-    uint16_t sprite_attribute_table_base = (((uint16_t) context->state.regs.sprite_attr_table_base) << 7) & 0x3f80;
-    uint16_t pattern_generator_base = (((uint16_t) context->state.regs.sprite_pg_base) << 11) & 0x3800;
-    uint8_t sprite_size = context->state.regs.ctrl_1_sprite_size ? 16 : 8;
-    TMS9928A_Sprite *line_sprite_buffer [32];
-    uint8_t line_sprite_count = 0;
-    TMS9928A_Pattern *pattern;
-    int_point_t position;
-    bool magnify = false;
-
-    /* Sprite magnification */
-    if (context->state.regs.ctrl_1_sprite_mag)
+    TMS9928A_Sprite_Lines *sprite_lines = &context->sprite_lines;
+
+    if (sprite_lines->valid &&
+        sprite_lines->table.base       == table->base &&
+        sprite_lines->table.stride     == table->stride &&
+        sprite_lines->table.entries    == table->entries &&
+        sprite_lines->table.height     == table->height &&
+        sprite_lines->table.limit      == table->limit &&
+        sprite_lines->table.terminator == table->terminator)
     {
-        magnify = true;
+        return;
     }
 
-    /* Traverse the sprite list, filling the line sprite buffer */
-    for (int i = 0; i < 32; i++)
+    sprite_lines->table = *table;
+    sprite_lines->valid = true;
+    memset (sprite_lines->count, 0, sizeof (sprite_lines->count));
+    memset (sprite_lines->overflow, 0xff, sizeof (sprite_lines->overflow));
+
+    for (uint32_t i = 0; i < table->entries; i++)
     {
-        TMS9928A_Sprite *sprite = (TMS9928A_Sprite *) &context->vram [sprite_attribute_table_base + i * sizeof (TMS9928A_Sprite)];
+        uint8_t y = context->vram [table->base + i * table->stride];
 
         /* Break if there are no more sprites */
-        if (sprite->y == 0xd0)
+        if (table->terminator && y == 0xd0)
+        {
             break;
+        }
 
         /* This number is treated as unsigned when the first line of
          * the sprite is on the screen, but signed when it is not */
-        if (sprite->y >= 0xe0)
-            position.y = ((int8_t) sprite->y) + 1;
-        else
-            position.y = sprite->y + 1;
+        int32_t start = (y >= 0xe0) ? ((int8_t) y) + 1 : y + 1;
 
-        /* If the sprite is on this line, add it to the buffer */
-        if (line >= position.y && line < position.y + (sprite_size << magnify))
+        for (int32_t line = (start > 0) ? start : 0; line < start + table->height && line < 256; line++)
         {
-            /* Update the fifth-sprite number when setting the flag. */
-            /* Note: On real hardware with no overflow, the fifth-sprite-number
-             *       in the status register contains the number of sprites in
-             *       the sprite list. List length 31 and 32 share a value of 31.
-             *       Does anything rely on this behaviour? */
-            if (line_sprite_count == 4 && !context->remove_sprite_limit)
+            /* Sprites beyond the limit are not drawn, but the first is noted for the overflow flag */
+            if (sprite_lines->count [line] == table->limit)
             {
-                if (!(context->state.status & TMS9928A_SPRITE_OVERFLOW))
+                if (sprite_lines->overflow [line] == 0xff)
                 {
-                    context->state.status |= TMS9928A_SPRITE_OVERFLOW;
-                    context->state.status = (context->state.status & 0xe0) | i;
+                    sprite_lines->overflow [line] = i;
                 }
-                break;
+                continue;
             }
-            line_sprite_buffer [line_sprite_count++] = sprite;
+
+            sprite_lines->sprites [line] [sprite_lines->count [line]++] =
+                (TMS9928A_Line_Sprite) { .index = i, .row = line - start };
         }
     }
+}
+
+
+/*
+ * Mark the sprites on each line as needing to be evaluated again.
+ * Called when VRAM has been replaced, eg, by loading a save-state.
+ */
+void tms9928a_sprite_lines_invalidate (TMS9928A_Context *context)
+{
+    context->sprite_lines.valid = false;
+}
+
+
+/*
+ * Render one line of the sprite layer.
+ * Sprites can be either 8×8 pixels, or 16×16.
+ *
+ * If draw is false, only the overflow and collision flags are updated.
+ */
+void tms9928a_draw_sprites (TMS9928A_Context *context, uint16_t line, bool draw)
+{
+    uint16_t sprite_attribute_table_base = (((uint16_t) context->state.regs.sprite_attr_table_base) << 7) & 0x3f80;
+    uint16_t pattern_generator_base = (((uint16_t) context->state.regs.sprite_pg_base) << 11) & 0x3800;
+    uint8_t sprite_size = context->state.regs.ctrl_1_sprite_size ? 16 : 8;
+    TMS9928A_Pattern *pattern;
+    int_point_t position;
+    bool magnify = false;
+
+    /* Sprite magnification */
+    if (context->state.regs.ctrl_1_sprite_mag)
+    {
+        magnify = true;
+    }
+
+    /* Find the sprites on this line */
+    tms9928a_sprite_lines_update (context, &(TMS9928A_Sprite_Table) {
+        .base = sprite_attribute_table_base,
+        .stride = sizeof (TMS9928A_Sprite),
+        .entries = 32,
+        .height = sprite_size << magnify,
+        .limit = context->remove_sprite_limit ? 32 : 4,
+        .terminator = true
+    });
+    uint8_t line_sprite_count = context->sprite_lines.count [line];
+    uint8_t overflow = context->sprite_lines.overflow [line];
+
+    /* Update the fifth-sprite number when setting the flag. */
+    /* Note: On real hardware with no overflow, the fifth-sprite-number
+     *       in the status register contains the number of sprites in
+     *       the sprite list. List length 31 and 32 share a value of 31.
+     *       Does anything rely on this behaviour? */
+    if (overflow != 0xff && !(context->state.status & TMS9928A_SPRITE_OVERFLOW))
+    {
+        context->state.status |= TMS9928A_SPRITE_OVERFLOW;
+        context->state.status = (context->state.status & 0xe0) | overflow;
+    }
 
     /* Clear the sprite collision buffer */
     memset (context->state.collision_buffer, 0, sizeof (context->state.collision_buffer));
 
-    /* Render the sprites in the line sprite buffer.
+    /* Render the sprites on this line.
      * Done in reverse order so that the first sprite is the one left on the screen */
     while (line_sprite_count--)
     {
-        TMS9928A_Sprite *sprite = line_sprite_buffer [line_sprite_count];
+        TMS9928A_Line_Sprite *line_sprite = &context->sprite_lines.sprites [line] [line_sprite_count];
+        TMS9928A_Sprite *sprite = (TMS9928A_Sprite *) &context->vram [sprite_attribute_table_base +
+                                                                      line_sprite->index * sizeof (TMS9928A_Sprite)];
         uint8_t pattern_index = sprite->pattern;
 
         /* The most-significant bit of the colour byte decides if we 'early-clock' the sprite */
@@ -420,15 +485,7 @@ void tms9928a_draw_sprites (TMS9928A_Context *context, uint16_t line)
             position.x = sprite->x;
         }
 
-        /* TODO: Can we remove these duplicated lines? */
-        if (sprite->y >= 0xe0)
-        {
-            position.y = ((int8_t) sprite->y) + 1;
-        }
-        else
-        {
-            position.y = sprite->y + 1;
-        }
+        position.y = line - line_sprite->row;
 
         if (context->state.regs.ctrl_1_sprite_size)
         {
@@ -440,13 +497,13 @@ void tms9928a_draw_sprites (TMS9928A_Context *context, uint16_t line)
             {
                 sub_position.x = position.x + ((i & 2) ? (8 << magnify) : 0);
                 sub_position.y = position.y + ((i & 1) ? (8 << magnify) : 0);
-                tms9928a_draw_pattern_sprite (context, line, pattern + i, sprite->colour_ec << 4, sub_position, magnify);
+                tms9928a_draw_pattern_sprite (context, line, pattern + i, sprite->colour_ec << 4, sub_position, magnify, draw);
             }
         }
         else
         {
             pattern = (TMS9928A_Pattern *) &context->vram [pattern_generator_base + (pattern_index * sizeof (TMS9928A_Pattern))];
-            tms9928a_draw_pattern_sprite (context, line, pattern, sprite->colour_ec << 4, position, magnify);
+            tms9928a_draw_pattern_sprite (context, line, pattern, sprite->colour_ec << 4, position, magnify, draw);
         }
     }
 }
@@ -576,21 +633,19 @@ void tms9928a_mode3_draw_background (TMS9928A_Context *context, uint16_t line)
         {
             colour_left = context->state.regs.background_colour & 0x0f;
         }
-        uint_pixel_t pixel_left = context->palette [colour_left];
-        context->frame_buffer.active_area [(8 * tile_x + 0) + line * context->frame_buffer.width] = pixel_left;
-        context->frame_buffer.active_area [(8 * tile_x + 1) + line * context->frame_buffer.width] = pixel_left;
-        context->frame_buffer.active_area [(8 * tile_x + 2) + line * context->frame_buffer.width] = pixel_left;
-        context->frame_buffer.active_area [(8 * tile_x + 3) + line * context->frame_buffer.width] = pixel_left;
+        context->frame_buffer->active_area_index [(8 * tile_x + 0) + line * context->frame_buffer->width] = colour_left;
+        context->frame_buffer->active_area_index [(8 * tile_x + 1) + line * context->frame_buffer->width] = colour_left;
+        context->frame_buffer->active_area_index [(8 * tile_x + 2) + line * context->frame_buffer->width] = colour_left;
+        context->frame_buffer->active_area_index [(8 * tile_x + 3) + line * context->frame_buffer->width] = colour_left;
 
         if (colour_right == TMS9928A_COLOUR_TRANSPARENT)
         {
             colour_right = context->state.regs.background_colour & 0x0f;
         }
-        uint_pixel_t pixel_right = context->palette [colour_right];
-        context->frame_buffer.active_area [(8 * tile_x + 4) + line * context->frame_buffer.width] = pixel_right;
-        context->frame_buffer.active_area [(8 * tile_x + 5) + line * context->frame_buffer.width] = pixel_right;
-        context->frame_buffer.active_area [(8 * tile_x + 6) + line * context->frame_buffer.width] = pixel_right;
-        context->frame_buffer.active_area [(8 * tile_x + 7) + line * context->frame_buffer.width] = pixel_right;
+        context->frame_buffer->active_area_index [(8 * tile_x + 4) + line * context->frame_buffer->width] = colour_right;
+        context->frame_buffer->active_area_index [(8 * tile_x + 5) + line * context->frame_buffer->width] = colour_right;
+        context->frame_buffer->active_area_index [(8 * tile_x + 6) + line * context->frame_buffer->width] = colour_right;
+        context->frame_buffer->active_area_index [(8 * tile_x + 7) + line * context->frame_buffer->width] = colour_right;
     }
 }
 
@@ -611,22 +666,23 @@ uint8_t tms9928a_get_mode (TMS9928A_Context *context)
  */
 void tms9928a_render_line (TMS9928A_Context *context, uint16_t line)
 {
-    uint_pixel_t video_backdrop;
+    uint8_t video_backdrop;
+
+    /* The line is drawn as palette indices */
+    snepulator_frame_line_palette (context->frame_buffer, line, context->palette, 16);
 
     /* Background */
-    video_backdrop = context->palette [context->state.regs.background_colour & 0x0f];
+    video_backdrop = context->state.regs.background_colour & 0x0f;
 
     /* Note: The top/bottom borders use the background colour of the first and last active lines. */
-    context->frame_buffer.backdrop [line] = video_backdrop;
+    context->frame_buffer->backdrop [line] = context->palette [video_backdrop];
 
     /* If blanking is enabled, fill the whole screen with the backdrop colour.
      * Otherwise, fill only the border. */
     if (!context->state.regs.ctrl_1_blank && !context->disable_blanking)
     {
-        for (int x = 0; x < context->frame_buffer.width; x++)
-        {
-            context->frame_buffer.active_area [x + line * context->frame_buffer.width] = video_backdrop;
-        }
+        memset (&context->frame_buffer->active_area_index [line * context->frame_buffer->width], video_backdrop,
+                context->frame_buffer->width);
 
         /* Return without rendering patterns if BLANK is enabled */
         return;
@@ -635,7 +691,7 @@ void tms9928a_render_line (TMS9928A_Context *context, uint16_t line)
     if (context->mode == TMS9928A_MODE_0)
     {
         tms9928a_mode0_draw_background (context, line);
-        tms9928a_draw_sprites (context, line);
+        tms9928a_draw_sprites (context, line, true);
     }
     else if (context->mode & TMS9928A_MODE_1)
     {
@@ -644,12 +700,31 @@ void tms9928a_render_line (TMS9928A_Context *context, uint16_t line)
     else if (context->mode & TMS9928A_MODE_2)
     {
         tms9928a_mode2_draw_background (context, line);
-        tms9928a_draw_sprites (context, line);
+        tms9928a_draw_sprites (context, line, true);
     }
     else if (context->mode & TMS9928A_MODE_3)
     {
         tms9928a_mode3_draw_background (context, line);
-        tms9928a_draw_sprites (context, line);
+        tms9928a_draw_sprites (context, line, true);
+    }
+}
+
+
+/*
+ * Update the sprite overflow and collision flags for one active line, without drawing it.
+ * Used for frames that will not be displayed.
+ */
+static void tms9928a_update_line_status (TMS9928A_Context *context, uint16_t line)
+{
+    if (!context->state.regs.ctrl_1_blank && !context->disable_blanking)
+    {
+        return;
+    }
+
+    /* Mode 1 has no sprites */
+    if (!(context->mode & TMS9928A_MODE_1))
+    {
+        tms9928a_draw_sprites (context, line, false);
     }
 }
 
@@ -699,6 +774,9 @@ static void tms9928a_vdp_update_mode (TMS9928A_Context *context)
  */
 void tms9928a_run_one_scanline (TMS9928A_Context *context)
 {
+    /* Lines are drawn directly into the frame that will be passed on for display */
+    context->frame_buffer = snepulator_get_draw_frame ();
+
     /* Update the V-Counter */
     context->state.line = (context->state.line + 1) % context->lines_total;
 
@@ -708,19 +786,26 @@ void tms9928a_run_one_scanline (TMS9928A_Context *context)
         tms9928a_vdp_update_mode (context);
         if (context->mode & TMS9928A_MODE_1)
         {
-            context->frame_buffer.width = 240;
+            context->frame_buffer->width = 240;
         }
         else
         {
-            context->frame_buffer.width = 256;
+            context->frame_buffer->width = 256;
         }
-        context->frame_buffer.height = 192;
+        context->frame_buffer->height = 192;
     }
 
     /* If this is an active line, render it */
     if (context->state.line < context->lines_active)
     {
-        tms9928a_render_line (context, context->state.line);
+        if (context->frame_buffer->skip)
+        {
+            tms9928a_update_line_status (context, context->state.line);
+        }
+        else
+        {
+            tms9928a_render_line (context, context->state.line);
+        }
     }
 
     /* If this the final active line, copy to the frame buffer */
@@ -766,6 +851,7 @@ TMS9928A_Context *tms9928a_init (void *parent, void (* frame_done) (void *))
 
     context->parent = parent;
     context->frame_done = frame_done;
+    context->frame_buffer = snepulator_get_draw_frame ();
 
     context->palette = tms9928a_palette;
 
@@ -776,12 +862,33 @@ TMS9928A_Context *tms9928a_init (void *parent, void (* frame_done) (void *))
 
 
 #ifdef HAVE_SAVE_STATES
+/* Save-state layout of TMS9928A_State. CRAM is stored as packed RGB
+ * so that the layout does not depend on the host pixel format. */
+typedef struct TMS9928A_State_Save_s {
+    TMS9928A_Registers regs;
+    uint16_t line;
+    uint16_t address;
+    uint8_t  first_byte_received;
+    uint8_t  code;
+    uint8_t  read_buffer;
+    uint8_t  status;
+    uint8_t  collision_buffer [256];
+    uint8_t  cram [32] [3];
+    uint8_t  line_interrupt_counter;
+    uint8_t  line_interrupt;
+    uint8_t  h_counter;
+    uint8_t  v_counter;
+    uint8_t  bg_scroll_x_latch;
+    uint8_t  cram_latch;
+} TMS9928A_State_Save;
+
+
 /*
  * Export tms9928a state.
  */
 void tms9928a_state_save (TMS9928A_Context *context)
 {
-    TMS9928A_State tms9928a_state_be = {
+    TMS9928A_State_Save tms9928a_state_be = {
         .regs =                   context->state.regs,
         .line =                   util_hton16 (context->state.line),
         .address =                util_hton16 (context->state.address),
@@ -799,7 +906,12 @@ void tms9928a_state_save (TMS9928A_Context *context)
     };
 
     memcpy (tms9928a_state_be.collision_buffer, context->state.collision_buffer, 256);
-    memcpy (tms9928a_state_be.cram, context->state.cram, sizeof (context->state.cram));
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        tms9928a_state_be.cram [i] [0] = context->state.cram [i].r;
+        tms9928a_state_be.cram [i] [1] = context->state.cram [i].g;
+        tms9928a_state_be.cram [i] [2] = context->state.cram [i].b;
+    }
 
     save_state_section_add (SECTION_ID_VDP, 1, sizeof (tms9928a_state_be), &tms9928a_state_be);
 }
@@ -810,7 +922,7 @@ void tms9928a_state_save (TMS9928A_Context *context)
  */
 void tms9928a_state_load (TMS9928A_Context *context, uint32_t version, uint32_t size, void *data)
 {
-    TMS9928A_State tms9928a_state_be;
+    TMS9928A_State_Save tms9928a_state_be;
 
     if (size == sizeof (tms9928a_state_be))
     {
@@ -825,7 +937,12 @@ void tms9928a_state_load (TMS9928A_Context *context, uint32_t version, uint32_t
         context->state.status =                 tms9928a_state_be.status;
 
         memcpy (context->state.collision_buffer, tms9928a_state_be.collision_buffer, 256);
-        memcpy (context->state.cram, tms9928a_state_be.cram, sizeof (context->state.cram));
+        for (uint32_t i = 0; i < 32; i++)
+        {
+            context->state.cram [i] = (uint_pixel_t) { .r = tms9928a_state_be.cram [i] [0],
+                                                       .g = tms9928a_state_be.cram [i] [1],
+                                                       .b = tms9928a_state_be.cram [i] [2] };
+        }
 
         context->state.line_interrupt_counter = tms9928a_state_be.line_interrupt_counter;
         context->state.line_interrupt =         tms9928a_state_be.line_interrupt;
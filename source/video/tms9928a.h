@@ -148,6 +148,33 @@ typedef struct TMS9928A_State_s {
     uint8_t cram_latch;
 } TMS9928A_State;
 
+/* Layout of the sprite attribute table, and how it is read */
+typedef struct TMS9928A_Sprite_Table_s {
+    uint16_t base;          /* Address of the first y-coordinate */
+    uint8_t  stride;        /* Bytes between y-coordinates */
+    uint8_t  entries;       /* Number of sprites in the table */
+    uint8_t  height;        /* Lines per sprite */
+    uint8_t  limit;         /* Sprites per line */
+    bool     terminator;    /* A y-coordinate of 0xd0 ends the table */
+} TMS9928A_Sprite_Table;
+
+/* One sprite on a line */
+typedef struct TMS9928A_Line_Sprite_s {
+    uint8_t index;          /* Entry in the sprite attribute table */
+    uint8_t row;            /* Line within the sprite */
+} TMS9928A_Line_Sprite;
+
+/* The sprites on each line, in priority order. Evaluated from the sprite
+ * attribute table for the whole frame, and only evaluated again if the
+ * table, or the registers that control how it is read, change. */
+typedef struct TMS9928A_Sprite_Lines_s {
+    TMS9928A_Sprite_Table table;
+    bool valid;
+    uint8_t count [256];
+    uint8_t overflow [256];                     /* First sprite over the limit, or 0xff */
+    TMS9928A_Line_Sprite sprites [256] [64];
+} TMS9928A_Sprite_Lines;
+
 typedef struct TMS9928A_Context_s {
 
     void *parent;
@@ -167,12 +194,25 @@ typedef struct TMS9928A_Context_s {
     uint16_t lines_total;
     SMS_VDP_V_Counter_Range v_counter_map [3]; /* SMS VDP v-counter mapping */
 
+    /* SMS VDP Mode 4 pattern cache, one palette index per pixel. The second
+     * index selects the horizontally flipped copy of the pattern. */
+    uint8_t pattern_cache [512][2][8][8];
+    uint32_t pattern_cache_dirty [512 / 32];
+
+    /* Sprite evaluation */
+    TMS9928A_Sprite_Lines sprite_lines;
+
     /* Video output */
-    Video_Frame frame_buffer;
+    Video_Frame *frame_buffer;
     uint_pixel_t *palette;
     int_point_t crop_start; /* Game Gear mode behaves like a cropped Master System. */
     void (* frame_done) (void *);
 
+#ifdef SMS_VDP_DEFERRED
+    /* Lines drawn by the rendering thread, NULL if drawing as each line is run */
+    struct SMS_VDP_Deferred_s *deferred;
+#endif
+
 } TMS9928A_Context;
 
 /* Each byte of the pattern represents a row of eight pixels. */
@@ -206,8 +246,14 @@ uint8_t tms9928a_status_read (TMS9928A_Context *context);
 /* Write one byte to the tms9928a control port. */
 void tms9928a_control_write (TMS9928A_Context *context, uint8_t value);
 
+/* Evaluate the sprites on each line, if the sprite attribute table has changed. */
+void tms9928a_sprite_lines_update (TMS9928A_Context *context, const TMS9928A_Sprite_Table *table);
+
+/* Mark the sprites on each line as needing to be evaluated again. */
+void tms9928a_sprite_lines_invalidate (TMS9928A_Context *context);
+
 /* Render one line of sprites for mode0 / mode2 / mode3. */
-void tms9928a_draw_sprites (TMS9928A_Context *context, uint16_t line);
+void tms9928a_draw_sprites (TMS9928A_Context *context, uint16_t line, bool draw);
 
 /* Render one line of the mode0 background layer. */
 void tms9928a_mode0_draw_background (TMS9928A_Context *context, uint16_t line);
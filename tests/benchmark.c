@@ -0,0 +1,415 @@
+/*
+ * Snepulator benchmark harness.
+ *
+ * Runs each fixture for a fixed number of frames with no video, audio, or
+ * input devices, and reports the time per frame, the CPU instruction rate,
+ * and the number of heap allocations made. Results are printed to the console
+ * and optionally written out as JSON so that runs can be compared.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <time.h>
+
+#include "../libraries/cJSON-1.7.19/cJSON.h"
+
+#include "../source/snepulator.h"
+#include "../source/util.h"
+#include "../source/headless_run.h"
+#include "../source/cpu/z80.h"
+#include "../source/cpu/m68k.h"
+#include "../source/video/tms9928a.h"
+#include "../source/video/sms_vdp.h"
+#include "../source/video/smd_vdp.h"
+#include "../source/sound/band_limit.h"
+#include "../source/sound/sn76489.h"
+#include "../source/sound/ym2413.h"
+#include "../source/sound/ym2612.h"
+#include "../source/sms.h"
+#include "../source/sg-1000.h"
+#include "../source/colecovision.h"
+#include "../source/smd.h"
+
+#define FIXTURE_DIR "benchmark/"
+#define MAX_FIXTURES 200
+
+/* Global state */
+Snepulator_State state;
+
+typedef struct Benchmark_Result_s {
+    const char *fixture;
+    const char *console;
+    bool error;
+    uint64_t frames;
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t run_time_ns;
+    uint64_t init_allocations;
+    uint64_t init_allocation_bytes;
+    uint64_t run_allocations;
+    uint64_t run_allocation_bytes;
+} Benchmark_Result;
+
+/* Allocation counters, updated by the wrapped allocator */
+static uint64_t allocation_count = 0;
+static uint64_t allocation_bytes = 0;
+
+
+/*
+ * Allocator wrappers.
+ *
+ * The benchmark is linked with --wrap for each of these, so all allocations
+ * made by the emulator core are counted before being passed on to libc.
+ */
+void *__real_malloc (size_t size);
+void *__real_calloc (size_t count, size_t size);
+void *__real_realloc (void *ptr, size_t size);
+void  __real_free (void *ptr);
+
+void *__wrap_malloc (size_t size)
+{
+    allocation_count++;
+    allocation_bytes += size;
+    return __real_malloc (size);
+}
+
+void *__wrap_calloc (size_t count, size_t size)
+{
+    allocation_count++;
+    allocation_bytes += count * size;
+    return __real_calloc (count, size);
+}
+
+void *__wrap_realloc (void *ptr, size_t size)
+{
+    allocation_count++;
+    allocation_bytes += size;
+    return __real_realloc (ptr, size);
+}
+
+void __wrap_free (void *ptr)
+{
+    __real_free (ptr);
+}
+
+
+/*
+ * Get a monotonic timestamp in nanoseconds.
+ */
+static uint64_t benchmark_time_ns (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+
+/*
+ * Get the name of the running console.
+ */
+static const char *benchmark_console_name (Console console)
+{
+    switch (console)
+    {
+        case CONSOLE_VGM_PLAYER:    return "vgm";
+        case CONSOLE_MIDI_PLAYER:   return "midi";
+        case CONSOLE_COLECOVISION:  return "colecovision";
+        case CONSOLE_SG_1000:       return "sg-1000";
+        case CONSOLE_MASTER_SYSTEM: return "master-system";
+        case CONSOLE_GAME_GEAR:     return "game-gear";
+        case CONSOLE_MEGA_DRIVE:    return "mega-drive";
+        default:                    return "none";
+    }
+}
+
+
+/*
+ * Get the number of CPU instructions run by the console.
+ *
+ * Players without an emulated CPU report zero.
+ */
+static uint64_t benchmark_instruction_count (void)
+{
+    switch (state.console)
+    {
+        case CONSOLE_COLECOVISION:
+            return ((ColecoVision_Context *) state.console_context)->z80_context->instruction_count;
+
+        case CONSOLE_SG_1000:
+            return ((SG_1000_Context *) state.console_context)->z80_context->instruction_count;
+
+        case CONSOLE_MASTER_SYSTEM:
+        case CONSOLE_GAME_GEAR:
+            return ((SMS_Context *) state.console_context)->z80_context->instruction_count;
+
+        case CONSOLE_MEGA_DRIVE:
+            return ((SMD_Context *) state.console_context)->m68k_context->instruction_count +
+                   ((SMD_Context *) state.console_context)->z80_context->instruction_count;
+
+        default:
+            return 0;
+    }
+}
+
+
+/*
+ * Run a single fixture for the requested number of frames.
+ */
+static void benchmark_run_fixture (const char *filename, uint64_t frames, Benchmark_Result *result)
+{
+    memset (result, 0, sizeof (Benchmark_Result));
+    result->fixture = filename;
+
+    /* Load the fixture */
+    allocation_count = 0;
+    allocation_bytes = 0;
+
+    snepulator_rom_set (filename);
+
+    result->init_allocations = allocation_count;
+    result->init_allocation_bytes = allocation_bytes;
+    result->console = benchmark_console_name (state.console);
+
+    if (state.run != RUN_STATE_RUNNING)
+    {
+        fprintf (stderr, "Unable to start %s.\n", filename);
+        result->error = true;
+        snepulator_reset ();
+        return;
+    }
+
+    /* Run as fast as possible */
+    allocation_count = 0;
+    allocation_bytes = 0;
+
+    uint64_t start_time = benchmark_time_ns ();
+    result->cycles = headless_run (frames);
+
+    result->run_time_ns = benchmark_time_ns () - start_time;
+    result->run_allocations = allocation_count;
+    result->run_allocation_bytes = allocation_bytes;
+    result->frames = state.frame_count;
+    result->instructions = benchmark_instruction_count ();
+    result->error = (state.run != RUN_STATE_RUNNING);
+
+    snepulator_reset ();
+}
+
+
+/*
+ * Print the result of a single fixture.
+ */
+static void benchmark_print_result (Benchmark_Result *result)
+{
+    double run_seconds = result->run_time_ns / 1000000000.0;
+
+    fprintf (stdout, "%s (%s):\n", result->fixture, result->console);
+
+    if (result->frames == 0)
+    {
+        fprintf (stdout, "    No frames completed.\n");
+        return;
+    }
+
+    fprintf (stdout, "    %" PRIu64 " frames, %.0f ns/frame, %.2f fps.\n",
+             result->frames, (double) result->run_time_ns / result->frames, result->frames / run_seconds);
+    fprintf (stdout, "    %" PRIu64 " instructions, %.2f M instructions/s.\n",
+             result->instructions, result->instructions / run_seconds / 1000000.0);
+    fprintf (stdout, "    %" PRIu64 " allocations (%" PRIu64 " bytes) during init, %" PRIu64 " (%" PRIu64 " bytes) while running.\n",
+             result->init_allocations, result->init_allocation_bytes,
+             result->run_allocations, result->run_allocation_bytes);
+
+    if (result->error)
+    {
+        fprintf (stdout, "    Emulation stopped with an error.\n");
+    }
+}
+
+
+/*
+ * Write all results to a JSON file.
+ */
+static int benchmark_write_json (const char *filename, uint64_t frames, Benchmark_Result *results, uint32_t count)
+{
+    cJSON *json = cJSON_CreateObject ();
+    cJSON_AddNumberToObject (json, "frames_requested", frames);
+
+    cJSON *json_results = cJSON_AddArrayToObject (json, "results");
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Benchmark_Result *result = &results [i];
+        double run_seconds = result->run_time_ns / 1000000000.0;
+        cJSON *entry = cJSON_CreateObject ();
+
+        cJSON_AddStringToObject (entry, "fixture", result->fixture);
+        cJSON_AddStringToObject (entry, "console", result->console);
+        cJSON_AddBoolToObject   (entry, "error", result->error);
+        cJSON_AddNumberToObject (entry, "frames", result->frames);
+        cJSON_AddNumberToObject (entry, "cycles", result->cycles);
+        cJSON_AddNumberToObject (entry, "run_time_ns", result->run_time_ns);
+        cJSON_AddNumberToObject (entry, "ns_per_frame", result->frames ? (double) result->run_time_ns / result->frames : 0.0);
+        cJSON_AddNumberToObject (entry, "instructions", result->instructions);
+        cJSON_AddNumberToObject (entry, "instructions_per_second", run_seconds > 0.0 ? result->instructions / run_seconds : 0.0);
+        cJSON_AddNumberToObject (entry, "init_allocations", result->init_allocations);
+        cJSON_AddNumberToObject (entry, "init_allocation_bytes", result->init_allocation_bytes);
+        cJSON_AddNumberToObject (entry, "run_allocations", result->run_allocations);
+        cJSON_AddNumberToObject (entry, "run_allocation_bytes", result->run_allocation_bytes);
+
+        cJSON_AddItemToArray (json_results, entry);
+    }
+
+    char *json_string = cJSON_Print (json);
+    cJSON_Delete (json);
+
+    if (json_string == NULL)
+    {
+        fprintf (stderr, "Error: Unable to generate JSON.\n");
+        return -1;
+    }
+
+    FILE *output = fopen (filename, "w");
+    if (output == NULL)
+    {
+        fprintf (stderr, "Error: Unable to open %s for writing.\n", filename);
+        free (json_string);
+        return -1;
+    }
+
+    fprintf (output, "%s\n", json_string);
+    fclose (output);
+    free (json_string);
+
+    return 0;
+}
+
+
+/*
+ * Display usage.
+ */
+static void usage (void)
+{
+    fprintf (stdout, "Usage: benchmark [--frames <count>] [--output <file.json>]\n"
+                     "                 [--colecovision-bios <file>] [fixture ...]\n"
+                     "If no fixtures are given, all files in " FIXTURE_DIR " are run.\n");
+}
+
+
+/*
+ * Entry point.
+ */
+int main (int argc, char **argv)
+{
+    static char *fixture_list [MAX_FIXTURES] = { };
+    static Benchmark_Result results [MAX_FIXTURES];
+    uint32_t fixture_count = 0;
+    const char *output_filename = NULL;
+    uint64_t frames = 600;
+    bool error = false;
+
+    /* Initialise Snepulator state */
+    headless_init ();
+
+    /* The user's configuration file is not read, so that results don't depend
+     * on local settings. Use the same defaults as snepulator_config_import. */
+    state.region = REGION_WORLD;
+    state.format = VIDEO_FORMAT_NTSC;
+    state.format_auto = true;
+    state.z80_idle_skip = true;
+
+    /* Parse all CLI arguments */
+    while (*(++argv))
+    {
+        if (strcmp (*argv, "--frames") == 0 && argv [1] != NULL)
+        {
+            frames = strtoull (*(++argv), NULL, 0);
+        }
+        else if (strcmp (*argv, "--output") == 0 && argv [1] != NULL)
+        {
+            output_filename = *(++argv);
+        }
+        else if (strcmp (*argv, "--colecovision-bios") == 0 && argv [1] != NULL)
+        {
+            state.colecovision_bios_filename = strdup (*(++argv));
+        }
+        else if (strncmp (*argv, "--", 2) == 0 || fixture_count >= MAX_FIXTURES)
+        {
+            usage ();
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            fixture_list [fixture_count++] = strdup (*argv);
+        }
+    }
+
+    if (frames == 0)
+    {
+        usage ();
+        return EXIT_FAILURE;
+    }
+
+    /* Default to running everything in the fixture directory */
+    if (fixture_count == 0)
+    {
+        DIR *dir = opendir (FIXTURE_DIR);
+        if (dir == NULL)
+        {
+            fprintf (stderr, "Error: Unable to open directory " FIXTURE_DIR ".\n");
+            usage ();
+            return EXIT_FAILURE;
+        }
+
+        struct dirent *entry;
+        while ((entry = readdir (dir)) != NULL && fixture_count < MAX_FIXTURES)
+        {
+            if (entry->d_type != DT_REG)
+            {
+                continue;
+            }
+            asprintf (&fixture_list [fixture_count++], FIXTURE_DIR "%s", entry->d_name);
+        }
+        closedir (dir);
+
+        /* Sort alphabetically so the output order is stable */
+        for (uint32_t i = 1; i < fixture_count; i++)
+        {
+            for (uint32_t j = i; j > 0 && strcmp (fixture_list [j - 1], fixture_list [j]) > 0; j--)
+            {
+                char *swap = fixture_list [j];
+                fixture_list [j] = fixture_list [j - 1];
+                fixture_list [j - 1] = swap;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < fixture_count; i++)
+    {
+        benchmark_run_fixture (fixture_list [i], frames, &results [i]);
+        benchmark_print_result (&results [i]);
+        error |= results [i].error;
+    }
+
+    if (output_filename != NULL)
+    {
+        if (benchmark_write_json (output_filename, frames, results, fixture_count) == -1)
+        {
+            error = true;
+        }
+    }
+
+    for (uint32_t i = 0; i < fixture_count; i++)
+    {
+        free (fixture_list [i]);
+    }
+
+    return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -14,18 +14,78 @@ then
     CXX="ccache $CXX"
 fi
 
+# The benchmark is built from the full emulator core, using the same options
+# as the headless build of Snepulator.
+CORE_CFLAGS="$CFLAGS -D_POSIX_C_SOURCE=200809L \
+             -I ../libraries/BLAKE3/ \
+             -I ../libraries/libspng-0.7.4/ \
+             -I work/ \
+             -DHAVE_SAVE_STATES \
+             -DDEVELOPER_BUILD \
+             -DTARGET_HEADLESS \
+             -DBUILD_DATE=\\\"benchmark\\\" \
+             -DBUILD_TAG=\\\"benchmark\\\""
+
 # Create a build directory if it does not already exist.
 mkdir -p work
+mkdir -p work/core
+
+# Generate the 68000 opcode tables.
+echo "Generating tables... "
+eval $CC $CFLAGS ../source/cpu/m68k_gen.c -o work/m68k_gen
+./work/m68k_gen work/m68k_tables.h
 
 # Compile all objects.
 echo "Compiling... "
 eval $CC $CFLAGS -c ../libraries/cJSON-1.7.19/cJSON.c   -o work/cJSON.o
-eval $CC $CFLAGS -c ../source/cpu/m68k.c                -o work/m68k.o
+eval $CC $CFLAGS -I work/ -c ../source/cpu/m68k.c       -o work/m68k.o
+eval $CC $CFLAGS -I work/ -c ../source/cpu/m68k.c -DM68K_COMPACT -o work/m68k-compact.o
 eval $CC $CFLAGS -c ../source/cpu/z80.c                 -o work/z80.o
+eval $CC $CFLAGS -c ../source/cpu/z80.c -DZ80_COMPUTED_GOTO -o work/z80-threaded.o
+eval $CC $CFLAGS -c ../source/cpu/z80_jit.c             -o work/z80_jit.o
 eval $CC $CFLAGS -c ./snepulator_compat.c               -o work/snepulator_compat.o
 eval $CC $CFLAGS -c ./util.c                            -o work/util.o
 eval $CC $CFLAGS -c ./z80-sst.c                         -o work/z80-sst.o
+eval $CC $CFLAGS -c ./z80-sst.c -DZ80_SST_JIT            -o work/z80-sst-jit.o
 eval $CC $CFLAGS -c ./m68k-sst.c                        -o work/m68k-sst.o
+eval $CC $CFLAGS -c ./m68k-sst.c -DM68K_COMPACT          -o work/m68k-sst-compact.o
+
+echo "Compiling benchmark core... "
+for SOURCE in ../source/cpu/m68k.c \
+              ../source/cpu/z80.c \
+              ../source/cpu/z80_jit.c \
+              ../source/database/sg_db.c \
+              ../source/database/sms_db.c \
+              ../source/sound/band_limit.c \
+              ../source/sound/sn76489.c \
+              ../source/sound/ym2413.c \
+              ../source/sound/ym2612.c \
+              ../source/video/smd_vdp.c \
+              ../source/video/sms_vdp.c \
+              ../source/video/tms9928a.c \
+              ../source/colecovision.c \
+              ../source/config.c \
+              ../source/gamepad.c \
+              ../source/headless_run.c \
+              ../source/logo.c \
+              ../source/midi_player.c \
+              ../source/path.c \
+              ../source/save_state.c \
+              ../source/sg-1000.c \
+              ../source/smd.c \
+              ../source/sms.c \
+              ../source/snepulator.c \
+              ../source/util.c \
+              ../source/vgm_player.c \
+              ../libraries/BLAKE3/blake3.c \
+              ../libraries/BLAKE3/blake3_portable.c \
+              ../libraries/libspng-0.7.4/spng.c
+do
+    eval $CC $CORE_CFLAGS -c $SOURCE -o work/core/$(basename ${SOURCE%.c}).o
+done
+eval $CC $CORE_CFLAGS -DBLAKE3_NO_SSE2 -DBLAKE3_NO_SSE41 -DBLAKE3_NO_AVX2 -DBLAKE3_NO_AVX512 \
+                      -c ../libraries/BLAKE3/blake3_dispatch.c -o work/core/blake3_dispatch.o
+eval $CC $CORE_CFLAGS -c ./benchmark.c                   -o work/benchmark.o
 
 # Link the binaries
 echo "Linking..."
@@ -34,10 +94,37 @@ $CC $CFLAGS work/z80-sst.o \
             work/util.o \
             work/snepulator_compat.o \
             work/z80.o \
+            work/z80_jit.o \
             work/cJSON.o \
             -Werror \
             -o z80-sst
 
+$CC $CFLAGS work/z80-sst.o \
+            work/util.o \
+            work/snepulator_compat.o \
+            work/z80-threaded.o \
+            work/z80_jit.o \
+            work/cJSON.o \
+            -Werror \
+            -o z80-sst-threaded
+
+$CC $CFLAGS work/z80-sst-jit.o \
+            work/util.o \
+            work/snepulator_compat.o \
+            work/z80.o \
+            work/z80_jit.o \
+            work/cJSON.o \
+            -Werror \
+            -o z80-sst-jit
+
+$CC $CFLAGS work/benchmark.o \
+            work/core/*.o \
+            work/cJSON.o \
+            -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free \
+            -lz -lm -lpthread \
+            -Werror \
+            -o benchmark
+
 $CC $CFLAGS work/m68k-sst.o \
             work/util.o \
             work/snepulator_compat.o \
@@ -47,4 +134,13 @@ $CC $CFLAGS work/m68k-sst.o \
             -Werror \
             -o m68k-sst
 
+$CC $CFLAGS work/m68k-sst-compact.o \
+            work/util.o \
+            work/snepulator_compat.o \
+            work/m68k-compact.o \
+            work/cJSON.o \
+            -lpthread \
+            -Werror \
+            -o m68k-sst-compact
+
 echo "Done."
@@ -29,7 +29,13 @@
 #include "../source/cpu/m68k.h"
 
 extern Snepulator_State state;
-extern uint32_t (*m68k_instruction [SIZE_64K]) (M68000_Context *, uint16_t);
+#ifdef M68K_COMPACT
+extern const uint16_t m68k_class [SIZE_64K];
+#define M68K_IMPLEMENTED(OPCODE) (m68k_class [OPCODE] != 0)
+#else
+extern uint32_t (* const m68k_instruction [SIZE_64K]) (M68000_Context *, uint16_t);
+#define M68K_IMPLEMENTED(OPCODE) (m68k_instruction [OPCODE] != NULL)
+#endif
 
 #define TEST_DIR "m68000/v1/"
 #define COLOUR_RED      "\033[0;31m"
@@ -326,16 +332,15 @@ static uint32_t run_test (Worker_Thread_Data *data, FILE *result_memstream, cons
 
     /* Skip if the instruction has not been implemented */
     uint16_t opcode = memory_read_16 (test_context, m68k_context->state.pc);
-    if (m68k_instruction [opcode] == NULL)
+    if (!M68K_IMPLEMENTED (opcode))
     {
         result = RESULT_SKIP;
     }
     else
     {
-        /* TODO: Accurate cycle counting has not yet been implemented, instead
-         *       Snepulator assumes a 10 cycles per instruction. Assume that each
-         *       test runs exactly one instruction. */
-        m68k_run_cycles (m68k_context, 10);
+        /* Each test runs exactly one instruction. Any instruction takes at
+         * least one cycle, so this stops after the first. */
+        m68k_run_cycles (m68k_context, 1);
 
         /* Skip memory exceptions */
         if (m68k_context->state.pc & 0x000001)
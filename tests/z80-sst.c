@@ -4,6 +4,11 @@
  * Note: These tests are being used to check that the final state matches the
  *       expected final state. The bus states during the instruction are ignored.
  *
+ * When built with Z80_SST_JIT, the test RAM is mapped into the Z80's memory map
+ * and the tests are run with the dynamic recompiler enabled. A few additional
+ * programs check that modified and banked-out code is not run from stale
+ * translations.
+ *
  * To do list:
  *  - I/O Support
  *  - ei
@@ -175,6 +180,15 @@ static uint32_t run_test (const cJSON *test, bool print_details)
     }
     read_state_from_json (&final_context, final);
 
+#ifdef Z80_SST_JIT
+    /* Map the test RAM so that the recompiler can translate from it */
+    for (uint32_t page = 0; page < Z80_PAGE_COUNT; page++)
+    {
+        z80_context->memory_map [page] = &test_context.ram [page * Z80_PAGE_SIZE];
+    }
+    z80_jit_set (z80_context, true);
+#endif
+
     /* Run cycles,
      * For now ignore the cycle-by-cycle bus values, just count how many cycles
      * there are, run them, and then check the result. */
@@ -316,6 +330,9 @@ static uint32_t run_test (const cJSON *test, bool print_details)
         }
     }
 
+#ifdef Z80_SST_JIT
+    z80_jit_set (z80_context, false);
+#endif
 
     free (z80_context);
     free (final_z80_context);
@@ -324,6 +341,184 @@ static uint32_t run_test (const cJSON *test, bool print_details)
 }
 
 
+#ifdef Z80_SST_JIT
+/* Memory for the recompiler programs, with a 16 KiB bank switched in at 0x4000 */
+typedef struct Jit_Test_Context_s {
+    Z80_Context *z80_context;
+    uint8_t ram [SIZE_64K];
+    /* Aligned, so that the recompiler does not see the banks as RAM when the RAM beside them is written to */
+    _Alignas (SIZE_1K) uint8_t bank [2] [SIZE_16K];
+} Jit_Test_Context;
+
+
+/*
+ * Map a bank in at 0x4000.
+ */
+static void jit_test_select_bank (Jit_Test_Context *context, uint8_t bank)
+{
+    for (uint32_t page = 0; page < SIZE_16K / Z80_PAGE_SIZE; page++)
+    {
+        context->z80_context->memory_map [0x4000 / Z80_PAGE_SIZE + page] = &context->bank [bank] [page * Z80_PAGE_SIZE];
+    }
+}
+
+
+/*
+ * Memory read through the memory map.
+ */
+static uint8_t jit_test_memory_read (void *context_ptr, uint16_t addr)
+{
+    Jit_Test_Context *context = (Jit_Test_Context *) context_ptr;
+    return context->z80_context->memory_map [addr / Z80_PAGE_SIZE] [addr & (Z80_PAGE_SIZE - 1)];
+}
+
+
+/*
+ * Memory write, with the bank selected by writing to 0xffff.
+ */
+static void jit_test_memory_write (void *context_ptr, uint16_t addr, uint8_t data)
+{
+    Jit_Test_Context *context = (Jit_Test_Context *) context_ptr;
+
+    /* The banks are read-only */
+    if (addr < 0x4000 || addr >= 0x8000)
+    {
+        context->ram [addr] = data;
+    }
+
+    if (addr == 0xffff)
+    {
+        jit_test_select_bank (context, data & 0x01);
+    }
+}
+
+
+/*
+ * Run a recompiler program until it halts, and check the value left in b.
+ */
+static void jit_test_run (const char *name, Jit_Test_Context *context, uint8_t expected_b)
+{
+    Z80_Context *z80_context = z80_init (context, jit_test_memory_read, jit_test_memory_write,
+                                         NULL, NULL, no_interrupt, no_interrupt);
+    context->z80_context = z80_context;
+
+    for (uint32_t page = 0; page < Z80_PAGE_COUNT; page++)
+    {
+        z80_context->memory_map [page] = &context->ram [page * Z80_PAGE_SIZE];
+    }
+    jit_test_select_bank (context, 0);
+    z80_context->state.sp = 0xc000;
+
+    z80_jit_set (z80_context, true);
+    z80_run_cycles (z80_context, 1000);
+
+    printf ("JIT  %18s:", name);
+    if (z80_context->state.halt && z80_context->state.b == expected_b)
+    {
+        printf (COLOUR_GREEN "  Passed    1 /    1 tests.\n" COLOUR_NORMAL);
+        pass_total += 1;
+    }
+    else
+    {
+        printf ("\n     Calculated b=%02x. Expected b=%02x.\n", z80_context->state.b, expected_b);
+        printf (COLOUR_RED "                          Passed    0 /    1 tests.\n" COLOUR_NORMAL);
+    }
+    test_total += 1;
+
+    z80_jit_set (z80_context, false);
+    free (z80_context);
+}
+
+
+/*
+ * Check that code modified after being translated is not run from a stale
+ * translation, both when it is called again and when it follows the write
+ * within the running block.
+ */
+static void jit_test_self_modifying (void)
+{
+    static Jit_Test_Context context;
+    memset (&context, 0, sizeof (context));
+
+    static const uint8_t program [] = {
+        0x06, 0x00,         /* 0000: ld b, 0x00         */
+        0xcd, 0x00, 0x08,   /* 0002: call 0x0800        ; inc b, b = 1 */
+        0x3e, 0x05,         /* 0005: ld a, 0x05         ; opcode for dec b */
+        0x32, 0x00, 0x08,   /* 0007: ld (0x0800), a     */
+        0xcd, 0x00, 0x08,   /* 000a: call 0x0800        ; dec b, b = 0 */
+        0xc3, 0x00, 0x10    /* 000d: jp 0x1000          */
+    };
+    static const uint8_t subroutine [] = {
+        0x04,               /* 0800: inc b              */
+        0xc9                /* 0801: ret                */
+    };
+    static const uint8_t block [] = {
+        0x32, 0x04, 0x10,   /* 1000: ld (0x1004), a     */
+        0x00,               /* 1003: nop                */
+        0x04,               /* 1004: inc b              ; replaced with dec b, b = 0xff */
+        0x76                /* 1005: halt               */
+    };
+
+    memcpy (&context.ram [0x0000], program, sizeof (program));
+    memcpy (&context.ram [0x0800], subroutine, sizeof (subroutine));
+    memcpy (&context.ram [0x1000], block, sizeof (block));
+
+    jit_test_run ("self-modifying", &context, 0xff);
+}
+
+
+/*
+ * Check that code banked out after being translated is not run from a stale
+ * translation, both when it is called again and when the bank is switched
+ * from within the running block.
+ */
+static void jit_test_bank_switch (void)
+{
+    static Jit_Test_Context context;
+    memset (&context, 0, sizeof (context));
+
+    static const uint8_t program [] = {
+        0x06, 0x00,         /* 0000: ld b, 0x00         */
+        0xcd, 0x00, 0x40,   /* 0002: call 0x4000        ; bank 0, b = 1 */
+        0x3e, 0x01,         /* 0005: ld a, 0x01         */
+        0x32, 0xff, 0xff,   /* 0007: ld (0xffff), a     */
+        0xcd, 0x00, 0x40,   /* 000a: call 0x4000        ; bank 1, b = 0xff */
+        0x3e, 0x00,         /* 000d: ld a, 0x00         */
+        0x32, 0xff, 0xff,   /* 000f: ld (0xffff), a     */
+        0xcd, 0x00, 0x40,   /* 0012: call 0x4000        ; bank 0, b = 0 */
+        0xc3, 0x00, 0x41    /* 0015: jp 0x4100          */
+    };
+    static const uint8_t bank_0_subroutine [] = {
+        0x04,               /* 4000: inc b              */
+        0xc9                /* 4001: ret                */
+    };
+    static const uint8_t bank_1_subroutine [] = {
+        0x05,               /* 4000: dec b              */
+        0x05,               /* 4001: dec b              */
+        0xc9                /* 4002: ret                */
+    };
+    static const uint8_t bank_0_block [] = {
+        0x3e, 0x01,         /* 4100: ld a, 0x01         */
+        0x32, 0xff, 0xff,   /* 4102: ld (0xffff), a     */
+        0x04,               /* 4105: inc b              ; bank 1 is now mapped */
+        0x76                /* 4106: halt               */
+    };
+    static const uint8_t bank_1_block [] = {
+        0x05,               /* 4105: dec b              ; b = 0xff */
+        0x76                /* 4106: halt               */
+    };
+
+    memcpy (&context.ram [0x0000], program, sizeof (program));
+    memcpy (&context.bank [0] [0x0000], bank_0_subroutine, sizeof (bank_0_subroutine));
+    memcpy (&context.bank [1] [0x0000], bank_1_subroutine, sizeof (bank_1_subroutine));
+    memcpy (&context.bank [0] [0x0100], bank_0_block, sizeof (bank_0_block));
+    memcpy (&context.bank [1] [0x0105], bank_1_block, sizeof (bank_1_block));
+
+    jit_test_run ("bank-switch", &context, 0xff);
+}
+#endif
+
+
 /*
  * Process a single test file
  */
@@ -458,6 +653,11 @@ int main (int argc, char **argv)
     }
 
 
+#ifdef Z80_SST_JIT
+    jit_test_self_modifying ();
+    jit_test_bank_switch ();
+#endif
+
     DIR *dir = opendir (TEST_DIR);
     if (dir == NULL)
     {